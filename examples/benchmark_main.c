@@ -0,0 +1,722 @@
+/*
+// compilation:
+// gcc
+gcc -O2 -no-pie -fno-pie -I"../include" benchmark_main.c -o benchmark_main
+// clang
+clang -O2 -no-pie -fno-pie -I"../include" benchmark_main.c -o benchmark_main
+// mingw
+x86_64-w64-mingw32-gcc -mconsole -O2 -I"../include" benchmark_main.c -o benchmark_main.exe
+// cl.exe
+cl /O2 /MT /Tc benchmark_main.c /I"../include" /link /out:benchmark_main.exe user32.lib kernel32.lib
+*/
+
+/*
+// compile as C++ (it adds std::vector and std::unordered_map to the results)
+// gcc
+g++ -O2 -no-pie -fno-pie -I"../include" benchmark_main.c -o benchmark_main_cpp
+// or
+gcc -O2 -x c++ -no-pie -fno-pie -I"../include" benchmark_main.c -o benchmark_main_cpp
+// clang and mingw are gcc based (try using clang++ and x86_64-w64-mingw32-g++)
+
+// cl.exe
+cl /O2 /MT /Tp benchmark_main.c /I"../include" /EHsc /link /out:benchmark_main_cpp.exe user32.lib kernel32.lib
+*/
+
+/* Usage:
+benchmark_main [max_num_items]
+// It measures ns/op and ops/s of the most common vector and hashtable operations, with keys of 4, 16 and 64 bytes,
+// with 1000, 100000 and 1000000 items (but not more than 'max_num_items', that defaults to 1000000), and (for
+// hashtables) with CH_NUM_BUCKETS 256, 4096 and 65536. Short runs are repeated, so that every row measures at least
+// BENCH_MIN_OPS operations. Tables with more than BENCH_MAX_ITEMS_PER_BUCKET items per bucket are skipped.
+// Rows are: container, key size (in bytes), number of items, CH_NUM_BUCKETS (hashtables only), operation, ns/op, Mops/s.
+// 'cv_xxx_insert_sorted' inserts at most BENCH_MAX_SORTED_INSERTS items (each insertion is O(n)).
+// '_serialize' and '_deserialize' count one op per item.
+// A second table compares the 'cvh_growth_policy_t' policies (NULL is the default 1.5x growth) on cv_key16_push_back(...),
+// on cvh_serializer_write_bytes(...) (16 bytes per op) and on ch_key16_val256_get_or_insert(...) (at most
+// 256*BENCH_MAX_ITEMS_PER_BUCKET items, and not with chunks bigger than 64 KB, that are pointless for small buckets).
+// Its rows are: policy, container, number of items, ns/op, number of reallocations (capacity changes), final capacity
+// (sum of the bucket capacities for hashtables) in KB, and the percentage of that capacity that is not used.
+// The 'vm' rows use a 'cvh_vm_allocator_t' (mmap(...) and mremap(...) with huge pages) for cv_key16: its growths never copy the items.
+*/
+
+/* Program Output (g++ -O2, on a single core of a virtual machine: timings depend on the machine):
+container           key  num_items  buckets  operation                  ns/op     Mops/s
+cv_key4               4       1000        -  push_back                   3.61    277.051
+cv_key4               4       1000        -  insert_sorted              76.27     13.112
+cv_key4               4       1000        -  binary_search              50.08     19.969
+cv_key4               4       1000        -  serialize                   0.05  18815.383
+cv_key4               4       1000        -  deserialize                 0.05  20102.927
+ch_key4_val256        4       1000      256  get_or_insert              16.27     61.468
+ch_key4_val256        4       1000      256  get                        16.47     60.723
+ch_key4_val256        4       1000      256  serialize                   2.64    378.248
+ch_key4_val256        4       1000      256  deserialize                 4.90    204.031
+ch_key4_val256        4       1000      256  remove                     24.10     41.486
+ch_key4_val4096       4       1000     4096  get_or_insert              16.51     60.564
+ch_key4_val4096       4       1000     4096  get                         9.58    104.394
+ch_key4_val4096       4       1000     4096  serialize                  17.87     55.950
+ch_key4_val4096       4       1000     4096  deserialize                30.38     32.919
+ch_key4_val4096       4       1000     4096  remove                     41.06     24.355
+ch_key4_val65536      4       1000    65536  get_or_insert             124.41      8.038
+ch_key4_val65536      4       1000    65536  get                         7.63    131.042
+ch_key4_val65536      4       1000    65536  serialize                 144.17      6.936
+ch_key4_val65536      4       1000    65536  deserialize               321.63      3.109
+ch_key4_val65536      4       1000    65536  remove                     24.75     40.402
+std::vector           4       1000        -  push_back                   1.21    828.942
+std::vector           4       1000        -  insert_sorted              61.48     16.265
+std::vector           4       1000        -  binary_search              48.15     20.770
+std::unordered_map    4       1000        -  get_or_insert              27.94     35.797
+std::unordered_map    4       1000        -  get                         7.92    126.296
+std::unordered_map    4       1000        -  remove                     33.84     29.549
+cv_key16             16       1000        -  push_back                   8.04    124.369
+cv_key16             16       1000        -  insert_sorted             138.27      7.232
+cv_key16             16       1000        -  binary_search              75.86     13.181
+cv_key16             16       1000        -  serialize                   0.18   5623.411
+cv_key16             16       1000        -  deserialize                 0.18   5694.274
+ch_key16_val256      16       1000      256  get_or_insert              27.94     35.786
+ch_key16_val256      16       1000      256  get                        29.26     34.171
+ch_key16_val256      16       1000      256  serialize                   2.56    391.176
+ch_key16_val256      16       1000      256  deserialize                 6.26    159.871
+ch_key16_val256      16       1000      256  remove                     36.91     27.095
+ch_key16_val65536    16       1000    65536  get_or_insert             112.13      8.918
+ch_key16_val65536    16       1000    65536  get                        13.24     75.511
+ch_key16_val65536    16       1000    65536  serialize                 175.33      5.704
+ch_key16_val65536    16       1000    65536  deserialize               333.18      3.001
+ch_key16_val65536    16       1000    65536  remove                     33.17     30.152
+std::vector          16       1000        -  push_back                   1.99    502.102
+std::vector          16       1000        -  insert_sorted              92.26     10.839
+std::vector          16       1000        -  binary_search              68.80     14.536
+std::unordered_map   16       1000        -  get_or_insert              34.78     28.749
+std::unordered_map   16       1000        -  get                        15.40     64.928
+std::unordered_map   16       1000        -  remove                     32.85     30.443
+cv_key64             64       1000        -  push_back                  10.89     91.812
+cv_key64             64       1000        -  insert_sorted             280.13      3.570
+cv_key64             64       1000        -  binary_search             103.03      9.706
+cv_key64             64       1000        -  serialize                   1.86    537.991
+cv_key64             64       1000        -  deserialize                 1.96    509.799
+ch_key64_val256      64       1000      256  get_or_insert              54.56     18.328
+ch_key64_val256      64       1000      256  get                        64.87     15.416
+ch_key64_val256      64       1000      256  serialize                   3.82    261.453
+ch_key64_val256      64       1000      256  deserialize                 9.00    111.164
+ch_key64_val256      64       1000      256  remove                     63.73     15.692
+ch_key64_val65536    64       1000    65536  get_or_insert             103.29      9.682
+ch_key64_val65536    64       1000    65536  get                        43.13     23.185
+ch_key64_val65536    64       1000    65536  serialize                 155.79      6.419
+ch_key64_val65536    64       1000    65536  deserialize               333.26      3.001
+ch_key64_val65536    64       1000    65536  remove                     68.54     14.590
+std::vector          64       1000        -  push_back                   6.21    160.974
+std::vector          64       1000        -  insert_sorted             163.54      6.115
+std::vector          64       1000        -  binary_search              99.45     10.056
+std::unordered_map   64       1000        -  get_or_insert              52.93     18.892
+std::unordered_map   64       1000        -  get                        52.61     19.006
+std::unordered_map   64       1000        -  remove                     64.28     15.557
+cv_key4               4     100000        -  push_back                   3.58    279.621
+cv_key4               4      10000        -  insert_sorted             174.19      5.741
+cv_key4               4     100000        -  binary_search             147.90      6.761
+cv_key4               4     100000        -  serialize                   0.37   2682.569
+cv_key4               4     100000        -  deserialize                 0.35   2830.015
+ch_key4_val256        4     100000      256  (skipped: more than 256 items per bucket)
+ch_key4_val4096       4     100000     4096  get_or_insert              58.08     17.217
+ch_key4_val4096       4     100000     4096  get                        62.50     16.001
+ch_key4_val4096       4     100000     4096  serialize                   1.66    602.544
+ch_key4_val4096       4     100000     4096  deserialize                 0.92   1083.557
+ch_key4_val4096       4     100000     4096  remove                     66.51     15.036
+ch_key4_val65536      4     100000    65536  get_or_insert              40.55     24.662
+ch_key4_val65536      4     100000    65536  get                        45.62     21.921
+ch_key4_val65536      4     100000    65536  serialize                   8.79    113.824
+ch_key4_val65536      4     100000    65536  deserialize                14.99     66.724
+ch_key4_val65536      4     100000    65536  remove                     47.31     21.137
+std::vector           4     100000        -  push_back                   2.90    345.199
+std::vector           4      10000        -  insert_sorted             158.75      6.299
+std::vector           4     100000        -  binary_search             127.73      7.829
+std::unordered_map    4     100000        -  get_or_insert              75.36     13.269
+std::unordered_map    4     100000        -  get                        28.52     35.063
+std::unordered_map    4     100000        -  remove                     71.05     14.075
+cv_key16             16     100000        -  push_back                   5.09    196.342
+cv_key16             16      10000        -  insert_sorted             774.73      1.291
+cv_key16             16     100000        -  binary_search             199.13      5.022
+cv_key16             16     100000        -  serialize                   1.88    530.645
+cv_key16             16     100000        -  deserialize                 1.98    505.172
+ch_key16_val256      16     100000      256  (skipped: more than 256 items per bucket)
+ch_key16_val65536    16     100000    65536  get_or_insert              48.81     20.487
+ch_key16_val65536    16     100000    65536  get                        63.62     15.719
+ch_key16_val65536    16     100000    65536  serialize                  10.24     97.627
+ch_key16_val65536    16     100000    65536  deserialize                16.82     59.462
+ch_key16_val65536    16     100000    65536  remove                     67.09     14.904
+std::vector          16     100000        -  push_back                   5.84    171.365
+std::vector          16      10000        -  insert_sorted             789.54      1.267
+std::vector          16     100000        -  binary_search             183.21      5.458
+std::unordered_map   16     100000        -  get_or_insert             103.76      9.637
+std::unordered_map   16     100000        -  get                        59.03     16.941
+std::unordered_map   16     100000        -  remove                    105.81      9.451
+cv_key64             64     100000        -  push_back                  18.09     55.266
+cv_key64             64      10000        -  insert_sorted            3680.24      0.272
+cv_key64             64     100000        -  binary_search             279.97      3.572
+cv_key64             64     100000        -  serialize                   8.92    112.080
+cv_key64             64     100000        -  deserialize                 8.76    114.159
+ch_key64_val256      64     100000      256  (skipped: more than 256 items per bucket)
+ch_key64_val65536    64     100000    65536  get_or_insert              98.94     10.107
+ch_key64_val65536    64     100000    65536  get                       147.15      6.796
+ch_key64_val65536    64     100000    65536  serialize                  20.20     49.497
+ch_key64_val65536    64     100000    65536  deserialize                28.84     34.675
+ch_key64_val65536    64     100000    65536  remove                    167.75      5.961
+std::vector          64     100000        -  push_back                  17.43     57.362
+std::vector          64      10000        -  insert_sorted            3830.18      0.261
+std::vector          64     100000        -  binary_search             303.85      3.291
+std::unordered_map   64     100000        -  get_or_insert             168.60      5.931
+std::unordered_map   64     100000        -  get                       154.99      6.452
+std::unordered_map   64     100000        -  remove                    245.93      4.066
+cv_key4               4    1000000        -  push_back                   4.99    200.314
+cv_key4               4      10000        -  insert_sorted             183.29      5.456
+cv_key4               4    1000000        -  binary_search             271.24      3.687
+cv_key4               4    1000000        -  serialize                   2.94    339.925
+cv_key4               4    1000000        -  deserialize                 2.83    353.756
+ch_key4_val256        4    1000000      256  (skipped: more than 256 items per bucket)
+ch_key4_val4096       4    1000000     4096  get_or_insert             129.70      7.710
+ch_key4_val4096       4    1000000     4096  get                       191.62      5.219
+ch_key4_val4096       4    1000000     4096  serialize                   4.05    246.920
+ch_key4_val4096       4    1000000     4096  deserialize                 2.85    351.309
+ch_key4_val4096       4    1000000     4096  remove                    219.75      4.551
+ch_key4_val65536      4    1000000    65536  get_or_insert             103.78      9.636
+ch_key4_val65536      4    1000000    65536  get                       122.94      8.134
+ch_key4_val65536      4    1000000    65536  serialize                  14.17     70.588
+ch_key4_val65536      4    1000000    65536  deserialize                 6.40    156.335
+ch_key4_val65536      4    1000000    65536  remove                    118.53      8.437
+std::vector           4    1000000        -  push_back                   1.74    574.977
+std::vector           4      10000        -  insert_sorted             155.38      6.436
+std::vector           4    1000000        -  binary_search             218.02      4.587
+std::unordered_map    4    1000000        -  get_or_insert             327.88      3.050
+std::unordered_map    4    1000000        -  get                       102.34      9.772
+std::unordered_map    4    1000000        -  remove                    238.08      4.200
+cv_key16             16    1000000        -  push_back                  14.49     69.011
+cv_key16             16      10000        -  insert_sorted             745.57      1.341
+cv_key16             16    1000000        -  binary_search             417.74      2.394
+cv_key16             16    1000000        -  serialize                   9.70    103.141
+cv_key16             16    1000000        -  deserialize                 9.97    100.302
+ch_key16_val256      16    1000000      256  (skipped: more than 256 items per bucket)
+ch_key16_val65536    16    1000000    65536  get_or_insert             146.43      6.829
+ch_key16_val65536    16    1000000    65536  get                       164.26      6.088
+ch_key16_val65536    16    1000000    65536  serialize                  17.47     57.255
+ch_key16_val65536    16    1000000    65536  deserialize                 8.31    120.402
+ch_key16_val65536    16    1000000    65536  remove                    150.73      6.635
+std::vector          16    1000000        -  push_back                   4.64    215.735
+std::vector          16      10000        -  insert_sorted             716.03      1.397
+std::vector          16    1000000        -  binary_search             354.80      2.818
+std::unordered_map   16    1000000        -  get_or_insert             279.52      3.578
+std::unordered_map   16    1000000        -  get                       167.30      5.977
+std::unordered_map   16    1000000        -  remove                    286.80      3.487
+cv_key64             64    1000000        -  push_back                  46.45     21.528
+cv_key64             64      10000        -  insert_sorted            3410.12      0.293
+cv_key64             64    1000000        -  binary_search             491.55      2.034
+cv_key64             64    1000000        -  serialize                  33.22     30.100
+cv_key64             64    1000000        -  deserialize                32.97     30.330
+ch_key64_val256      64    1000000      256  (skipped: more than 256 items per bucket)
+ch_key64_val65536    64    1000000    65536  get_or_insert             352.32      2.838
+ch_key64_val65536    64    1000000    65536  get                       359.79      2.779
+ch_key64_val65536    64    1000000    65536  serialize                  38.42     26.028
+ch_key64_val65536    64    1000000    65536  deserialize                26.10     38.315
+ch_key64_val65536    64    1000000    65536  remove                    363.69      2.750
+std::vector          64    1000000        -  push_back                  42.75     23.394
+std::vector          64      10000        -  insert_sorted            3382.87      0.296
+std::vector          64    1000000        -  binary_search             477.89      2.093
+std::unordered_map   64    1000000        -  get_or_insert             463.66      2.157
+std::unordered_map   64    1000000        -  get                       399.31      2.504
+std::unordered_map   64    1000000        -  remove                    487.09      2.053
+
+policy             container           num_items     ns/op  reallocs  capacity_KB  unused%
+...
+default (NULL)     cv_key16              1000000     10.24        33      16404.2      4.7
+default (NULL)     cvh_serializer_t      1000000      9.74        35      20184.9     22.6
+default (NULL)     ch_key16_val256         65536    102.07      3328       1570.0     18.5
+geometric 2/1      cv_key16              1000000      7.18        21      16384.0      4.6
+geometric 2/1      cvh_serializer_t      1000000      6.15        21      16384.0      4.6
+geometric 2/1      ch_key16_val256         65536    102.59      2435       1935.0     33.9
+fixed_chunk 64KB   cv_key16              1000000     17.94       245      15680.0      0.4
+fixed_chunk 64KB   cvh_serializer_t      1000000     16.33       245      15680.0      0.4
+fixed_chunk 64KB   ch_key16_val256         65536     98.72       512      16385.0     92.2
+page 3/2 4KB       cv_key16              1000000      8.49        21      21576.0     27.6
+page 3/2 4KB       cvh_serializer_t      1000000      6.90        21      21576.0     27.6
+page 3/2 4KB       ch_key16_val256         65536     97.62       768       2045.0     37.4
+page 3/2 2MB       cv_key16              1000000      8.03         5      16384.0      4.6
+page 3/2 2MB       cvh_serializer_t      1000000      6.62         5      16384.0      4.6
+vm (NULL)          cv_key16              1000000      6.28        33      16404.2      4.7
+vm page 3/2 2MB    cv_key16              1000000      5.05         5      16384.0      4.6
+*/
+
+#if (!defined(_WIN32) && !defined(_POSIX_C_SOURCE))
+#   define _POSIX_C_SOURCE 200809L    /* clock_gettime (with -std=c89 or -std=c99) */
+#endif
+#if (defined(__linux__) && !defined(_GNU_SOURCE))
+#   define _GNU_SOURCE  /* mremap(...) for 'cvh_vm_allocator_t' */
+#endif
+#include <stdio.h>  /* printf */
+#include <stdlib.h> /* atol */
+
+#define CH_MAX_NUM_BUCKETS 65536    /* global definition (it should be set in the Project Options): it allows CH_NUM_BUCKETS>256 */
+#include "c_vector.h"   /* 'cvh_serializer_t': it must be included before <c_hashtable.h> to get 'ch_xxx_serialize(...)' and 'ch_xxx_deserialize(...)' */
+
+#ifndef BENCH_MIN_OPS
+#   define BENCH_MIN_OPS 1000000
+#endif
+#ifndef BENCH_MAX_SORTED_INSERTS
+#   define BENCH_MAX_SORTED_INSERTS 10000
+#endif
+#ifndef BENCH_MAX_ITEMS_PER_BUCKET
+#   define BENCH_MAX_ITEMS_PER_BUCKET 256
+#endif
+
+#ifdef _WIN32
+/* <windows.h> is included by <c_hashtable.h> */
+static double bench_seconds(void) {LARGE_INTEGER f,c;QueryPerformanceFrequency(&f);QueryPerformanceCounter(&c);return (double)c.QuadPart/(double)f.QuadPart;}
+#else
+#include <time.h>   /* clock_gettime */
+static double bench_seconds(void) {struct timespec t;clock_gettime(CLOCK_MONOTONIC,&t);return (double)t.tv_sec+(double)t.tv_nsec*1e-9;}
+#endif
+
+static size_t bench_num_runs(size_t num_items) {return num_items>=BENCH_MIN_OPS ? 1 : (BENCH_MIN_OPS+num_items-1)/num_items;}
+static void bench_print(const char* container,size_t key_size,size_t num_items,size_t num_buckets,const char* operation,size_t num_ops,double seconds)  {
+    const double ns = num_ops>0 ? seconds*1e9/(double)num_ops : 0.0;
+    char buckets[32];
+    if (num_buckets>0) sprintf(buckets,"%lu",(unsigned long)num_buckets);
+    else sprintf(buckets,"-");
+    printf("%-18s %4lu %10lu %8s  %-22s %9.2f %10.3f\n",container,(unsigned long)key_size,(unsigned long)num_items,buckets,operation,ns,ns>0.0 ? 1e3/ns : 0.0);
+}
+static void bench_print_skipped(const char* container,size_t key_size,size_t num_items,size_t num_buckets)  {
+    printf("%-18s %4lu %10lu %8lu  (skipped: more than %d items per bucket)\n",container,(unsigned long)key_size,(unsigned long)num_items,(unsigned long)num_buckets,BENCH_MAX_ITEMS_PER_BUCKET);
+}
+
+/* 'order' is a random permutation of [0,num_items): lookups and removals follow it */
+static size_t* bench_create_order(size_t num_items)  {
+    size_t* order = (size_t*) malloc(num_items*sizeof(size_t));
+    size_t i;unsigned seed = 12345;
+    for (i=0;i<num_items;i++) order[i]=i;
+    for (i=num_items;i>1;i--)   {
+        size_t j,tmp;
+        seed = seed*1664525u+1013904223u;j = (size_t)(seed>>8)%i;
+        tmp=order[i-1];order[i-1]=order[j];order[j]=tmp;
+    }
+    return order;
+}
+
+
+/* The key types: 'k[0]' is unique for every key, and keys are created in random sort order */
+typedef struct {unsigned k[1];} key4;
+typedef struct {unsigned k[4];} key16;
+typedef struct {unsigned k[16];} key64;
+
+#define BENCH_KEY_FUNCTIONS(KEY)    \
+static void KEY##_make(KEY* key,size_t i)   {   \
+    const unsigned x = (unsigned)i*2654435761u;size_t j; /* bijective for i<2^32 */    \
+    for (j=0;j<sizeof(KEY)/sizeof(unsigned);j++) key->k[j] = x^(unsigned)j;   \
+}   \
+static int KEY##_cmp(const KEY* a,const KEY* b)   {   \
+    size_t j;   \
+    for (j=0;j<sizeof(KEY)/sizeof(unsigned);j++) {if (a->k[j]!=b->k[j]) return a->k[j]<b->k[j] ? -1 : 1;}  \
+    return 0;   \
+}   \
+static KEY* KEY##_create_keys(size_t num_items)  {   \
+    KEY* keys = (KEY*) malloc(num_items*sizeof(KEY));size_t i;   \
+    for (i=0;i<num_items;i++) KEY##_make(&keys[i],i);   \
+    return keys;    \
+}
+
+BENCH_KEY_FUNCTIONS(key4)
+BENCH_KEY_FUNCTIONS(key16)
+BENCH_KEY_FUNCTIONS(key64)
+
+CV_DECLARE_AND_DEFINE(key4)     /* for 'cv_key4' */
+CV_DECLARE_AND_DEFINE(key16)    /* for 'cv_key16' */
+CV_DECLARE_AND_DEFINE(key64)    /* for 'cv_key64' */
+
+
+/* cv_xxx benchmark: push_back, insert_sorted, binary_search, serialize, deserialize */
+#define BENCH_VECTOR(KEY)   \
+static void bench_cv_##KEY(const KEY* keys,const size_t* order,size_t num_items)  {  \
+    const size_t num_runs = bench_num_runs(num_items);  \
+    const size_t num_sorted_inserts = num_items<BENCH_MAX_SORTED_INSERTS ? num_items : BENCH_MAX_SORTED_INSERTS;   \
+    const size_t num_sorted_runs = bench_num_runs(num_sorted_inserts*100);  /* fewer ops (they are O(n)) */  \
+    cv_##KEY v = cv_##KEY##_create(&KEY##_cmp), v2 = cv_##KEY##_create(&KEY##_cmp);  \
+    cvh_serializer_t s = cvh_serializer_create();   \
+    size_t i,r,num_found=0;double start; \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        cv_##KEY##_free(&v);  /* the vector grows from scratch in every run */   \
+        for (i=0;i<num_items;i++) cv_##KEY##_push_back(&v,&keys[i]);    \
+    }   \
+    bench_print("cv_" #KEY,sizeof(KEY),num_items,0,"push_back",num_runs*num_items,bench_seconds()-start);   \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_sorted_runs;r++)    {   \
+        cv_##KEY##_clear(&v2);  \
+        for (i=0;i<num_sorted_inserts;i++) cv_##KEY##_insert_sorted(&v2,&keys[i],NULL,0);    \
+    }   \
+    bench_print("cv_" #KEY,sizeof(KEY),num_sorted_inserts,0,"insert_sorted",num_sorted_runs*num_sorted_inserts,bench_seconds()-start);   \
+    \
+    cv_##KEY##_sort(&v);    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        for (i=0;i<num_items;i++) {int match;cv_##KEY##_binary_search(&v,&keys[order[i]],&match);num_found+=(size_t)match;}    \
+    }   \
+    bench_print("cv_" #KEY,sizeof(KEY),num_items,0,"binary_search",num_runs*num_items,bench_seconds()-start);   \
+    if (num_found!=num_runs*num_items) printf("ERROR: %lu/%lu keys found.\n",(unsigned long)num_found,(unsigned long)(num_runs*num_items)); \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {cvh_serializer_clear(&s);cv_##KEY##_serialize(&v,&s);}    \
+    bench_print("cv_" #KEY,sizeof(KEY),num_items,0,"serialize",num_runs*num_items,bench_seconds()-start);   \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {cvh_serializer_offset_rewind(&s);cv_##KEY##_deserialize(&v2,&s);}    \
+    bench_print("cv_" #KEY,sizeof(KEY),num_items,0,"deserialize",num_runs*num_items,bench_seconds()-start);   \
+    if (v2.size!=v.size) printf("ERROR: %lu/%lu items deserialized.\n",(unsigned long)v2.size,(unsigned long)v.size); \
+    \
+    cvh_serializer_free(&s);    \
+    cv_##KEY##_free(&v2);   \
+    cv_##KEY##_free(&v);    \
+}
+
+BENCH_VECTOR(key4)
+BENCH_VECTOR(key16)
+BENCH_VECTOR(key64)
+
+
+/* The hashtable types: we need a different value type name for every CH_NUM_BUCKETS (the value is an unsigned in every case) */
+typedef unsigned val256;
+typedef unsigned val4096;
+typedef unsigned val65536;
+
+#ifndef C_HASHTABLE_key4_val256_H
+#define C_HASHTABLE_key4_val256_H
+#   define CH_KEY_TYPE key4
+#   define CH_VALUE_TYPE val256
+#   define CH_NUM_BUCKETS 256
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key4_val256_H */
+#ifndef C_HASHTABLE_key4_val4096_H
+#define C_HASHTABLE_key4_val4096_H
+#   define CH_KEY_TYPE key4
+#   define CH_VALUE_TYPE val4096
+#   define CH_NUM_BUCKETS 4096
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key4_val4096_H */
+#ifndef C_HASHTABLE_key4_val65536_H
+#define C_HASHTABLE_key4_val65536_H
+#   define CH_KEY_TYPE key4
+#   define CH_VALUE_TYPE val65536
+#   define CH_NUM_BUCKETS 65536
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key4_val65536_H */
+#ifndef C_HASHTABLE_key16_val256_H
+#define C_HASHTABLE_key16_val256_H
+#   define CH_KEY_TYPE key16
+#   define CH_VALUE_TYPE val256
+#   define CH_NUM_BUCKETS 256
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key16_val256_H */
+#ifndef C_HASHTABLE_key16_val65536_H
+#define C_HASHTABLE_key16_val65536_H
+#   define CH_KEY_TYPE key16
+#   define CH_VALUE_TYPE val65536
+#   define CH_NUM_BUCKETS 65536
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key16_val65536_H */
+#ifndef C_HASHTABLE_key64_val256_H
+#define C_HASHTABLE_key64_val256_H
+#   define CH_KEY_TYPE key64
+#   define CH_VALUE_TYPE val256
+#   define CH_NUM_BUCKETS 256
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key64_val256_H */
+#ifndef C_HASHTABLE_key64_val65536_H
+#define C_HASHTABLE_key64_val65536_H
+#   define CH_KEY_TYPE key64
+#   define CH_VALUE_TYPE val65536
+#   define CH_NUM_BUCKETS 65536
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_key64_val65536_H */
+
+
+/* ch_xxx benchmark: get_or_insert, get, remove, serialize, deserialize */
+#define BENCH_HASHTABLE(KEY,VALUE,NUM_BUCKETS)   \
+static ch_hash_uint KEY##_##VALUE##_hash(const KEY* k) {return (ch_hash_uint)(ch_hash32_murmur3((const unsigned char*)k,sizeof(KEY),7)%(NUM_BUCKETS));}  \
+static void bench_ch_##KEY##_##VALUE(const KEY* keys,const size_t* order,size_t num_items)  {  \
+    const size_t num_runs = bench_num_runs(num_items);  \
+    ch_##KEY##_##VALUE ht,ht2;  \
+    cvh_serializer_t s; \
+    size_t i,r,num_found=0;int ok=1;double start; \
+    if (num_items/(NUM_BUCKETS)>BENCH_MAX_ITEMS_PER_BUCKET) {bench_print_skipped("ch_" #KEY "_" #VALUE,sizeof(KEY),num_items,NUM_BUCKETS);return;}   \
+    cvh_serializer_init(&s);   \
+    ch_##KEY##_##VALUE##_create(&ht,&KEY##_##VALUE##_hash,&KEY##_cmp,1);   \
+    ch_##KEY##_##VALUE##_create(&ht2,&KEY##_##VALUE##_hash,&KEY##_cmp,1);  \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        ch_##KEY##_##VALUE##_clear(&ht);    \
+        for (i=0;i<num_items;i++) *ch_##KEY##_##VALUE##_get_or_insert(&ht,&keys[i],NULL) = (VALUE)i;   \
+    }   \
+    bench_print("ch_" #KEY "_" #VALUE,sizeof(KEY),num_items,NUM_BUCKETS,"get_or_insert",num_runs*num_items,bench_seconds()-start);  \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        for (i=0;i<num_items;i++) {if (ch_##KEY##_##VALUE##_get(&ht,&keys[order[i]])) ++num_found;}  \
+    }   \
+    bench_print("ch_" #KEY "_" #VALUE,sizeof(KEY),num_items,NUM_BUCKETS,"get",num_runs*num_items,bench_seconds()-start);  \
+    if (num_found!=num_runs*num_items) printf("ERROR: %lu/%lu keys found.\n",(unsigned long)num_found,(unsigned long)(num_runs*num_items)); \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {cvh_serializer_clear(&s);ch_##KEY##_##VALUE##_serialize(&ht,&s,NULL,NULL);}    \
+    bench_print("ch_" #KEY "_" #VALUE,sizeof(KEY),num_items,NUM_BUCKETS,"serialize",num_runs*num_items,bench_seconds()-start);  \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {cvh_serializer_offset_rewind(&s);ok &= ch_##KEY##_##VALUE##_deserialize(&ht2,&s,NULL,NULL);}    \
+    bench_print("ch_" #KEY "_" #VALUE,sizeof(KEY),num_items,NUM_BUCKETS,"deserialize",num_runs*num_items,bench_seconds()-start);  \
+    if (!ok || ch_##KEY##_##VALUE##_get_num_items(&ht2)!=num_items) printf("ERROR: %lu/%lu items deserialized.\n",(unsigned long)ch_##KEY##_##VALUE##_get_num_items(&ht2),(unsigned long)num_items); \
+    \
+    /* 'remove' can't be repeated: short runs are timed one by one (tables are refilled from 'ht' between them) */   \
+    start = 0.0;    \
+    for (r=0;r<num_runs;r++)    {   \
+        double run_start;   \
+        ch_##KEY##_##VALUE##_cpy(&ht2,&ht); \
+        run_start = bench_seconds();    \
+        for (i=0;i<num_items;i++) {if (!ch_##KEY##_##VALUE##_remove(&ht2,&keys[order[i]])) ok=0;}   \
+        start += bench_seconds()-run_start; \
+    }   \
+    bench_print("ch_" #KEY "_" #VALUE,sizeof(KEY),num_items,NUM_BUCKETS,"remove",num_runs*num_items,start);  \
+    if (!ok || ch_##KEY##_##VALUE##_get_num_items(&ht2)!=0) printf("ERROR: %lu items not removed.\n",(unsigned long)ch_##KEY##_##VALUE##_get_num_items(&ht2)); \
+    \
+    cvh_serializer_free(&s);    \
+    ch_##KEY##_##VALUE##_free(&ht2);    \
+    ch_##KEY##_##VALUE##_free(&ht); \
+}
+
+BENCH_HASHTABLE(key4,val256,256)
+BENCH_HASHTABLE(key4,val4096,4096)
+BENCH_HASHTABLE(key4,val65536,65536)
+BENCH_HASHTABLE(key16,val256,256)
+BENCH_HASHTABLE(key16,val65536,65536)
+BENCH_HASHTABLE(key64,val256,256)
+BENCH_HASHTABLE(key64,val65536,65536)
+
+
+/* growth policy benchmark: reallocations are counted in a separate (untimed) run, by watching the capacity (of the bucket that received the key, for hashtables) */
+static void bench_print_growth(const char* policy,const char* container,size_t num_items,size_t num_ops,double seconds,size_t num_reallocs,size_t capacity_bytes,size_t used_bytes)  {
+    const double ns = num_ops>0 ? seconds*1e9/(double)num_ops : 0.0;
+    printf("%-18s %-18s %10lu %9.2f %9lu %12.1f %8.1f\n",policy,container,(unsigned long)num_items,ns,(unsigned long)num_reallocs,(double)capacity_bytes/1024.0,capacity_bytes>0 ? (double)(capacity_bytes-used_bytes)*100.0/(double)capacity_bytes : 0.0);
+}
+static void bench_growth_policy(const char* name,const cvh_growth_policy_t* policy,const key16* keys,size_t num_items)  {
+    const size_t num_runs = bench_num_runs(num_items);
+    cv_key16 v = cv_key16_create(&key16_cmp);
+    cvh_serializer_t s = cvh_serializer_create();
+    size_t i,r,num_reallocs,last_capacity;double seconds;
+    cv_key16_set_growth_policy(&v,policy);
+    cvh_serializer_set_growth_policy(&s,policy);
+
+    seconds = bench_seconds();
+    for (r=0;r<num_runs;r++)    {
+        cv_key16_free(&v);  /* the vector grows from scratch in every run */
+        for (i=0;i<num_items;i++) cv_key16_push_back(&v,&keys[i]);
+    }
+    seconds = bench_seconds()-seconds;
+    cv_key16_free(&v);num_reallocs=last_capacity=0;
+    for (i=0;i<num_items;i++) {cv_key16_push_back(&v,&keys[i]);if (v.capacity!=last_capacity) {++num_reallocs;last_capacity=v.capacity;}}
+    bench_print_growth(name,"cv_key16",num_items,num_runs*num_items,seconds,num_reallocs,v.capacity*sizeof(key16),v.size*sizeof(key16));
+
+    seconds = bench_seconds();
+    for (r=0;r<num_runs;r++)    {
+        cvh_serializer_free(&s);    /* the serializer grows from scratch in every run */
+        for (i=0;i<num_items;i++) cvh_serializer_write_bytes(&s,&keys[i],sizeof(key16));
+    }
+    seconds = bench_seconds()-seconds;
+    cvh_serializer_free(&s);num_reallocs=last_capacity=0;
+    for (i=0;i<num_items;i++) {cvh_serializer_write_bytes(&s,&keys[i],sizeof(key16));if (s.capacity!=last_capacity) {++num_reallocs;last_capacity=s.capacity;}}
+    bench_print_growth(name,"cvh_serializer_t",num_items,num_runs*num_items,seconds,num_reallocs,s.capacity,s.size);
+
+    if (!policy || policy->type==CVH_GROWTH_GEOMETRIC || policy->chunk_bytes<=65536) {
+        const size_t num_ht_items = num_items<256*BENCH_MAX_ITEMS_PER_BUCKET ? num_items : 256*BENCH_MAX_ITEMS_PER_BUCKET;
+        const size_t num_ht_runs = bench_num_runs(num_ht_items);
+        size_t last_capacities[256],capacity_bytes=0;
+        ch_key16_val256 ht;
+        ch_key16_val256_create(&ht,&key16_val256_hash,&key16_cmp,1);
+        ch_key16_val256_set_growth_policy(&ht,policy);
+        seconds = bench_seconds();
+        for (r=0;r<num_ht_runs;r++)    {
+            ch_key16_val256_free(&ht);  /* the buckets grow from scratch in every run */
+            for (i=0;i<num_ht_items;i++) *ch_key16_val256_get_or_insert(&ht,&keys[i],NULL) = (val256)i;
+        }
+        seconds = bench_seconds()-seconds;
+        ch_key16_val256_free(&ht);num_reallocs=0;
+        for (i=0;i<256;i++) last_capacities[i]=0;
+        for (i=0;i<num_ht_items;i++) {
+            const size_t b = (size_t)key16_val256_hash(&keys[i]);
+            *ch_key16_val256_get_or_insert(&ht,&keys[i],NULL) = (val256)i;
+            if (ht.buckets[b].capacity!=last_capacities[b]) {++num_reallocs;last_capacities[b]=ht.buckets[b].capacity;}
+        }
+        for (i=0;i<256;i++) capacity_bytes+=ht.buckets[i].capacity*sizeof(ht.buckets[i].v[0]);
+        bench_print_growth(name,"ch_key16_val256",num_ht_items,num_ht_runs*num_ht_items,seconds,num_reallocs,capacity_bytes,num_ht_items*sizeof(ht.buckets[0].v[0]));
+        ch_key16_val256_free(&ht);
+    }
+
+    cvh_serializer_free(&s);
+    cv_key16_free(&v);
+}
+static void bench_vm_allocator(const char* name,const cvh_growth_policy_t* policy,const key16* keys,size_t num_items)  {
+    const size_t num_runs = bench_num_runs(num_items);
+    cvh_vm_allocator_t vm_allocator;
+    cv_key16 v;
+    size_t i,r,num_reallocs=0,last_capacity=0;double seconds;
+    cvh_vm_allocator_init(&vm_allocator,1);
+    cv_key16_init_with_allocator(&v,&key16_cmp,NULL,NULL,NULL,NULL,NULL,&vm_allocator.allocator);
+    cv_key16_set_growth_policy(&v,policy);
+    seconds = bench_seconds();
+    for (r=0;r<num_runs;r++)    {
+        cv_key16_free(&v);
+        for (i=0;i<num_items;i++) cv_key16_push_back(&v,&keys[i]);
+    }
+    seconds = bench_seconds()-seconds;
+    cv_key16_free(&v);
+    for (i=0;i<num_items;i++) {cv_key16_push_back(&v,&keys[i]);if (v.capacity!=last_capacity) {++num_reallocs;last_capacity=v.capacity;}}
+    bench_print_growth(name,"cv_key16",num_items,num_runs*num_items,seconds,num_reallocs,v.capacity*sizeof(key16),v.size*sizeof(key16));
+    cv_key16_free(&v);
+    cvh_vm_allocator_close(&vm_allocator);
+}
+
+
+#ifdef __cplusplus
+/* The same operations with std::vector and std::unordered_map ('insert_sorted' is std::lower_bound(...) plus insert(...)) */
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#define BENCH_STD(KEY)  \
+struct KEY##_less {bool operator()(const KEY& a,const KEY& b) const {return KEY##_cmp(&a,&b)<0;}}; \
+struct KEY##_equal {bool operator()(const KEY& a,const KEY& b) const {return KEY##_cmp(&a,&b)==0;}};    \
+struct KEY##_hasher {size_t operator()(const KEY& k) const {return (size_t)ch_hash32_murmur3((const unsigned char*)&k,sizeof(KEY),7);}};  \
+static void bench_std_##KEY(const KEY* keys,const size_t* order,size_t num_items)  {  \
+    const size_t num_runs = bench_num_runs(num_items);  \
+    const size_t num_sorted_inserts = num_items<BENCH_MAX_SORTED_INSERTS ? num_items : BENCH_MAX_SORTED_INSERTS;   \
+    const size_t num_sorted_runs = bench_num_runs(num_sorted_inserts*100);  /* fewer ops (they are O(n)) */  \
+    std::vector<KEY> v,v2;  \
+    std::unordered_map<KEY,unsigned,KEY##_hasher,KEY##_equal> ht,ht2;   \
+    size_t i,r,num_found=0;double start;   \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        std::vector<KEY>().swap(v);  /* the vector grows from scratch in every run */   \
+        for (i=0;i<num_items;i++) v.push_back(keys[i]); \
+    }   \
+    bench_print("std::vector",sizeof(KEY),num_items,0,"push_back",num_runs*num_items,bench_seconds()-start);   \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_sorted_runs;r++)    {   \
+        v2.clear(); \
+        for (i=0;i<num_sorted_inserts;i++) v2.insert(std::lower_bound(v2.begin(),v2.end(),keys[i],KEY##_less()),keys[i]);   \
+    }   \
+    bench_print("std::vector",sizeof(KEY),num_sorted_inserts,0,"insert_sorted",num_sorted_runs*num_sorted_inserts,bench_seconds()-start);   \
+    \
+    std::sort(v.begin(),v.end(),KEY##_less());  \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        for (i=0;i<num_items;i++) {if (std::binary_search(v.begin(),v.end(),keys[order[i]],KEY##_less())) ++num_found;}    \
+    }   \
+    bench_print("std::vector",sizeof(KEY),num_items,0,"binary_search",num_runs*num_items,bench_seconds()-start);   \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        ht.clear(); \
+        for (i=0;i<num_items;i++) ht[keys[i]] = (unsigned)i;    \
+    }   \
+    bench_print("std::unordered_map",sizeof(KEY),num_items,0,"get_or_insert",num_runs*num_items,bench_seconds()-start);  \
+    \
+    start = bench_seconds();    \
+    for (r=0;r<num_runs;r++)    {   \
+        for (i=0;i<num_items;i++) {if (ht.find(keys[order[i]])!=ht.end()) ++num_found;}  \
+    }   \
+    bench_print("std::unordered_map",sizeof(KEY),num_items,0,"get",num_runs*num_items,bench_seconds()-start);  \
+    \
+    start = 0.0;    \
+    for (r=0;r<num_runs;r++)    {   \
+        double run_start;   \
+        ht2 = ht;   \
+        run_start = bench_seconds();    \
+        for (i=0;i<num_items;i++) ht2.erase(keys[order[i]]);    \
+        start += bench_seconds()-run_start; \
+    }   \
+    bench_print("std::unordered_map",sizeof(KEY),num_items,0,"remove",num_runs*num_items,start);  \
+    if (num_found!=2*num_runs*num_items || !ht2.empty()) printf("ERROR: std containers.\n");    \
+}
+
+BENCH_STD(key4)
+BENCH_STD(key16)
+BENCH_STD(key64)
+#endif /* __cplusplus */
+
+
+int main(int argc,char* argv[])
+{
+    const size_t all_num_items[3] = {1000,100000,1000000};
+    const size_t max_num_items = argc>1 ? (size_t)atol(argv[1]) : 1000000;
+    size_t n;
+
+    printf("%-18s %4s %10s %8s  %-22s %9s %10s\n","container","key","num_items","buckets","operation","ns/op","Mops/s");
+    for (n=0;n<3;n++)   {
+        const size_t num_items = all_num_items[n]<max_num_items ? all_num_items[n] : max_num_items;
+        size_t* order;
+        if (num_items==0 || (n>0 && all_num_items[n-1]>=max_num_items)) break;
+        order = bench_create_order(num_items);
+        {
+            key4* keys = key4_create_keys(num_items);
+            bench_cv_key4(keys,order,num_items);
+            bench_ch_key4_val256(keys,order,num_items);
+            bench_ch_key4_val4096(keys,order,num_items);
+            bench_ch_key4_val65536(keys,order,num_items);
+#           ifdef __cplusplus
+            bench_std_key4(keys,order,num_items);
+#           endif
+            free(keys);
+        }
+        {
+            key16* keys = key16_create_keys(num_items);
+            bench_cv_key16(keys,order,num_items);
+            bench_ch_key16_val256(keys,order,num_items);
+            bench_ch_key16_val65536(keys,order,num_items);
+#           ifdef __cplusplus
+            bench_std_key16(keys,order,num_items);
+#           endif
+            free(keys);
+        }
+        {
+            key64* keys = key64_create_keys(num_items);
+            bench_cv_key64(keys,order,num_items);
+            bench_ch_key64_val256(keys,order,num_items);
+            bench_ch_key64_val65536(keys,order,num_items);
+#           ifdef __cplusplus
+            bench_std_key64(keys,order,num_items);
+#           endif
+            free(keys);
+        }
+        free(order);
+    }
+
+    {
+        const cvh_growth_policy_t geometric = cvh_growth_policy_geometric(2,1);
+        const cvh_growth_policy_t fixed_chunk = cvh_growth_policy_fixed_chunk(65536);
+        const cvh_growth_policy_t page_aligned = cvh_growth_policy_page_aligned(3,2,4096);
+        const cvh_growth_policy_t huge_page_aligned = cvh_growth_policy_page_aligned(3,2,2*1024*1024);
+        printf("\n%-18s %-18s %10s %9s %9s %12s %8s\n","policy","container","num_items","ns/op","reallocs","capacity_KB","unused%");
+        for (n=0;n<3;n++)   {
+            const size_t num_items = all_num_items[n]<max_num_items ? all_num_items[n] : max_num_items;
+            key16* keys;
+            if (num_items==0 || (n>0 && all_num_items[n-1]>=max_num_items)) break;
+            keys = key16_create_keys(num_items);
+            bench_growth_policy("default (NULL)",NULL,keys,num_items);
+            bench_growth_policy("geometric 2/1",&geometric,keys,num_items);
+            bench_growth_policy("fixed_chunk 64KB",&fixed_chunk,keys,num_items);
+            bench_growth_policy("page 3/2 4KB",&page_aligned,keys,num_items);
+            bench_growth_policy("page 3/2 2MB",&huge_page_aligned,keys,num_items);
+            bench_vm_allocator("vm (NULL)",NULL,keys,num_items);
+            bench_vm_allocator("vm page 3/2 2MB",&huge_page_aligned,keys,num_items);
+            free(keys);
+        }
+    }
+
+    return 0;
+}
@@ -39,10 +39,10 @@ All items (generally unsorted):
 1) ht[	100,	50,	25]	=	["100-50-25"].
 [ch_mykey_myvalue_dbg_check]:
     num_total_items=2 (num_total_capacity=3) in 256 buckets [items per bucket: mean=0.008 std_deviation=0.088 min=0 (in 254/256) avg=0 (in 254/256) max=1 (in 2/256)].
-    memory_used: 6 KB 324 Bytes. memory_minimal_possible: 6 KB 280 Bytes. mem_used_percentage: 100.68% (100% is the best possible result).
+    memory_used: 6 KB 340 Bytes. memory_minimal_possible: 6 KB 296 Bytes. mem_used_percentage: 100.68% (100% is the best possible result).
 [ch_mykey_myvalue_dbg_check]:
     num_total_items=2 (num_total_capacity=2) in 256 buckets [items per bucket: mean=0.008 std_deviation=0.088 min=0 (in 254/256) avg=0 (in 254/256) max=1 (in 2/256)].
-    memory_used: 6 KB 280 Bytes. memory_minimal_possible: 6 KB 280 Bytes. mem_used_percentage: 100.00% (100% is the best possible result).
+    memory_used: 6 KB 296 Bytes. memory_minimal_possible: 6 KB 296 Bytes. mem_used_percentage: 100.00% (100% is the best possible result).
 
 STRING-STRING TEST:
 All items (generally unsorted):
@@ -53,7 +53,7 @@ All items (generally unsorted):
 4) ht["very famous nickname"] = ["Super Johnny"];
 [ch_string_string_dbg_check]:
     num_total_items=5 (num_total_capacity=5) in 256 buckets [items per bucket: mean=0.020 std_deviation=0.139 min=0 (in 251/256) avg=0 (in 251/256) max=1 (in 5/256)].
-    memory_used: 6 KB 272 Bytes. memory_minimal_possible: 6 KB 272 Bytes. mem_used_percentage: 100.00% (100% is the best possible result).
+    memory_used: 6 KB 288 Bytes. memory_minimal_possible: 6 KB 288 Bytes. mem_used_percentage: 100.00% (100% is the best possible result).
 Removed item with key "gender".
 All items (generally unsorted):
 0) ht["name"] = ["John"];
@@ -61,13 +61,97 @@ All items (generally unsorted):
 2) ht["profession"] = ["plumber"];
 3) ht["very famous nickname"] = ["Super Johnny"];
 Fetched item ht["name"]=["John"].
+
+DYNAMIC BUCKETS TEST:
+Inserted 100000 items: num_items=100000 num_buckets=65536.
+Removed odd keys: num_items=50000 (errors=0).
+[ch_uint_uint_dbg_check]:
+    num_total_items=50000 (num_total_capacity=110587) in 65536 buckets [items per bucket: mean=0.763 std_deviation=0.873 min=0 (in 30570/65536) avg=1 (in 23268/65536) max=7 (in 3/65536)].
+    memory_used: 2 MB 352 KB 224 Bytes. memory_minimal_possible: 1 MB 902 KB 904 Bytes. mem_used_percentage: 124.56% (100% is the best possible result).
+
+OPEN ADDRESSING TEST:
+Inserted 100000 items: num_items=100000 capacity=131072.
+Removed 99990 items: num_items=10 (errors=0).
+After shrink_to_fit: capacity=16 used_slots=10.
+[ch_uint_double_dbg_check]:
+    num_total_items=10 in 16 slots [load_factor=0.625 deleted_slots=0 growth_left=4] [groups probed per item: mean=1.000 max=1].
+    memory_used: 528 Bytes. memory_minimal_possible: 426 Bytes. mem_used_percentage: 123.94% (100% is the best possible result).
+
+CACHED HASHES TEST:
+Inserted 20000 items (78 items per bucket): string_cmp calls per insertion: 0.000.
+Fetched 20000 items (errors=0): string_cmp calls per lookup: 1.000.
+Removed even keys: num_items=10000 (errors=0).
+[ch_string_int_dbg_check]:
+    num_total_items=10000 (num_total_capacity=23961) in 256 buckets [items per bucket: mean=39.062 std_deviation=6.020 min=18 (in 1/256) avg=39 (in 18/256) max=55 (in 1/256)].
+    memory_used: 567 KB 808 Bytes. memory_minimal_possible: 240 KB 592 Bytes. mem_used_percentage: 236.01% (100% is the best possible result).
+
+BATCH TEST:
+Inserted 1000000 items.
+ch_uint_uint_get(...):       found 333332/1000000 keys in 0.113 s.
+ch_uint_uint_get_batch(...): found 333332/1000000 keys in 0.062 s.
+errors=0.
+
+BUCKET SLABS TEST:
+with slabs:    inserted 1000000 items in 0.215 s (RSS grew by 12 MB).
+without slabs: inserted 1000000 items in 0.347 s (RSS grew by 24 MB 356 KB).
+Removed odd keys: num_items=500000 (errors=0).
+[ch_suint_uint_dbg_check]:
+    num_total_items=500000 (num_total_capacity=1300228) in 524288 buckets [items per bucket: mean=0.954 std_deviation=0.975 min=0 (in 201907/524288) avg=1 (in 192597/524288) max=9 (in 1/524288)].
+    bucket slabs: 164 pages of 64 KB (10 MB 256 KB).
+    memory_used: 21 MB 942 KB 584 Bytes. memory_minimal_possible: 15 MB 834 KB 808 Bytes. mem_used_percentage: 138.60% (100% is the best possible result).
+
+SNAPSHOT TEST:
+ch_uint_uint: 1000000 items -> 12194328 bytes, deserialized in 0.038 s (ok=1).
+ch_uint_uint: 1000000 items re-inserted in 0.111 s.
+ch_string_string: 1000 items -> 15852 bytes (ok=1).
+errors=0.
+
+BUILD FROM TEST:
+ch_uint_uint_build_from(...):    723877 items in 0.083 s.
+ch_uint_uint_get_or_insert(...): 723877 items in 0.209 s.
+ch_string_string: 2 items (one=eins two=due).
+errors=0.
+
+STATS TEST:
+bad hash:  insert: lookups=20000 inserts=20000 key_cmps/lookup=8.92 reallocs=272 bytes_moved=49154808.
+bad hash:  get:    lookups=40000 hits=20000 misses=20000 key_cmps/lookup=10.19.
+bad hash:  remove: lookups=10000 removes=10000 key_cmps/lookup=8.38 bytes_moved=49960000 (errors=0).
+good hash: insert: lookups=20000 inserts=20000 key_cmps/lookup=4.97 reallocs=2571 bytes_moved=3133368.
+good hash: get:    lookups=40000 hits=20000 misses=20000 key_cmps/lookup=6.21.
+good hash: remove: lookups=10000 removes=10000 key_cmps/lookup=5.04 bytes_moved=3134528 (errors=0).
+
+STRIPED LOCKS TEST:
+global lock:   4 threads x 1000000 ops in 0.411 s (increments=399479 sum_of_counters=399479).
+striped locks: 4 threads x 1000000 ops in 0.386 s (increments=399479 sum_of_counters=399479).
+
+RCU READS TEST:
+striped locks: 4 threads x 1000000 ops in 0.331 s (found=1983398 errors=0).
+rcu reads:     4 threads x 1000000 ops in 0.419 s (found=1983217 errors=0).
+[Timings depend on the machine (and the number of its cores), and the RSS values on the memory released by the previous tests]
 */
 
+#if (!defined(_WIN32) && !defined(_POSIX_C_SOURCE))
+#   define _POSIX_C_SOURCE 200809L    /* clock_gettime (with -std=c89 or -std=c99): STRIPED LOCKS and RCU READS tests */
+#endif
 #include <stdio.h>  /* printf */
 
 /*#define NO_SIMPLE_TEST*/
 /*#define NO_STRING_STRING_TEST*/
 /*#define NO_CPP_TEST*/
+/*#define NO_DYNAMIC_BUCKETS_TEST*/
+/*#define NO_OPEN_ADDRESSING_TEST*/
+/*#define NO_CACHED_HASHES_TEST*/
+/*#define NO_BATCH_TEST*/
+/*#define NO_BUCKET_SLABS_TEST*/
+/*#define NO_STRIPED_LOCKS_TEST*/  /* it uses threads: with glibc<2.34 please compile with -pthread */
+/*#define NO_RCU_READS_TEST*/       /* it needs the STRIPED LOCKS TEST */
+/*#define NO_SNAPSHOT_TEST*/
+/*#define NO_BUILD_FROM_TEST*/
+/*#define NO_STATS_TEST*/
+
+#ifndef NO_SNAPSHOT_TEST
+#   include "c_vector.h"   /* 'cvh_serializer_t': it must be included before <c_hashtable.h> to get 'ch_xxx_serialize(...)' and 'ch_xxx_deserialize(...)' */
+#endif
 
 #ifndef NO_SIMPLE_TEST
 /* 'typedef is mandatory: we need global visibility */
@@ -363,6 +447,577 @@ static void StringStringTest(void)  {
 }
 #endif /* NO_STRING_STRING_TEST */
 
+#ifndef NO_DYNAMIC_BUCKETS_TEST
+typedef unsigned uint;
+#ifndef C_HASHTABLE_uint_uint_H
+#define C_HASHTABLE_uint_uint_H
+#   define CH_KEY_TYPE uint
+#   define CH_VALUE_TYPE uint
+#   define CH_USE_DYNAMIC_BUCKETS   /* scoped definition: 'buckets' is heap-allocated and grows */
+#   define CH_NUM_BUCKETS 16        /* initial number of buckets (must be a power of two) */
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_uint_uint_H */
+static int uint_cmp(const uint* a,const uint* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+static __inline size_t uint_hash(const uint* k) {
+    /* with CH_USE_DYNAMIC_BUCKETS 'key_hash' returns a full-width hash value,
+       and its low bits are used to select the bucket */
+    return (size_t) ch_hash32_murmur3((const unsigned char*)k,sizeof(uint),7);
+}
+static void DynamicBucketsTest(void)    {
+    ch_uint_uint ht;
+    const uint num_items = 100000;
+    uint i,num_errors=0;
+
+    printf("\nDYNAMIC BUCKETS TEST:\n");
+    ch_uint_uint_create(&ht,&uint_hash,&uint_cmp,1);
+
+    /* the bucket array grows (incrementally) while we insert items */
+    for (i=0;i<num_items;i++) *ch_uint_uint_get_or_insert(&ht,&i,NULL) = i*2;
+    printf("Inserted %u items: num_items=%lu num_buckets=%lu.\n",num_items,ch_uint_uint_get_num_items(&ht),ht.num_buckets);
+
+    /* remove odd keys */
+    for (i=1;i<num_items;i+=2) {if (!ch_uint_uint_remove(&ht,&i)) ++num_errors;}
+    for (i=0;i<num_items;i++)   {
+        const uint* value = ch_uint_uint_get_const(&ht,&i);
+        if ((i%2==0 && (!value || *value!=i*2)) || (i%2==1 && value)) ++num_errors;
+    }
+    printf("Removed odd keys: num_items=%lu (errors=%u).\n",ch_uint_uint_get_num_items(&ht),num_errors);
+
+    /* completes the pending rehashing (if any): only after this call we can iterate 'ht.buckets' directly */
+    ch_uint_uint_rehash(&ht,0);
+    ch_uint_uint_dbg_check(&ht);
+
+    ch_uint_uint_free(&ht);
+}
+#endif /* NO_DYNAMIC_BUCKETS_TEST */
+
+#ifndef NO_OPEN_ADDRESSING_TEST
+#ifdef NO_DYNAMIC_BUCKETS_TEST
+typedef unsigned uint;
+#endif
+#ifndef C_HASHTABLE_uint_double_H
+#define C_HASHTABLE_uint_double_H
+#   define CH_KEY_TYPE uint
+#   define CH_VALUE_TYPE double
+#   define CH_USE_OPEN_ADDRESSING   /* scoped definition: flat table with control bytes (no buckets) */
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_uint_double_H */
+static __inline size_t uint_hash_oa(const uint* k) {
+    /* with CH_USE_OPEN_ADDRESSING all the bits of 'key_hash' are used */
+    return (size_t) ch_hash32_murmur3((const unsigned char*)k,sizeof(uint),7);
+}
+static void OpenAddressingTest(void)    {
+    ch_uint_double ht;
+    const uint num_items = 100000;
+    uint i,num_errors=0;size_t j,k;
+
+    printf("\nOPEN ADDRESSING TEST:\n");
+    ch_uint_double_create(&ht,&uint_hash_oa,NULL,16);  /* key_cmp==NULL: keys are compared with memcmp */
+
+    for (i=0;i<num_items;i++) *ch_uint_double_get_or_insert(&ht,&i,NULL) = (double)i*0.5;
+    printf("Inserted %u items: num_items=%lu capacity=%lu.\n",num_items,ch_uint_double_get_num_items(&ht),ht.capacity);
+
+    /* remove all keys but the first ten */
+    for (i=10;i<num_items;i++) {if (!ch_uint_double_remove(&ht,&i)) ++num_errors;}
+    for (i=0;i<num_items;i++)   {
+        const double* value = ch_uint_double_get_const(&ht,&i);
+        if ((i<10 && (!value || *value!=(double)i*0.5)) || (i>=10 && value)) ++num_errors;
+    }
+    printf("Removed %u items: num_items=%lu (errors=%u).\n",num_items-10,ch_uint_double_get_num_items(&ht),num_errors);
+
+    ch_uint_double_shrink_to_fit(&ht);
+    /* used slots are the ones with 'ctrl[j]<0x80' (slot order is random) */
+    k=0;for (j=0;j<ht.capacity;j++) {if (ht.ctrl[j]<0x80) ++k;}
+    printf("After shrink_to_fit: capacity=%lu used_slots=%lu.\n",ht.capacity,k);
+    ch_uint_double_dbg_check(&ht);
+
+    ch_uint_double_free(&ht);
+}
+#endif /* NO_OPEN_ADDRESSING_TEST */
+
+#ifndef NO_CACHED_HASHES_TEST
+#ifdef NO_STRING_STRING_TEST
+#   define NO_CACHED_HASHES_TEST    /* it uses the 'string' helpers of the STRING-STRING TEST */
+#else
+#ifndef C_HASHTABLE_string_int_H
+#define C_HASHTABLE_string_int_H
+#   define CH_KEY_TYPE string
+#   define CH_VALUE_TYPE int
+#   define CH_USE_CACHED_HASHES     /* scoped definition: items store their hash, and buckets are sorted by (hash,key) */
+#   define CH_NUM_BUCKETS_string_int 256
+#   define CH_NUM_BUCKETS CH_NUM_BUCKETS_string_int
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_string_int_H */
+static size_t num_string_cmp_calls = 0;
+static int string_cmp_counted(const string* a,const string* b) {++num_string_cmp_calls;return string_cmp(a,b);}
+static __inline size_t string_hash_cached(const string* k) {
+    /* with CH_USE_CACHED_HASHES 'key_hash' returns a full-width hash value (no mod CH_NUM_BUCKETS) */
+    return (size_t) ((*k) ? ch_hash32_murmur3_str(*k,7) : 0);
+}
+static void CachedHashesTest(void)    {
+    ch_string_int ht;
+    const int num_items = 20000;
+    int i,num_errors=0;
+    string key = NULL;
+    char tmp[32];
+
+    printf("\nCACHED HASHES TEST:\n");
+    ch_string_int_create_with(&ht,&string_hash_cached,&string_cmp_counted,
+                              &string_ctr,&string_dtr,&string_cpy,  /* key */
+                              NULL,NULL,NULL,                       /* value */
+                              4);
+
+    for (i=0;i<num_items;i++)   {sprintf(tmp,"key_%d",i);*ch_string_int_get_or_insert_by_val(&ht,tmp,NULL)=i;}
+    printf("Inserted %d items (%lu items per bucket): string_cmp calls per insertion: %1.3f.\n",num_items,ch_string_int_get_num_items(&ht)/CH_NUM_BUCKETS_string_int,(double)num_string_cmp_calls/(double)num_items);
+
+    num_string_cmp_calls = 0;
+    for (i=0;i<num_items;i++)   {
+        const int* value;
+        sprintf(tmp,"key_%d",i);
+        value = ch_string_int_get_const_by_val(&ht,tmp);
+        if (!value || *value!=i) ++num_errors;
+    }
+    printf("Fetched %d items (errors=%d): string_cmp calls per lookup: %1.3f.\n",num_items,num_errors,(double)num_string_cmp_calls/(double)num_items);
+
+    /* remove even keys */
+    for (i=0;i<num_items;i+=2) {sprintf(tmp,"key_%d",i);if (!ch_string_int_remove_by_val(&ht,tmp)) ++num_errors;}
+    string_setter(&key,"key_1");
+    if (!ch_string_int_get(&ht,&key) || ch_string_int_get_by_val(&ht,(string)"key_0")) ++num_errors;
+    string_dtr(&key);
+    printf("Removed even keys: num_items=%lu (errors=%d).\n",ch_string_int_get_num_items(&ht),num_errors);
+
+    ch_string_int_dbg_check(&ht);   /* it checks the cached hashes too */
+    ch_string_int_free(&ht);
+}
+#endif /* NO_STRING_STRING_TEST */
+#endif /* NO_CACHED_HASHES_TEST */
+
+#ifndef NO_BATCH_TEST
+#ifdef NO_DYNAMIC_BUCKETS_TEST
+#   define NO_BATCH_TEST    /* it uses the 'ch_uint_uint' hashtable of the DYNAMIC BUCKETS TEST */
+#else
+#include <time.h>   /* clock */
+static void BatchTest(void)    {
+    ch_uint_uint ht;
+    const uint num_items = 1000000;
+    uint i,num_errors=0;size_t num_found=0;
+    uint* keys = (uint*) malloc(num_items*sizeof(uint));
+    uint** values = (uint**) malloc(num_items*sizeof(uint*));
+    clock_t start;
+
+    printf("\nBATCH TEST:\n");
+    ch_uint_uint_create(&ht,&uint_hash,&uint_cmp,1);
+
+    /* inserts all the keys, and then fetches pointers to their values */
+    for (i=0;i<num_items;i++) keys[i]=i*3;
+    printf("Inserted %lu items.\n",ch_uint_uint_get_or_insert_batch(&ht,keys,num_items,values,NULL));
+    for (i=0;i<num_items;i++) *values[i]=i;
+
+    /* random lookups (about one third of them are present) */
+    for (i=0;i<num_items;i++) keys[i]=(uint)((i*2654435761U)%(num_items*3));
+    start = clock();
+    for (i=0;i<num_items;i++) {if (ch_uint_uint_get(&ht,&keys[i])) ++num_found;}
+    printf("ch_uint_uint_get(...):       found %lu/%u keys in %1.3f s.\n",num_found,num_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+    start = clock();
+    num_found = ch_uint_uint_get_batch(&ht,keys,num_items,values);
+    printf("ch_uint_uint_get_batch(...): found %lu/%u keys in %1.3f s.\n",num_found,num_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+    for (i=0;i<num_items;i++) {if ((keys[i]%3==0) != (values[i]!=NULL) || (values[i] && *values[i]!=keys[i]/3)) ++num_errors;}
+    printf("errors=%u.\n",num_errors);
+
+    ch_uint_uint_free(&ht);
+    free(values);free(keys);
+}
+#endif /* NO_DYNAMIC_BUCKETS_TEST */
+#endif /* NO_BATCH_TEST */
+
+#ifndef NO_BUCKET_SLABS_TEST
+#ifdef NO_DYNAMIC_BUCKETS_TEST
+#   define NO_BUCKET_SLABS_TEST    /* it compares against the 'ch_uint_uint' hashtable of the DYNAMIC BUCKETS TEST */
+#else
+typedef unsigned suint; /* just another name for 'uint', so that we can define another hashtable */
+#ifndef C_HASHTABLE_suint_uint_H
+#define C_HASHTABLE_suint_uint_H
+#   define CH_KEY_TYPE suint
+#   define CH_VALUE_TYPE uint
+#   define CH_USE_DYNAMIC_BUCKETS
+#   define CH_USE_BUCKET_SLABS      /* scoped definition: bucket arrays are carved from large pages owned by the hashtable */
+#   define CH_NUM_BUCKETS 16
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_suint_uint_H */
+#include <time.h>   /* clock */
+#ifdef __linux__
+#include <unistd.h> /* sysconf */
+static size_t get_rss_bytes(void)   {
+    /* resident set size of this process (from /proc/self/statm) */
+    size_t pages=0,rss_pages=0;
+    FILE* f = fopen("/proc/self/statm","r");
+    if (f) {if (fscanf(f,"%lu %lu",&pages,&rss_pages)!=2) rss_pages=0;fclose(f);}
+    return rss_pages*(size_t)sysconf(_SC_PAGESIZE);
+}
+#else
+static size_t get_rss_bytes(void)   {return 0;}    /* not implemented */
+#endif
+static void BucketSlabsTest(void)    {
+    ch_uint_uint ht;        /* every bucket array is allocated with CH_MALLOC */
+    ch_suint_uint hts;      /* bucket arrays are carved from 'hts.slabs' */
+    const uint num_items = 1000000;
+    uint i,num_errors=0;
+    size_t rss;clock_t start;
+
+    printf("\nBUCKET SLABS TEST:\n");
+    ch_uint_uint_create(&ht,&uint_hash,&uint_cmp,1);
+    ch_suint_uint_create(&hts,&uint_hash,&uint_cmp,1);  /* 'suint' and 'uint' are the same type */
+
+    rss = get_rss_bytes();start = clock();
+    for (i=0;i<num_items;i++) *ch_suint_uint_get_or_insert(&hts,&i,NULL) = i;
+    printf("with slabs:    inserted %u items in %1.3f s (RSS grew by ",num_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+    ch_display_bytes(get_rss_bytes()-rss);printf(").\n");
+
+    rss = get_rss_bytes();start = clock();
+    for (i=0;i<num_items;i++) *ch_uint_uint_get_or_insert(&ht,&i,NULL) = i;
+    printf("without slabs: inserted %u items in %1.3f s (RSS grew by ",num_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+    ch_display_bytes(get_rss_bytes()-rss);printf(").\n");
+
+    /* remove odd keys (the blocks of shrinking buckets are reused by the next insertions) */
+    for (i=1;i<num_items;i+=2) {if (!ch_uint_uint_remove(&ht,&i) || !ch_suint_uint_remove(&hts,&i)) ++num_errors;}
+    for (i=0;i<num_items;i++)   {
+        const uint* value = ch_suint_uint_get_const(&hts,&i);
+        if ((value!=NULL)!=(ch_uint_uint_get_const(&ht,&i)!=NULL) || (value && *value!=i)) ++num_errors;
+    }
+    printf("Removed odd keys: num_items=%lu (errors=%u).\n",ch_suint_uint_get_num_items(&hts),num_errors);
+
+    ch_suint_uint_rehash(&hts,0);   /* completes the pending rehashing (if any) */
+    ch_suint_uint_dbg_check(&hts);
+
+    ch_suint_uint_free(&hts);   /* all the slab pages are released at once */
+    ch_uint_uint_free(&ht);
+}
+#endif /* NO_DYNAMIC_BUCKETS_TEST */
+#endif /* NO_BUCKET_SLABS_TEST */
+
+#ifndef NO_SNAPSHOT_TEST
+#if (defined(NO_DYNAMIC_BUCKETS_TEST) || defined(NO_STRING_STRING_TEST))
+#   define NO_SNAPSHOT_TEST    /* it uses the 'ch_uint_uint' and 'ch_string_string' hashtables of the DYNAMIC BUCKETS and STRING-STRING TESTS */
+#else
+#include <time.h>   /* clock */
+static void string_serialize(const string* a,cvh_serializer_t* s)  {cvh_serializer_write_string(s,*a,NULL);}
+static int string_deserialize(string* a,const cvh_serializer_t* d)   {return cvh_serializer_read_string(d,a,NULL,NULL);}
+static void SnapshotTest(void)    {
+    ch_uint_uint ht,ht2;
+    ch_string_string hs,hs2;
+    cvh_serializer_t s = cvh_serializer_create();
+    const uint num_items = 1000000;
+    uint i,num_errors=0;int ok;
+    char tmp[32];
+    clock_t start;
+
+    printf("\nSNAPSHOT TEST:\n");
+    ch_uint_uint_create(&ht,&uint_hash,&uint_cmp,1);
+    ch_uint_uint_create(&ht2,&uint_hash,&uint_cmp,1);
+    for (i=0;i<num_items;i++) *ch_uint_uint_get_or_insert(&ht,&i,NULL) = i*2;
+
+    /* plain-old-data keys and values (NULL callbacks): every bucket is a single block of items */
+    ch_uint_uint_serialize(&ht,&s,NULL,NULL);
+    start = clock();
+    ok = ch_uint_uint_deserialize(&ht2,&s,NULL,NULL);
+    printf("ch_uint_uint: %lu items -> %lu bytes, deserialized in %1.3f s (ok=%d).\n",ch_uint_uint_get_num_items(&ht),s.size,(double)(clock()-start)/CLOCKS_PER_SEC,ok);
+    ch_uint_uint_clear(&ht2);
+    start = clock();
+    for (i=0;i<num_items;i++) *ch_uint_uint_get_or_insert(&ht2,&i,NULL) = i*2;
+    printf("ch_uint_uint: %u items re-inserted in %1.3f s.\n",num_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+    for (i=0;i<num_items;i++)   {
+        const uint* value = ch_uint_uint_get_const(&ht2,&i);
+        if (!value || *value!=i*2) ++num_errors;
+    }
+    ch_uint_uint_free(&ht2);ch_uint_uint_free(&ht);
+
+    /* strings need (de)serialization callbacks (NULL callbacks copy plain-old-data keys or values) */
+    cvh_serializer_clear(&s);
+    ch_string_string_create_with(&hs,&string_hash,&string_cmp,&string_ctr,&string_dtr,&string_cpy,&string_ctr,&string_dtr,&string_cpy,1);
+    ch_string_string_create_with(&hs2,&string_hash,&string_cmp,&string_ctr,&string_dtr,&string_cpy,&string_ctr,&string_dtr,&string_cpy,1);
+    for (i=0;i<1000;i++)   {sprintf(tmp,"key_%u",i);string_setter(ch_string_string_get_or_insert_by_val(&hs,tmp,NULL),tmp+4);}
+    ch_string_string_serialize(&hs,&s,&string_serialize,&string_serialize);
+    ok = ch_string_string_deserialize(&hs2,&s,&string_deserialize,&string_deserialize);
+    for (i=0;i<1000;i++)   {
+        const string* value;
+        sprintf(tmp,"key_%u",i);
+        value = ch_string_string_get_const_by_val(&hs2,tmp);
+        if (!value || strcmp(*value,tmp+4)!=0) ++num_errors;
+    }
+    printf("ch_string_string: %lu items -> %lu bytes (ok=%d).\nerrors=%u.\n",ch_string_string_get_num_items(&hs2),s.size,ok,num_errors);
+    ch_string_string_free(&hs2);ch_string_string_free(&hs);
+
+    cvh_serializer_free(&s);
+}
+#endif /* (defined(NO_DYNAMIC_BUCKETS_TEST) || defined(NO_STRING_STRING_TEST)) */
+#endif /* NO_SNAPSHOT_TEST */
+
+#ifndef NO_BUILD_FROM_TEST
+#if (defined(NO_DYNAMIC_BUCKETS_TEST) || defined(NO_STRING_STRING_TEST))
+#   define NO_BUILD_FROM_TEST    /* it uses the 'ch_uint_uint' and 'ch_string_string' hashtables of the DYNAMIC BUCKETS and STRING-STRING TESTS */
+#else
+#include <time.h>   /* clock */
+static void BuildFromTest(void)    {
+    ch_uint_uint ht,ht2;
+    ch_string_string hs;
+    const uint num_items = 1000000;
+    uint_uint* items = (uint_uint*) malloc(num_items*sizeof(uint_uint));
+    string_string sitems[3];
+    char one[]="one",two[]="two",uno[]="uno",due[]="due",eins[]="eins";
+    uint i,num_errors=0;
+    clock_t start;
+
+    printf("\nBUILD FROM TEST:\n");
+    /* unsorted keys, with a few duplicates: the last value of a key wins */
+    for (i=0;i<num_items;i++) {items[i].k = (i*2654435761U)%(num_items-1000);items[i].v = i;}
+    ch_uint_uint_create(&ht,&uint_hash,&uint_cmp,1);
+    ch_uint_uint_create(&ht2,&uint_hash,&uint_cmp,1);
+
+    start = clock();
+    ch_uint_uint_build_from(&ht,items,num_items);
+    printf("ch_uint_uint_build_from(...):    %lu items in %1.3f s.\n",ch_uint_uint_get_num_items(&ht),(double)(clock()-start)/CLOCKS_PER_SEC);
+    start = clock();
+    for (i=0;i<num_items;i++) *ch_uint_uint_get_or_insert(&ht2,&items[i].k,NULL) = items[i].v;
+    printf("ch_uint_uint_get_or_insert(...): %lu items in %1.3f s.\n",ch_uint_uint_get_num_items(&ht2),(double)(clock()-start)/CLOCKS_PER_SEC);
+    if (ch_uint_uint_get_num_items(&ht)!=ch_uint_uint_get_num_items(&ht2)) ++num_errors;
+    for (i=0;i<num_items;i++)   {
+        const uint* value = ch_uint_uint_get_const(&ht,&items[i].k);
+        if (!value || *value!=*ch_uint_uint_get_const(&ht2,&items[i].k)) ++num_errors;
+    }
+    ch_uint_uint_free(&ht2);ch_uint_uint_free(&ht);
+    free(items);
+
+    /* items are copied with 'key_cpy' and 'value_cpy' (and dropped duplicates are destroyed with 'key_dtr' and 'value_dtr') */
+    ch_string_string_create_with(&hs,&string_hash,&string_cmp,&string_ctr,&string_dtr,&string_cpy,&string_ctr,&string_dtr,&string_cpy,1);
+    sitems[0].k = one;sitems[0].v = uno;
+    sitems[1].k = two;sitems[1].v = due;
+    sitems[2].k = one;sitems[2].v = eins;
+    ch_string_string_build_from(&hs,sitems,3);
+    if (ch_string_string_get_num_items(&hs)!=2 || strcmp(*ch_string_string_get_const_by_val(&hs,one),"eins")!=0) ++num_errors;
+    printf("ch_string_string: %lu items (one=%s two=%s).\nerrors=%u.\n",ch_string_string_get_num_items(&hs),
+           *ch_string_string_get_const_by_val(&hs,one),*ch_string_string_get_const_by_val(&hs,two),num_errors);
+    ch_string_string_free(&hs);
+}
+#endif /* (defined(NO_DYNAMIC_BUCKETS_TEST) || defined(NO_STRING_STRING_TEST)) */
+#endif /* NO_BUILD_FROM_TEST */
+
+#ifndef NO_STATS_TEST
+typedef unsigned ukey;
+typedef unsigned uval;
+#ifndef C_HASHTABLE_ukey_uval_H
+#define C_HASHTABLE_ukey_uval_H
+#   define CH_KEY_TYPE ukey
+#   define CH_VALUE_TYPE uval
+#   define CH_USE_STATS             /* scoped definition: the hashtable counts lookups, key comparisons, reallocations and moved bytes */
+#   define CH_NUM_BUCKETS_ukey_uval 256
+#   define CH_NUM_BUCKETS CH_NUM_BUCKETS_ukey_uval
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_ukey_uval_H */
+static int ukey_cmp(const ukey* a,const ukey* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+static ch_hash_uint ukey_hash_bad(const ukey* k) {return (ch_hash_uint) ((*k)%16);}   /* only 16 buckets are used */
+static ch_hash_uint ukey_hash_good(const ukey* k) {return (ch_hash_uint) (ch_hash32_murmur3((const unsigned char*)k,sizeof(ukey),7)%CH_NUM_BUCKETS_ukey_uval);}
+static void StatsTestRun(const char* name,ch_hash_uint (*key_hash)(const ukey*))    {
+    ch_ukey_uval ht;
+    ch_stats_t st;
+    const ukey num_items = 20000;
+    ukey i;uval num_errors=0;
+
+    ch_ukey_uval_create(&ht,key_hash,&ukey_cmp,1);
+    for (i=0;i<num_items;i++) {const ukey k = (i*7919)%num_items;*ch_ukey_uval_get_or_insert(&ht,&k,NULL) = k;}  /* shuffled keys */
+    ch_ukey_uval_get_stats(&ht,&st);
+    printf("%s insert: lookups=%lu inserts=%lu key_cmps/lookup=%1.2f reallocs=%lu bytes_moved=%lu.\n",name,
+           st.num_lookups,st.num_inserts,(double)st.num_key_cmps/(double)st.num_lookups,st.num_reallocs,st.num_bytes_moved);
+
+    ch_ukey_uval_reset_stats(&ht);
+    for (i=0;i<2*num_items;i++) {
+        const uval* value = ch_ukey_uval_get_const(&ht,&i);
+        if ((i<num_items && (!value || *value!=i)) || (i>=num_items && value)) ++num_errors;
+    }
+    ch_ukey_uval_get_stats(&ht,&st);
+    printf("%s get:    lookups=%lu hits=%lu misses=%lu key_cmps/lookup=%1.2f.\n",name,
+           st.num_lookups,st.num_hits,st.num_misses,(double)st.num_key_cmps/(double)st.num_lookups);
+
+    ch_ukey_uval_reset_stats(&ht);
+    for (i=0;i<num_items;i+=2) {if (!ch_ukey_uval_remove(&ht,&i)) ++num_errors;}
+    ch_ukey_uval_get_stats(&ht,&st);
+    printf("%s remove: lookups=%lu removes=%lu key_cmps/lookup=%1.2f bytes_moved=%lu (errors=%u).\n",name,
+           st.num_lookups,st.num_removes,(double)st.num_key_cmps/(double)st.num_lookups,st.num_bytes_moved,num_errors);
+    ch_ukey_uval_free(&ht);
+}
+static void StatsTest(void)    {
+    printf("\nSTATS TEST:\n");
+    StatsTestRun("bad hash: ",&ukey_hash_bad);
+    StatsTestRun("good hash:",&ukey_hash_good);
+}
+#endif /* NO_STATS_TEST */
+
+#ifndef NO_STRIPED_LOCKS_TEST
+typedef unsigned cuint; /* key type of the concurrent hashtable */
+#ifndef C_HASHTABLE_cuint_unsigned_H
+#define C_HASHTABLE_cuint_unsigned_H
+#   define CH_KEY_TYPE cuint
+#   define CH_VALUE_TYPE unsigned
+#   define CH_USE_STRIPED_LOCKS     /* scoped definition: adds the thread-safe 'ch_cuint_unsigned_concurrent_xxx(...)' functions */
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_cuint_unsigned_H */
+#ifdef _WIN32
+/* <windows.h> has already been included by <c_hashtable.h> */
+typedef HANDLE thread_t;
+#   define THREAD_FCT(name) DWORD WINAPI name(LPVOID arg)
+static void thread_start(thread_t* t,LPTHREAD_START_ROUTINE fcn,void* arg) {*t=CreateThread(NULL,0,fcn,arg,0,NULL);}
+static void thread_join(thread_t t)    {WaitForSingleObject(t,INFINITE);CloseHandle(t);}
+static double get_seconds(void) {return (double)GetTickCount()/1000.0;}
+#else
+#include <pthread.h>
+#include <time.h>   /* clock_gettime */
+typedef pthread_t thread_t;
+#   define THREAD_FCT(name) void* name(void* arg)
+static void thread_start(thread_t* t,void* (*fcn)(void*),void* arg) {pthread_create(t,NULL,fcn,arg);}
+static void thread_join(thread_t t)    {pthread_join(t,NULL);}
+static double get_seconds(void) {struct timespec ts;clock_gettime(CLOCK_MONOTONIC,&ts);return (double)ts.tv_sec+(double)ts.tv_nsec*1e-9;}
+#endif
+static ch_hash_uint cuint_hash(const cuint* k) {
+    /* CH_NUM_BUCKETS==256 (==CH_MAX_NUM_BUCKETS) here: we fold the 32-bit hash to 8 bits */
+    return (ch_hash_uint) CH_HASH_FROM_HASH32_USING_FIBFOLDING(ch_hash32_murmur3((const unsigned char*)k,sizeof(cuint),7),8);
+}
+#define STRIPED_LOCKS_TEST_NUM_THREADS  4
+#define STRIPED_LOCKS_TEST_NUM_OPS      1000000     /* per thread: 90% lookups and 10% increments of random keys */
+typedef struct {
+    ch_cuint_unsigned* ht;
+    ch_stripe_lock* global_lock;    /* NULL: 'ht' uses its own striped locks */
+    unsigned seed,num_increments;
+} striped_locks_test_arg;
+static void increment(unsigned* value,int match,void* user_data) {(void)user_data;*value = match ? (*value+1) : 1;}
+static THREAD_FCT(striped_locks_test_thread)    {
+    striped_locks_test_arg* a = (striped_locks_test_arg*) arg;
+    unsigned i,value,x=a->seed;
+    for (i=0;i<STRIPED_LOCKS_TEST_NUM_OPS;i++)   {
+        cuint key;
+        x = x*1103515245U+12345U;key = (x>>8)%65536;
+        if (!a->global_lock)    {
+            if ((x>>16)%10!=0) ch_cuint_unsigned_concurrent_get(a->ht,&key,&value);
+            else {ch_cuint_unsigned_concurrent_update(a->ht,&key,&increment,NULL);++a->num_increments;}
+        }
+        else if ((x>>16)%10!=0) {
+            /* the old way: one lock for the whole table */
+            const unsigned* pvalue;
+            ch_stripe_lock_read(a->global_lock);
+            pvalue = ch_cuint_unsigned_get(a->ht,&key);
+            if (pvalue) value = *pvalue;
+            ch_stripe_unlock_read(a->global_lock);
+        }
+        else {
+            int match;unsigned* pvalue;
+            ch_stripe_lock_write(a->global_lock);
+            pvalue = ch_cuint_unsigned_get_or_insert(a->ht,&key,&match);
+            increment(pvalue,match,NULL);
+            ch_stripe_unlock_write(a->global_lock);
+            ++a->num_increments;
+        }
+    }
+    return 0;
+}
+static void StripedLocksTest(void)    {
+    ch_cuint_unsigned ht;
+    ch_stripe_lock global_lock;
+    striped_locks_test_arg args[STRIPED_LOCKS_TEST_NUM_THREADS];
+    thread_t threads[STRIPED_LOCKS_TEST_NUM_THREADS];
+    int use_global_lock;
+    size_t i;
+
+    printf("\nSTRIPED LOCKS TEST:\n");
+    for (use_global_lock=1;use_global_lock>=0;use_global_lock--)   {
+        unsigned num_increments=0,sum=0;double start;
+        ch_cuint_unsigned_create(&ht,&cuint_hash,NULL,4);
+        memset(&global_lock,0,sizeof(ch_stripe_lock));
+        start = get_seconds();
+        for (i=0;i<STRIPED_LOCKS_TEST_NUM_THREADS;i++)  {
+            args[i].ht=&ht;args[i].global_lock=use_global_lock ? &global_lock : NULL;
+            args[i].seed=(unsigned)i*7919U+1U;args[i].num_increments=0;
+            thread_start(&threads[i],&striped_locks_test_thread,&args[i]);
+        }
+        for (i=0;i<STRIPED_LOCKS_TEST_NUM_THREADS;i++)  {thread_join(threads[i]);num_increments+=args[i].num_increments;}
+        /* single-threaded again: we can iterate the buckets directly */
+        for (i=0;i<CH_MAX_NUM_BUCKETS;i++)  {size_t j;for (j=0;j<ht.buckets[i].size;j++) sum+=ht.buckets[i].v[j].v;}
+        printf("%s %d threads x %d ops in %1.3f s (increments=%u sum_of_counters=%u).\n",use_global_lock ? "global lock:  " : "striped locks:",
+               STRIPED_LOCKS_TEST_NUM_THREADS,STRIPED_LOCKS_TEST_NUM_OPS,get_seconds()-start,num_increments,sum);
+        ch_cuint_unsigned_free(&ht);
+    }
+}
+
+#ifndef NO_RCU_READS_TEST
+typedef unsigned ruint; /* key type of the hashtable with lock-free reads */
+#ifndef C_HASHTABLE_ruint_unsigned_H
+#define C_HASHTABLE_ruint_unsigned_H
+#   define CH_KEY_TYPE ruint
+#   define CH_VALUE_TYPE unsigned
+#   define CH_USE_STRIPED_LOCKS
+#   define CH_USE_RCU_READS         /* scoped definition: 'ch_ruint_unsigned_concurrent_get(...)' takes no locks */
+#   include "c_hashtable.h"	/* this header has no header guards inside! */
+#endif /* C_HASHTABLE_ruint_unsigned_H */
+static ch_hash_uint ruint_hash(const ruint* k) {return cuint_hash(k);}
+#define RCU_READS_TEST_NUM_OPS      1000000     /* per thread: 99% lookups and 1% insertions or removals of random keys */
+typedef struct {
+    ch_cuint_unsigned* ht;  /* one of them is NULL */
+    ch_ruint_unsigned* htr;
+    unsigned seed,num_found,num_errors;
+} rcu_reads_test_arg;
+static THREAD_FCT(rcu_reads_test_thread)    {
+    rcu_reads_test_arg* a = (rcu_reads_test_arg*) arg;
+    unsigned i,value,x=a->seed;int found;
+    for (i=0;i<RCU_READS_TEST_NUM_OPS;i++)   {
+        unsigned key;
+        x = x*1103515245U+12345U;key = (x>>8)%65536;
+        if ((x>>16)%100!=0) {
+            value = 0;
+            found = a->htr ? ch_ruint_unsigned_concurrent_get(a->htr,&key,&value) : ch_cuint_unsigned_concurrent_get(a->ht,&key,&value);
+            if (found) {++a->num_found;if (value!=key*2) ++a->num_errors;}  /* all values are 'key*2' */
+        }
+        else if ((x>>24)&1) {
+            value = key*2;
+            if (a->htr) ch_ruint_unsigned_concurrent_set(a->htr,&key,&value);
+            else ch_cuint_unsigned_concurrent_set(a->ht,&key,&value);
+        }
+        else if (a->htr) ch_ruint_unsigned_concurrent_remove(a->htr,&key);
+        else ch_cuint_unsigned_concurrent_remove(a->ht,&key);
+    }
+    return 0;
+}
+static void RcuReadsTest(void)    {
+    ch_cuint_unsigned ht;
+    ch_ruint_unsigned htr;
+    rcu_reads_test_arg args[STRIPED_LOCKS_TEST_NUM_THREADS];
+    thread_t threads[STRIPED_LOCKS_TEST_NUM_THREADS];
+    int use_rcu;
+    unsigned key,value;
+    size_t i;
+
+    printf("\nRCU READS TEST:\n");
+    for (use_rcu=0;use_rcu<=1;use_rcu++)   {
+        unsigned num_found=0,num_errors=0;double start;
+        if (use_rcu) ch_ruint_unsigned_create(&htr,&ruint_hash,NULL,4);
+        else ch_cuint_unsigned_create(&ht,&cuint_hash,NULL,4);
+        for (key=0;key<65536;key+=2)  {
+            value = key*2;
+            if (use_rcu) ch_ruint_unsigned_concurrent_set(&htr,&key,&value);
+            else ch_cuint_unsigned_concurrent_set(&ht,&key,&value);
+        }
+        start = get_seconds();
+        for (i=0;i<STRIPED_LOCKS_TEST_NUM_THREADS;i++)  {
+            args[i].ht=use_rcu ? NULL : &ht;args[i].htr=use_rcu ? &htr : NULL;
+            args[i].seed=(unsigned)i*7919U+1U;args[i].num_found=args[i].num_errors=0;
+            thread_start(&threads[i],&rcu_reads_test_thread,&args[i]);
+        }
+        for (i=0;i<STRIPED_LOCKS_TEST_NUM_THREADS;i++)  {thread_join(threads[i]);num_found+=args[i].num_found;num_errors+=args[i].num_errors;}
+        printf("%s %d threads x %d ops in %1.3f s (found=%u errors=%u).\n",use_rcu ? "rcu reads:    " : "striped locks:",
+               STRIPED_LOCKS_TEST_NUM_THREADS,RCU_READS_TEST_NUM_OPS,get_seconds()-start,num_found,num_errors);
+        if (use_rcu) ch_ruint_unsigned_free(&htr);  /* it frees the retired bucket arrays too */
+        else ch_cuint_unsigned_free(&ht);
+    }
+}
+#endif /* NO_RCU_READS_TEST */
+#endif /* NO_STRIPED_LOCKS_TEST */
+
 #ifndef NO_CPP_TEST
 #ifdef __cplusplus
 
@@ -494,7 +1149,37 @@ int main(int argc,char* argv[])
 #   ifndef NO_STRING_STRING_TEST
     StringStringTest();
 #   endif
+#   ifndef NO_DYNAMIC_BUCKETS_TEST
+    DynamicBucketsTest();
+#   endif
+#   ifndef NO_OPEN_ADDRESSING_TEST
+    OpenAddressingTest();
+#   endif
 
+#   ifndef NO_CACHED_HASHES_TEST
+    CachedHashesTest();
+#   endif
+#   ifndef NO_BATCH_TEST
+    BatchTest();
+#   endif
+#   ifndef NO_BUCKET_SLABS_TEST
+    BucketSlabsTest();
+#   endif
+#   ifndef NO_SNAPSHOT_TEST
+    SnapshotTest();
+#   endif
+#   ifndef NO_BUILD_FROM_TEST
+    BuildFromTest();
+#   endif
+#   ifndef NO_STATS_TEST
+    StatsTest();
+#   endif
+#   ifndef NO_STRIPED_LOCKS_TEST
+    StripedLocksTest();
+#   ifndef NO_RCU_READS_TEST
+    RcuReadsTest();
+#   endif
+#   endif
 #   ifndef NO_CPP_TEST
 #   ifdef __cplusplus
     CppTest();
@@ -135,6 +135,70 @@ v content:
     2) "Florence"		population: 15000
     3) "Venice"		population: 25000
 
+ALLOCATOR TEST:
+request 0: v.size=1000 sorted.size=1000 sorted[0]=0 sorted[999]=999. arena used: 24 KB 960 Bytes.
+request 1: v.size=2000 sorted.size=2000 sorted[0]=0 sorted[1999]=999. arena used: 56 KB 160 Bytes.
+request 2: v.size=3000 sorted.size=3000 sorted[0]=0 sorted[2999]=999. arena used: 84 KB 256 Bytes.
+
+VM ALLOCATOR TEST:
+pushed 10000000 items in 8 reallocations. capacity: 54 MB.
+after resize and shrink_to_fit: size=3333333 capacity: 12 MB 732 KB 852 Bytes (errors=0).
+
+STREAMING SERIALIZER TEST:
+serialized 1000000 items (4000016 bytes written) using a buffer of: 4 KB (ok=1).
+deserialized 'cv_int' (1000000 items) using a buffer of: 4 KB (ok=1, errors=0).
+with a buffer of 4 Bytes: 1000000 items written and read back (ok=1, errors=0).
+
+MAPPED LOAD TEST:
+deserialized 1000000 items (ok=1, errors=0). Zero-copy: yes.
+after push_back: v.size=1000001 v[0]=-1 v[1000000]=1000000.
+
+SORTED RANGE TEST:
+cv_int_insert_sorted(...):       inserted 49999/50000 items in 0.333 s.
+cv_int_insert_sorted_range(...): inserted 49999/50000 items in 0.011 s.
+v.size=149999 (errors=0).
+
+SORT TEST:
+random:        qsort(...):       10000000 items in 2.090 s.
+random:        cv_int_sort(...): 10000000 items in 1.596 s.
+almost sorted: qsort(...):       10000000 items in 0.470 s.
+almost sorted: cv_int_sort(...): 10000000 items in 0.647 s.
+errors=0.
+
+RADIX SORT TEST:
+cv_int_sort(...):              10000000 items in 1.613 s.
+cv_int_radix_sort_by_key(...): 10000000 items in 0.683 s.
+cv_scored_item_radix_sort_by_key(...): 1000000 items (float keys) in 0.045 s.
+s.v[0].key=-250.00 s.v[999999].key=250.00 (errors=0).
+
+SEARCH INDEX TEST:
+cv_int_search_index_init(...):  10000000 items in 0.035 s.
+cv_int_binary_search(...):      10000000 searches in 6.440 s (4999999 matches).
+cv_int_search_index_find(...):  10000000 searches in 4.552 s (4999999 matches).
+errors=0.
+
+CMP INLINE TEST:
+cv_int_sort(...):                   10000000 items in 1.850 s.
+cv_int_sort_inline(...):            10000000 items in 1.348 s.
+cv_int_binary_search(...):          10000000 searches in 5.818 s (5172366 matches).
+cv_int_binary_search_inline(...):   10000000 searches in 3.580 s (5172366 matches).
+errors=0.
+
+POD TEST:
+cv_vec3_push_back(...):     5 x 20000000 items in 0.794 s.
+cv_vec3_pod_push_back(...): 5 x 20000000 items in 0.481 s.
+errors=0.
+
+======= THIS OUTPUT IS PRESENT ONLY WHEN CV_ENABLE_PARALLEL is defined (timings measured on a single core): ======
+
+PARALLEL TEST (4 threads):
+cv_int_parallel_for_each(...): 20000000 items in 0.069 s.
+cv_int_cpy(...):               20000000 items in 0.053 s.
+cv_int_parallel_cpy(...):      20000000 items in 0.015 s.
+cv_int_sort(...):              20000000 items in 3.442 s.
+cv_int_parallel_sort(...):     20000000 items in 3.878 s.
+errors=0.
+
 ======= THIS OUTPUT IS PRESENT ONLY WHEN this file is compiled as c++: ======
 
 'std::vector<cv_int>' test:
@@ -161,12 +225,16 @@ v[2] = {1:	[6]	};
 
 /*#define CV_ENABLE_CLEARING_ITEM_MEMORY */    /* just for testing */
 /*#define CV_DISABLE_FAKE_MEMBER_FUNCTIONS*/ /* just for testing */
+/*#define CV_ENABLE_PARALLEL*/  /* just for testing (it needs -pthread on unix-like systems) */
 
 /* The following line is completely optional, and must be used only
    if you need to silence some compiler or static analyzer warning.
    For further info, see: https://en.cppreference.com/w/c/string/byte/memcpy
 */
 /*#define __STDC_WANT_LIB_EXT1__ 1*/ /* use memcpy_s, memmove_s and memset_s instead of memcpy, memmove and memset, if bound-checking functions are supported */
+#if (defined(__linux__) && !defined(_GNU_SOURCE))
+#   define _GNU_SOURCE  /* optional: it lets 'cvh_vm_allocator_t' grow with mremap(...), without copying the items (see the VM ALLOCATOR TEST) */
+#endif
 #include "c_vector.h"
 #include <stdio.h>  /* printf */
 
@@ -174,6 +242,17 @@ v[2] = {1:	[6]	};
 /*#define NO_STRINGVECTOR_TEST*/
 /*#define NO_COMPLEXTEST*/
 /*#define NO_CVH_STRING_T_TEST*/
+/*#define NO_ALLOCATOR_TEST*/
+/*#define NO_VM_ALLOCATOR_TEST*/
+/*#define NO_STREAMING_SERIALIZER_TEST*/
+/*#define NO_MAPPED_LOAD_TEST*/
+/*#define NO_SORTED_RANGE_TEST*/
+/*#define NO_SORT_TEST*/
+/*#define NO_RADIX_SORT_TEST*/
+/*#define NO_PARALLEL_TEST*/
+/*#define NO_SEARCH_INDEX_TEST*/
+/*#define NO_CMP_INLINE_TEST*/
+/*#define NO_POD_TEST*/
 /*#define NO_CPP_TEST*/
 
 #ifndef NO_SIMPLE_TEST
@@ -773,6 +852,540 @@ void CvhStringTTest(void)   {
 #endif /* (defined(NO_CVH_STRING_T_TEST) && !defined(CV_NO_CVH_STRING_T)) */
 
 
+#ifndef NO_ALLOCATOR_TEST
+/* This test shows how to use a per-instance allocator ('cvh_allocator_t'). */
+/* Here a simple bump arena backs some short-lived ("request-scoped") vectors. */
+/* The arena never frees single blocks ('cvh_allocator_t::free' is NULL), */
+/* so all the vectors allocated with it are released together, in O(1), by resetting the arena. */
+typedef struct bump_arena_t {unsigned char* mem;size_t size,capacity;} bump_arena_t;
+#define BUMP_ARENA_ALIGN(SIZE)  (((SIZE)+15)&(~((size_t)15)))
+static void* bump_arena_alloc(void* user_data,size_t size)   {
+    bump_arena_t* a = (bump_arena_t*) user_data;
+    const size_t aligned_size = BUMP_ARENA_ALIGN(size);
+    if (a->size+aligned_size>a->capacity) return NULL;  /* out of memory */
+    a->size+=aligned_size;
+    return &a->mem[a->size-aligned_size];
+}
+static void* bump_arena_realloc(void* user_data,void* ptr,size_t new_size,size_t old_size)   {
+    /* optional: if it's NULL, cvh_allocator_t::alloc is used, and the old content is copied */
+    bump_arena_t* a = (bump_arena_t*) user_data;
+    if (ptr && (unsigned char*)ptr+BUMP_ARENA_ALIGN(old_size)==&a->mem[a->size])   {
+        /* the last allocated block can grow in place */
+        const size_t offset = (size_t)((unsigned char*)ptr-a->mem);
+        if (offset+BUMP_ARENA_ALIGN(new_size)>a->capacity) return NULL;  /* out of memory */
+        a->size = offset+BUMP_ARENA_ALIGN(new_size);
+        return ptr;
+    }
+    else {
+        void* p = bump_arena_alloc(user_data,new_size);
+        if (p && ptr) memcpy(p,ptr,old_size<new_size ? old_size : new_size);
+        return p;
+    }
+}
+#undef BUMP_ARENA_ALIGN
+
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+
+static void AllocatorTest(void) {
+    static unsigned char arena_memory[256*1024];
+    bump_arena_t arena = {arena_memory,0,sizeof(arena_memory)};
+    cvh_allocator_t allocator = {&bump_arena_alloc,&bump_arena_realloc,NULL,NULL,NULL};
+    int request;size_t i;
+
+    printf("\nALLOCATOR TEST:\n");
+    allocator.user_data = &arena;  /* the allocator must outlive the vectors that use it */
+    for (request=0;request<3;request++) {
+        cv_int v,sorted;
+        cv_int_init_with_allocator(&v,NULL,NULL,NULL,NULL,NULL,NULL,&allocator);
+        cv_int_init_with_allocator(&sorted,&int_cmp,NULL,NULL,NULL,NULL,NULL,&allocator);
+        for (i=0;i<(size_t)(1000*(request+1));i++)  {
+            const int value = (int)((i*7919)%1000);
+            cv_int_push_back(&v,&value);
+            cv_int_insert_sorted(&sorted,&value,NULL,1);
+        }
+        printf("request %d: v.size=%lu sorted.size=%lu sorted[0]=%d sorted[%lu]=%d. arena used: ",request,v.size,sorted.size,sorted.v[0],sorted.size-1,sorted.v[sorted.size-1]);
+        cv_display_bytes(arena.size);printf(".\n");
+        /* no need to call cv_int_free(...) here (there's no 'item_dtr'): we just reset the arena */
+        arena.size = 0;
+    }
+}
+#endif /* NO_ALLOCATOR_TEST */
+
+#ifndef NO_VM_ALLOCATOR_TEST
+/* This test shows 'cvh_vm_allocator_t', an allocator for very large vectors: its buffers are mmap(...) regions */
+/* that grow with mremap(...) on Linux (without copying the items), and that can use transparent huge pages. */
+/* Here it's used together with a page-aligned growth policy, so that every buffer is made of whole huge pages. */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+static void VmAllocatorTest(void) {
+    const size_t num_items = 10000000;
+    cvh_vm_allocator_t vm_allocator;
+    const cvh_growth_policy_t policy = cvh_growth_policy_page_aligned(3,2,CVH_VM_HUGE_PAGE_SIZE);
+    cv_int v;
+    size_t i,num_reallocs=0,last_capacity=0,num_errors=0;
+
+    printf("\nVM ALLOCATOR TEST:\n");
+    cvh_vm_allocator_init(&vm_allocator,1);   /* it must not be moved, and it must outlive the vectors that use it (see cvh_vm_allocator_close(...)) */
+    cv_int_init_with_allocator(&v,NULL,NULL,NULL,NULL,NULL,NULL,&vm_allocator.allocator);
+    cv_int_set_growth_policy(&v,&policy);
+    for (i=0;i<num_items;i++)  {
+        cv_int_push_back_by_val(&v,(int)i);
+        if (v.capacity!=last_capacity) {++num_reallocs;last_capacity=v.capacity;}
+    }
+    printf("pushed %lu items in %lu reallocations. capacity: ",v.size,num_reallocs);cv_display_bytes(v.capacity*sizeof(int));printf(".\n");
+    cv_int_resize(&v,num_items/3);
+    cv_int_shrink_to_fit(&v);   /* it just releases the tail pages */
+    for (i=0;i<v.size;i++) {if (v.v[i]!=(int)i) ++num_errors;}
+    printf("after resize and shrink_to_fit: size=%lu capacity: ",v.size);cv_display_bytes(v.capacity*sizeof(int));printf(" (errors=%lu).\n",num_errors);
+    cv_int_free(&v);
+    cvh_vm_allocator_close(&vm_allocator);
+}
+#endif /* NO_VM_ALLOCATOR_TEST */
+
+#if (!defined(NO_STREAMING_SERIALIZER_TEST) && !defined(CV_NO_STDIO))
+/* This test shows how to serialize a big vector to a file (and back) using a streaming 'cvh_serializer_t'. */
+/* Its buffer has a fixed size: it's flushed to the file (or refilled from it) when needed, */
+/* so that the whole serialized vector is never stored in memory. */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+static void StreamingSerializerTest(void) {
+    const size_t num_items = 1000000, buffer_size = 4096;
+    cv_int v = cv_int_create(NULL), v2 = cv_int_create(NULL);
+    cvh_serializer_t serializer;
+    size_t i,num_errors=0;int ok;
+    FILE* f = tmpfile();    /* any FILE* opened in binary mode works */
+    printf("\nSTREAMING SERIALIZER TEST:\n");
+    if (!f) {printf("Error: tmpfile() failed.\n");return;}
+    cv_int_reserve(&v,num_items);
+    for (i=0;i<num_items;i++) {const int value=(int)i;cv_int_push_back(&v,&value);}
+
+    cvh_serializer_init_file_sink(&serializer,f,buffer_size); /* when 'buffer_size' is zero, CVH_SERIALIZER_STREAM_BUFFER_SIZE is used */
+    cvh_serializer_write_string(&serializer,"cv_int",NULL);
+    cv_int_serialize(&v,&serializer);
+    ok = cvh_serializer_flush(&serializer); /* mandatory at the end: it returns 0 if some write failed */
+    printf("serialized %lu items (%ld bytes written) using a buffer of: ",v.size,ftell(f));cv_display_bytes(serializer.capacity);printf(" (ok=%d).\n",ok);
+    cvh_serializer_free(&serializer);
+
+    rewind(f);
+    cvh_serializer_init_file_source(&serializer,f,buffer_size);
+    {
+        char* name = NULL;
+        ok = cvh_serializer_read_string(&serializer,&name,NULL,NULL);
+        ok = ok && cv_int_deserialize(&v2,&serializer);
+        for (i=0;i<v2.size;i++) {if (v2.v[i]!=(int)i) ++num_errors;}
+        printf("deserialized '%s' (%lu items) using a buffer of: ",name ? name : "",v2.size);cv_display_bytes(serializer.capacity);printf(" (ok=%d, errors=%lu).\n",ok,num_errors);
+        free(name);
+    }
+    cvh_serializer_free(&serializer);
+    fclose(f);
+
+    f = tmpfile();  /* now with a buffer smaller than a single write (the buffer grows when needed) */
+    if (f)  {
+        size_t value = 0;
+        cvh_serializer_init_file_sink(&serializer,f,4);
+        cvh_serializer_write_size_t(&serializer,(size_t)42);
+        cv_int_serialize(&v2,&serializer);
+        ok = cvh_serializer_flush(&serializer);
+        cvh_serializer_free(&serializer);
+        rewind(f);num_errors=0;
+        cvh_serializer_init_file_source(&serializer,f,4);
+        ok = ok && cvh_serializer_read_size_t(&serializer,&value) && value==42;
+        ok = ok && cv_int_deserialize(&v2,&serializer);
+        for (i=0;i<v2.size;i++) {if (v2.v[i]!=(int)i) ++num_errors;}
+        printf("with a buffer of 4 Bytes: %lu items written and read back (ok=%d, errors=%lu).\n",v2.size,ok,num_errors);
+        cvh_serializer_free(&serializer);
+        fclose(f);
+    }
+    cv_int_free(&v2);
+    cv_int_free(&v);
+}
+#endif /* (!defined(NO_STREAMING_SERIALIZER_TEST) && !defined(CV_NO_STDIO)) */
+
+#ifndef NO_MAPPED_LOAD_TEST
+/* This test shows how to load a POD vector without copying its items: 'v.v' points directly into the mapped file. */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+static void MappedLoadTest(void) {
+    const size_t num_items = 1000000;
+    cv_int v = cv_int_create(NULL);
+    cvh_serializer_t serializer = cvh_serializer_create();
+    cvh_mmap_t mapped_file;
+    size_t i,num_errors=0;int ok;
+    printf("\nMAPPED LOAD TEST:\n");
+    for (i=0;i<num_items;i++) {const int value=(int)i;cv_int_push_back(&v,&value);}
+    cv_int_serialize(&v,&serializer);
+    cvh_serializer_save(&serializer,"cv_int_mapped.bin");
+    cvh_serializer_free(&serializer);
+    cv_int_free(&v);
+
+    if (!cvh_mmap_open(&mapped_file,"cv_int_mapped.bin")) {printf("Error: cannot open 'cv_int_mapped.bin'.\n");return;}
+    cvh_serializer_init_mapped(&serializer,&mapped_file);   /* a read-only deserializer of the mapped file */
+    ok = cv_int_deserialize_mapped(&v,&serializer);  /* no item is copied here: the file pages are loaded lazily */
+    for (i=0;i<v.size;i++) {if (v.v[i]!=(int)i) ++num_errors;}
+    printf("deserialized %lu items (ok=%d, errors=%lu). Zero-copy: %s.\n",v.size,ok,num_errors,
+           ((unsigned char*)v.v>=mapped_file.v && (unsigned char*)v.v<mapped_file.v+mapped_file.size) ? "yes" : "no");
+    v.v[0] = -1;    /* allowed: the mapping is copy-on-write (the file is not modified) */
+    {const int value=(int)num_items;cv_int_push_back(&v,&value);}   /* when the vector grows, its items are moved to the heap */
+    printf("after push_back: v.size=%lu v[0]=%d v[%lu]=%d.\n",v.size,v.v[0],v.size-1,v.v[v.size-1]);
+    cv_int_free(&v);    /* vectors using 'mapped_file.allocator' must be freed before calling cvh_mmap_close(...) */
+    cvh_serializer_free(&serializer);
+    cvh_mmap_close(&mapped_file);
+}
+#endif /* NO_MAPPED_LOAD_TEST */
+
+#ifndef NO_SORTED_RANGE_TEST
+/* This test compares inserting a batch of items into a sorted vector one by one, and with cv_xxx_insert_sorted_range(...). */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+#include <time.h>   /* clock */
+static void SortedRangeTest(void) {
+    const size_t num_items = 100000, num_batch_items = 50000;
+    cv_int v = cv_int_create(&int_cmp), v2 = cv_int_create(&int_cmp);
+    int* batch = (int*) malloc(num_batch_items*sizeof(int));
+    size_t i,num_inserted,num_errors=0;
+    clock_t start;
+    printf("\nSORTED RANGE TEST:\n");
+    for (i=0;i<num_items;i++) {const int value=(int)(i*2);cv_int_push_back(&v,&value);}   /* even numbers (sorted) */
+    for (i=0;i<num_batch_items;i++) batch[i] = (int)((i*7919)%num_batch_items)*4+1;        /* odd numbers (unsorted) */
+    batch[num_batch_items-1] = 0;   /* already present */
+    cv_int_cpy(&v2,&v);
+
+    start = clock();
+    for (i=0,num_inserted=0;i<num_batch_items;i++) {int match;cv_int_insert_sorted(&v2,&batch[i],&match,0);if (!match) ++num_inserted;}
+    printf("cv_int_insert_sorted(...):       inserted %lu/%lu items in %1.3f s.\n",num_inserted,num_batch_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+    start = clock();
+    num_inserted = cv_int_insert_sorted_range(&v,batch,num_batch_items,0);
+    printf("cv_int_insert_sorted_range(...): inserted %lu/%lu items in %1.3f s.\n",num_inserted,num_batch_items,(double)(clock()-start)/CLOCKS_PER_SEC);
+
+    if (v.size!=v2.size) ++num_errors;
+    for (i=0;i<v.size && i<v2.size;i++) {if (v.v[i]!=v2.v[i] || (i>0 && v.v[i-1]>=v.v[i])) ++num_errors;}
+    printf("v.size=%lu (errors=%lu).\n",v.size,num_errors);
+    free(batch);
+    cv_int_free(&v2);
+    cv_int_free(&v);
+}
+#endif /* NO_SORTED_RANGE_TEST */
+
+#ifndef NO_SORT_TEST
+/* This test compares cv_xxx_sort(...) with qsort(...) on a big vector (random and then almost sorted items). */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+static int int_qsort_cmp(const void* a,const void* b) {return int_cmp((const int*)a,(const int*)b);}   /* qsort needs 'const void*' arguments */
+#include <time.h>   /* clock */
+static void SortTest(void) {
+    const size_t num_items = 10000000;
+    cv_int v = cv_int_create(&int_cmp), v2 = cv_int_create(&int_cmp);
+    size_t i,num_errors=0;int pass;
+    unsigned seed = 12345;
+    clock_t start;
+    printf("\nSORT TEST:\n");
+    cv_int_resize(&v,num_items);
+    for (i=0;i<num_items;i++) {seed = seed*1664525u+1013904223u;v.v[i] = (int)(seed>>1);}
+    for (pass=0;pass<2;pass++)  {
+        if (pass==1) {for (i=0;i<num_items;i+=1000) v.v[i] = (int)i;}   /* almost sorted now */
+        cv_int_cpy(&v2,&v);
+        start = clock();
+        qsort(v2.v,v2.size,sizeof(int),&int_qsort_cmp);
+        printf("%s qsort(...):       %lu items in %1.3f s.\n",pass==0 ? "random:       " : "almost sorted:",v2.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+        start = clock();
+        cv_int_sort(&v);
+        printf("%s cv_int_sort(...): %lu items in %1.3f s.\n",pass==0 ? "random:       " : "almost sorted:",v.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+        for (i=0;i<num_items;i++) {if (v.v[i]!=v2.v[i]) ++num_errors;}
+    }
+    printf("errors=%lu.\n",num_errors);
+    cv_int_free(&v2);
+    cv_int_free(&v);
+}
+#endif /* NO_SORT_TEST */
+
+#ifndef NO_RADIX_SORT_TEST
+/* This test compares cv_xxx_radix_sort_by_key(...) with cv_xxx_sort(...), and shows that the radix sort is stable (on float keys). */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+static unsigned long long int_radix_key(const int* a) {return cv_radix_key_from_int(*a);}
+typedef struct {
+    float key;
+    int id;
+} scored_item;
+CV_DECLARE_AND_DEFINE(scored_item) /* for 'cv_scored_item' */
+static unsigned long long scored_item_radix_key(const scored_item* a) {return cv_radix_key_from_float(a->key);}
+#include <time.h>   /* clock */
+static void RadixSortTest(void) {
+    const size_t num_items = 10000000, num_scored_items = 1000000;
+    cv_int v = cv_int_create(&int_cmp), v2 = cv_int_create(&int_cmp);
+    cv_scored_item s = cv_scored_item_create(NULL);
+    size_t i,num_errors=0;
+    unsigned seed = 12345;
+    clock_t start;
+    printf("\nRADIX SORT TEST:\n");
+    cv_int_resize(&v,num_items);
+    for (i=0;i<num_items;i++) {seed = seed*1664525u+1013904223u;v.v[i] = (int)seed;}  /* negative values too */
+    cv_int_cpy(&v2,&v);
+    start = clock();
+    cv_int_sort(&v2);
+    printf("cv_int_sort(...):              %lu items in %1.3f s.\n",v2.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+    start = clock();
+    cv_int_radix_sort_by_key(&v,&int_radix_key);
+    printf("cv_int_radix_sort_by_key(...): %lu items in %1.3f s.\n",v.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+    for (i=0;i<num_items;i++) {if (v.v[i]!=v2.v[i]) ++num_errors;}
+
+    cv_scored_item_resize(&s,num_scored_items);
+    for (i=0;i<num_scored_items;i++) {seed = seed*1664525u+1013904223u;s.v[i].key = (float)((int)(seed>>16)%2001-1000)*0.25f;s.v[i].id = (int)i;}
+    start = clock();
+    cv_scored_item_radix_sort_by_key(&s,&scored_item_radix_key);
+    printf("cv_scored_item_radix_sort_by_key(...): %lu items (float keys) in %1.3f s.\n",s.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+    for (i=1;i<num_scored_items;i++) {
+        if (s.v[i-1].key>s.v[i].key) ++num_errors;
+        else if (s.v[i-1].key==s.v[i].key && s.v[i-1].id>s.v[i].id) ++num_errors;  /* stability check */
+    }
+    printf("s.v[0].key=%1.2f s.v[%lu].key=%1.2f (errors=%lu).\n",s.v[0].key,s.size-1,s.v[s.size-1].key,num_errors);
+    cv_scored_item_free(&s);
+    cv_int_free(&v2);
+    cv_int_free(&v);
+}
+#endif /* NO_RADIX_SORT_TEST */
+
+#ifndef NO_SEARCH_INDEX_TEST
+/* This test compares cv_xxx_binary_search(...) with cv_xxx_search_index_find(...) on a big sorted vector (without duplicates, where they can return different equal items). */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+#include <time.h>   /* clock */
+static void SearchIndexTest(void) {
+    const size_t num_items = 10000000, num_searches = 10000000;
+    cv_int v = cv_int_create(&int_cmp);
+    cv_int_search_index index;
+    int* keys = (int*) malloc(num_searches*sizeof(int));
+    size_t i,num_matches=0,num_errors=0,*positions = (size_t*) malloc(num_searches*sizeof(size_t));
+    unsigned seed = 12345;
+    clock_t start;
+    printf("\nSEARCH INDEX TEST:\n");
+    cv_int_resize(&v,num_items);
+    for (i=0;i<num_items;i++) v.v[i] = (int)(i*2);  /* even numbers (sorted) */
+    for (i=0;i<num_searches;i++) {seed = seed*1664525u+1013904223u;keys[i] = (int)((seed>>4)%(2*num_items+2));}  /* half of them are missing */
+    start = clock();
+    cv_int_search_index_init(&index,&v);
+    printf("cv_int_search_index_init(...):  %lu items in %1.3f s.\n",v.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+    start = clock();
+    for (i=0;i<num_searches;i++) {int match;positions[i] = cv_int_binary_search(&v,&keys[i],&match);if (match) ++num_matches;}
+    printf("cv_int_binary_search(...):      %lu searches in %1.3f s (%lu matches).\n",num_searches,(double)(clock()-start)/CLOCKS_PER_SEC,num_matches);
+    num_matches = 0;
+    start = clock();
+    for (i=0;i<num_searches;i++) {int match;if (cv_int_search_index_find(&index,&keys[i],&match)!=positions[i]) ++num_errors;if (match) ++num_matches;}
+    printf("cv_int_search_index_find(...):  %lu searches in %1.3f s (%lu matches).\n",num_searches,(double)(clock()-start)/CLOCKS_PER_SEC,num_matches);
+    printf("errors=%lu.\n",num_errors);
+    cv_int_search_index_free(&index);
+    free(positions);
+    free(keys);
+    cv_int_free(&v);
+}
+#endif /* NO_SEARCH_INDEX_TEST */
+
+#ifndef NO_CMP_INLINE_TEST
+/* This test compares cv_xxx_sort(...) and cv_xxx_binary_search(...) with their CV_CMP_INLINE(a,b) versions. */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+#define CV_CMP_INLINE(a,b) ((*(a)>*(b))-(*(a)<*(b)))  /* same as int_cmp(a,b) */
+CV_DECLARE_AND_DEFINE_CMP_INLINE(int) /* for 'cv_int_sort_inline', 'cv_int_binary_search_inline' and 'cv_int_insert_sorted_inline' */
+#undef CV_CMP_INLINE
+#include <time.h>   /* clock */
+static void CmpInlineTest(void) {
+    const size_t num_items = 10000000, num_searches = 10000000;
+    cv_int v = cv_int_create(&int_cmp), v2 = cv_int_create(&int_cmp);
+    int* keys = (int*) malloc(num_searches*sizeof(int));
+    size_t i,num_matches=0,num_errors=0,*positions = (size_t*) malloc(num_searches*sizeof(size_t));
+    unsigned seed = 12345;
+    clock_t start;
+    printf("\nCMP INLINE TEST:\n");
+    cv_int_resize(&v,num_items);
+    for (i=0;i<num_items;i++) {seed = seed*1664525u+1013904223u;v.v[i] = (int)(seed>>4);}
+    cv_int_cpy(&v2,&v);
+    start = clock();
+    cv_int_sort(&v);
+    printf("cv_int_sort(...):                   %lu items in %1.3f s.\n",v.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+    start = clock();
+    cv_int_sort_inline(&v2);
+    printf("cv_int_sort_inline(...):            %lu items in %1.3f s.\n",v2.size,(double)(clock()-start)/CLOCKS_PER_SEC);
+    for (i=0;i<num_items;i++) {if (v.v[i]!=v2.v[i]) ++num_errors;}
+    for (i=0;i<num_searches;i++) {seed = seed*1664525u+1013904223u;keys[i] = (i%2) ? v.v[(seed>>4)%num_items] : (int)(seed>>4);}  /* about half of them are missing */
+    start = clock();
+    for (i=0;i<num_searches;i++) {int match;positions[i] = cv_int_binary_search(&v,&keys[i],&match);if (match) ++num_matches;}
+    printf("cv_int_binary_search(...):          %lu searches in %1.3f s (%lu matches).\n",num_searches,(double)(clock()-start)/CLOCKS_PER_SEC,num_matches);
+    num_matches = 0;
+    start = clock();
+    for (i=0;i<num_searches;i++) {
+        /* cv_int_binary_search(...) can return any of the equal items, cv_int_binary_search_inline(...) always returns the first one */
+        int match;const size_t position = cv_int_binary_search_inline(&v,&keys[i],&match);
+        if (match) {++num_matches;if (v.v[position]!=v.v[positions[i]]) ++num_errors;}
+        else if (position!=positions[i]) ++num_errors;
+    }
+    printf("cv_int_binary_search_inline(...):   %lu searches in %1.3f s (%lu matches).\n",num_searches,(double)(clock()-start)/CLOCKS_PER_SEC,num_matches);
+    printf("errors=%lu.\n",num_errors);
+    free(positions);
+    free(keys);
+    cv_int_free(&v2);
+    cv_int_free(&v);
+}
+#endif /* NO_CMP_INLINE_TEST */
+
+#ifndef NO_POD_TEST
+/* This test compares cv_xxx_push_back(...) of a small struct defined with CV_DECLARE_AND_DEFINE(...) and CV_DECLARE_AND_DEFINE_POD(...) */
+typedef struct {float x,y,z;} vec3;
+typedef vec3 vec3_pod;  /* same struct: we just need another name for the second vector type */
+CV_DECLARE_AND_DEFINE(vec3)         /* for 'cv_vec3' */
+CV_DECLARE_AND_DEFINE_POD(vec3_pod) /* for 'cv_vec3_pod' (item_ctr, item_dtr and item_cpy must be NULL) */
+#include <time.h>   /* clock */
+static void PodTest(void) {
+    const size_t num_items = 20000000;
+    const int num_runs = 5;
+    cv_vec3 v = cv_vec3_create(NULL);
+    cv_vec3_pod vp = cv_vec3_pod_create(NULL);
+    size_t i,num_errors=0;int run;
+    clock_t start;double seconds=0,seconds_pod=0;
+    printf("\nPOD TEST:\n");
+    for (run=0;run<num_runs;run++)  {
+        cv_vec3_clear(&v);cv_vec3_pod_clear(&vp);   /* the capacity is kept after the first run */
+        start = clock();
+        for (i=0;i<num_items;i++) {vec3 p;p.x=(float)i;p.y=p.x*0.5f;p.z=-p.x;cv_vec3_push_back(&v,&p);}
+        seconds+=(double)(clock()-start)/CLOCKS_PER_SEC;
+        start = clock();
+        for (i=0;i<num_items;i++) {vec3_pod p;p.x=(float)i;p.y=p.x*0.5f;p.z=-p.x;cv_vec3_pod_push_back(&vp,&p);}
+        seconds_pod+=(double)(clock()-start)/CLOCKS_PER_SEC;
+    }
+    printf("cv_vec3_push_back(...):     %d x %lu items in %1.3f s.\n",num_runs,num_items,seconds);
+    printf("cv_vec3_pod_push_back(...): %d x %lu items in %1.3f s.\n",num_runs,num_items,seconds_pod);
+    for (i=0;i<num_items;i++) {if (v.v[i].x!=vp.v[i].x || v.v[i].y!=vp.v[i].y || v.v[i].z!=vp.v[i].z) ++num_errors;}
+    printf("errors=%lu.\n",num_errors);
+    cv_vec3_pod_free(&vp);
+    cv_vec3_free(&v);
+}
+#endif /* NO_POD_TEST */
+
+#if (!defined(NO_PARALLEL_TEST) && defined(CV_ENABLE_PARALLEL))
+/* This test compares cv_xxx_parallel_sort(...) and cv_xxx_parallel_cpy(...) with their serial versions (CV_ENABLE_PARALLEL must be defined globally). */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+#ifndef C_VECTOR_int_cmp_H
+#define C_VECTOR_int_cmp_H
+static int int_cmp(const int* a,const int* b) {return (*a)<(*b)?-1:((*a)>(*b)?1:0);}
+#endif /* C_VECTOR_int_cmp_H */
+static void int_scramble(int* item,size_t position,void* user_data) {
+    const unsigned seed = *((const unsigned*)user_data)+(unsigned)position*2654435761u;
+    *item = (int)((seed^(seed>>15))*2246822519u);
+}
+#include <time.h>   /* clock_gettime (clock() measures the CPU time of all the threads) */
+static double parallel_test_seconds(void) {struct timespec t;clock_gettime(CLOCK_MONOTONIC,&t);return (double)t.tv_sec+(double)t.tv_nsec*1e-9;}
+static void ParallelTest(void) {
+    const size_t num_items = 20000000;
+    const int num_threads = 4;  /* <=0 means: CV_PARALLEL_NUM_THREADS (or all the cores) */
+    cv_int v = cv_int_create(&int_cmp), v2 = cv_int_create(&int_cmp);
+    size_t i,num_errors=0;
+    unsigned seed = 12345;
+    double start;
+    printf("\nPARALLEL TEST (%lu threads):\n",cv_parallel_num_threads(num_threads,num_items));
+    cv_int_resize(&v,num_items);
+    start = parallel_test_seconds();
+    cv_int_parallel_for_each(&v,&int_scramble,&seed,num_threads);
+    printf("cv_int_parallel_for_each(...): %lu items in %1.3f s.\n",v.size,parallel_test_seconds()-start);
+    start = parallel_test_seconds();
+    cv_int_cpy(&v2,&v);
+    printf("cv_int_cpy(...):               %lu items in %1.3f s.\n",v2.size,parallel_test_seconds()-start);
+    start = parallel_test_seconds();
+    cv_int_parallel_cpy(&v2,&v,num_threads);
+    printf("cv_int_parallel_cpy(...):      %lu items in %1.3f s.\n",v2.size,parallel_test_seconds()-start);
+    start = parallel_test_seconds();
+    cv_int_sort(&v2);
+    printf("cv_int_sort(...):              %lu items in %1.3f s.\n",v2.size,parallel_test_seconds()-start);
+    start = parallel_test_seconds();
+    cv_int_parallel_sort(&v,num_threads);
+    printf("cv_int_parallel_sort(...):     %lu items in %1.3f s.\n",v.size,parallel_test_seconds()-start);
+    for (i=0;i<num_items;i++) {if (v.v[i]!=v2.v[i]) ++num_errors;}
+    printf("errors=%lu.\n",num_errors);
+    cv_int_free(&v2);
+    cv_int_free(&v);
+}
+#endif /* (!defined(NO_PARALLEL_TEST) && defined(CV_ENABLE_PARALLEL)) */
+
+#if (!defined(NO_ALLOC_STATS_TEST) && defined(CV_ENABLE_ALLOC_STATS))
+/* This test shows the allocation counters and the allocation callback (CV_ENABLE_ALLOC_STATS must be defined globally). */
+#ifndef C_VECTOR_int_H
+#define C_VECTOR_int_H
+CV_DECLARE_AND_DEFINE(int) /* for 'cv_int' */
+#endif /* C_VECTOR_int_H */
+static void alloc_stats_callback(const cvh_alloc_event_t* e,void* user_data) {
+    size_t* num_events = (size_t*) user_data;
+    if ((*num_events)++<4) printf("  [callback] %s: size=%lu capacity %lu -> %lu (%lu bytes per item)\n",e->type_name,e->size,e->old_capacity,e->new_capacity,e->item_size);
+}
+static void alloc_stats_display(const char* type_name,const cvh_alloc_stats_t* s) {
+    printf("%s: allocs=%lu reallocs=%lu frees=%lu bytes_copied=%lu capacity_bytes=%lu peak_capacity_bytes=%lu wasted_bytes=%lu.\n",type_name,
+           s->num_allocs,s->num_reallocs,s->num_frees,s->num_bytes_copied,s->capacity_bytes,s->peak_capacity_bytes,s->wasted_bytes);
+}
+static void AllocStatsTest(void) {
+    const size_t num_items = 100000;
+    cv_int v = cv_int_create(NULL);
+    cvh_serializer_t s = cvh_serializer_create();
+    cvh_alloc_stats_t stats;
+    size_t i,num_events=0;
+    printf("\nALLOC STATS TEST:\n");
+    cv_int_reset_alloc_stats();cvh_serializer_reset_alloc_stats();
+    cvh_set_alloc_callback(&alloc_stats_callback,&num_events);
+    for (i=0;i<num_items;i++) cv_int_push_back_by_val(&v,(int)i);
+    cv_int_get_alloc_stats(&stats);alloc_stats_display("cv_int (push_back)",&stats);
+    cv_int_serialize(&v,&s);
+    cv_int_free(&v);
+    cv_int_get_alloc_stats(&stats);alloc_stats_display("cv_int (free)",&stats);
+    cvh_serializer_free(&s);
+    cvh_serializer_get_alloc_stats(&stats);alloc_stats_display("cvh_serializer_t",&stats);
+    cvh_set_alloc_callback(NULL,NULL);
+    printf("callback events: %lu.\n",num_events);
+}
+#endif /* (!defined(NO_ALLOC_STATS_TEST) && defined(CV_ENABLE_ALLOC_STATS)) */
+
+
 #ifndef NO_CPP_TEST
 #ifdef __cplusplus
 
@@ -897,6 +1510,42 @@ int main(int argc,char* argv[])
 #if (!defined(NO_CVH_STRING_T_TEST) && !defined(CV_NO_CVH_STRING_T))
     CvhStringTTest();
 #endif
+#ifndef NO_ALLOCATOR_TEST
+    AllocatorTest();
+#endif /* NO_ALLOCATOR_TEST */
+#ifndef NO_VM_ALLOCATOR_TEST
+    VmAllocatorTest();
+#endif /* NO_VM_ALLOCATOR_TEST */
+#if (!defined(NO_STREAMING_SERIALIZER_TEST) && !defined(CV_NO_STDIO))
+    StreamingSerializerTest();
+#endif
+#ifndef NO_MAPPED_LOAD_TEST
+    MappedLoadTest();
+#endif /* NO_MAPPED_LOAD_TEST */
+#ifndef NO_SORTED_RANGE_TEST
+    SortedRangeTest();
+#endif /* NO_SORTED_RANGE_TEST */
+#ifndef NO_SORT_TEST
+    SortTest();
+#endif /* NO_SORT_TEST */
+#ifndef NO_RADIX_SORT_TEST
+    RadixSortTest();
+#endif /* NO_RADIX_SORT_TEST */
+#ifndef NO_SEARCH_INDEX_TEST
+    SearchIndexTest();
+#endif /* NO_SEARCH_INDEX_TEST */
+#ifndef NO_CMP_INLINE_TEST
+    CmpInlineTest();
+#endif /* NO_CMP_INLINE_TEST */
+#ifndef NO_POD_TEST
+    PodTest();
+#endif /* NO_POD_TEST */
+#if (!defined(NO_PARALLEL_TEST) && defined(CV_ENABLE_PARALLEL))
+    ParallelTest();
+#endif /* (!defined(NO_PARALLEL_TEST) && defined(CV_ENABLE_PARALLEL)) */
+#if (!defined(NO_ALLOC_STATS_TEST) && defined(CV_ENABLE_ALLOC_STATS))
+    AllocStatsTest();
+#endif /* (!defined(NO_ALLOC_STATS_TEST) && defined(CV_ENABLE_ALLOC_STATS)) */
 
 #ifndef NO_CPP_TEST
 #ifdef __cplusplus
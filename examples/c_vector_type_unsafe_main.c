@@ -136,6 +136,10 @@ v content:
     2) "Florence"		population: 15000
     3) "Venice"		population: 25000
 
+RADIX SORT TEST:
+Paris (987), Vienna (1156), Lisbon (1255), Madrid (1561), Berlin (1701), Bonn (1701), Prague (1784), Rome (1871)
+sorted 1000000 records (errors=0).
+
 ======= THIS OUTPUT IS PRESENT ONLY WHEN this file is compiled as c++: ======
 
 CPP MODE TEST:
@@ -197,6 +201,7 @@ v[2] = {1:	[6]};
 /*#define NO_COMPLEXTEST*/
 /*#define NO_CPP_TEST*/
 /*#define NO_CVH_STRING_T_TEST*/
+/*#define NO_RADIX_SORT_TEST*/
 
 #ifndef NO_SIMPLE_TEST
 /* The struct we'll use in a vector */
@@ -815,6 +820,39 @@ void CvhStringTTest(void)   {
 }
 #endif /* (defined(NO_CVH_STRING_T_TEST) && !defined(CV_NO_CVH_STRING_T)) */
 
+#ifndef NO_RADIX_SORT_TEST
+#include <stddef.h> /* offsetof */
+typedef struct {
+    const char* name;
+    unsigned short year;    /* the radix sort key */
+    int id;
+} record_t;
+void RadixSortTest(void)   {
+    const record_t records[] = {{"Rome",1871,0},{"Paris",987,1},{"Berlin",1701,2},{"Madrid",1561,3},
+                                {"Vienna",1156,4},{"Lisbon",1255,5},{"Prague",1784,6},{"Bonn",1701,7}};
+    const size_t num_records = sizeof(records)/sizeof(records[0]), num_items = 1000000;
+    cvector v = cvector_create(sizeof(record_t),NULL);
+    const record_t* pr = NULL;
+    size_t i,num_errors=0;
+    unsigned seed = 12345;
+
+    printf("\nRADIX SORT TEST:\n");
+    cvector_insert_range_at(&v,records,num_records,0);
+    cvector_radix_sort(&v,offsetof(record_t,year),sizeof(unsigned short));  /* stable: "Berlin" stays before "Bonn" */
+    pr = (const record_t*) v.v;
+    for (i=0;i<v.size;i++) printf("%s%s (%u)",i==0?"":", ",pr[i].name,pr[i].year);
+    printf("\n");
+
+    cvector_clear(&v);cvector_reserve(&v,num_items);
+    for (i=0;i<num_items;i++) {record_t r;seed = seed*1664525u+1013904223u;r.name = NULL;r.year = (unsigned short)(seed>>20);r.id = (int)i;cvector_push_back(&v,&r);}
+    cvector_radix_sort(&v,offsetof(record_t,year),sizeof(unsigned short));
+    pr = (const record_t*) v.v;
+    for (i=1;i<v.size;i++) {if (pr[i-1].year>pr[i].year || (pr[i-1].year==pr[i].year && pr[i-1].id>pr[i].id)) ++num_errors;}
+    printf("sorted %lu records (errors=%lu).\n",v.size,num_errors);
+    cvector_free(&v);
+}
+#endif /* NO_RADIX_SORT_TEST */
+
 
 #ifndef NO_CPP_TEST
 #ifdef __cplusplus
@@ -935,6 +973,9 @@ int main(int argc,char* argv[])
 #if (!defined(NO_CVH_STRING_T_TEST) && !defined(CV_NO_CVH_STRING_T))
     CvhStringTTest();
 #endif
+#ifndef NO_RADIX_SORT_TEST
+    RadixSortTest();
+#endif /* NO_RADIX_SORT_TEST */
 
 #ifndef NO_CPP_TEST
 #ifdef __cplusplus
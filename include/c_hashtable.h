@@ -34,6 +34,13 @@ freely, subject to the following restrictions:
 							//		'xor-folding' or 'fibonacci-folding' (please search this file for: 'xor-folding' or 'fibonacci-folding' for further info)
    CH_USE_VOID_PTRS_IN_CMP_FCT  (optional: if you want to share cmp_fcts with c style functions like qsort)
    CHV_KEY_SUPPORT_EQUALITY_CMP_IN_UNSORTED_SEARCH (optional, but affects only unsorted buckets, which we should never use)
+   CH_USE_DYNAMIC_BUCKETS       (optional: heap-allocated bucket array that grows with incremental rehashing. See history for version 1.11)
+   CH_USE_OPEN_ADDRESSING       (optional: flat open-addressing table with control bytes instead of bucket vectors. See history for version 1.12)
+   CH_USE_CACHED_HASHES         (optional: every item stores a 32-bit hash, and buckets are sorted by (hash,key). See history for version 1.13)
+   CH_USE_BUCKET_SLABS          (optional: bucket arrays are carved from large pages owned by the hashtable. See history for version 1.15)
+   CH_USE_STRIPED_LOCKS         (optional: adds thread-safe 'ch_xxx_concurrent_xxx(...)' functions with a lock per stripe of buckets. See history for version 1.16)
+   CH_USE_RCU_READS             (optional: it needs CH_USE_STRIPED_LOCKS. 'ch_xxx_concurrent_get(...)' takes no locks, and writers copy buckets on write. See history for version 1.17)
+   CH_USE_STATS                 (optional: the hashtable counts lookups, key comparisons, reallocations and moved bytes. See 'ch_xxx_get_stats(...)' and history for version 1.20)
    C_HASHTABLE_IMPLEMENTATION   	(optional: it needs CH_ENABLE_DECLARATION_AND_DEFINITION. See history for version 1.04)
    C_HASHTABLE_FORCE_DECLARATION  	(optional: it needs CH_ENABLE_DECLARATION_AND_DEFINITION. See history for version 1.04)
 
@@ -45,6 +52,21 @@ freely, subject to the following restrictions:
    CH_DISABLE_CLEARING_ITEM_MEMORY      // faster with this defined
    CH_ENABLE_DECLARATION_AND_DEFINITION // slower with this defined (but saves memory)
    CH_NO_PLACEMENT_NEW                  // (c++ mode only) it does not define (unused) helper stuff like: CH_PLACEMENT_NEW, cpp_ctr,cpp_dtr,cpp_cpy,cpp_cmp
+   CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR   // (CH_USE_DYNAMIC_BUCKETS only) defaults to 2: the bucket array doubles when num_items>num_buckets*CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR
+   CH_DYNAMIC_BUCKETS_REHASH_STEP       // (CH_USE_DYNAMIC_BUCKETS only) defaults to 2: number of old buckets moved by every insertion/removal while rehashing
+   CH_NO_SIMD                           // (CH_USE_OPEN_ADDRESSING only) disables the SSE2 group probing (a scalar fallback is used)
+   CH_BATCH_SIZE                        // defaults to 16: number of keys hashed and prefetched together by 'ch_xxx_get_batch(...)' and 'ch_xxx_get_or_insert_batch(...)'
+   CH_PREFETCH(ADDR)                    // defaults to __builtin_prefetch(ADDR) (or to _mm_prefetch(ADDR,_MM_HINT_T0) with Visual C++). It can be defined as a no-op
+   CH_SLAB_PAGE_SIZE                    // (CH_USE_BUCKET_SLABS only) defaults to 65536: size in bytes of the pages allocated by the bucket slabs (a multiple of 16, at least 16384)
+   CH_NUM_LOCK_STRIPES                  // (CH_USE_STRIPED_LOCKS only) defaults to 64: number of locks (bucket 'i' is protected by lock 'i%CH_NUM_LOCK_STRIPES')
+   CH_ATOMIC_CAS(PTR,OLD,NEW)           // (CH_USE_STRIPED_LOCKS only) defaults to __sync_bool_compare_and_swap(...) (or to InterlockedCompareExchange(...) with Visual C++)
+   CH_ATOMIC_ADD(PTR,VALUE)             // (CH_USE_STRIPED_LOCKS only) defaults to __sync_fetch_and_add(...) (or to InterlockedExchangeAdd(...) with Visual C++)
+   CH_ATOMIC_LOAD(PTR)                  // (CH_USE_STRIPED_LOCKS only) defaults to __atomic_load_n(PTR,__ATOMIC_RELAXED) (or to a volatile read)
+   CH_THREAD_YIELD()                    // (CH_USE_STRIPED_LOCKS only) defaults to sched_yield() (or to SwitchToThread() on Windows): called by threads waiting for a lock
+   CH_ATOMIC_LOAD_PTR(PTR)              // (CH_USE_RCU_READS only) defaults to __atomic_load_n(PTR,__ATOMIC_ACQUIRE) (or to a volatile read). 'PTR' is a 'void**'
+   CH_ATOMIC_STORE_PTR(PTR,VALUE)       // (CH_USE_RCU_READS only) defaults to __atomic_store_n(PTR,VALUE,__ATOMIC_RELEASE) (or to a volatile write). 'PTR' is a 'void**'
+   CH_RCU_NUM_READER_SLOTS              // (CH_USE_RCU_READS only) defaults to 16: number of reader counters (readers are spread over them by stack address)
+   CH_RCU_RETIRE_BATCH                  // (CH_USE_RCU_READS only) defaults to 64: number of replaced bucket arrays that are freed together after a grace period
 
    CH_MALLOC
    CH_REALLOC
@@ -68,12 +90,148 @@ freely, subject to the following restrictions:
 #endif
 
 #ifndef C_HASHTABLE_VERSION
-#define C_HASHTABLE_VERSION         "1.10 rev2"
-#define C_HASHTABLE_VERSION_NUM     0110
+#define C_HASHTABLE_VERSION         "1.21"
+#define C_HASHTABLE_VERSION_NUM     0121
 #endif
 
 
 /* HISTORY:
+   C_HASHTABLE_VERSION_NUM 0121:
+   -> added 'ch_xxx_set_growth_policy(ht,&policy)': the optional 'cvh_growth_policy_t' (shared with "c_vector.h" and "c_vector_type_unsafe.h")
+      replaces the default (1.5x) growth of the sorted buckets (e.g. cvh_growth_policy_fixed_chunk(...) bounds the unused memory of big buckets).
+      It's copied by 'ch_xxx_cpy(...)' and swapped by 'ch_xxx_swap(...)', and it must outlive the hashtable.
+      It's ignored by CH_USE_OPEN_ADDRESSING (its slot array is always a power of two).
+
+   C_HASHTABLE_VERSION_NUM 0120:
+   -> added the (optional) scoped definition CH_USE_STATS (it can't be used with CH_USE_STRIPED_LOCKS, because
+      its counters are not atomic). When it's defined, the hashtable has a (read-only) 'ch_stats_t stats' field,
+      whose counters are incremented by the hot paths:
+      -> 'num_lookups', 'num_hits' and 'num_misses': every 'ch_xxx_get(...)', 'ch_xxx_get_or_insert(...)' and 'ch_xxx_remove(...)'
+         (and their overloads and batch versions) is a lookup, that is either a hit or a miss
+      -> 'num_inserts' and 'num_removes': items actually inserted or removed
+      -> 'num_key_cmps': calls to 'key_cmp' (or to memcmp, when it's NULL): 'num_key_cmps/num_lookups' measures the quality of 'key_hash'
+      -> 'num_reallocs': (re)allocations of bucket arrays (and of the bucket array itself, or of the slot array)
+      -> 'num_bytes_moved': bytes moved by memmove(...) when items are inserted into (or removed from) the middle of a sorted bucket
+      Added 'ch_xxx_get_stats(ht,&stats)' and 'ch_xxx_reset_stats(ht)' (and their fake member functions), available with CH_USE_STATS only.
+      The counters are kept by 'ch_xxx_swap(...)' and 'ch_xxx_shrink_to_fit(...)', but not copied by 'ch_xxx_cpy(...)'.
+      Without CH_USE_STATS the hot paths don't change at all.
+      See the STATS TEST in "c_hashtable_main.c".
+
+   C_HASHTABLE_VERSION_NUM 0119:
+   -> added 'ch_xxx_build_from(ht,items,num_items)' (and its fake member function). It replaces the content of 'ht'
+      with an unsorted array of key/value items in a single bulk load: every key is hashed once, the items of every bucket
+      are counted, every bucket array is allocated once (with its exact size), the items are copied to their buckets
+      and then every bucket is sorted in place (with a stable merge sort, so that the last of duplicated keys wins).
+      With CH_USE_DYNAMIC_BUCKETS the bucket array is sized for 'num_items' first (no incremental rehash is started),
+      and with CH_USE_OPEN_ADDRESSING the slot array is grown once and the items are just inserted one by one.
+      See the BUILD FROM TEST in "c_hashtable_main.c" for a comparison with 'ch_xxx_get_or_insert(...)'.
+
+   C_HASHTABLE_VERSION_NUM 0118:
+   -> added 'ch_xxx_serialize(ht,serializer,key_serialize,value_serialize)' and 'ch_xxx_deserialize(ht,deserializer,key_deserialize,value_deserialize)'.
+      They use the 'cvh_serializer_t' of "c_vector.h" (or of "c_vector_type_unsafe.h"), so they are available only when
+      one of these two headers is included before <c_hashtable.h>. The callbacks are optional: when both are NULL keys and values
+      are plain-old-data and every bucket is written (and read back) as a single block of items, without touching them one by one.
+      When only one of them is NULL, its (plain-old-data) key or value is just copied.
+      The snapshot layout is: [size_t num_items][size_t num_buckets][size_t item_size] then 'num_buckets' times:
+      [size_t bucket_size][items]. 'item_size' is sizeof(item) when both callbacks are NULL (0 otherwise), and 'num_buckets' is 0
+      with CH_USE_OPEN_ADDRESSING (or while CH_USE_DYNAMIC_BUCKETS is rehashing): in this case a single block of 'num_items' items follows.
+      When the reader has the same number of buckets (CH_USE_DYNAMIC_BUCKETS just allocates them), buckets are restored as they are
+      (after checking that the 'key_hash' of their first item still maps to them). Otherwise every item is inserted again.
+      Like the vector (de)serialization, the snapshot is NOT endian-independent (and its plain-old-data items are NOT portable).
+
+   C_HASHTABLE_VERSION_NUM 0117:
+   -> added the (optional) scoped definition CH_USE_RCU_READS (it needs CH_USE_STRIPED_LOCKS).
+      When it's defined, 'ch_xxx_concurrent_get(...)' takes no locks at all (RCU-style), so that readers never wait
+      for writers and never write to shared cache lines (except one reader counter):
+      -> every bucket array starts with a small header ('ch_rcu_block_header') that stores its number of items
+      -> 'ch_xxx_concurrent_set(...)', 'ch_xxx_concurrent_update(...)' and 'ch_xxx_concurrent_remove(...)' still lock
+         their stripe, but they never modify a bucket array in place: they build a modified copy of it and publish it
+         with an atomic (release) store (see CH_ATOMIC_STORE_PTR). Readers see either the old or the new array
+      -> replaced arrays are 'retired' to the hashtable ('rcu'), and every CH_RCU_RETIRE_BATCH retirements a grace period
+         waits until no reader can still access them (epoch-based: readers increment a counter of the current epoch
+         parity while they read, see CH_RCU_NUM_READER_SLOTS). Only then they are freed, and the dtrs of their removed
+         or overwritten item are called. 'ch_xxx_free(...)' frees all the retired arrays
+      This makes writes slower (every write copies a bucket), so it's useful for read-mostly hashtables only.
+      All the other functions are still NOT thread-safe.
+
+   C_HASHTABLE_VERSION_NUM 0116:
+   -> added the (optional) scoped definition CH_USE_STRIPED_LOCKS (it can't be used with CH_USE_DYNAMIC_BUCKETS,
+      CH_USE_OPEN_ADDRESSING or CH_USE_BUCKET_SLABS, because they can modify the whole table at every insertion).
+      When it's defined, the hashtable has CH_NUM_LOCK_STRIPES reader-writer spin locks ('locks'), one per cache line,
+      and bucket 'i' is protected by 'locks[i%CH_NUM_LOCK_STRIPES]'. The following functions (and their fake member functions)
+      can be called by many threads at the same time, and they only contend when they access the same stripe:
+      -> 'ch_xxx_concurrent_get(ht,key,value_out)': it copies the value of 'key' to 'value_out' (when it's not NULL),
+         and returns 1 if 'key' was found. Readers of the same stripe don't block each other
+      -> 'ch_xxx_concurrent_set(ht,key,value)': it inserts or overwrites the value of 'key', and returns 1 if 'key' was already present
+      -> 'ch_xxx_concurrent_update(ht,key,update_fcn,user_data)': it gets or inserts 'key', and calls 'update_fcn(value,match,user_data)'
+         while the stripe is locked (so that read-modify-write operations, like incrementing a counter, are atomic). It returns 'match'
+      -> 'ch_xxx_concurrent_remove(ht,key)': like 'ch_xxx_remove(...)'
+      Values are copied with 'value_cpy' when present (so 'value_out' must be a valid value in this case).
+      All the other functions are NOT thread-safe: no thread can use the hashtable while they are running.
+
+   C_HASHTABLE_VERSION_NUM 0115:
+   -> added the (optional) scoped definition CH_USE_BUCKET_SLABS (it can't be used with CH_USE_OPEN_ADDRESSING).
+      When it's defined, the hashtable owns a slab allocator ('slabs') and bucket arrays are not allocated
+      one by one with CH_MALLOC anymore:
+      -> bucket arrays up to CH_SLAB_MAX_BLOCK_SIZE (8 KB) are carved from pages of CH_SLAB_PAGE_SIZE bytes,
+         in 32 size classes (multiples of 16 bytes, 4 classes for every power of two). Bigger arrays use CH_MALLOC
+      -> when a bucket grows to another size class, its old block goes to a per-class free list and is reused
+         by the next bucket of the same class (with CH_USE_DYNAMIC_BUCKETS, rehashing reuses the old buckets' blocks)
+      -> bucket capacities are rounded up to fill their block, and all the pages are released at once by 'ch_xxx_free(...)'
+      -> 'ch_xxx_dbg_check(...)' displays the number of slab pages too
+      This removes most of the tiny heap allocations of tables with many buckets (and their per-allocation
+      overhead and fragmentation). See the BUCKET SLABS TEST in "c_hashtable_main.c" for a comparison.
+
+   C_HASHTABLE_VERSION_NUM 0114:
+   -> added 'ch_xxx_get_batch(ht,keys,num_keys,values)' and 'ch_xxx_get_or_insert_batch(ht,keys,num_keys,values,matches)'
+      (and their fake member functions). Keys are processed in groups of CH_BATCH_SIZE: all the keys of a group are
+      hashed first, then their buckets (or control bytes) and bucket items (or slots) are prefetched (see CH_PREFETCH),
+      and only then they are looked up, so that the cache misses of different keys overlap.
+      All the returned pointers are valid until the next insertion or removal.
+
+   C_HASHTABLE_VERSION_NUM 0113:
+   -> added the (optional) scoped definition CH_USE_CACHED_HASHES (it can't be used with CH_USE_OPEN_ADDRESSING).
+      When it's defined:
+      -> every item stores the low 32 bits of its hash in an additional field ('unsigned h')
+      -> 'key_hash' returns a full-width size_t hash. Without CH_USE_DYNAMIC_BUCKETS the bucket index is
+         'hash%CH_NUM_BUCKETS' (so please don't apply any mod in 'key_hash' and use a good hash function,
+         e.g. 'ch_hash32_murmur3_str(...)')
+      -> buckets are sorted by (hash,key) (or by hash only when 'key_cmp' is NULL): most mismatches are rejected
+         by an integer comparison, and 'key_cmp' (or memcmp) is called only on items with the same hash
+      -> with CH_USE_DYNAMIC_BUCKETS, rehashing does not call 'key_hash' anymore
+      -> 'ch_xxx_dbg_check(...)' checks that every cached hash is correct
+
+   C_HASHTABLE_VERSION_NUM 0112:
+   -> added the (optional) scoped definition CH_USE_OPEN_ADDRESSING. When it's defined, the hashtable has no
+      buckets: all the items are stored in a single flat array ('slots') with a parallel array of control bytes
+      ('ctrl'), grouped in groups of 16 bytes (SwissTable-style):
+      -> 'ctrl[i]<0x80' means that 'slots[i]' is used (and 'ctrl[i]' stores 7 bits of its hash), otherwise
+         'ctrl[i]' is CH_OA_EMPTY or CH_OA_DELETED. A whole group of 16 control bytes is matched at once
+         with SSE2 instructions (when available, unless CH_NO_SIMD is defined globally)
+      -> 'key_hash' returns a full-width size_t hash (all its bits are used, so please use a good hash function)
+      -> 'key_cmp' is used only to test keys for equality (0 means equal). When it's NULL, keys are compared with memcmp
+      -> 'initial_bucket_capacity' is the number of items the table can store before growing
+      -> the max load factor is 7/8, and the slot array doubles when it's full
+      -> 'ch_xxx_rehash(ht,min_capacity)' grows the slot array in advance
+      -> all the other functions have the same signature
+      Users can iterate all the items this way:
+          for (i=0;i<ht.capacity;i++) {if (ht.ctrl[i]<0x80) {const mykey_myvalue* item = &ht.slots[i];...}}
+
+   C_HASHTABLE_VERSION_NUM 0111:
+   -> added the (optional) scoped definition CH_USE_DYNAMIC_BUCKETS. When it's defined:
+      -> 'buckets' is a heap-allocated array of 'num_buckets' buckets (CH_NUM_BUCKETS is just the initial
+         number of buckets and must be a power of two)
+      -> 'key_hash' returns a full-width size_t hash: the bucket index is simply 'hash&(num_buckets-1)',
+         so please use a hash function with good low bits (e.g. 'ch_hash32_murmur3(...)')
+      -> when num_items>num_buckets*CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR the bucket array doubles, and the old
+         buckets are moved to the new array incrementally (CH_DYNAMIC_BUCKETS_REHASH_STEP old buckets
+         at every 'ch_xxx_get_or_insert(...)' or 'ch_xxx_remove(...)' call)
+      -> added 'ch_xxx_rehash(ht,min_num_buckets)': it completes any pending rehashing and can grow the
+         bucket array in a single step (please call it before iterating 'buckets' directly)
+      -> 'ch_xxx_get_num_items(...)' is O(1)
+   -> fixed 'ch_xxx_cpy(...)' when 'key_cpy' or 'value_cpy' are used (a loop counter was reused,
+      and 'value_cpy' was ignored when 'key_cpy' was present)
+
    C_HASHTABLE_VERSION_NUM 0110 rev2:
    -> added the CV_SIZE_T_FORMATTING definition (internal usage).
 
@@ -184,6 +342,20 @@ freely, subject to the following restrictions:
 #   endif
 #endif /* CV_SIZE_T_FORMATTING */
 
+#ifndef CH_PREFETCH
+#   if (defined(__GNUC__) || defined(__clang__))
+#       define CH_PREFETCH(ADDR)   __builtin_prefetch((const void*)(ADDR))
+#   elif (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86)))
+#       include <xmmintrin.h>
+#       define CH_PREFETCH(ADDR)   _mm_prefetch((const char*)(ADDR),_MM_HINT_T0)
+#   else
+#       define CH_PREFETCH(ADDR)   /* no-op */
+#   endif
+#endif /* CH_PREFETCH */
+#ifndef CH_BATCH_SIZE
+#   define CH_BATCH_SIZE 16
+#endif
+
 #if (defined (NDEBUG) || defined (_NDEBUG))
 #   undef CH_NO_ASSERT
 #   define CH_NO_ASSERT
@@ -324,6 +496,24 @@ freely, subject to the following restrictions:
 
 #if CH_NUM_BUCKETS<=0
 #   error CH_NUM_BUCKETS must be positive.
+#elif (defined(CH_USE_DYNAMIC_BUCKETS) && defined(CH_USE_OPEN_ADDRESSING))
+#   error CH_USE_DYNAMIC_BUCKETS and CH_USE_OPEN_ADDRESSING cannot be both defined.
+#elif (defined(CH_USE_CACHED_HASHES) && defined(CH_USE_OPEN_ADDRESSING))
+#   error CH_USE_CACHED_HASHES and CH_USE_OPEN_ADDRESSING cannot be both defined (control bytes already store 7 bits of the hash).
+#elif (defined(CH_USE_BUCKET_SLABS) && defined(CH_USE_OPEN_ADDRESSING))
+#   error CH_USE_BUCKET_SLABS and CH_USE_OPEN_ADDRESSING cannot be both defined (there are no buckets).
+#elif (defined(CH_USE_STRIPED_LOCKS) && (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING) || defined(CH_USE_BUCKET_SLABS)))
+#   error CH_USE_STRIPED_LOCKS cannot be used with CH_USE_DYNAMIC_BUCKETS, CH_USE_OPEN_ADDRESSING or CH_USE_BUCKET_SLABS.
+#elif (defined(CH_USE_RCU_READS) && !defined(CH_USE_STRIPED_LOCKS))
+#   error CH_USE_RCU_READS needs CH_USE_STRIPED_LOCKS (writers still lock their stripe).
+#elif (defined(CH_USE_STATS) && defined(CH_USE_STRIPED_LOCKS))
+#   error CH_USE_STATS and CH_USE_STRIPED_LOCKS cannot be both defined (the counters are not atomic).
+#elif defined(CH_USE_OPEN_ADDRESSING)
+    /* CH_NUM_BUCKETS is not used */
+#elif defined(CH_USE_DYNAMIC_BUCKETS)
+#   if ((CH_NUM_BUCKETS)&((CH_NUM_BUCKETS)-1))!=0
+#       error CH_NUM_BUCKETS must be a power of two when CH_USE_DYNAMIC_BUCKETS is defined.
+#   endif
 #elif CH_NUM_BUCKETS>CH_MAX_NUM_BUCKETS
 #   if CH_NUM_BUCKETS<=65536
 #       error CH_MAX_NUM_BUCKETS must be set to 65536 globally in the Project Options to allow CH_NUM_BUCKETS>256.
@@ -334,6 +524,216 @@ freely, subject to the following restrictions:
 #   endif
 #endif
 
+#if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING) || defined(CH_USE_CACHED_HASHES))
+#   define CH_KEY_HASH_UINT size_t  /* full-width hash: it's masked to 'num_buckets' (or to 'capacity', or mod CH_NUM_BUCKETS) internally */
+#   ifndef CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR
+#       define CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR 2
+#   endif
+#   ifndef CH_DYNAMIC_BUCKETS_REHASH_STEP
+#       define CH_DYNAMIC_BUCKETS_REHASH_STEP 2
+#   endif
+#else
+#   define CH_KEY_HASH_UINT ch_hash_uint
+#endif
+
+#if (defined(C_VECTOR_H_) || (defined(C_VECTOR_TYPE_UNSAFE_H) && !defined(CV_NO_CVH_SERIALIZER_T)))
+#   define CH_HAS_CVH_SERIALIZER   /* 'ch_xxx_serialize(...)' and 'ch_xxx_deserialize(...)' need 'cvh_serializer_t' (internal usage) */
+#endif
+
+
+#ifndef CVH_GROWTH_POLICY_GUARD_
+#define CVH_GROWTH_POLICY_GUARD_
+/* cvh_growth_policy_t is an optional per-instance growth policy (see cv_xxx_set_growth_policy(...)), shared by all the containers of
+   "c_vector.h", "c_vector_type_unsafe.h" and "c_hashtable.h". When it's NULL, every container keeps its default growth (about 1.5x).
+   A policy can be shared by many containers, and it must outlive them */
+#define CVH_GROWTH_GEOMETRIC      0   /* capacity*factor_num/factor_den (e.g. 2/1 doubles the capacity) */
+#define CVH_GROWTH_FIXED_CHUNK    1   /* capacity plus 'chunk_bytes' (at least one item): linear growth and bounded unused memory, for very big containers */
+#define CVH_GROWTH_PAGE_ALIGNED   2   /* like CVH_GROWTH_GEOMETRIC, but the buffer size is rounded up to a multiple of 'chunk_bytes' (e.g. 4 KB pages or 2 MB huge pages) */
+typedef struct cvh_growth_policy_t {
+    int type;                       /* one of the CVH_GROWTH_xxx definitions */
+    size_t factor_num,factor_den;   /* CVH_GROWTH_GEOMETRIC and CVH_GROWTH_PAGE_ALIGNED only (when not factor_num>factor_den>0, 3/2 is used) */
+    size_t chunk_bytes;             /* CVH_GROWTH_FIXED_CHUNK and CVH_GROWTH_PAGE_ALIGNED only */
+} cvh_growth_policy_t;
+CH_API cvh_growth_policy_t cvh_growth_policy_geometric(size_t factor_num,size_t factor_den)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_GEOMETRIC;p.factor_num=factor_num;p.factor_den=factor_den;p.chunk_bytes=0;return p;
+}
+CH_API cvh_growth_policy_t cvh_growth_policy_fixed_chunk(size_t chunk_bytes)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_FIXED_CHUNK;p.factor_num=p.factor_den=0;p.chunk_bytes=chunk_bytes;return p;
+}
+CH_API cvh_growth_policy_t cvh_growth_policy_page_aligned(size_t factor_num,size_t factor_den,size_t page_bytes)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_PAGE_ALIGNED;p.factor_num=factor_num;p.factor_den=factor_den;p.chunk_bytes=page_bytes;return p;
+}
+/* it returns the new capacity (in items of 'item_size' bytes) of a container of 'capacity' items that needs at least 'min_capacity' items */
+CH_API size_t cvh_growth_policy_next_capacity(const cvh_growth_policy_t* p,size_t capacity,size_t min_capacity,size_t item_size)  {
+    size_t c;
+    if (min_capacity<=capacity) return capacity;
+    if (item_size==0) item_size=1;
+    if (p->type==CVH_GROWTH_FIXED_CHUNK) c = capacity+(p->chunk_bytes>item_size ? p->chunk_bytes/item_size : 1);
+    else if (p->factor_den>0 && p->factor_num>p->factor_den) c = capacity/p->factor_den*p->factor_num+(capacity%p->factor_den)*p->factor_num/p->factor_den;
+    else c = capacity+capacity/2;
+    if (c<min_capacity) c=min_capacity;
+    if (p->type==CVH_GROWTH_PAGE_ALIGNED && p->chunk_bytes>0) c = (c*item_size+p->chunk_bytes-1)/p->chunk_bytes*p->chunk_bytes/item_size;
+    return c;
+}
+#endif /* CVH_GROWTH_POLICY_GUARD_ */
+
+#if (defined(CH_USE_STATS) && !defined(CH_STATS_GUARD))
+#define CH_STATS_GUARD
+typedef struct ch_stats_t {
+    size_t num_lookups;         /* get, get_or_insert and remove calls (batch calls count once per key) */
+    size_t num_hits;            /* lookups that found their key */
+    size_t num_misses;          /* lookups that did not find their key */
+    size_t num_inserts;         /* items inserted by get_or_insert */
+    size_t num_removes;         /* items removed by remove */
+    size_t num_key_cmps;        /* calls to 'key_cmp' (or to memcmp, when 'key_cmp' is NULL) */
+    size_t num_reallocs;        /* (re)allocations of bucket arrays (or of the slot array) */
+    size_t num_bytes_moved;     /* bytes moved by memmove inside sorted buckets */
+} ch_stats_t;
+#endif /* CH_STATS_GUARD */
+#ifdef CH_USE_STATS
+#   define CH_STATS_ADD(HT,FIELD,VALUE)    (((CH_HASHTABLE_TYPE*)(HT))->stats.FIELD+=(size_t)(VALUE))    /* it works on const hashtables too */
+#else
+#   define CH_STATS_ADD(HT,FIELD,VALUE)    /* no-op */
+#endif
+
+#if (defined(CH_USE_BUCKET_SLABS) && !defined(CH_SLAB_ALLOCATOR_GUARD))
+#define CH_SLAB_ALLOCATOR_GUARD
+#ifndef CH_SLAB_PAGE_SIZE
+#   define CH_SLAB_PAGE_SIZE 65536
+#endif
+#define CH_SLAB_MAX_BLOCK_SIZE  8192    /* bigger bucket arrays are allocated with CH_MALLOC */
+#define CH_SLAB_NUM_CLASSES     32      /* size classes in [16,CH_SLAB_MAX_BLOCK_SIZE] */
+#define CH_SLAB_PAGE_HEADER     16      /* every page starts with a pointer to the previous page (padded to keep blocks 16-byte aligned) */
+#if (CH_SLAB_PAGE_SIZE<2*CH_SLAB_MAX_BLOCK_SIZE || (CH_SLAB_PAGE_SIZE%16)!=0)
+#   error CH_SLAB_PAGE_SIZE must be a multiple of 16, and at least 16384.
+#endif
+typedef struct ch_slab_allocator {
+    void* pages;                /* singly linked list of pages (the last allocated one first) */
+    unsigned char* page_ptr;    /* unused space at the end of the first page */
+    size_t page_left;
+    void* free_blocks[CH_SLAB_NUM_CLASSES]; /* singly linked lists of released blocks (one per size class) */
+    size_t num_pages;
+} ch_slab_allocator;
+#endif /* CH_SLAB_ALLOCATOR_GUARD */
+
+#if (defined(CH_USE_STRIPED_LOCKS) && !defined(CH_STRIPED_LOCKS_GUARD))
+#define CH_STRIPED_LOCKS_GUARD
+#ifndef CH_NUM_LOCK_STRIPES
+#   define CH_NUM_LOCK_STRIPES 64
+#endif
+#ifdef _WIN32
+#   include <windows.h> /* SwitchToThread, InterlockedCompareExchange, InterlockedExchangeAdd */
+#endif
+#if (!defined(CH_ATOMIC_CAS) || !defined(CH_ATOMIC_ADD))
+#   if (defined(__GNUC__) || defined(__clang__))
+#       define CH_ATOMIC_CAS(PTR,OLD,NEW)  __sync_bool_compare_and_swap((PTR),(OLD),(NEW))
+#       define CH_ATOMIC_ADD(PTR,VALUE)    ((void)__sync_fetch_and_add((PTR),(VALUE)))
+#   elif defined(_MSC_VER)
+#       define CH_ATOMIC_CAS(PTR,OLD,NEW)  (InterlockedCompareExchange((PTR),(NEW),(OLD))==(OLD))
+#       define CH_ATOMIC_ADD(PTR,VALUE)    ((void)InterlockedExchangeAdd((PTR),(VALUE)))
+#   else
+#       error CH_USE_STRIPED_LOCKS needs CH_ATOMIC_CAS(PTR,OLD,NEW) and CH_ATOMIC_ADD(PTR,VALUE) (please define them globally for this compiler).
+#   endif
+#endif
+#ifndef CH_ATOMIC_LOAD
+#   ifdef __ATOMIC_RELAXED
+#       define CH_ATOMIC_LOAD(PTR)  __atomic_load_n((PTR),__ATOMIC_RELAXED)
+#   else
+#       define CH_ATOMIC_LOAD(PTR)  (*(PTR))    /* 'PTR' is volatile */
+#   endif
+#endif
+#ifndef CH_THREAD_YIELD
+#   ifdef _WIN32
+#       define CH_THREAD_YIELD()   SwitchToThread()
+#   else
+#       include <sched.h>   /* sched_yield */
+#       define CH_THREAD_YIELD()   sched_yield()
+#   endif
+#endif
+/* reader-writer spin lock: the writer sets bit 0, waiting writers set bit 1 (so that new readers wait), and every reader adds 4 */
+typedef struct ch_stripe_lock {
+    volatile long state;
+    char padding[64-sizeof(long)];  /* one lock per cache line (no false sharing) */
+} ch_stripe_lock;
+CH_API void ch_stripe_lock_read(ch_stripe_lock* l)  {
+    unsigned n=0;
+    for (;;)    {
+        const long s = CH_ATOMIC_LOAD(&l->state);   /* just a hint: CH_ATOMIC_CAS checks it */
+        if (!(s&3) && CH_ATOMIC_CAS(&l->state,s,s+4)) return;
+        if (++n%64==0) CH_THREAD_YIELD();
+    }
+}
+CH_API void ch_stripe_unlock_read(ch_stripe_lock* l)    {CH_ATOMIC_ADD(&l->state,-4);}
+CH_API void ch_stripe_lock_write(ch_stripe_lock* l)  {
+    unsigned n=0;
+    for (;;)    {
+        const long s = CH_ATOMIC_LOAD(&l->state);   /* just a hint: CH_ATOMIC_CAS checks it */
+        if ((s&~2L)==0) {if (CH_ATOMIC_CAS(&l->state,s,1)) return;}  /* it clears bit 1 too */
+        else if (!(s&2)) (void)CH_ATOMIC_CAS(&l->state,s,s|2);
+        if (++n%64==0) CH_THREAD_YIELD();
+    }
+}
+CH_API void ch_stripe_unlock_write(ch_stripe_lock* l)   {CH_ATOMIC_ADD(&l->state,-1);}
+#endif /* CH_STRIPED_LOCKS_GUARD */
+
+#if (defined(CH_USE_RCU_READS) && !defined(CH_RCU_GUARD))
+#define CH_RCU_GUARD
+#ifndef CH_RCU_NUM_READER_SLOTS
+#   define CH_RCU_NUM_READER_SLOTS 16
+#endif
+#ifndef CH_RCU_RETIRE_BATCH
+#   define CH_RCU_RETIRE_BATCH 64
+#endif
+#ifndef CH_ATOMIC_LOAD_PTR
+#   ifdef __ATOMIC_ACQUIRE
+#       define CH_ATOMIC_LOAD_PTR(PTR)          __atomic_load_n((PTR),__ATOMIC_ACQUIRE)
+#       define CH_ATOMIC_STORE_PTR(PTR,VALUE)   __atomic_store_n((PTR),(VALUE),__ATOMIC_RELEASE)
+#   else
+#       define CH_ATOMIC_LOAD_PTR(PTR)          (*(void* volatile*)(PTR))  /* acquire/release semantics with Visual C++ (/volatile:ms) */
+#       define CH_ATOMIC_STORE_PTR(PTR,VALUE)   (*(void* volatile*)(PTR)=(VALUE))
+#   endif
+#endif
+#define CH_RCU_HEADER   32      /* every bucket array starts with a 'ch_rcu_block_header' (padded to keep items 16-byte aligned) */
+typedef struct ch_rcu_block_header {
+    size_t size;                /* number of items: readers use it instead of 'v->size' */
+    struct ch_rcu_block_header* next_retired;
+    size_t retired_item;        /* index of the item whose dtrs are called when the retired array is freed */
+    size_t retired_dtrs;        /* 1: key_dtr, 2: value_dtr (0: none) */
+} ch_rcu_block_header;
+#define CH_RCU_HEADER_OF(ITEMS)  ((ch_rcu_block_header*)((unsigned char*)(ITEMS)-CH_RCU_HEADER))
+typedef struct ch_rcu_reader_slot {
+    volatile long count[2];     /* number of readers of an even [0] or odd [1] epoch */
+    char padding[64-2*sizeof(long)];
+} ch_rcu_reader_slot;
+typedef struct ch_rcu_state {
+    ch_stripe_lock lock;        /* it protects 'retired' and 'num_retired', and serializes grace periods */
+    volatile long epoch;
+    ch_rcu_reader_slot readers[CH_RCU_NUM_READER_SLOTS];
+    ch_rcu_block_header* retired;   /* replaced bucket arrays that readers might still access */
+    size_t num_retired;
+} ch_rcu_state;
+CH_API size_t ch_rcu_read_lock(ch_rcu_state* r)  {
+    /* it returns the token for 'ch_rcu_read_unlock(...)'. Threads are spread over the reader slots by their stack address */
+    const long e = CH_ATOMIC_LOAD(&r->epoch)&1;
+    const size_t slot = (size_t)(((((size_t)&e)>>12)*2654435761U)%CH_RCU_NUM_READER_SLOTS);
+    CH_ATOMIC_ADD(&r->readers[slot].count[e],1);    /* full barrier: the following loads can't move before it */
+    return slot*2+(size_t)e;
+}
+CH_API void ch_rcu_read_unlock(ch_rcu_state* r,size_t token)    {CH_ATOMIC_ADD(&r->readers[token/2].count[token&1],-1);}
+CH_API void ch_rcu_synchronize(ch_rcu_state* r)  {
+    /* it waits until every reader that could have loaded a replaced pointer has finished.
+       The epoch is flipped twice, because a reader might have read the epoch parity just before the first flip */
+    int k;size_t i;unsigned n=0;
+    for (k=0;k<2;k++)   {
+        const long e = CH_ATOMIC_LOAD(&r->epoch)&1;
+        CH_ATOMIC_ADD(&r->epoch,1);
+        for (i=0;i<CH_RCU_NUM_READER_SLOTS;i++) {
+            while (!CH_ATOMIC_CAS(&r->readers[i].count[e],0,0)) {if (++n%64==0) CH_THREAD_YIELD();}  /* full-barrier read */
+        }
+    }
+}
+#endif /* CH_RCU_GUARD */
+
 #define CH_HASHTABLE_ITEM_TYPE_TMP CH_CAT(CH_KEY_TYPE,_) 
 #define CH_HASHTABLE_ITEM_TYPE CH_CAT(CH_HASHTABLE_ITEM_TYPE_TMP,CH_VALUE_TYPE) 
 #define CH_HASHTABLE_TYPE CH_CAT(ch_,CH_HASHTABLE_ITEM_TYPE)
@@ -343,6 +743,9 @@ freely, subject to the following restrictions:
 
 #if (!defined(CH_ENABLE_DECLARATION_AND_DEFINITION) || !defined(C_HASHTABLE_IMPLEMENTATION) || defined(C_HASHTABLE_FORCE_DECLARATION))
 typedef struct {
+#   ifdef CH_USE_CACHED_HASHES
+    unsigned h;     /* low 32 bits of 'key_hash(&k)' (read-only) */
+#   endif
 	CH_KEY_TYPE k;
 	CH_VALUE_TYPE v;	
 } CH_HASHTABLE_ITEM_TYPE;
@@ -353,7 +756,7 @@ struct CH_HASHTABLE_TYPE {
     void (*const key_dtr)(CH_KEY_TYPE*);                     /* optional (can be NULL) */
     void (*const key_cpy)(CH_KEY_TYPE*,const CH_KEY_TYPE*);		/* optional (can be NULL) */
     int (*const key_cmp)(const CH_CMP_TYPE*,const CH_CMP_TYPE*);/* optional (can be NULL) (for sorted vectors only) */
-    ch_hash_uint (*const key_hash)(const CH_KEY_TYPE*);
+    CH_KEY_HASH_UINT (*const key_hash)(const CH_KEY_TYPE*);
     /* value callbacks */
     void (*const value_ctr)(CH_VALUE_TYPE*);                     /* optional (can be NULL) */
     void (*const value_dtr)(CH_VALUE_TYPE*);                     /* optional (can be NULL) */
@@ -361,6 +764,15 @@ struct CH_HASHTABLE_TYPE {
 
     /* CH_NUM_BUCKETS sorted buckets */
     const size_t initial_bucket_capacity;
+    const cvh_growth_policy_t* const growth_policy;     /* optional (can be NULL): growth of the sorted buckets (ignored by CH_USE_OPEN_ADDRESSING) */
+#   ifdef CH_USE_OPEN_ADDRESSING
+    /* 'capacity' slots: 'slots[i]' is used when 'ctrl[i]<0x80' */
+    CH_HASHTABLE_ITEM_TYPE* slots;
+    unsigned char* ctrl;                /* 'capacity' control bytes (in groups of CH_OA_GROUP_WIDTH): please don't modify them */
+    const size_t capacity;              /* zero or a power of two, multiple of CH_OA_GROUP_WIDTH */
+    const size_t num_items;
+    const size_t growth_left;           /* number of insertions left before the slot array grows */
+#   else /* CH_USE_OPEN_ADDRESSING */
     struct CH_VECTOR_TYPE {
 		CH_HASHTABLE_ITEM_TYPE * v;
 		const size_t size;
@@ -370,7 +782,30 @@ struct CH_HASHTABLE_TYPE {
         inline const CH_HASHTABLE_ITEM_TYPE& operator[](size_t i) const {CH_ASSERT(i<size);return v[i];}
         inline CH_HASHTABLE_ITEM_TYPE& operator[](size_t i) {CH_ASSERT(i<size);return v[i];}
 #       endif
+#   ifndef CH_USE_DYNAMIC_BUCKETS
     } buckets[CH_NUM_BUCKETS];
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    } * buckets;                        /* 'num_buckets' sorted buckets (allocated at the first insertion) */
+    const size_t num_buckets;           /* always a power of two */
+    const size_t num_items;
+    /* incremental rehashing (internal usage) */
+    struct CH_VECTOR_TYPE * old_buckets;/* not NULL while rehashing */
+    const size_t old_num_buckets;
+    const size_t rehash_index;          /* 'old_buckets[i]' with i<rehash_index have already been moved to 'buckets' */
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+#   ifdef CH_USE_BUCKET_SLABS
+    ch_slab_allocator slabs;            /* bucket arrays are carved from its pages (internal usage) */
+#   endif
+#   ifdef CH_USE_STRIPED_LOCKS
+    ch_stripe_lock locks[CH_NUM_LOCK_STRIPES];  /* 'buckets[i]' is protected by 'locks[i%CH_NUM_LOCK_STRIPES]' (internal usage) */
+#   endif
+#   ifdef CH_USE_RCU_READS
+    ch_rcu_state rcu;                   /* reader counters and retired bucket arrays (internal usage) */
+#   endif
+#   endif /* CH_USE_OPEN_ADDRESSING */
+#   ifdef CH_USE_STATS
+    ch_stats_t stats;                   /* hot-path counters (read-only: please use 'ch_xxx_get_stats(...)' and 'ch_xxx_reset_stats(...)') */
+#   endif
 
 #   ifndef CH_DISABLE_FAKE_MEMBER_FUNCTIONS  /* must be defined glabally (in the Project Options)) */
     void (* const clear)(CH_HASHTABLE_TYPE* ht);
@@ -388,6 +823,22 @@ struct CH_HASHTABLE_TYPE {
     int (* const dbg_check)(const CH_HASHTABLE_TYPE* ht);
     void (* const swap)(CH_HASHTABLE_TYPE* a,CH_HASHTABLE_TYPE* b);
     void (* const cpy)(CH_HASHTABLE_TYPE* a,const CH_HASHTABLE_TYPE* b);
+    size_t (* const get_batch)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* keys,size_t num_keys,CH_VALUE_TYPE** values);
+    size_t (* const get_or_insert_batch)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* keys,size_t num_keys,CH_VALUE_TYPE** values,int* matches);
+    void (* const build_from)(CH_HASHTABLE_TYPE* ht,const CH_HASHTABLE_ITEM_TYPE* items,size_t num_items);
+#   if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+    void (* const rehash)(CH_HASHTABLE_TYPE* ht,size_t min_num_buckets_or_capacity);
+#   endif
+#   ifdef CH_USE_STRIPED_LOCKS
+    int (* const concurrent_get)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_VALUE_TYPE* value_out);
+    int (* const concurrent_set)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,const CH_VALUE_TYPE* value);
+    int (* const concurrent_update)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,void (*update_fcn)(CH_VALUE_TYPE* value,int match,void* user_data),void* user_data);
+    int (* const concurrent_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key);
+#   endif
+#   ifdef CH_USE_STATS
+    void (* const get_stats)(const CH_HASHTABLE_TYPE* ht,ch_stats_t* stats);
+    void (* const reset_stats)(CH_HASHTABLE_TYPE* ht);
+#   endif
 #   endif
 #   ifdef __cplusplus
     CH_HASHTABLE_TYPE();
@@ -401,12 +852,16 @@ struct CH_HASHTABLE_TYPE {
     ~CH_HASHTABLE_TYPE();
 #   endif
 };
+#ifndef CH_USE_OPEN_ADDRESSING
 #ifdef __cplusplus
 typedef CH_HASHTABLE_TYPE::CH_VECTOR_TYPE CH_VECTOR_TYPE;
 #else
 typedef struct CH_VECTOR_TYPE CH_VECTOR_TYPE;
 #endif
+#ifndef CH_USE_DYNAMIC_BUCKETS
 typedef CH_VECTOR_TYPE CH_VECTORS_TYPE[CH_NUM_BUCKETS];
+#endif
+#endif /* CH_USE_OPEN_ADDRESSING */
 
 
 #ifdef CH_ENABLE_DECLARATION_AND_DEFINITION
@@ -426,14 +881,35 @@ CH_API_DEC int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht);
 CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_swap)(CH_HASHTABLE_TYPE* a,CH_HASHTABLE_TYPE* b);
 CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_cpy)(CH_HASHTABLE_TYPE* a,const CH_HASHTABLE_TYPE* b);
 CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_shrink_to_fit)(CH_HASHTABLE_TYPE* ht);
+CH_API_DEC size_t CH_HASHTABLE_TYPE_FCT(_get_batch)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* keys,size_t num_keys,CH_VALUE_TYPE** values);
+CH_API_DEC size_t CH_HASHTABLE_TYPE_FCT(_get_or_insert_batch)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* keys,size_t num_keys,CH_VALUE_TYPE** values,int* matches);
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_build_from)(CH_HASHTABLE_TYPE* ht,const CH_HASHTABLE_ITEM_TYPE* items,size_t num_items);
+#if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_rehash)(CH_HASHTABLE_TYPE* ht,size_t min_num_buckets_or_capacity);
+#endif
+#ifdef CH_USE_STRIPED_LOCKS
+CH_API_DEC int CH_HASHTABLE_TYPE_FCT(_concurrent_get)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_VALUE_TYPE* value_out);
+CH_API_DEC int CH_HASHTABLE_TYPE_FCT(_concurrent_set)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,const CH_VALUE_TYPE* value);
+CH_API_DEC int CH_HASHTABLE_TYPE_FCT(_concurrent_update)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,void (*update_fcn)(CH_VALUE_TYPE* value,int match,void* user_data),void* user_data);
+CH_API_DEC int CH_HASHTABLE_TYPE_FCT(_concurrent_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key);
+#endif
+#ifdef CH_USE_STATS
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_get_stats)(const CH_HASHTABLE_TYPE* ht,ch_stats_t* stats);
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_reset_stats)(CH_HASHTABLE_TYPE* ht);
+#endif
+#ifdef CH_HAS_CVH_SERIALIZER
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_serialize)(const CH_HASHTABLE_TYPE* ht,cvh_serializer_t* serializer,void (*key_serialize)(const CH_KEY_TYPE*,cvh_serializer_t*),void (*value_serialize)(const CH_VALUE_TYPE*,cvh_serializer_t*));
+CH_API_DEC int CH_HASHTABLE_TYPE_FCT(_deserialize)(CH_HASHTABLE_TYPE* ht,const cvh_serializer_t* deserializer,int (*key_deserialize)(CH_KEY_TYPE*,const cvh_serializer_t*),int (*value_deserialize)(CH_VALUE_TYPE*,const cvh_serializer_t*));
+#endif
 CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_create_with)(
         CH_HASHTABLE_TYPE* ht,
-        ch_hash_uint (*key_hash)(const CH_KEY_TYPE*),
+        CH_KEY_HASH_UINT (*key_hash)(const CH_KEY_TYPE*),
         int (*key_cmp) (const CH_CMP_TYPE*,const CH_CMP_TYPE*),
         void (*key_ctr)(CH_KEY_TYPE*),void (*key_dtr)(CH_KEY_TYPE*),void (*key_cpy)(CH_KEY_TYPE*,const CH_KEY_TYPE*),
         void (*value_ctr)(CH_VALUE_TYPE*),void (*value_dtr)(CH_VALUE_TYPE*),void (*value_cpy)(CH_VALUE_TYPE*,const CH_VALUE_TYPE*),
         size_t initial_bucket_capacity);
-CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uint (*key_hash)(const CH_KEY_TYPE*),int (*key_cmp) (const CH_CMP_TYPE*,const CH_CMP_TYPE*),size_t initial_bucket_capacity);
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,CH_KEY_HASH_UINT (*key_hash)(const CH_KEY_TYPE*),int (*key_cmp) (const CH_CMP_TYPE*,const CH_CMP_TYPE*),size_t initial_bucket_capacity);
+CH_API_DEC void CH_HASHTABLE_TYPE_FCT(_set_growth_policy)(CH_HASHTABLE_TYPE* ht,const cvh_growth_policy_t* policy);
 #endif /* CH_ENABLE_DECLARATION_AND_DEFINITION */
 #endif /*  (!defined(CH_ENABLE_DECLARATION_AND_DEFINITION) || !defined(C_HASHTABLE_IMPLEMENTATION) || defined(C_HASHTABLE_FORCE_DECLARATION)) */
 
@@ -627,9 +1103,125 @@ CH_API unsigned ch_hash32_FNV1a_str(const char* text)	{
 #	define CH_HASH_FROM_HASH32_USING_FIBFOLDING(hash32,num_buckets_pot_exponent)	((hash32*2654435769U) >> (32-(num_buckets_pot_exponent)))
 #endif /* CH_COMMON_FUNCTIONS_GUARD */
 
+#if (defined(CH_USE_OPEN_ADDRESSING) && !defined(CH_OPEN_ADDRESSING_GUARD))
+#define CH_OPEN_ADDRESSING_GUARD
+/* open addressing helpers: control bytes are processed in groups of CH_OA_GROUP_WIDTH bytes */
+#define CH_OA_GROUP_WIDTH   16
+#define CH_OA_EMPTY         0x80
+#define CH_OA_DELETED       0xFE    /* EMPTY and DELETED are the only control bytes with the high bit set */
+#define CH_OA_MAX_LOAD(capacity)    ((capacity)-(capacity)/8)
+#if (!defined(CH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)))
+#   include <emmintrin.h>
+#   define CH_OA_USE_SSE2
+#endif
+/* returns a bit mask of the control bytes in 'group' equal to 'h' */
+CH_API unsigned ch_oa_group_match(const unsigned char* group,unsigned char h)  {
+#   ifdef CH_OA_USE_SSE2
+    const __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl,_mm_set1_epi8((char)h)));
+#   else
+    unsigned mask=0,i;
+    for (i=0;i<CH_OA_GROUP_WIDTH;i++) mask|=(unsigned)(group[i]==h)<<i;
+    return mask;
+#   endif
+}
+CH_API unsigned ch_oa_group_match_empty(const unsigned char* group)   {return ch_oa_group_match(group,CH_OA_EMPTY);}
+CH_API unsigned ch_oa_group_match_empty_or_deleted(const unsigned char* group)   {
+#   ifdef CH_OA_USE_SSE2
+    return (unsigned) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+#   else
+    unsigned mask=0,i;
+    for (i=0;i<CH_OA_GROUP_WIDTH;i++) mask|=(unsigned)(group[i]>>7)<<i;
+    return mask;
+#   endif
+}
+CH_API unsigned ch_oa_ctz(unsigned mask)    {
+    /* 'mask' must not be zero */
+#   if (defined(__GNUC__) || defined(__clang__))
+    return (unsigned) __builtin_ctz(mask);
+#   else
+    unsigned n=0;
+    while (!(mask&1)) {mask>>=1;++n;}
+    return n;
+#   endif
+}
+/* smallest valid capacity that can store 'num_items' items */
+CH_API size_t ch_oa_capacity_for(size_t num_items)  {
+    size_t capacity = CH_OA_GROUP_WIDTH;
+    while (CH_OA_MAX_LOAD(capacity)<num_items) capacity*=2;
+    return capacity;
+}
+#endif /* CH_OPEN_ADDRESSING_GUARD */
+
+#if (defined(CH_USE_BUCKET_SLABS) && !defined(CH_SLAB_FUNCTIONS_GUARD))
+#define CH_SLAB_FUNCTIONS_GUARD
+/* slab allocator helpers: size classes are 16,32,48,64 bytes, and then 4 classes for every power of two (80,96,112,128,160,...,8192) */
+CH_API size_t ch_slab_class_size(size_t c)  {
+    size_t e;
+    CH_ASSERT(c<CH_SLAB_NUM_CLASSES);
+    if (c<4) return (c+1)*16;
+    e = 2+(c-4)/4;
+    return (((size_t)1<<e)+((c-4)%4+1)*((size_t)1<<(e-2)))*16;
+}
+/* smallest size class that can store 'size' bytes ('size' in [1,CH_SLAB_MAX_BLOCK_SIZE]) */
+CH_API size_t ch_slab_class(size_t size)  {
+    const size_t n = (size+15)/16;   /* in units of 16 bytes */
+    size_t e = 2;
+    CH_ASSERT(size>0 && size<=CH_SLAB_MAX_BLOCK_SIZE);
+    if (n<=4) return n-1;
+    while (((size_t)1<<(e+1))<n) ++e;   /* now 2^e < n <= 2^(e+1) */
+    return 4+(e-2)*4+((n-1-((size_t)1<<e))>>(e-2));
+}
+CH_API void ch_slab_free(ch_slab_allocator* s,void* p,size_t c)  {
+    CH_ASSERT(s && p && c<CH_SLAB_NUM_CLASSES);
+    *((void**)p) = s->free_blocks[c];
+    s->free_blocks[c] = p;
+}
+CH_API void* ch_slab_alloc(ch_slab_allocator* s,size_t c)  {
+    const size_t size = ch_slab_class_size(c);
+    void* p;
+    CH_ASSERT(s);
+    p = s->free_blocks[c];
+    if (p)  {s->free_blocks[c] = *((void**)p);return p;}
+    if (s->page_left<size)  {
+        /* the tail of the current page is split into free blocks, and a new page is allocated */
+        while (s->page_left>=16)   {
+            size_t tc = ch_slab_class(s->page_left);
+            if (ch_slab_class_size(tc)>s->page_left) --tc;
+            ch_slab_free(s,s->page_ptr,tc);
+            s->page_ptr+=ch_slab_class_size(tc);s->page_left-=ch_slab_class_size(tc);
+        }
+        p = ch_malloc(CH_SLAB_PAGE_SIZE);
+        *((void**)p) = s->pages;s->pages = p;++s->num_pages;
+        s->page_ptr = (unsigned char*)p+CH_SLAB_PAGE_HEADER;
+        s->page_left = CH_SLAB_PAGE_SIZE-CH_SLAB_PAGE_HEADER;
+    }
+    p = s->page_ptr;
+    s->page_ptr+=size;s->page_left-=size;
+    return p;
+}
+/* it frees all the pages at once (all the blocks become invalid) */
+CH_API void ch_slab_release(ch_slab_allocator* s)  {
+    CH_ASSERT(s);
+    while (s->pages)    {
+        void* next = *((void**)s->pages);
+        ch_free(s->pages);
+        s->pages = next;
+    }
+    memset(s,0,sizeof(ch_slab_allocator));
+}
+#endif /* CH_SLAB_FUNCTIONS_GUARD */
+
 
 #if (!defined(CH_ENABLE_DECLARATION_AND_DEFINITION) || defined(C_HASHTABLE_IMPLEMENTATION))
 /* --- PRIVATE FUNCTIONS START -------------------------------------------------- */
+#ifndef CH_USE_OPEN_ADDRESSING
+CH_API void CH_VECTOR_TYPE_FCT(_set_size)(CH_VECTOR_TYPE* v,size_t size)	{
+    *((size_t*) &v->size)=size;
+#   ifdef CH_USE_RCU_READS
+    if (v->v) CH_RCU_HEADER_OF(v->v)->size=size;   /* used by lock-free readers */
+#   endif
+}
 CH_API void CH_VECTOR_TYPE_FCT(_clear)(CH_VECTOR_TYPE* v,const CH_HASHTABLE_TYPE* ht)	{
     CH_ASSERT(v && ht);
     if (v->v) {
@@ -642,20 +1234,79 @@ CH_API void CH_VECTOR_TYPE_FCT(_clear)(CH_VECTOR_TYPE* v,const CH_HASHTABLE_TYPE
             }
         }
     }
-    *((size_t*) &v->size)=0;
+    CH_VECTOR_TYPE_FCT(_set_size)(v,0);
 }
-CH_API void CH_VECTOR_TYPE_FCT(_reserve)(CH_VECTOR_TYPE* v,size_t size,const CH_HASHTABLE_TYPE* ht)	{
+CH_API void CH_VECTOR_TYPE_FCT(_set_capacity)(CH_VECTOR_TYPE* v,size_t new_capacity,CH_HASHTABLE_TYPE* ht)	{
+    /* (re)allocates 'v->v' so that it can store at least 'new_capacity' items (the first 'v->size' items are kept) */
+#   if (!defined(CH_USE_BUCKET_SLABS) && !defined(CH_USE_RCU_READS))
+    CH_ASSERT(v && ht && new_capacity>=v->size);(void)ht;
+    CH_STATS_ADD(ht,num_reallocs,1);
+    if (!v->v) v->v = (CH_HASHTABLE_ITEM_TYPE*) ch_malloc(new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    else ch_safe_realloc((void** const) &v->v,new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
+#   elif defined(CH_USE_RCU_READS)
+    /* the allocated block starts with a 'ch_rcu_block_header' */
+    void* p = v->v ? (void*)CH_RCU_HEADER_OF(v->v) : NULL;
+    CH_ASSERT(v && ht && new_capacity>=v->size);(void)ht;
+    CH_STATS_ADD(ht,num_reallocs,1);
+    if (!p) p = ch_malloc(CH_RCU_HEADER+new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    else ch_safe_realloc(&p,CH_RCU_HEADER+new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    v->v = (CH_HASHTABLE_ITEM_TYPE*) ((unsigned char*)p+CH_RCU_HEADER);
+    CH_RCU_HEADER_OF(v->v)->size = v->size;
+#   else /* CH_USE_BUCKET_SLABS */
+    /* blocks up to CH_SLAB_MAX_BLOCK_SIZE bytes are in 'ht->slabs': their size class depends on their capacity only */
+    const size_t old_bytes = v->capacity*sizeof(CH_HASHTABLE_ITEM_TYPE);
+    CH_HASHTABLE_ITEM_TYPE* p;
+    CH_ASSERT(v && ht && new_capacity>=v->size);
+    CH_STATS_ADD(ht,num_reallocs,1);
+    if (new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE)>CH_SLAB_MAX_BLOCK_SIZE)  {
+        if (v->v && old_bytes>CH_SLAB_MAX_BLOCK_SIZE) {ch_safe_realloc((void** const) &v->v,new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));*((size_t*) &v->capacity) = new_capacity;return;}
+        p = (CH_HASHTABLE_ITEM_TYPE*) ch_malloc(new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    }
+    else {
+        const size_t c = ch_slab_class(new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
+        new_capacity = ch_slab_class_size(c)/sizeof(CH_HASHTABLE_ITEM_TYPE); /* we use the whole block (its size class does not change) */
+        if (v->v && old_bytes<=CH_SLAB_MAX_BLOCK_SIZE && ch_slab_class(old_bytes)==c) {*((size_t*) &v->capacity) = new_capacity;return;}  /* same block */
+        p = (CH_HASHTABLE_ITEM_TYPE*) ch_slab_alloc(&ht->slabs,c);
+    }
+    if (v->v)   {
+        if (v->size) memcpy((void*)p,v->v,v->size*sizeof(CH_HASHTABLE_ITEM_TYPE));
+        if (old_bytes>CH_SLAB_MAX_BLOCK_SIZE) ch_free(v->v);
+        else ch_slab_free(&ht->slabs,v->v,ch_slab_class(old_bytes));
+    }
+    v->v = p;
+#   endif /* CH_USE_BUCKET_SLABS */
+    *((size_t*) &v->capacity) = new_capacity;
+}
+CH_API void CH_VECTOR_TYPE_FCT(_free_items)(CH_VECTOR_TYPE* v,CH_HASHTABLE_TYPE* ht)	{
+    /* it does not call any dtr: please call '_clear(...)' first */
+    CH_ASSERT(v && ht);(void)ht;
+    if (v->v) {
+#       ifdef CH_USE_BUCKET_SLABS
+        const size_t bytes = v->capacity*sizeof(CH_HASHTABLE_ITEM_TYPE);
+        if (bytes<=CH_SLAB_MAX_BLOCK_SIZE) ch_slab_free(&ht->slabs,v->v,ch_slab_class(bytes));
+        else
+#       endif
+#       ifdef CH_USE_RCU_READS
+        ch_free(CH_RCU_HEADER_OF(v->v));
+#       else
+        ch_free(v->v);
+#       endif
+        v->v=NULL;
+    }
+    *((size_t*)&v->size)=*((size_t*)&v->capacity)=0;
+}
+CH_API void CH_VECTOR_TYPE_FCT(_reserve)(CH_VECTOR_TYPE* v,size_t size,CH_HASHTABLE_TYPE* ht)	{
     CH_ASSERT(v && ht);
     /* grows-only! */
     if (size>v->capacity) {
-        const size_t new_capacity = (v->capacity==0 && size>1) ?
+        const size_t new_capacity = ht->growth_policy ? cvh_growth_policy_next_capacity(ht->growth_policy,v->capacity,size,sizeof(CH_HASHTABLE_ITEM_TYPE)) :
+                    (v->capacity==0 && size>1) ?
                     size :      /* possibly keep initial user-guided 'reserve(...)' */
                     (v->capacity+(size-v->capacity)+(v->capacity)/2);   /* our growing strategy */
-        ch_safe_realloc((void** const) &v->v,new_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
-        *((size_t*) &v->capacity) = new_capacity;
+        CH_VECTOR_TYPE_FCT(_set_capacity)(v,new_capacity,ht);
     }
 }
-CH_API void CH_VECTOR_TYPE_FCT(_resize)(CH_VECTOR_TYPE* v,size_t size,const CH_HASHTABLE_TYPE* ht)	{
+CH_API void CH_VECTOR_TYPE_FCT(_resize)(CH_VECTOR_TYPE* v,size_t size,CH_HASHTABLE_TYPE* ht)	{
     CH_ASSERT(v && ht);
     if (size>v->capacity) CH_VECTOR_TYPE_FCT(_reserve)(v,size,ht);
     if (size<v->size)   {
@@ -673,7 +1324,7 @@ CH_API void CH_VECTOR_TYPE_FCT(_resize)(CH_VECTOR_TYPE* v,size_t size,const CH_H
         else if (ht->key_ctr)        {for (i=v->size;i<size;i++) ht->key_ctr(&v->v[i].k);}
         else if (ht->value_ctr) {for (i=v->size;i<size;i++) ht->value_ctr(&v->v[i].v);}
     }
-    *((size_t*) &v->size)=size;
+    CH_VECTOR_TYPE_FCT(_set_size)(v,size);
 }
 CH_API size_t CH_VECTOR_TYPE_FCT(_unsorted_search)(const CH_VECTOR_TYPE* v,const CH_KEY_TYPE* key,int* match,const CH_HASHTABLE_TYPE* ht)  {
     size_t i;
@@ -688,11 +1339,12 @@ CH_API size_t CH_VECTOR_TYPE_FCT(_unsorted_search)(const CH_VECTOR_TYPE* v,const
 #           else
             cmp_ok = (*key==v->v[i].k)?1:0;
 #           endif
-            if (cmp_ok) {if (match) {*match=1;} return i;}}
+            if (cmp_ok) {if (match) {*match=1;} CH_STATS_ADD(ht,num_key_cmps,i+1);return i;}}
     }
     else    {
-        for (i = 0; i < v->size; i++) {if (ht->key_cmp(key,&v->v[i].k)==0) {if (match) {*match=1;}return i;}}
+        for (i = 0; i < v->size; i++) {if (ht->key_cmp(key,&v->v[i].k)==0) {if (match) {*match=1;}CH_STATS_ADD(ht,num_key_cmps,i+1);return i;}}
     }
+    CH_STATS_ADD(ht,num_key_cmps,v->size);
     CH_ASSERT(i==v->size);
     return i;
 }
@@ -702,7 +1354,7 @@ CH_API size_t CH_VECTOR_TYPE_FCT(_linear_search)(const CH_VECTOR_TYPE* v,const C
     if (match) *match=0;
     if (v->size==0) return 0;  /* otherwise match will be 1 */
     for (i = 0; i < v->size; i++) {
-        cmp = ht->key_cmp(key,&v->v[i].k);
+        cmp = ht->key_cmp(key,&v->v[i].k);CH_STATS_ADD(ht,num_key_cmps,1);
         if (cmp<=0) {
             if (cmp==0 && match) *match=1;
             return i;
@@ -720,7 +1372,7 @@ CH_API size_t CH_VECTOR_TYPE_FCT(_binary_search)(const CH_VECTOR_TYPE* v,const C
     last=v->size-1;
     while (first <= last) {
         mid = (first + last) / 2;
-        cmp = ht->key_cmp(key,&v->v[mid].k);
+        cmp = ht->key_cmp(key,&v->v[mid].k);CH_STATS_ADD(ht,num_key_cmps,1);
         if (cmp>0) {
             first = mid + 1;
         }
@@ -733,12 +1385,63 @@ CH_API size_t CH_VECTOR_TYPE_FCT(_binary_search)(const CH_VECTOR_TYPE* v,const C
     CH_ASSERT(mid<v->size);
     return cmp>0 ? (mid+1) : mid;
 }
-CH_API size_t CH_VECTOR_TYPE_FCT(_insert_key_at)(CH_VECTOR_TYPE* v,const CH_KEY_TYPE* key_to_insert,size_t position,const CH_HASHTABLE_TYPE* ht)  {
+#ifdef CH_USE_CACHED_HASHES
+CH_API size_t CH_VECTOR_TYPE_FCT(_hash_search)(const CH_VECTOR_TYPE* v,const CH_KEY_TYPE* key,unsigned h,int* match,const CH_HASHTABLE_TYPE* ht)  {
+    /* items are sorted by (h,key) (or by h only when 'key_cmp' is NULL):
+       we find the first item with the same 'h' with a binary search on integers,
+       and then we compare keys only inside this (generally very short) range */
+    size_t first=0,last=v->size,mid;int cmp;
+    CH_ASSERT(v && ht);
+    if (match) *match=0;
+    while (first<last) {
+        mid = first+(last-first)/2;
+        if (v->v[mid].h<h) first = mid+1;
+        else last = mid;
+    }
+    for (;first<v->size && v->v[first].h==h;first++)    {
+        if (ht->key_cmp) cmp = ht->key_cmp(key,&v->v[first].k);
+        else {
+#           ifndef CHV_KEY_SUPPORT_EQUALITY_CMP_IN_UNSORTED_SEARCH  /* this is reset after header inclusion */
+            cmp = memcmp(key,&v->v[first].k,sizeof(CH_KEY_TYPE));
+#           else
+            cmp = (*key==v->v[first].k)?0:1;
+#           endif
+        }
+        CH_STATS_ADD(ht,num_key_cmps,1);
+        if (cmp==0) {if (match) {*match=1;} return first;}
+        if (cmp<0 && ht->key_cmp) break;  /* keys with the same 'h' are sorted only when 'key_cmp' is present */
+    }
+    return first;
+}
+#endif /* CH_USE_CACHED_HASHES */
+CH_API size_t CH_VECTOR_TYPE_FCT(_search)(const CH_VECTOR_TYPE* v,const CH_KEY_TYPE* key,CH_KEY_HASH_UINT hash,int* match,const CH_HASHTABLE_TYPE* ht)  {
+    /* returns the position of 'key' (*match==1) or the position where it must be inserted (*match==0) */
+    CH_ASSERT(v && ht && match);
+#   ifdef CH_USE_CACHED_HASHES
+    return CH_VECTOR_TYPE_FCT(_hash_search)(v,key,(unsigned)hash,match,ht);
+#   else
+    (void)hash;
+    if (v->size==0)    {*match=0;return 0;}
+    if (ht->key_cmp)   {
+        /* slightly faster */
+        return  v->size>2 ? CH_VECTOR_TYPE_FCT(_binary_search)(v,key,match,ht) :
+                CH_VECTOR_TYPE_FCT(_linear_search)(v,key,match,ht);
+        /* slightly slower */
+        /* return CH_VECTOR_TYPE_FCT(_binary_search)(v,key,match,ht); */
+    }
+    /* '_unsorted_search' uses memcmp(...) (when ht->key_cmp==NULL) */
+    return CH_VECTOR_TYPE_FCT(_unsorted_search)(v,key,match,ht);
+#   endif
+}
+CH_API size_t CH_VECTOR_TYPE_FCT(_insert_key_at)(CH_VECTOR_TYPE* v,const CH_KEY_TYPE* key_to_insert,size_t position,CH_HASHTABLE_TYPE* ht)  {
     /* position is in [0,v->size] */
     /* warning: this code does NOT support passing pointers to keys already present in this hashtable */
     CH_ASSERT(v && ht && key_to_insert && position<=v->size);
     CH_VECTOR_TYPE_FCT(_reserve)(v,v->size+1,ht);
-    if (position<v->size) memmove(&v->v[position+1],&v->v[position],(v->size-position)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    if (position<v->size) {
+        memmove(&v->v[position+1],&v->v[position],(v->size-position)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+        CH_STATS_ADD(ht,num_bytes_moved,(v->size-position)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    }
 #   ifndef CH_DISABLE_CLEARING_ITEM_MEMORY
     if (ht->key_ctr || ht->key_cpy || ht->value_ctr || ht->value_cpy) memset(&v->v[position],0,sizeof(CH_HASHTABLE_ITEM_TYPE));
 #   endif
@@ -746,7 +1449,7 @@ CH_API size_t CH_VECTOR_TYPE_FCT(_insert_key_at)(CH_VECTOR_TYPE* v,const CH_KEY_
     if (ht->value_ctr)  ht->value_ctr(&v->v[position].v);
     if (!ht->key_cpy)   memcpy(&v->v[position].k,key_to_insert,sizeof(CH_KEY_TYPE));
     else ht->key_cpy(&v->v[position].k,key_to_insert);
-    *((size_t*) &v->size)=v->size+1;
+    CH_VECTOR_TYPE_FCT(_set_size)(v,v->size+1);
     return position;
 }
 CH_API int CH_VECTOR_TYPE_FCT(_remove_at)(CH_VECTOR_TYPE* v,size_t position,const CH_HASHTABLE_TYPE* ht)  {
@@ -759,12 +1462,431 @@ CH_API int CH_VECTOR_TYPE_FCT(_remove_at)(CH_VECTOR_TYPE* v,size_t position,cons
         if (ht->key_dtr)    ht->key_dtr(&v->v[position].k);
         if (ht->value_dtr)  ht->value_dtr(&v->v[position].v);
         memmove(&v->v[position],&v->v[position+1],(v->size-position-1)*sizeof(CH_HASHTABLE_ITEM_TYPE));
-        *((size_t*) &v->size)=v->size-1;
+        CH_STATS_ADD(ht,num_bytes_moved,(v->size-position-1)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+        CH_VECTOR_TYPE_FCT(_set_size)(v,v->size-1);
     }
     return removal_ok;
 }
+CH_API void CH_VECTOR_TYPE_FCT(_cpy)(CH_VECTOR_TYPE* A,const CH_VECTOR_TYPE* B,CH_HASHTABLE_TYPE* ht)  {
+    size_t i;
+    CH_ASSERT(A && B && ht);
+    /* bad init asserts */
+    CH_ASSERT(!(A->v && A->capacity==0));
+    CH_ASSERT(!(!A->v && A->capacity>0));
+    CH_ASSERT(!(B->v && B->capacity==0));
+    CH_ASSERT(!(!B->v && B->capacity>0));
+    CH_VECTOR_TYPE_FCT(_clear)(A,ht);
+    if (B->size==0) return;
+    CH_VECTOR_TYPE_FCT(_resize)(A,B->size,ht);
+    CH_ASSERT(A->size==B->size);
+    if (!ht->key_cpy && !ht->value_cpy)   {memcpy(&A->v[0],&B->v[0],A->size*sizeof(CH_HASHTABLE_ITEM_TYPE));}
+    else {
+        for (i=0;i<A->size;i++) {
+#           ifdef CH_USE_CACHED_HASHES
+            A->v[i].h = B->v[i].h;
+#           endif
+            if (ht->key_cpy)    ht->key_cpy(&A->v[i].k,&B->v[i].k);
+            else                memcpy(&A->v[i].k,&B->v[i].k,sizeof(CH_KEY_TYPE));
+            if (ht->value_cpy)  ht->value_cpy(&A->v[i].v,&B->v[i].v);
+            else                memcpy(&A->v[i].v,&B->v[i].v,sizeof(CH_VALUE_TYPE));
+        }
+    }
+}
+#ifdef CH_USE_RCU_READS
+CH_API void CH_VECTOR_TYPE_FCT(_rcu_free_retired)(CH_HASHTABLE_TYPE* ht,ch_rcu_block_header* list)  {
+    /* no reader can access these arrays anymore: the dtrs of their retired item are called, and they are freed */
+    while (list)    {
+        ch_rcu_block_header* next = list->next_retired;
+        CH_HASHTABLE_ITEM_TYPE* item = &((CH_HASHTABLE_ITEM_TYPE*)((unsigned char*)list+CH_RCU_HEADER))[list->retired_item];
+        if ((list->retired_dtrs&1) && ht->key_dtr)    ht->key_dtr(&item->k);
+        if ((list->retired_dtrs&2) && ht->value_dtr)  ht->value_dtr(&item->v);
+        ch_free(list);
+        list = next;
+    }
+}
+CH_API CH_HASHTABLE_ITEM_TYPE* CH_VECTOR_TYPE_FCT(_rcu_copy)(const CH_VECTOR_TYPE* v,size_t position,size_t num_removed,size_t num_inserted)  {
+    /* it returns a new array with the items of 'v', where 'num_removed' items at 'position' are replaced by
+       'num_inserted' uninitialized items (or NULL, if the new array is empty). Items are copied with memcpy:
+       both arrays share their keys and values until the old one is freed */
+    const size_t size = v->size-num_removed+num_inserted;
+    CH_HASHTABLE_ITEM_TYPE* items;
+    CH_ASSERT(position+num_removed<=v->size);
+    if (size==0) return NULL;
+    items = (CH_HASHTABLE_ITEM_TYPE*) ((unsigned char*)ch_malloc(CH_RCU_HEADER+size*sizeof(CH_HASHTABLE_ITEM_TYPE))+CH_RCU_HEADER);
+    CH_RCU_HEADER_OF(items)->size = size;
+    if (position>0) memcpy((void*)items,v->v,position*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    if (position+num_removed<v->size) memcpy((void*)&items[position+num_inserted],&v->v[position+num_removed],(v->size-position-num_removed)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    return items;
+}
+CH_API void CH_VECTOR_TYPE_FCT(_rcu_publish)(CH_HASHTABLE_TYPE* ht,CH_VECTOR_TYPE* v,CH_HASHTABLE_ITEM_TYPE* items,size_t retired_item,size_t retired_dtrs)  {
+    /* it replaces the items of 'v' (its stripe must be write-locked), and retires the old array.
+       The old array is freed (and the dtrs of its item 'retired_item' are called) after a grace period */
+    CH_HASHTABLE_ITEM_TYPE* old_items = v->v;
+    ch_rcu_block_header* list = NULL;
+    CH_ATOMIC_STORE_PTR((void**)&v->v,(void*)items);   /* release: readers see a fully initialized array */
+    *((size_t*) &v->size) = *((size_t*) &v->capacity) = (items ? CH_RCU_HEADER_OF(items)->size : 0);
+    if (!old_items) return;
+    CH_RCU_HEADER_OF(old_items)->retired_item = retired_item;
+    CH_RCU_HEADER_OF(old_items)->retired_dtrs = retired_dtrs;
+    ch_stripe_lock_write(&ht->rcu.lock);
+    CH_RCU_HEADER_OF(old_items)->next_retired = ht->rcu.retired;
+    ht->rcu.retired = CH_RCU_HEADER_OF(old_items);
+    if (++ht->rcu.num_retired>=CH_RCU_RETIRE_BATCH) {
+        list = ht->rcu.retired;ht->rcu.retired = NULL;ht->rcu.num_retired = 0;
+        ch_rcu_synchronize(&ht->rcu);
+    }
+    ch_stripe_unlock_write(&ht->rcu.lock);
+    CH_VECTOR_TYPE_FCT(_rcu_free_retired)(ht,list);    /* dtrs are called without holding 'rcu.lock' */
+}
+#endif /* CH_USE_RCU_READS */
+#ifdef CH_USE_DYNAMIC_BUCKETS
+CH_API CH_VECTOR_TYPE* CH_VECTOR_TYPE_FCT(_from_hash)(const CH_HASHTABLE_TYPE* ht,size_t hash)  {
+    /* while rehashing, an item stays in 'old_buckets' until its old bucket has been moved */
+    CH_ASSERT(ht && ht->buckets);
+    if (ht->old_buckets)    {
+        const size_t i = hash&(ht->old_num_buckets-1);
+        if (i>=ht->rehash_index) return &ht->old_buckets[i];
+    }
+    return &ht->buckets[hash&(ht->num_buckets-1)];
+}
+CH_API CH_VECTOR_TYPE* CH_VECTOR_TYPE_FCT(_alloc_buckets)(size_t num_buckets)  {
+    CH_VECTOR_TYPE* b = (CH_VECTOR_TYPE*) ch_malloc(num_buckets*sizeof(CH_VECTOR_TYPE));
+    memset((void*)b,0,num_buckets*sizeof(CH_VECTOR_TYPE));
+    return b;
+}
+CH_API void CH_VECTOR_TYPE_FCT(_rehash_start)(CH_HASHTABLE_TYPE* ht,size_t new_num_buckets)  {
+    CH_ASSERT(ht && ht->buckets && !ht->old_buckets);
+    CH_ASSERT(new_num_buckets>ht->num_buckets && (new_num_buckets&(new_num_buckets-1))==0);
+    ht->old_buckets = ht->buckets;
+    *((size_t*)&ht->old_num_buckets) = ht->num_buckets;
+    *((size_t*)&ht->rehash_index) = 0;
+    ht->buckets = CH_VECTOR_TYPE_FCT(_alloc_buckets)(new_num_buckets);
+    *((size_t*)&ht->num_buckets) = new_num_buckets;
+    CH_STATS_ADD(ht,num_reallocs,1);
+}
+CH_API void CH_VECTOR_TYPE_FCT(_rehash_step)(CH_HASHTABLE_TYPE* ht,size_t num_steps)  {
+    /* moves 'num_steps' old buckets to the new bucket array.
+       Since 'num_buckets' is a multiple of 'old_num_buckets', the items of 'old_buckets[i]' can only go
+       to new buckets that receive items from 'old_buckets[i]' only: so we can just append them
+       in their (sorted) order, and items are moved without calling any ctr/dtr/cpy callback */
+    CH_ASSERT(ht);
+    while (ht->old_buckets && num_steps--)  {
+        CH_VECTOR_TYPE* ob = &ht->old_buckets[ht->rehash_index];
+        size_t j;
+        for (j=0;j<ob->size;j++)  {
+            const CH_HASHTABLE_ITEM_TYPE* item = &ob->v[j];
+#           ifdef CH_USE_CACHED_HASHES
+            CH_VECTOR_TYPE* nb = &ht->buckets[item->h&(ht->num_buckets-1)];  /* 'num_buckets' can't exceed 2^32 here */
+#           else
+            CH_VECTOR_TYPE* nb = &ht->buckets[ht->key_hash(&item->k)&(ht->num_buckets-1)];
+#           endif
+            CH_VECTOR_TYPE_FCT(_reserve)(nb,nb->size+1,ht);
+            memcpy(&nb->v[nb->size],item,sizeof(CH_HASHTABLE_ITEM_TYPE));
+            *((size_t*) &nb->size)=nb->size+1;
+        }
+        CH_VECTOR_TYPE_FCT(_free_items)(ob,ht);  /* with CH_USE_BUCKET_SLABS its block is reused by the new buckets */
+        *((size_t*)&ht->rehash_index) = ht->rehash_index+1;
+        if (ht->rehash_index==ht->old_num_buckets)  {
+            ch_free(ht->old_buckets);ht->old_buckets=NULL;
+            *((size_t*)&ht->old_num_buckets) = *((size_t*)&ht->rehash_index) = 0;
+        }
+    }
+}
+#endif /* CH_USE_DYNAMIC_BUCKETS */
+#else /* CH_USE_OPEN_ADDRESSING */
+CH_API int CH_VECTOR_TYPE_FCT(_oa_key_equal)(const CH_KEY_TYPE* a,const CH_KEY_TYPE* b,const CH_HASHTABLE_TYPE* ht)  {
+    CH_STATS_ADD(ht,num_key_cmps,1);
+    if (ht->key_cmp) return ht->key_cmp(a,b)==0 ? 1 : 0;
+#   ifndef CHV_KEY_SUPPORT_EQUALITY_CMP_IN_UNSORTED_SEARCH  /* this is reset after header inclusion */
+    return memcmp(a,b,sizeof(CH_KEY_TYPE))==0 ? 1 : 0;
+#   else
+    return (*a==*b) ? 1 : 0;
+#   endif
+}
+CH_API size_t CH_VECTOR_TYPE_FCT(_oa_find)(const CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,size_t hash,int* match)  {
+    /* returns the slot of 'key' (and *match=1), or the slot where 'key' can be inserted (and *match=0).
+       Groups are visited by triangular probing, that visits all of them when their number is a power of two */
+    const size_t group_mask = ht->capacity/CH_OA_GROUP_WIDTH-1;
+    const unsigned char h2 = (unsigned char)(hash&0x7F);
+    size_t g = (hash>>7)&group_mask, step = 0, insert_pos = ht->capacity;
+    CH_ASSERT(ht && match && ht->capacity>0);
+    *match = 0;
+    for (;;)    {
+        const unsigned char* group = &ht->ctrl[g*CH_OA_GROUP_WIDTH];
+        unsigned mask = ch_oa_group_match(group,h2);
+        while (mask)    {
+            const size_t i = g*CH_OA_GROUP_WIDTH+ch_oa_ctz(mask);
+            if (CH_VECTOR_TYPE_FCT(_oa_key_equal)(key,&ht->slots[i].k,ht)) {*match=1;return i;}
+            mask&=mask-1;
+        }
+        if (insert_pos==ht->capacity)   {
+            mask = ch_oa_group_match_empty_or_deleted(group);
+            if (mask) insert_pos = g*CH_OA_GROUP_WIDTH+ch_oa_ctz(mask);
+        }
+        if (ch_oa_group_match_empty(group) || step==group_mask) break;    /* 'key' is not present */
+        g = (g+(++step))&group_mask;
+    }
+    return insert_pos;
+}
+CH_API size_t CH_VECTOR_TYPE_FCT(_oa_find_free)(const CH_HASHTABLE_TYPE* ht,size_t hash)  {
+    const size_t group_mask = ht->capacity/CH_OA_GROUP_WIDTH-1;
+    size_t g = (hash>>7)&group_mask, step = 0;
+    unsigned mask;
+    CH_ASSERT(ht && ht->capacity>0);
+    while (!(mask=ch_oa_group_match_empty_or_deleted(&ht->ctrl[g*CH_OA_GROUP_WIDTH]))) g = (g+(++step))&group_mask;
+    return g*CH_OA_GROUP_WIDTH+ch_oa_ctz(mask);
+}
+CH_API void CH_VECTOR_TYPE_FCT(_oa_resize)(CH_HASHTABLE_TYPE* ht,size_t new_capacity)  {
+    /* moves all the items to a new slot array, without calling any ctr/dtr/cpy callback */
+    CH_HASHTABLE_ITEM_TYPE* old_slots = ht->slots;
+    const unsigned char* old_ctrl = ht->ctrl;
+    const size_t old_capacity = ht->capacity;
+    size_t i;
+    CH_ASSERT(ht && new_capacity>=CH_OA_GROUP_WIDTH && (new_capacity&(new_capacity-1))==0 && CH_OA_MAX_LOAD(new_capacity)>=ht->num_items);
+    /* a single allocation: slots first, then control bytes */
+    CH_STATS_ADD(ht,num_reallocs,1);
+    ht->slots = (CH_HASHTABLE_ITEM_TYPE*) ch_malloc(new_capacity*(sizeof(CH_HASHTABLE_ITEM_TYPE)+1));
+    ht->ctrl = (unsigned char*) &ht->slots[new_capacity];
+    memset(ht->ctrl,CH_OA_EMPTY,new_capacity);
+    *((size_t*)&ht->capacity) = new_capacity;
+    for (i=0;i<old_capacity;i++)    {
+        if (old_ctrl[i]<0x80)   {
+            const size_t hash = ht->key_hash(&old_slots[i].k);
+            const size_t j = CH_VECTOR_TYPE_FCT(_oa_find_free)(ht,hash);
+            ht->ctrl[j] = (unsigned char)(hash&0x7F);
+            memcpy((void*)&ht->slots[j],&old_slots[i],sizeof(CH_HASHTABLE_ITEM_TYPE));
+        }
+    }
+    *((size_t*)&ht->growth_left) = CH_OA_MAX_LOAD(new_capacity)-ht->num_items;
+    if (old_slots) ch_free(old_slots);
+}
+#endif /* CH_USE_OPEN_ADDRESSING */
+CH_API void CH_VECTOR_TYPE_FCT(_prefetch)(const CH_HASHTABLE_TYPE* ht,CH_KEY_HASH_UINT hash,int stage)  {
+    /* stage 0 prefetches the bucket (or the control bytes), stage 1 the bucket items (or the slots).
+       Stage 1 reads the bucket prefetched by stage 0, so it should be called later */
+#   ifdef CH_USE_OPEN_ADDRESSING
+    if (ht->capacity)   {
+        const size_t i = ((hash>>7)&(ht->capacity/CH_OA_GROUP_WIDTH-1))*CH_OA_GROUP_WIDTH;
+        if (stage==0)   CH_PREFETCH(&ht->ctrl[i]);
+        else            CH_PREFETCH(&ht->slots[i]);
+    }
+#   else /* CH_USE_OPEN_ADDRESSING */
+    const CH_VECTOR_TYPE* v;
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+#   ifdef CH_USE_CACHED_HASHES
+    v = &ht->buckets[hash%CH_NUM_BUCKETS];
+#   else
+    v = &ht->buckets[hash];
+#   endif
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    if (!ht->buckets) return;
+    v = CH_VECTOR_TYPE_FCT(_from_hash)(ht,hash);
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+    if (stage==0)   CH_PREFETCH(v);
+    else if (v->v)  {
+#       ifndef CH_USE_CACHED_HASHES
+        if (!ht->key_cmp) {CH_PREFETCH(&v->v[0]);return;}   /* unsorted search */
+#       endif
+        CH_PREFETCH(&v->v[v->size/2]);  /* first probe of the binary search */
+    }
+#   endif /* CH_USE_OPEN_ADDRESSING */
+}
 /* --- PRIVATE FUNCTIONS END -------------------------------------------------- */
 
+#ifdef CH_USE_OPEN_ADDRESSING
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_clear)(CH_HASHTABLE_TYPE* ht)    {
+    if (ht && ht->capacity) {
+        if (ht->key_dtr || ht->value_dtr)   {
+            size_t i;
+            for (i=0;i<ht->capacity;i++)    {
+                if (ht->ctrl[i]<0x80)   {
+                    if (ht->key_dtr)    ht->key_dtr(&ht->slots[i].k);
+                    if (ht->value_dtr)  ht->value_dtr(&ht->slots[i].v);
+                }
+            }
+        }
+        memset(ht->ctrl,CH_OA_EMPTY,ht->capacity);
+        *((size_t*)&ht->num_items) = 0;
+        *((size_t*)&ht->growth_left) = CH_OA_MAX_LOAD(ht->capacity);
+    }
+}
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_free)(CH_HASHTABLE_TYPE* ht)    {
+    if (ht) {
+        CH_HASHTABLE_TYPE_FCT(_clear)(ht);
+        if (ht->slots) {ch_free(ht->slots);ht->slots=NULL;ht->ctrl=NULL;}
+        *((size_t*)&ht->capacity) = *((size_t*)&ht->growth_left) = 0;
+    }
+}
+CH_API CH_VALUE_TYPE* CH_VECTOR_TYPE_FCT(_get_or_insert_with_hash)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,size_t hash,int* match) {
+    CH_HASHTABLE_ITEM_TYPE* item = NULL;
+    size_t position=0;int match2=0;
+    CH_ASSERT(ht);
+    CH_STATS_ADD(ht,num_lookups,1);
+    if (ht->capacity)   {
+        position = CH_VECTOR_TYPE_FCT(_oa_find)(ht,key,hash,&match2);
+        if (match) *match=match2;
+        if (match2) {CH_STATS_ADD(ht,num_hits,1);return &ht->slots[position].v;}
+    }
+    else if (match) *match=0;
+    CH_STATS_ADD(ht,num_misses,1);CH_STATS_ADD(ht,num_inserts,1);
+
+    if (ht->capacity==0 || (ht->growth_left==0 && ht->ctrl[position]==CH_OA_EMPTY))  {
+        /* the slot array grows (or it's just rebuilt at the same size, when most of the used slots are CH_OA_DELETED) */
+        const size_t new_capacity = ht->capacity==0 ? ch_oa_capacity_for(ht->initial_bucket_capacity) :
+                                    (ht->num_items*2<=CH_OA_MAX_LOAD(ht->capacity) ? ht->capacity : ht->capacity*2);
+        CH_VECTOR_TYPE_FCT(_oa_resize)(ht,new_capacity);
+        position = CH_VECTOR_TYPE_FCT(_oa_find_free)(ht,hash);
+    }
+
+    /* we must insert an item at 'position' */
+    if (ht->ctrl[position]==CH_OA_EMPTY) *((size_t*)&ht->growth_left) = ht->growth_left-1;
+    ht->ctrl[position] = (unsigned char)(hash&0x7F);
+    item = &ht->slots[position];
+#   ifndef CH_DISABLE_CLEARING_ITEM_MEMORY
+    if (ht->key_ctr || ht->key_cpy || ht->value_ctr || ht->value_cpy) memset((void*)item,0,sizeof(CH_HASHTABLE_ITEM_TYPE));
+#   endif
+    if (ht->key_ctr)    ht->key_ctr(&item->k);
+    if (ht->value_ctr)  ht->value_ctr(&item->v);
+    if (!ht->key_cpy)   memcpy((void*)&item->k,key,sizeof(CH_KEY_TYPE));
+    else ht->key_cpy(&item->k,key);
+    *((size_t*)&ht->num_items) = ht->num_items+1;
+    return &item->v;
+}
+CH_API CH_VALUE_TYPE* CH_VECTOR_TYPE_FCT(_get_with_hash)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,size_t hash) {
+    size_t position;int match=0;
+    CH_ASSERT(ht);
+    CH_STATS_ADD(ht,num_lookups,1);
+    if (ht->num_items==0) {CH_STATS_ADD(ht,num_misses,1);return NULL;}
+    position = CH_VECTOR_TYPE_FCT(_oa_find)(ht,key,hash,&match);
+    if (match) {CH_STATS_ADD(ht,num_hits,1);return &ht->slots[position].v;}
+    CH_STATS_ADD(ht,num_misses,1);
+    return NULL;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+    CH_HASHTABLE_ITEM_TYPE* item = NULL;
+    size_t position;int match=0;
+    CH_ASSERT(ht && ht->key_hash);
+    CH_STATS_ADD(ht,num_lookups,1);
+    if (ht->num_items==0) {CH_STATS_ADD(ht,num_misses,1);return 0;}
+    position = CH_VECTOR_TYPE_FCT(_oa_find)(ht,key,ht->key_hash(key),&match);
+    if (!match) {CH_STATS_ADD(ht,num_misses,1);return 0;}
+    CH_STATS_ADD(ht,num_hits,1);CH_STATS_ADD(ht,num_removes,1);
+    item = &ht->slots[position];
+    if (ht->key_dtr)    ht->key_dtr(&item->k);
+    if (ht->value_dtr)  ht->value_dtr(&item->v);
+    if (ch_oa_group_match_empty(&ht->ctrl[position-position%CH_OA_GROUP_WIDTH]))  {
+        /* no probe sequence has ever gone past this group, so the slot can be CH_OA_EMPTY again */
+        ht->ctrl[position] = CH_OA_EMPTY;
+        *((size_t*)&ht->growth_left) = ht->growth_left+1;
+    }
+    else ht->ctrl[position] = CH_OA_DELETED;
+    *((size_t*)&ht->num_items) = ht->num_items-1;
+    return 1;
+}
+CH_API_DEF size_t CH_HASHTABLE_TYPE_FCT(_get_num_items)(const CH_HASHTABLE_TYPE* ht) {CH_ASSERT(ht);return ht->num_items;}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht) {
+    size_t i,num_used=0,num_deleted=0,num_hash_errors=0,sum_probe_len=0,max_probe_len=0;
+    size_t mem_minimal=sizeof(CH_HASHTABLE_TYPE),mem_used=sizeof(CH_HASHTABLE_TYPE);
+    double mem_used_percentage = 100,load_factor = 0,mean_probe_len = 0;
+    CH_ASSERT(ht);
+    for (i=0;i<ht->capacity;i++) {
+        if (ht->ctrl[i]<0x80)   {
+            /* number of groups probed to find this item */
+            const size_t hash = ht->key_hash(&ht->slots[i].k);
+            const size_t group_mask = ht->capacity/CH_OA_GROUP_WIDTH-1;
+            size_t g = (hash>>7)&group_mask, step = 0;
+            while (g!=i/CH_OA_GROUP_WIDTH && step<=group_mask) g = (g+(++step))&group_mask;
+            sum_probe_len+=step+1;
+            if (max_probe_len<step+1) max_probe_len=step+1;
+            if (ht->ctrl[i]!=(unsigned char)(hash&0x7F) || step>group_mask)  {
+                /* When this happens, 'key_hash' is not consistent (or the table is corrupted) */
+                ++num_hash_errors;
+#               ifndef CH_NO_STDIO
+                fprintf(stderr,"[%s] Hash Error (%" CV_SIZE_T_FORMATTING "): in slot[%" CV_SIZE_T_FORMATTING "]\n",CH_XSTR(CH_HASHTABLE_TYPE_FCT(_dbg_check)),num_hash_errors,i);
+#               endif
+            }
+            ++num_used;
+        }
+        else if (ht->ctrl[i]==CH_OA_DELETED) ++num_deleted;
+    }
+    mem_minimal += num_used*(sizeof(CH_HASHTABLE_ITEM_TYPE)+1);
+    mem_used += ht->capacity*(sizeof(CH_HASHTABLE_ITEM_TYPE)+1);
+    mem_used_percentage = (double)mem_used*100.0/(double)mem_minimal;
+    if (ht->capacity) load_factor = (double)num_used/(double)ht->capacity;
+    if (num_used) mean_probe_len = (double)sum_probe_len/(double)num_used;
+#   ifndef CH_NO_STDIO
+    printf("[%s]:\n",CH_XSTR(CH_HASHTABLE_TYPE_FCT(_dbg_check)));
+    printf("\tnum_total_items=%" CV_SIZE_T_FORMATTING " in %" CV_SIZE_T_FORMATTING " slots [load_factor=%1.3f deleted_slots=%" CV_SIZE_T_FORMATTING " growth_left=%" CV_SIZE_T_FORMATTING "] [groups probed per item: mean=%1.3f max=%" CV_SIZE_T_FORMATTING "].\n",num_used,ht->capacity,load_factor,num_deleted,ht->growth_left,mean_probe_len,max_probe_len);
+    printf("\tmemory_used: ");ch_display_bytes(mem_used);
+    printf(". memory_minimal_possible: ");ch_display_bytes(mem_minimal);
+    printf(". mem_used_percentage: %1.2f%% (100%% is the best possible result).\n",mem_used_percentage);
+#   endif
+    CH_ASSERT(num_hash_errors==0);
+    CH_ASSERT(num_used==ht->num_items);
+    return (int) num_used;
+}
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_cpy)(CH_HASHTABLE_TYPE* a,const CH_HASHTABLE_TYPE* b) {
+    typedef CH_KEY_HASH_UINT (*key_hash_type)(const CH_KEY_TYPE*);
+    typedef int (*key_cmp_type)(const CH_CMP_TYPE*,const CH_CMP_TYPE*);
+    typedef void (*key_ctr_dtr_type)(CH_KEY_TYPE*);
+    typedef void (*key_cpy_type)(CH_KEY_TYPE*,const CH_KEY_TYPE*);
+    typedef void (*value_ctr_dtr_type)(CH_VALUE_TYPE*);
+    typedef void (*value_cpy_type)(CH_VALUE_TYPE*,const CH_VALUE_TYPE*);
+    size_t i;
+    if (a==b) return;
+    CH_ASSERT(a && b);
+    CH_HASHTABLE_TYPE_FCT(_free)(a);   /* with its own callbacks */
+    *((key_hash_type*)&a->key_hash) = b->key_hash;
+    *((key_cmp_type*)&a->key_cmp) = b->key_cmp;
+    *((key_ctr_dtr_type*)&a->key_ctr) = b->key_ctr;
+    *((key_ctr_dtr_type*)&a->key_dtr) = b->key_dtr;
+    *((key_cpy_type*)&a->key_cpy) = b->key_cpy;
+    *((value_ctr_dtr_type*)&a->value_ctr) = b->value_ctr;
+    *((value_ctr_dtr_type*)&a->value_dtr) = b->value_dtr;
+    *((value_cpy_type*)&a->value_cpy) = b->value_cpy;
+    *((size_t*)&a->initial_bucket_capacity) = b->initial_bucket_capacity;
+    *((const cvh_growth_policy_t**)&a->growth_policy) = b->growth_policy;
+    if (b->capacity==0) return;
+    /* same layout: items keep their slots */
+    a->slots = (CH_HASHTABLE_ITEM_TYPE*) ch_malloc(b->capacity*(sizeof(CH_HASHTABLE_ITEM_TYPE)+1));
+    a->ctrl = (unsigned char*) &a->slots[b->capacity];
+    memcpy(a->ctrl,b->ctrl,b->capacity);
+    *((size_t*)&a->capacity) = b->capacity;
+    *((size_t*)&a->num_items) = b->num_items;
+    *((size_t*)&a->growth_left) = b->growth_left;
+    for (i=0;i<b->capacity;i++) {
+        if (b->ctrl[i]<0x80)   {
+            CH_HASHTABLE_ITEM_TYPE* A = &a->slots[i];
+            const CH_HASHTABLE_ITEM_TYPE* B = &b->slots[i];
+            if (!a->key_cpy && !a->value_cpy)   {memcpy((void*)A,B,sizeof(CH_HASHTABLE_ITEM_TYPE));continue;}
+#           ifndef CH_DISABLE_CLEARING_ITEM_MEMORY
+            memset((void*)A,0,sizeof(CH_HASHTABLE_ITEM_TYPE));
+#           endif
+            if (a->key_ctr)     a->key_ctr(&A->k);
+            if (a->value_ctr)   a->value_ctr(&A->v);
+            if (a->key_cpy)     a->key_cpy(&A->k,&B->k);
+            else                memcpy((void*)&A->k,&B->k,sizeof(CH_KEY_TYPE));
+            if (a->value_cpy)   a->value_cpy(&A->v,&B->v);
+            else                memcpy((void*)&A->v,&B->v,sizeof(CH_VALUE_TYPE));
+        }
+    }
+}
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_shrink_to_fit)(CH_HASHTABLE_TYPE* ht)   {
+    if (ht)	{
+        /* this removes all the CH_OA_DELETED slots too */
+        if (ht->num_items==0) CH_HASHTABLE_TYPE_FCT(_free)(ht);
+        else CH_VECTOR_TYPE_FCT(_oa_resize)(ht,ch_oa_capacity_for(ht->num_items));
+    }
+}
+/* It grows the slot array (if necessary), so that it can store at least 'min_capacity' items without growing again */
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_rehash)(CH_HASHTABLE_TYPE* ht,size_t min_capacity)   {
+    size_t new_capacity;
+    CH_ASSERT(ht);
+    new_capacity = ch_oa_capacity_for(min_capacity>ht->num_items ? min_capacity : ht->num_items);
+    if (new_capacity>ht->capacity) CH_VECTOR_TYPE_FCT(_oa_resize)(ht,new_capacity);
+}
+#else /* CH_USE_OPEN_ADDRESSING */
+#ifndef CH_USE_DYNAMIC_BUCKETS
 CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_free)(CH_HASHTABLE_TYPE* ht)    {
     if (ht) {
         const unsigned short max_value = (CH_NUM_BUCKETS-1);
@@ -772,10 +1894,16 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_free)(CH_HASHTABLE_TYPE* ht)    {
         do    {
             CH_VECTOR_TYPE* b = &ht->buckets[i];
             CH_VECTOR_TYPE_FCT(_clear)(b,ht);
-            if (b->v) {ch_free(b->v);ht->buckets[i].v=NULL;}
-            *((size_t*)&b->capacity)=0;
+            CH_VECTOR_TYPE_FCT(_free_items)(b,ht);
         }
         while (i++!=max_value);
+#       ifdef CH_USE_BUCKET_SLABS
+        ch_slab_release(&ht->slabs);
+#       endif
+#       ifdef CH_USE_RCU_READS
+        CH_VECTOR_TYPE_FCT(_rcu_free_retired)(ht,ht->rcu.retired);
+        ht->rcu.retired = NULL;ht->rcu.num_retired = 0;
+#       endif
     }
 }
 CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_clear)(CH_HASHTABLE_TYPE* ht)    {
@@ -786,107 +1914,542 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_clear)(CH_HASHTABLE_TYPE* ht)    {
         while (i++!=max_value);
     }
 }
+#else /* CH_USE_DYNAMIC_BUCKETS */
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_free)(CH_HASHTABLE_TYPE* ht)    {
+    if (ht) {
+        size_t i;
+        for (i=0;ht->buckets && i<ht->num_buckets;i++) {
+            CH_VECTOR_TYPE* b = &ht->buckets[i];
+            CH_VECTOR_TYPE_FCT(_clear)(b,ht);
+            CH_VECTOR_TYPE_FCT(_free_items)(b,ht);
+        }
+        for (i=0;ht->old_buckets && i<ht->old_num_buckets;i++) {
+            CH_VECTOR_TYPE* b = &ht->old_buckets[i];
+            CH_VECTOR_TYPE_FCT(_clear)(b,ht);
+            CH_VECTOR_TYPE_FCT(_free_items)(b,ht);
+        }
+        if (ht->buckets) {ch_free(ht->buckets);ht->buckets=NULL;}
+        if (ht->old_buckets) {ch_free(ht->old_buckets);ht->old_buckets=NULL;}
+#       ifdef CH_USE_BUCKET_SLABS
+        ch_slab_release(&ht->slabs);
+#       endif
+        *((size_t*)&ht->num_items)=*((size_t*)&ht->old_num_buckets)=*((size_t*)&ht->rehash_index)=0;
+        /* 'num_buckets' is kept: the bucket array will be reallocated at the next insertion */
+    }
+}
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_clear)(CH_HASHTABLE_TYPE* ht)    {
+    if (ht) {
+        size_t i;
+        for (i=0;ht->buckets && i<ht->num_buckets;i++) CH_VECTOR_TYPE_FCT(_clear)(&ht->buckets[i],ht);
+        for (i=0;ht->old_buckets && i<ht->old_num_buckets;i++) CH_VECTOR_TYPE_FCT(_clear)(&ht->old_buckets[i],ht);
+        *((size_t*)&ht->num_items)=0;
+    }
+}
+#endif /* CH_USE_DYNAMIC_BUCKETS */
 
 /* Warning: 'ch_xxx_get_or_insert(...)' and 'ch_xxx_get(...)', and their overloads,
    return pointer to 'value' items inside the hashtable, that are invalidated when
    the hashtable inserts or removes other items. User should copy the result for longer storage.
 */
-CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_or_insert)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,int* match) {
+CH_API CH_VALUE_TYPE* CH_VECTOR_TYPE_FCT(_get_or_insert_with_hash)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_KEY_HASH_UINT hash,int* match) {
     CH_VECTOR_TYPE* v = NULL;
-    size_t position;ch_hash_uint hash;int match2;
-    CH_ASSERT(ht && ht->key_hash);
-    hash = ht->key_hash(key);
+    size_t position;int match2;
+    CH_ASSERT(ht);
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+#   ifdef CH_USE_CACHED_HASHES
+    v = &ht->buckets[hash%CH_NUM_BUCKETS];
+#   else
 #   if CH_NUM_BUCKETS!=CH_MAX_NUM_BUCKETS
     CH_ASSERT(hash<CH_NUM_BUCKETS);    /* user 'key_hash' should return values in [0,CH_NUM_BUCKETS). Please use: return somevalue%CH_NUM_BUCKETS */
 #   endif
     v = &ht->buckets[hash];
-    if (!v->v)  {
-        v->v = (CH_HASHTABLE_ITEM_TYPE*) ch_malloc(ht->initial_bucket_capacity*sizeof(CH_HASHTABLE_ITEM_TYPE));
-        *((size_t*)&v->capacity) = ht->initial_bucket_capacity;
+#   endif
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    if (!ht->buckets)   {
+        if (ht->num_buckets==0) *((size_t*)&ht->num_buckets) = CH_NUM_BUCKETS;
+        ht->buckets = CH_VECTOR_TYPE_FCT(_alloc_buckets)(ht->num_buckets);
     }
+    else if (ht->old_buckets) CH_VECTOR_TYPE_FCT(_rehash_step)(ht,CH_DYNAMIC_BUCKETS_REHASH_STEP);
+    v = CH_VECTOR_TYPE_FCT(_from_hash)(ht,hash);
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+    if (!v->v) CH_VECTOR_TYPE_FCT(_set_capacity)(v,ht->initial_bucket_capacity,ht);
 
-    if (v->size==0)    {position=0;match2=0;}
-    else if (ht->key_cmp)   {
-        /* slightly faster */
-        position =  v->size>2 ? CH_VECTOR_TYPE_FCT(_binary_search)(v,key,&match2,ht) :
-                    CH_VECTOR_TYPE_FCT(_linear_search)(v,key,&match2,ht);
-        /* slightly slower */
-        /* position = CH_VECTOR_TYPE_FCT(_binary_search)(v,key,&match2,ht); */
-    }
-    else    {
-        /* '_unsorted_search' uses memcmp(...) (when ht->key_cmp==NULL) */
-        position = CH_VECTOR_TYPE_FCT(_unsorted_search)(v,key,&match2,ht);
-    }
+    position = CH_VECTOR_TYPE_FCT(_search)(v,key,hash,&match2,ht);
     if (match) *match=match2;
+    CH_STATS_ADD(ht,num_lookups,1);
 
-    if (match2) return &v->v[position].v;
+    if (match2) {CH_STATS_ADD(ht,num_hits,1);return &v->v[position].v;}
+    CH_STATS_ADD(ht,num_misses,1);CH_STATS_ADD(ht,num_inserts,1);
 
     /* we must insert an item at 'position' */
     CH_VECTOR_TYPE_FCT(_insert_key_at)(v,key,position,ht);
+#   ifdef CH_USE_CACHED_HASHES
+    v->v[position].h = (unsigned)hash;
+#   endif
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    *((size_t*)&ht->num_items) = ht->num_items+1;
+    if (!ht->old_buckets && ht->num_items>ht->num_buckets*CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR)   {
+        /* this does not move any item yet, so '&v->v[position].v' is still valid */
+        CH_VECTOR_TYPE_FCT(_rehash_start)(ht,ht->num_buckets*2);
+    }
+#   endif
     return &v->v[position].v;
 }
+#endif /* CH_USE_OPEN_ADDRESSING */
+CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_or_insert)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,int* match) {
+    CH_ASSERT(ht && ht->key_hash);
+    return CH_VECTOR_TYPE_FCT(_get_or_insert_with_hash)(ht,key,ht->key_hash(key),match);
+}
 CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_or_insert_by_val)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE key,int* match) {return CH_HASHTABLE_TYPE_FCT(_get_or_insert)(ht,&key,match);}
-CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+#ifndef CH_USE_OPEN_ADDRESSING
+CH_API CH_VALUE_TYPE* CH_VECTOR_TYPE_FCT(_get_with_hash)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_KEY_HASH_UINT hash) {
     CH_VECTOR_TYPE* v = NULL;
-    size_t position;ch_hash_uint hash;int match=0;
-    CH_ASSERT(ht && ht->key_hash);
-    hash = ht->key_hash(key);
+    size_t position;int match=0;
+    CH_ASSERT(ht);
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+#   ifdef CH_USE_CACHED_HASHES
+    v = &ht->buckets[hash%CH_NUM_BUCKETS];
+#   else
 #   if CH_NUM_BUCKETS!=CH_MAX_NUM_BUCKETS
     CH_ASSERT(hash<CH_NUM_BUCKETS);    /* user 'key_hash' should return values in [0,CH_NUM_BUCKETS). Please use: return somevalue%CH_NUM_BUCKETS */
 #   endif
     v = &ht->buckets[hash];
-    if (!v->v || v->size==0)  return NULL;
+#   endif
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    if (!ht->buckets) {CH_STATS_ADD(ht,num_lookups,1);CH_STATS_ADD(ht,num_misses,1);return NULL;}
+    v = CH_VECTOR_TYPE_FCT(_from_hash)(ht,hash);
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+    CH_STATS_ADD(ht,num_lookups,1);
+    if (!v->v || v->size==0)  {CH_STATS_ADD(ht,num_misses,1);return NULL;}
+
+    position = CH_VECTOR_TYPE_FCT(_search)(v,key,hash,&match,ht);
+    if (match) {CH_STATS_ADD(ht,num_hits,1);return &v->v[position].v;}
+    CH_STATS_ADD(ht,num_misses,1);
+    return NULL;
+}
+#endif /* CH_USE_OPEN_ADDRESSING */
+CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+    CH_ASSERT(ht && ht->key_hash);
+    return CH_VECTOR_TYPE_FCT(_get_with_hash)(ht,key,ht->key_hash(key));
+}
+CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_by_val)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE key) {return CH_HASHTABLE_TYPE_FCT(_get)(ht,&key);}
+CH_API_DEF const CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_const)(const CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {return (const CH_VALUE_TYPE*) CH_HASHTABLE_TYPE_FCT(_get)((CH_HASHTABLE_TYPE*)ht,key);}
+CH_API_DEF const CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_const_by_val)(const CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE key) {return (const CH_VALUE_TYPE*) CH_HASHTABLE_TYPE_FCT(_get)((CH_HASHTABLE_TYPE*)ht,&key);}
 
-    if (ht->key_cmp)    {
-        /* slightly faster */
-        position =  v->size>2 ? CH_VECTOR_TYPE_FCT(_binary_search)(v,key,&match,ht) :
-                    CH_VECTOR_TYPE_FCT(_linear_search)(v,key,&match,ht);
-        /* slightly slower */
-        /* position = CH_VECTOR_TYPE_FCT(_binary_search)(v,key,&match,ht); */
+/* Batch lookups: keys are processed in groups of CH_BATCH_SIZE. All the keys of a group are hashed first,
+   then their buckets and bucket items are prefetched, and only then they are looked up:
+   this way the cache misses of different keys overlap, instead of stalling one key at a time. */
+/* It sets 'values[i]' to 'ch_xxx_get(ht,&keys[i])' (that can be NULL), and returns the number of keys found */
+CH_API_DEF size_t CH_HASHTABLE_TYPE_FCT(_get_batch)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* keys,size_t num_keys,CH_VALUE_TYPE** values) {
+    CH_KEY_HASH_UINT hashes[CH_BATCH_SIZE];
+    size_t i,j,n,num_found=0;
+    CH_ASSERT(ht && ht->key_hash && (keys || num_keys==0) && values);
+    for (i=0;i<num_keys;i+=n)   {
+        n = (num_keys-i<CH_BATCH_SIZE) ? (num_keys-i) : CH_BATCH_SIZE;
+        for (j=0;j<n;j++)   {hashes[j]=ht->key_hash(&keys[i+j]);CH_VECTOR_TYPE_FCT(_prefetch)(ht,hashes[j],0);}
+        for (j=0;j<n;j++)   CH_VECTOR_TYPE_FCT(_prefetch)(ht,hashes[j],1);
+        for (j=0;j<n;j++)   {
+            values[i+j] = CH_VECTOR_TYPE_FCT(_get_with_hash)(ht,&keys[i+j],hashes[j]);
+            if (values[i+j]) ++num_found;
+        }
     }
-    else    {
-        /* '_unsorted_search' uses memcmp(...) (when ht->key_cmp==NULL) */
-        position = CH_VECTOR_TYPE_FCT(_unsorted_search)(v,key,&match,ht);
+    return num_found;
+}
+/* It inserts all the missing keys, and returns the number of inserted items.
+   When 'matches' is not NULL, 'matches[i]' is set to 1 if 'keys[i]' was already present (or it's a duplicate in 'keys'), and to 0 otherwise.
+   When 'values' is not NULL, 'values[i]' is set to the value of 'keys[i]': since insertions can invalidate
+   pointers to other items, all the values are fetched at the end (with 'ch_xxx_get_batch(...)') */
+CH_API_DEF size_t CH_HASHTABLE_TYPE_FCT(_get_or_insert_batch)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* keys,size_t num_keys,CH_VALUE_TYPE** values,int* matches) {
+    CH_KEY_HASH_UINT hashes[CH_BATCH_SIZE];
+    size_t i,j,n,num_inserted=0;int match;
+    CH_ASSERT(ht && ht->key_hash && (keys || num_keys==0));
+    for (i=0;i<num_keys;i+=n)   {
+        n = (num_keys-i<CH_BATCH_SIZE) ? (num_keys-i) : CH_BATCH_SIZE;
+        for (j=0;j<n;j++)   {hashes[j]=ht->key_hash(&keys[i+j]);CH_VECTOR_TYPE_FCT(_prefetch)(ht,hashes[j],0);}
+        for (j=0;j<n;j++)   CH_VECTOR_TYPE_FCT(_prefetch)(ht,hashes[j],1);
+        for (j=0;j<n;j++)   {
+            CH_VECTOR_TYPE_FCT(_get_or_insert_with_hash)(ht,&keys[i+j],hashes[j],&match);
+            if (matches) matches[i+j]=match;
+            if (!match) ++num_inserted;
+        }
     }
+    if (values) CH_HASHTABLE_TYPE_FCT(_get_batch)(ht,keys,num_keys,values);
+    return num_inserted;
+}
 
-    return (match ? &v->v[position].v : NULL);
+#ifndef CH_USE_OPEN_ADDRESSING
+CH_API size_t CH_VECTOR_TYPE_FCT(_index_from_hash)(const CH_HASHTABLE_TYPE* ht,CH_KEY_HASH_UINT hash)  {
+    /* the bucket index of 'hash' (with CH_USE_DYNAMIC_BUCKETS, when no rehash is in progress) */
+    CH_ASSERT(ht);(void)ht;
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    return hash&(ht->num_buckets-1);
+#   elif defined(CH_USE_CACHED_HASHES)
+    return hash%CH_NUM_BUCKETS;
+#   else
+#   if CH_NUM_BUCKETS!=CH_MAX_NUM_BUCKETS
+    CH_ASSERT(hash<CH_NUM_BUCKETS);    /* user 'key_hash' should return values in [0,CH_NUM_BUCKETS). Please use: return somevalue%CH_NUM_BUCKETS */
+#   endif
+    return (size_t) hash;
+#   endif
 }
-CH_API_DEF CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_by_val)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE key) {return CH_HASHTABLE_TYPE_FCT(_get)(ht,&key);}
-CH_API_DEF const CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_const)(const CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {return (const CH_VALUE_TYPE*) CH_HASHTABLE_TYPE_FCT(_get)((CH_HASHTABLE_TYPE*)ht,key);}
-CH_API_DEF const CH_VALUE_TYPE* CH_HASHTABLE_TYPE_FCT(_get_const_by_val)(const CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE key) {return (const CH_VALUE_TYPE*) CH_HASHTABLE_TYPE_FCT(_get)((CH_HASHTABLE_TYPE*)ht,&key);}
+CH_API int CH_VECTOR_TYPE_FCT(_item_cmp)(const CH_HASHTABLE_ITEM_TYPE* a,const CH_HASHTABLE_ITEM_TYPE* b,const CH_HASHTABLE_TYPE* ht)  {
+    /* the order of the items of a bucket: by (h,key) with CH_USE_CACHED_HASHES, by key otherwise (memcmp is used when 'key_cmp' is NULL) */
+#   ifdef CH_USE_CACHED_HASHES
+    if (a->h!=b->h) return a->h<b->h ? -1 : 1;
+#   endif
+    return ht->key_cmp ? ht->key_cmp(&a->k,&b->k) : memcmp(&a->k,&b->k,sizeof(CH_KEY_TYPE));
+}
+CH_API void CH_VECTOR_TYPE_FCT(_stable_sort)(CH_HASHTABLE_ITEM_TYPE* v,size_t n,CH_HASHTABLE_ITEM_TYPE* tmp,const CH_HASHTABLE_TYPE* ht)  {
+    /* bottom-up merge sort ('tmp' must store 'n' items). Items are moved with memcpy (no ctr/dtr/cpy callback),
+       and items with the same key keep their order */
+    const size_t run = 8;
+    CH_HASHTABLE_ITEM_TYPE *src=v,*dst=tmp,*swp;
+    size_t i,j,k,width;
+    CH_ASSERT(v && tmp && ht);
+    for (i=0;i<n;i+=run)    {
+        /* insertion sort of every run ('tmp[0]' is our temporary item) */
+        const size_t end = (n-i<run) ? n : (i+run);
+        for (j=i+1;j<end;j++)   {
+            memcpy(&tmp[0],&v[j],sizeof(CH_HASHTABLE_ITEM_TYPE));
+            for (k=j;k>i && CH_VECTOR_TYPE_FCT(_item_cmp)(&v[k-1],&tmp[0],ht)>0;k--) memcpy(&v[k],&v[k-1],sizeof(CH_HASHTABLE_ITEM_TYPE));
+            if (k!=j) memcpy(&v[k],&tmp[0],sizeof(CH_HASHTABLE_ITEM_TYPE));
+        }
+    }
+    for (width=run;width<n;width*=2)    {
+        for (i=0;i<n;i+=2*width)    {
+            const size_t mid = (n-i<width) ? n : (i+width);
+            const size_t end = (n-i<2*width) ? n : (i+2*width);
+            size_t a=i,b=mid,o=i;
+            while (a<mid && b<end)  {
+                if (CH_VECTOR_TYPE_FCT(_item_cmp)(&src[b],&src[a],ht)<0) memcpy(&dst[o++],&src[b++],sizeof(CH_HASHTABLE_ITEM_TYPE));
+                else memcpy(&dst[o++],&src[a++],sizeof(CH_HASHTABLE_ITEM_TYPE));
+            }
+            if (a<mid) memcpy(&dst[o],&src[a],(mid-a)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+            else if (b<end) memcpy(&dst[o],&src[b],(end-b)*sizeof(CH_HASHTABLE_ITEM_TYPE));
+        }
+        swp=src;src=dst;dst=swp;
+    }
+    if (src!=v) memcpy(v,src,n*sizeof(CH_HASHTABLE_ITEM_TYPE));
+}
+#endif /* CH_USE_OPEN_ADDRESSING */
+/* It replaces all the items of 'ht' with 'num_items' key/value pairs copied from 'items' (in any order).
+   Instead of inserting the items one by one (a search and a memmove per item, and a reallocation every now and then),
+   it counts the items of every bucket, allocates every bucket array once, copies the items and sorts every bucket in place.
+   When a key is present more than once in 'items', its last value is kept. With CH_USE_CACHED_HASHES, 'items[i].h' is ignored.
+   With CH_USE_DYNAMIC_BUCKETS, the bucket array is (re)allocated at the right size first.
+   With CH_USE_OPEN_ADDRESSING, the slot array is grown once and the items are inserted one by one. */
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_build_from)(CH_HASHTABLE_TYPE* ht,const CH_HASHTABLE_ITEM_TYPE* items,size_t num_items)  {
+#   ifdef CH_USE_OPEN_ADDRESSING
+    size_t i;int match;
+    CH_ASSERT(ht && ht->key_hash && (items || num_items==0));
+    CH_HASHTABLE_TYPE_FCT(_clear)(ht);
+    if (num_items==0) return;
+    CH_HASHTABLE_TYPE_FCT(_rehash)(ht,num_items);
+    for (i=0;i<num_items;i++)   {
+        CH_VALUE_TYPE* value = CH_HASHTABLE_TYPE_FCT(_get_or_insert)(ht,&items[i].k,&match);
+        if (ht->value_cpy) ht->value_cpy(value,&items[i].v);
+        else memcpy((void*)value,&items[i].v,sizeof(CH_VALUE_TYPE));
+    }
+#   else /* CH_USE_OPEN_ADDRESSING */
+    const int plain_copy = (!ht->key_ctr && !ht->value_ctr && !ht->key_cpy && !ht->value_cpy);
+    CH_KEY_HASH_UINT* hashes;size_t* counts;
+    CH_VECTOR_TYPE* buckets;
+    CH_HASHTABLE_ITEM_TYPE* tmp = NULL;
+    size_t i,j,num_buckets,max_count=0,num_unique=0;
+    CH_ASSERT(ht && ht->key_hash && (items || num_items==0));
+    CH_HASHTABLE_TYPE_FCT(_clear)(ht);
+    if (num_items==0) return;
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+    num_buckets = CH_NUM_BUCKETS;
+#   else
+    num_buckets = ht->num_buckets ? ht->num_buckets : CH_NUM_BUCKETS;
+    while (num_items>num_buckets*CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR) num_buckets*=2;
+    if (ht->old_buckets || (ht->buckets && num_buckets!=ht->num_buckets)) CH_HASHTABLE_TYPE_FCT(_free)(ht);    /* it's empty */
+    if (!ht->buckets)   {
+        *((size_t*)&ht->num_buckets) = num_buckets;
+        ht->buckets = CH_VECTOR_TYPE_FCT(_alloc_buckets)(num_buckets);
+    }
+#   endif
+    buckets = ht->buckets;
+
+    /* 1) hash all the keys once, and count the items of every bucket */
+    hashes = (CH_KEY_HASH_UINT*) ch_malloc(num_items*sizeof(CH_KEY_HASH_UINT));
+    counts = (size_t*) ch_malloc(num_buckets*sizeof(size_t));
+    memset(counts,0,num_buckets*sizeof(size_t));
+    for (i=0;i<num_items;i++)   {
+        hashes[i] = ht->key_hash(&items[i].k);
+        ++counts[CH_VECTOR_TYPE_FCT(_index_from_hash)(ht,hashes[i])];
+    }
 
-CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+    /* 2) allocate every bucket array once (buckets are empty now: nothing needs to be copied) */
+    for (i=0;i<num_buckets;i++)  {
+        CH_VECTOR_TYPE* b = &buckets[i];
+        if (counts[i]>b->capacity)  {
+            CH_VECTOR_TYPE_FCT(_free_items)(b,ht);
+            CH_VECTOR_TYPE_FCT(_set_capacity)(b,counts[i],ht);
+        }
+        if (counts[i]>max_count) max_count=counts[i];
+    }
+    ch_free(counts);counts=NULL;
+
+    /* 3) append (a copy of) every item to its bucket */
+    for (i=0;i<num_items;i++)   {
+        CH_VECTOR_TYPE* b = &buckets[CH_VECTOR_TYPE_FCT(_index_from_hash)(ht,hashes[i])];
+        CH_HASHTABLE_ITEM_TYPE* item = &b->v[b->size];
+        const CH_HASHTABLE_ITEM_TYPE* src = &items[i];
+        if (plain_copy) memcpy((void*)item,src,sizeof(CH_HASHTABLE_ITEM_TYPE));
+        else {
+#           ifndef CH_DISABLE_CLEARING_ITEM_MEMORY
+            memset((void*)item,0,sizeof(CH_HASHTABLE_ITEM_TYPE));
+#           endif
+            if (ht->key_ctr)    ht->key_ctr(&item->k);
+            if (ht->value_ctr)  ht->value_ctr(&item->v);
+            if (ht->key_cpy)    ht->key_cpy(&item->k,&src->k);
+            else                memcpy((void*)&item->k,&src->k,sizeof(CH_KEY_TYPE));
+            if (ht->value_cpy)  ht->value_cpy(&item->v,&src->v);
+            else                memcpy((void*)&item->v,&src->v,sizeof(CH_VALUE_TYPE));
+        }
+#       ifdef CH_USE_CACHED_HASHES
+        item->h = (unsigned)hashes[i];
+#       endif
+        *((size_t*) &b->size)=b->size+1;
+    }
+    ch_free(hashes);hashes=NULL;
+
+    /* 4) sort every bucket in place and remove duplicated keys (the last one wins: the sort is stable) */
+    if (max_count>1) tmp = (CH_HASHTABLE_ITEM_TYPE*) ch_malloc(max_count*sizeof(CH_HASHTABLE_ITEM_TYPE));
+    for (i=0;i<num_buckets;i++)  {
+        CH_VECTOR_TYPE* b = &buckets[i];
+        size_t size = b->size;
+        if (size>1) {
+            CH_VECTOR_TYPE_FCT(_stable_sort)(b->v,size,tmp,ht);
+            for (j=size=0;j<b->size;j++)    {
+                CH_HASHTABLE_ITEM_TYPE* item = &b->v[j];
+                if (j+1<b->size && CH_VECTOR_TYPE_FCT(_item_cmp)(item,&b->v[j+1],ht)==0)   {
+                    if (ht->key_dtr)    ht->key_dtr(&item->k);
+                    if (ht->value_dtr)  ht->value_dtr(&item->v);
+                    continue;
+                }
+                if (size!=j) memcpy((void*)&b->v[size],item,sizeof(CH_HASHTABLE_ITEM_TYPE));
+                ++size;
+            }
+        }
+        if (b->v) CH_VECTOR_TYPE_FCT(_set_size)(b,size);
+        num_unique+=size;
+    }
+    if (tmp) ch_free(tmp);
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    *((size_t*)&ht->num_items) = num_unique;
+#   else
+    (void)num_unique;
+#   endif
+#   endif /* CH_USE_OPEN_ADDRESSING */
+}
+
+#ifndef CH_USE_OPEN_ADDRESSING
+CH_API int CH_VECTOR_TYPE_FCT(_remove_with_hash)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_KEY_HASH_UINT hash) {
     CH_VECTOR_TYPE* v = NULL;
-    size_t position;ch_hash_uint hash;int match = 0;
-    CH_ASSERT(ht && ht->key_hash);
-    hash = ht->key_hash(key);
+    size_t position;int match = 0;
+    CH_ASSERT(ht);
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+#   ifdef CH_USE_CACHED_HASHES
+    v = &ht->buckets[hash%CH_NUM_BUCKETS];
+#   else
 #   if CH_NUM_BUCKETS!=CH_MAX_NUM_BUCKETS
     CH_ASSERT(hash<CH_NUM_BUCKETS);    /* user 'key_hash' should return values in [0,CH_NUM_BUCKETS). Please use: return somevalue%CH_NUM_BUCKETS */
 #   endif
     v = &ht->buckets[hash];
-    if (!v->v)  return 0;
-    if (ht->key_cmp)    {
-        /* slightly faster */
-        position =  v->size>2 ? CH_VECTOR_TYPE_FCT(_binary_search)(v,key,&match,ht) :
-                    CH_VECTOR_TYPE_FCT(_linear_search)(v,key,&match,ht);
-        /* slightly slower */
-        /* position = CH_VECTOR_TYPE_FCT(_binary_search)(v,key,&match,ht); */
-    }
-    else    {
-        /* '_unsorted_search' uses memcmp(...) (when ht->key_cmp==NULL) */
-        position = CH_VECTOR_TYPE_FCT(_unsorted_search)(v,key,&match,ht);
-    }
+#   endif
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    if (!ht->buckets) {CH_STATS_ADD(ht,num_lookups,1);CH_STATS_ADD(ht,num_misses,1);return 0;}
+    if (ht->old_buckets) CH_VECTOR_TYPE_FCT(_rehash_step)(ht,CH_DYNAMIC_BUCKETS_REHASH_STEP);
+    v = CH_VECTOR_TYPE_FCT(_from_hash)(ht,hash);
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+    CH_STATS_ADD(ht,num_lookups,1);
+    if (!v->v)  {CH_STATS_ADD(ht,num_misses,1);return 0;}
+    position = CH_VECTOR_TYPE_FCT(_search)(v,key,hash,&match,ht);
     if (match) {
+        CH_STATS_ADD(ht,num_hits,1);CH_STATS_ADD(ht,num_removes,1);
         CH_VECTOR_TYPE_FCT(_remove_at)(v,position,ht);
+#       ifdef CH_USE_DYNAMIC_BUCKETS
+        *((size_t*)&ht->num_items) = ht->num_items-1;
+#       endif
         return 1;
     }
+    CH_STATS_ADD(ht,num_misses,1);
     return 0;
 }
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+    CH_ASSERT(ht && ht->key_hash);
+    return CH_VECTOR_TYPE_FCT(_remove_with_hash)(ht,key,ht->key_hash(key));
+}
+#endif /* CH_USE_OPEN_ADDRESSING */
 CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_remove_by_val)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE key) {return CH_HASHTABLE_TYPE_FCT(_remove)(ht,&key);}
+
+#ifdef CH_USE_STRIPED_LOCKS
+/* Thread-safe functions: 'key_hash' is called before locking, and the stripe of the bucket of 'key' is locked
+   only while the bucket is accessed. Values are always copied: pointers to values would not be safe after unlocking */
+CH_API ch_stripe_lock* CH_VECTOR_TYPE_FCT(_lock_from_hash)(CH_HASHTABLE_TYPE* ht,CH_KEY_HASH_UINT hash)  {
+#   ifdef CH_USE_CACHED_HASHES
+    return &ht->locks[(hash%CH_NUM_BUCKETS)%CH_NUM_LOCK_STRIPES];
+#   else
+    return &ht->locks[((size_t)hash)%CH_NUM_LOCK_STRIPES];
+#   endif
+}
+CH_API void CH_VECTOR_TYPE_FCT(_value_assign)(const CH_HASHTABLE_TYPE* ht,CH_VALUE_TYPE* dst,const CH_VALUE_TYPE* src)  {
+    if (ht->value_cpy) ht->value_cpy(dst,src);
+    else memcpy((void*)dst,(const void*)src,sizeof(CH_VALUE_TYPE));
+}
+#ifndef CH_USE_RCU_READS
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_get)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_VALUE_TYPE* value_out) {
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;const CH_VALUE_TYPE* value;
+    CH_ASSERT(ht && ht->key_hash);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    ch_stripe_lock_read(lock);
+    value = CH_VECTOR_TYPE_FCT(_get_with_hash)(ht,key,hash);    /* it does not modify 'ht' */
+    if (value && value_out) CH_VECTOR_TYPE_FCT(_value_assign)(ht,value_out,value);
+    ch_stripe_unlock_read(lock);
+    return value ? 1 : 0;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_set)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,const CH_VALUE_TYPE* value) {
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;int match;
+    CH_ASSERT(ht && ht->key_hash && value);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    ch_stripe_lock_write(lock);
+    CH_VECTOR_TYPE_FCT(_value_assign)(ht,CH_VECTOR_TYPE_FCT(_get_or_insert_with_hash)(ht,key,hash,&match),value);
+    ch_stripe_unlock_write(lock);
+    return match;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_update)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,void (*update_fcn)(CH_VALUE_TYPE* value,int match,void* user_data),void* user_data) {
+    /* 'update_fcn' must not call any function of 'ht' (the stripe is locked) */
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;CH_VALUE_TYPE* value;int match;
+    CH_ASSERT(ht && ht->key_hash && update_fcn);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    ch_stripe_lock_write(lock);
+    value = CH_VECTOR_TYPE_FCT(_get_or_insert_with_hash)(ht,key,hash,&match);
+    update_fcn(value,match,user_data);
+    ch_stripe_unlock_write(lock);
+    return match;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;int removed;
+    CH_ASSERT(ht && ht->key_hash);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    ch_stripe_lock_write(lock);
+    removed = CH_VECTOR_TYPE_FCT(_remove_with_hash)(ht,key,hash);
+    ch_stripe_unlock_write(lock);
+    return removed;
+}
+#else /* CH_USE_RCU_READS */
+/* Readers take no locks: writers never modify the items that a reader can see, but they publish modified copies of their bucket */
+CH_API CH_VECTOR_TYPE* CH_VECTOR_TYPE_FCT(_rcu_bucket)(CH_HASHTABLE_TYPE* ht,CH_KEY_HASH_UINT hash)  {
+#   ifdef CH_USE_CACHED_HASHES
+    return &ht->buckets[hash%CH_NUM_BUCKETS];
+#   else
+#   if CH_NUM_BUCKETS!=CH_MAX_NUM_BUCKETS
+    CH_ASSERT(hash<CH_NUM_BUCKETS);    /* user 'key_hash' should return values in [0,CH_NUM_BUCKETS). Please use: return somevalue%CH_NUM_BUCKETS */
+#   endif
+    return &ht->buckets[hash];
+#   endif
+}
+CH_API void CH_VECTOR_TYPE_FCT(_rcu_init_item)(const CH_HASHTABLE_TYPE* ht,CH_HASHTABLE_ITEM_TYPE* item,const CH_KEY_TYPE* key,CH_KEY_HASH_UINT hash,const CH_HASHTABLE_ITEM_TYPE* old_item)  {
+    /* it constructs the key (or it shares the key of 'old_item'), and a new value (default-constructed) */
+    if (old_item) memcpy((void*)item,(const void*)old_item,sizeof(CH_HASHTABLE_ITEM_TYPE));
+    else {
+#       ifndef CH_DISABLE_CLEARING_ITEM_MEMORY
+        if (ht->key_ctr || ht->key_cpy) memset((void*)&item->k,0,sizeof(CH_KEY_TYPE));
+#       endif
+        if (ht->key_ctr)    ht->key_ctr(&item->k);
+        if (!ht->key_cpy)   memcpy((void*)&item->k,key,sizeof(CH_KEY_TYPE));
+        else ht->key_cpy(&item->k,key);
+#       ifdef CH_USE_CACHED_HASHES
+        item->h = (unsigned) hash;
+#       endif
+    }
+    (void)hash;
+    /* the value of 'old_item' is still visible to readers: it must not be touched by 'value_cpy' */
+    if (ht->value_ctr || ht->value_cpy) memset((void*)&item->v,0,sizeof(CH_VALUE_TYPE));
+    if (ht->value_ctr)  ht->value_ctr(&item->v);
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_get)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,CH_VALUE_TYPE* value_out) {
+    CH_KEY_HASH_UINT hash;CH_VECTOR_TYPE* v;CH_VECTOR_TYPE snapshot;size_t token,position;int match=0;
+    CH_ASSERT(ht && ht->key_hash);
+    hash = ht->key_hash(key);
+    v = CH_VECTOR_TYPE_FCT(_rcu_bucket)(ht,hash);
+    token = ch_rcu_read_lock(&ht->rcu);
+    memset((void*)&snapshot,0,sizeof(CH_VECTOR_TYPE));
+    snapshot.v = (CH_HASHTABLE_ITEM_TYPE*) CH_ATOMIC_LOAD_PTR((void**)&v->v);  /* acquire */
+    if (snapshot.v) {
+        *((size_t*) &snapshot.size) = *((size_t*) &snapshot.capacity) = CH_RCU_HEADER_OF(snapshot.v)->size;
+        position = CH_VECTOR_TYPE_FCT(_search)(&snapshot,key,hash,&match,ht);
+        if (match && value_out) CH_VECTOR_TYPE_FCT(_value_assign)(ht,value_out,&snapshot.v[position].v);
+    }
+    ch_rcu_read_unlock(&ht->rcu,token);
+    return match;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_set)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,const CH_VALUE_TYPE* value) {
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;CH_VECTOR_TYPE* v;CH_HASHTABLE_ITEM_TYPE* items;size_t position=0;int match=0;
+    CH_ASSERT(ht && ht->key_hash && value);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    v = CH_VECTOR_TYPE_FCT(_rcu_bucket)(ht,hash);
+    ch_stripe_lock_write(lock);
+    if (v->v) position = CH_VECTOR_TYPE_FCT(_search)(v,key,hash,&match,ht);
+    items = CH_VECTOR_TYPE_FCT(_rcu_copy)(v,position,match,1);
+    CH_VECTOR_TYPE_FCT(_rcu_init_item)(ht,&items[position],key,hash,match ? &v->v[position] : NULL);
+    CH_VECTOR_TYPE_FCT(_value_assign)(ht,&items[position].v,value);
+    CH_VECTOR_TYPE_FCT(_rcu_publish)(ht,v,items,position,match ? 2 : 0);  /* the old value is destroyed later */
+    ch_stripe_unlock_write(lock);
+    return match;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_update)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key,void (*update_fcn)(CH_VALUE_TYPE* value,int match,void* user_data),void* user_data) {
+    /* 'update_fcn' must not call any function of 'ht' (the stripe is locked). It modifies a copy of the value */
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;CH_VECTOR_TYPE* v;CH_HASHTABLE_ITEM_TYPE* items;size_t position=0;int match=0;
+    CH_ASSERT(ht && ht->key_hash && update_fcn);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    v = CH_VECTOR_TYPE_FCT(_rcu_bucket)(ht,hash);
+    ch_stripe_lock_write(lock);
+    if (v->v) position = CH_VECTOR_TYPE_FCT(_search)(v,key,hash,&match,ht);
+    items = CH_VECTOR_TYPE_FCT(_rcu_copy)(v,position,match,1);
+    if (match && !ht->value_cpy) memcpy((void*)&items[position],(const void*)&v->v[position],sizeof(CH_HASHTABLE_ITEM_TYPE));   /* the value is moved */
+    else {
+        CH_VECTOR_TYPE_FCT(_rcu_init_item)(ht,&items[position],key,hash,match ? &v->v[position] : NULL);
+        if (match) ht->value_cpy(&items[position].v,&v->v[position].v);
+    }
+    update_fcn(&items[position].v,match,user_data);
+    CH_VECTOR_TYPE_FCT(_rcu_publish)(ht,v,items,position,(match && ht->value_cpy) ? 2 : 0);
+    ch_stripe_unlock_write(lock);
+    return match;
+}
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_concurrent_remove)(CH_HASHTABLE_TYPE* ht,const CH_KEY_TYPE* key) {
+    CH_KEY_HASH_UINT hash;ch_stripe_lock* lock;CH_VECTOR_TYPE* v;size_t position=0;int match=0;
+    CH_ASSERT(ht && ht->key_hash);
+    hash = ht->key_hash(key);
+    lock = CH_VECTOR_TYPE_FCT(_lock_from_hash)(ht,hash);
+    v = CH_VECTOR_TYPE_FCT(_rcu_bucket)(ht,hash);
+    ch_stripe_lock_write(lock);
+    if (v->v) position = CH_VECTOR_TYPE_FCT(_search)(v,key,hash,&match,ht);
+    if (match) CH_VECTOR_TYPE_FCT(_rcu_publish)(ht,v,CH_VECTOR_TYPE_FCT(_rcu_copy)(v,position,1,0),position,3);
+    ch_stripe_unlock_write(lock);
+    return match;
+}
+#endif /* CH_USE_RCU_READS */
+#endif /* CH_USE_STRIPED_LOCKS */
+#ifndef CH_USE_OPEN_ADDRESSING
 CH_API_DEF size_t CH_HASHTABLE_TYPE_FCT(_get_num_items)(const CH_HASHTABLE_TYPE* ht) {
+#   ifndef CH_USE_DYNAMIC_BUCKETS
     size_t i,sum=0;CH_ASSERT(ht);
     for (i=0;i<CH_NUM_BUCKETS;i++) sum+=ht->buckets[i].size;
     return sum;
+#   else
+    CH_ASSERT(ht);
+    return ht->num_items;
+#   endif
 }
 CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht) {
     size_t i,j,num_total_items=0,num_total_capacity=0,num_sorting_errors=0,min_num_bucket_items=(size_t)-1,max_num_bucket_items=0,min_cnt=0,max_cnt=0,avg_cnt=0,avg_round=0;
@@ -894,9 +2457,35 @@ CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht) {
     size_t mem_minimal=sizeof(CH_HASHTABLE_TYPE),mem_used=sizeof(CH_HASHTABLE_TYPE);
     double mem_used_percentage = 100;
     const CH_HASHTABLE_ITEM_TYPE* last_item = NULL;
+#   ifdef CH_USE_CACHED_HASHES
+    size_t num_hash_errors=0;
+#   endif
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+    const CH_VECTOR_TYPE* buckets = ht->buckets;
+    const size_t num_buckets = CH_NUM_BUCKETS;
+#   else
+    const CH_VECTOR_TYPE* buckets = ht->buckets;
+    const size_t num_buckets = ht->buckets ? ht->num_buckets : 0;
+#   endif
     CH_ASSERT(ht);
-    for (i=0;i<CH_NUM_BUCKETS;i++) {
-        const CH_VECTOR_TYPE* bck = &ht->buckets[i];
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    mem_minimal += num_buckets*sizeof(CH_VECTOR_TYPE);
+    mem_used += num_buckets*sizeof(CH_VECTOR_TYPE);
+    if (ht->old_buckets)    {
+        /* pending rehashing: old buckets are counted in the totals, but not in the bucket statistics */
+        mem_used += ht->old_num_buckets*sizeof(CH_VECTOR_TYPE);
+        for (i=ht->rehash_index;i<ht->old_num_buckets;i++) {
+            const CH_VECTOR_TYPE* bck = &ht->old_buckets[i];
+            num_total_items+=bck->size;
+            num_total_capacity+=bck->capacity;
+            mem_minimal += sizeof(CH_HASHTABLE_ITEM_TYPE)*bck->size;
+            mem_used += sizeof(CH_HASHTABLE_ITEM_TYPE)*bck->capacity;
+        }
+    }
+#   endif
+    if (num_buckets==0) min_num_bucket_items=0;
+    for (i=0;i<num_buckets;i++) {
+        const CH_VECTOR_TYPE* bck = &buckets[i];
         num_total_items+=bck->size;
         num_total_capacity+=bck->capacity;
         if (min_num_bucket_items>bck->size) min_num_bucket_items=bck->size;
@@ -904,12 +2493,29 @@ CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht) {
         if (bck->v) {
             mem_minimal += sizeof(CH_HASHTABLE_ITEM_TYPE)*bck->size;
             mem_used += sizeof(CH_HASHTABLE_ITEM_TYPE)*bck->capacity;
+#           ifdef CH_USE_CACHED_HASHES
+            for (j=0;j<bck->size;j++)  {
+                if (bck->v[j].h!=(unsigned)ht->key_hash(&bck->v[j].k)) {
+                    ++num_hash_errors;
+#                   ifndef CH_NO_STDIO
+                    fprintf(stderr,"[%s] Hash Error (%" CV_SIZE_T_FORMATTING "): in bucket[%" CV_SIZE_T_FORMATTING "]: item %" CV_SIZE_T_FORMATTING " has a wrong cached hash\n",CH_XSTR(CH_HASHTABLE_TYPE_FCT(_dbg_check)),num_hash_errors,i,j);
+#                   endif
+                }
+            }
+            if (bck->size)    {
+#           else
             if (ht->key_cmp && bck->size)    {
+#           endif
                 last_item = NULL;
                 for (j=0;j<bck->size;j++)  {
                     const CH_HASHTABLE_ITEM_TYPE* item = &bck->v[j];
                     if (last_item) {
+#                       ifdef CH_USE_CACHED_HASHES
+                        /* sorted by (h,key): keys are compared only when 'h' is the same */
+                        if (last_item->h>item->h || (last_item->h==item->h && ht->key_cmp && ht->key_cmp(&last_item->k,&item->k)>0)) {
+#                       else
                         if (ht->key_cmp(&last_item->k,&item->k)>0) {
+#                       endif
                             /* When this happens, it can be a wrong user 'key_cmp' function (that cannot sort keys in a consistent way) */
                             ++num_sorting_errors;
 #                       ifndef CH_NO_STDIO
@@ -922,22 +2528,22 @@ CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht) {
             }
         }
     }
-    avg_num_bucket_items = (double)num_total_items/(double) CH_NUM_BUCKETS;
+    avg_num_bucket_items = num_buckets>0 ? (double)num_total_items/(double) num_buckets : 0.0;
     mem_used_percentage = (double)mem_used*100.0/(double)mem_minimal;
-    if (CH_NUM_BUCKETS<2) {std_deviation=0.;avg_cnt=min_cnt=max_cnt=1;avg_round=(min_num_bucket_items+max_num_bucket_items)/2;}
+    if (num_buckets<2) {std_deviation=0.;avg_cnt=min_cnt=max_cnt=1;avg_round=(min_num_bucket_items+max_num_bucket_items)/2;}
     else {
         const double dec = avg_num_bucket_items-(double)((size_t)avg_num_bucket_items); /* in (0,1] */
         avg_round = (size_t)avg_num_bucket_items;
         if (dec>=0.5) avg_round+=1;
-        for (i=0;i<CH_NUM_BUCKETS;i++) {
-            const CH_VECTOR_TYPE* bck = &ht->buckets[i];
+        for (i=0;i<num_buckets;i++) {
+            const CH_VECTOR_TYPE* bck = &buckets[i];
             double tmp = bck->size-avg_num_bucket_items;
             std_deviation+=tmp*tmp;
             if (bck->size==min_num_bucket_items) ++min_cnt;
             if (bck->size==max_num_bucket_items) ++max_cnt;
             if (bck->size==avg_round) ++avg_cnt;
         }
-        std_deviation/=(double)(CH_NUM_BUCKETS-1); /* this is the variance */
+        std_deviation/=(double)(num_buckets-1); /* this is the variance */
         /* we must calculate its square root now without depending on <math.h>. Code based on:
            https://stackoverflow.com/questions/29018864/any-way-to-obtain-square-root-of-a-number-without-using-math-h-and-sqrt
         */
@@ -958,14 +2564,25 @@ CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_dbg_check)(const CH_HASHTABLE_TYPE* ht) {
     }
 #   ifndef CH_NO_STDIO    
     printf("[%s]:\n",CH_XSTR(CH_HASHTABLE_TYPE_FCT(_dbg_check)));
-    printf("\tnum_total_items=%" CV_SIZE_T_FORMATTING " (num_total_capacity=%" CV_SIZE_T_FORMATTING ") in %d buckets [items per bucket: mean=%1.3f std_deviation=%1.3f min=%" CV_SIZE_T_FORMATTING " (in %" CV_SIZE_T_FORMATTING "/%d) avg=%" CV_SIZE_T_FORMATTING " (in %" CV_SIZE_T_FORMATTING "/%d) max=%" CV_SIZE_T_FORMATTING " (in %" CV_SIZE_T_FORMATTING "/%d)].\n",num_total_items,num_total_capacity,CH_NUM_BUCKETS,avg_num_bucket_items,std_deviation,min_num_bucket_items,min_cnt,CH_NUM_BUCKETS,avg_round,avg_cnt,CH_NUM_BUCKETS,max_num_bucket_items,max_cnt,CH_NUM_BUCKETS);
+    printf("\tnum_total_items=%" CV_SIZE_T_FORMATTING " (num_total_capacity=%" CV_SIZE_T_FORMATTING ") in %" CV_SIZE_T_FORMATTING " buckets [items per bucket: mean=%1.3f std_deviation=%1.3f min=%" CV_SIZE_T_FORMATTING " (in %" CV_SIZE_T_FORMATTING "/%" CV_SIZE_T_FORMATTING ") avg=%" CV_SIZE_T_FORMATTING " (in %" CV_SIZE_T_FORMATTING "/%" CV_SIZE_T_FORMATTING ") max=%" CV_SIZE_T_FORMATTING " (in %" CV_SIZE_T_FORMATTING "/%" CV_SIZE_T_FORMATTING ")].\n",num_total_items,num_total_capacity,num_buckets,avg_num_bucket_items,std_deviation,min_num_bucket_items,min_cnt,num_buckets,avg_round,avg_cnt,num_buckets,max_num_bucket_items,max_cnt,num_buckets);
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    if (ht->old_buckets) printf("\trehashing: %" CV_SIZE_T_FORMATTING "/%" CV_SIZE_T_FORMATTING " old buckets still to be moved.\n",ht->old_num_buckets-ht->rehash_index,ht->old_num_buckets);
+#   endif
+#   ifdef CH_USE_BUCKET_SLABS
+    printf("\tbucket slabs: %" CV_SIZE_T_FORMATTING " pages of ",ht->slabs.num_pages);ch_display_bytes(CH_SLAB_PAGE_SIZE);
+    printf(" (");ch_display_bytes(ht->slabs.num_pages*CH_SLAB_PAGE_SIZE);printf(").\n");
+#   endif
     printf("\tmemory_used: ");ch_display_bytes(mem_used);
     printf(". memory_minimal_possible: ");ch_display_bytes(mem_minimal);
     printf(". mem_used_percentage: %1.2f%% (100%% is the best possible result).\n",mem_used_percentage);
 #   endif
     CH_ASSERT(num_sorting_errors==0); /* When this happens, it can be a wrong user 'itemKey_cmp' function (that cannot sort keys in a consistent way) */
+#   ifdef CH_USE_CACHED_HASHES
+    CH_ASSERT(num_hash_errors==0);  /* When this happens, 'key_hash' is not deterministic, or a key has been modified inside the hashtable */
+#   endif
     return (int) num_total_items;
 }
+#endif /* CH_USE_OPEN_ADDRESSING */
 
 CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_swap)(CH_HASHTABLE_TYPE* a,CH_HASHTABLE_TYPE* b)  {
     unsigned char t[sizeof(CH_HASHTABLE_TYPE)];
@@ -976,9 +2593,20 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_swap)(CH_HASHTABLE_TYPE* a,CH_HASHTABLE_T
         memcpy(b,&t,sizeof(CH_HASHTABLE_TYPE));
     }
 }
+#ifdef CH_USE_STATS
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_get_stats)(const CH_HASHTABLE_TYPE* ht,ch_stats_t* stats)  {
+    CH_ASSERT(ht && stats);
+    *stats = ht->stats;
+}
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_reset_stats)(CH_HASHTABLE_TYPE* ht)  {
+    CH_ASSERT(ht);
+    memset(&ht->stats,0,sizeof(ch_stats_t));
+}
+#endif /* CH_USE_STATS */
+#ifndef CH_USE_OPEN_ADDRESSING
 CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_cpy)(CH_HASHTABLE_TYPE* a,const CH_HASHTABLE_TYPE* b) {
     size_t i;
-    typedef ch_hash_uint (*key_hash_type)(const CH_KEY_TYPE*);
+    typedef CH_KEY_HASH_UINT (*key_hash_type)(const CH_KEY_TYPE*);
     typedef int (*key_cmp_type)(const CH_CMP_TYPE*,const CH_CMP_TYPE*);
     typedef void (*key_ctr_dtr_type)(CH_KEY_TYPE*);
     typedef void (*key_cpy_type)(CH_KEY_TYPE*,const CH_KEY_TYPE*);
@@ -986,6 +2614,9 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_cpy)(CH_HASHTABLE_TYPE* a,const CH_HASHTA
     typedef void (*value_cpy_type)(CH_VALUE_TYPE*,const CH_VALUE_TYPE*);
     if (a==b) return;
     CH_ASSERT(a && b);
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    CH_HASHTABLE_TYPE_FCT(_free)(a);   /* with its own callbacks */
+#   endif
     *((key_hash_type*)&a->key_hash) = b->key_hash;
     *((key_cmp_type*)&a->key_cmp) = b->key_cmp;
     *((key_ctr_dtr_type*)&a->key_ctr) = b->key_ctr;
@@ -995,41 +2626,228 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_cpy)(CH_HASHTABLE_TYPE* a,const CH_HASHTA
     *((value_ctr_dtr_type*)&a->value_dtr) = b->value_dtr;
     *((value_cpy_type*)&a->value_cpy) = b->value_cpy;
     *((size_t*)&a->initial_bucket_capacity) = b->initial_bucket_capacity;
-    for (i=0;i<CH_NUM_BUCKETS;i++)  {
-        CH_VECTOR_TYPE* A = &a->buckets[i];
-        const CH_VECTOR_TYPE* B = &b->buckets[i];
-        /* bad init asserts */
-        CH_ASSERT(!(A->v && A->capacity==0));
-        CH_ASSERT(!(!A->v && A->capacity>0));
-        CH_ASSERT(!(B->v && B->capacity==0));
-        CH_ASSERT(!(!B->v && B->capacity>0));
-        /*CH_VECTOR_TYPE_FCT(_free)(A,a);*/
-        CH_VECTOR_TYPE_FCT(_clear)(A,a);
-        CH_VECTOR_TYPE_FCT(_resize)(A,B->size,a);
-        CH_ASSERT(A->size==B->size);
-        if (!a->key_cpy && !a->value_cpy)   {memcpy(&A->v[0],&B->v[0],A->size*sizeof(CH_HASHTABLE_ITEM_TYPE));}
-        else if(a->key_cpy)     {for (i=0;i<A->size;i++) {a->key_cpy(&A->v[i].k,&B->v[i].k);memcpy(&A->v[i].v,&B->v[i].v,sizeof(CH_VALUE_TYPE));}}
-        else if(a->value_cpy)   {for (i=0;i<A->size;i++) {memcpy(&A->v[i].k,&B->v[i].k,sizeof(CH_KEY_TYPE));a->value_cpy(&A->v[i].v,&B->v[i].v);}}
+    *((const cvh_growth_policy_t**)&a->growth_policy) = b->growth_policy;
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+    for (i=0;i<CH_NUM_BUCKETS;i++)  CH_VECTOR_TYPE_FCT(_cpy)(&a->buckets[i],&b->buckets[i],a);
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    /* we copy the rehashing state too */
+    *((size_t*)&a->num_buckets) = b->num_buckets;
+    *((size_t*)&a->num_items) = b->num_items;
+    if (b->buckets) {
+        a->buckets = CH_VECTOR_TYPE_FCT(_alloc_buckets)(b->num_buckets);
+        for (i=0;i<b->num_buckets;i++)  CH_VECTOR_TYPE_FCT(_cpy)(&a->buckets[i],&b->buckets[i],a);
     }
+    if (b->old_buckets) {
+        *((size_t*)&a->old_num_buckets) = b->old_num_buckets;
+        *((size_t*)&a->rehash_index) = b->rehash_index;
+        a->old_buckets = CH_VECTOR_TYPE_FCT(_alloc_buckets)(b->old_num_buckets);
+        for (i=b->rehash_index;i<b->old_num_buckets;i++)  CH_VECTOR_TYPE_FCT(_cpy)(&a->old_buckets[i],&b->old_buckets[i],a);
+    }
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
 }
 CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_shrink_to_fit)(CH_HASHTABLE_TYPE* ht)   {
     if (ht)	{
         CH_HASHTABLE_TYPE o;
         memset(&o,0,sizeof(CH_HASHTABLE_TYPE));
         CH_HASHTABLE_TYPE_FCT(_cpy)(&o,ht); /* now 'o' is 'v' trimmed */
+#       ifdef CH_USE_STATS
+        o.stats = ht->stats;    /* the counters are kept */
+#       endif
         CH_HASHTABLE_TYPE_FCT(_free)(ht);
         CH_HASHTABLE_TYPE_FCT(_swap)(&o,ht);
     }
 }
 
+#ifdef CH_USE_DYNAMIC_BUCKETS
+/* It completes any pending (incremental) rehashing, and then grows the bucket array (if necessary)
+   to at least 'min_num_buckets' buckets (rounded up to the next power of two) in a single step.
+   Call it with 'min_num_buckets==0' before iterating 'ht->buckets' directly. */
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_rehash)(CH_HASHTABLE_TYPE* ht,size_t min_num_buckets)   {
+    size_t n;
+    CH_ASSERT(ht);
+    if (ht->old_buckets) CH_VECTOR_TYPE_FCT(_rehash_step)(ht,ht->old_num_buckets);
+    n = ht->num_buckets>0 ? ht->num_buckets : CH_NUM_BUCKETS;
+    while (n<min_num_buckets) n*=2;
+    if (!ht->buckets)   {*((size_t*)&ht->num_buckets) = n;return;}  /* allocated at the first insertion */
+    if (n>ht->num_buckets)  {
+        CH_VECTOR_TYPE_FCT(_rehash_start)(ht,n);
+        CH_VECTOR_TYPE_FCT(_rehash_step)(ht,ht->old_num_buckets);
+    }
+}
+#endif /* CH_USE_DYNAMIC_BUCKETS */
+#endif /* CH_USE_OPEN_ADDRESSING */
+
+#ifdef CH_HAS_CVH_SERIALIZER
+CH_API void CH_VECTOR_TYPE_FCT(_serialize_items)(const CH_HASHTABLE_ITEM_TYPE* items,size_t num_items,cvh_serializer_t* s,void (*key_serialize)(const CH_KEY_TYPE*,cvh_serializer_t*),void (*value_serialize)(const CH_VALUE_TYPE*,cvh_serializer_t*))  {
+    size_t i;
+    if (num_items==0) return;
+    if (!key_serialize && !value_serialize) {cvh_serializer_write_bytes(s,items,num_items*sizeof(CH_HASHTABLE_ITEM_TYPE));return;}
+    for (i=0;i<num_items;i++)   {
+        if (key_serialize) key_serialize(&items[i].k,s);
+        else cvh_serializer_write_bytes(s,&items[i].k,sizeof(CH_KEY_TYPE));
+        if (value_serialize) value_serialize(&items[i].v,s);
+        else cvh_serializer_write_bytes(s,&items[i].v,sizeof(CH_VALUE_TYPE));
+    }
+}
+/* It needs "c_vector.h" (or "c_vector_type_unsafe.h") to be included before <c_hashtable.h>.
+   'key_serialize' and 'value_serialize' can be NULL for plain-old-data keys and values
+   (when both are NULL, every bucket is written as a single block of items). Please see history for version 1.18 */
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_serialize)(const CH_HASHTABLE_TYPE* ht,cvh_serializer_t* serializer,void (*key_serialize)(const CH_KEY_TYPE*,cvh_serializer_t*),void (*value_serialize)(const CH_VALUE_TYPE*,cvh_serializer_t*))  {
+    const size_t item_size = (!key_serialize && !value_serialize) ? sizeof(CH_HASHTABLE_ITEM_TYPE) : 0;
+    size_t i;
+    CH_ASSERT(ht && serializer);
+    cvh_serializer_write_size_t(serializer,CH_HASHTABLE_TYPE_FCT(_get_num_items)(ht));
+#   ifdef CH_USE_OPEN_ADDRESSING
+    cvh_serializer_write_size_t(serializer,0);
+    cvh_serializer_write_size_t(serializer,item_size);
+    for (i=0;i<ht->capacity;i++)    {
+        if (ht->ctrl[i]<0x80) CH_VECTOR_TYPE_FCT(_serialize_items)(&ht->slots[i],1,serializer,key_serialize,value_serialize);
+    }
+#   else /* CH_USE_OPEN_ADDRESSING */
+#   ifndef CH_USE_DYNAMIC_BUCKETS
+    cvh_serializer_write_size_t(serializer,CH_NUM_BUCKETS);
+    cvh_serializer_write_size_t(serializer,item_size);
+    for (i=0;i<CH_NUM_BUCKETS;i++)  {
+        const CH_VECTOR_TYPE* b = &ht->buckets[i];
+        cvh_serializer_write_size_t(serializer,b->size);
+        CH_VECTOR_TYPE_FCT(_serialize_items)(b->v,b->size,serializer,key_serialize,value_serialize);
+    }
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    if (ht->old_buckets)    {
+        /* while rehashing, all the items are written as a single block */
+        cvh_serializer_write_size_t(serializer,0);
+        cvh_serializer_write_size_t(serializer,item_size);
+        for (i=ht->rehash_index;i<ht->old_num_buckets;i++) CH_VECTOR_TYPE_FCT(_serialize_items)(ht->old_buckets[i].v,ht->old_buckets[i].size,serializer,key_serialize,value_serialize);
+        for (i=0;i<ht->num_buckets;i++) CH_VECTOR_TYPE_FCT(_serialize_items)(ht->buckets[i].v,ht->buckets[i].size,serializer,key_serialize,value_serialize);
+        return;
+    }
+    cvh_serializer_write_size_t(serializer,ht->buckets ? ht->num_buckets : 0);
+    cvh_serializer_write_size_t(serializer,item_size);
+    for (i=0;ht->buckets && i<ht->num_buckets;i++)  {
+        const CH_VECTOR_TYPE* b = &ht->buckets[i];
+        cvh_serializer_write_size_t(serializer,b->size);
+        CH_VECTOR_TYPE_FCT(_serialize_items)(b->v,b->size,serializer,key_serialize,value_serialize);
+    }
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+#   endif /* CH_USE_OPEN_ADDRESSING */
+}
+/* It clears 'ht' (that must have been created with the same 'key_hash' and callbacks used when serializing)
+   and returns 1 on success. The deserialization callbacks must be NULL when the serialization callbacks were NULL */
+CH_API_DEF int CH_HASHTABLE_TYPE_FCT(_deserialize)(CH_HASHTABLE_TYPE* ht,const cvh_serializer_t* deserializer,int (*key_deserialize)(CH_KEY_TYPE*,const cvh_serializer_t*),int (*value_deserialize)(CH_VALUE_TYPE*,const cvh_serializer_t*))  {
+    const int pod = (!key_deserialize && !value_deserialize);
+    size_t num_items=0,num_buckets=0,item_size=0,i,j;
+    int check;
+    CH_ASSERT(ht && deserializer);
+    CH_HASHTABLE_TYPE_FCT(_clear)(ht);
+    check = cvh_serializer_read_size_t(deserializer,&num_items) && cvh_serializer_read_size_t(deserializer,&num_buckets) && cvh_serializer_read_size_t(deserializer,&item_size);
+    if (!check) return 0;
+    check = (item_size==(pod ? sizeof(CH_HASHTABLE_ITEM_TYPE) : 0));
+    CH_ASSERT(check);   /* the snapshot was written with different callbacks (or with a different item type) */
+    if (!check) return 0;
+#   ifndef CH_USE_OPEN_ADDRESSING
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    if (num_buckets>0 && (num_buckets&(num_buckets-1))==0)   {
+        /* we use the bucket array of the snapshot */
+        if (ht->buckets && (ht->num_buckets!=num_buckets || ht->old_buckets)) CH_HASHTABLE_TYPE_FCT(_free)(ht);
+        *((size_t*)&ht->num_buckets) = num_buckets;
+        if (!ht->buckets) ht->buckets = CH_VECTOR_TYPE_FCT(_alloc_buckets)(num_buckets);
+    }
+    if (num_buckets>0 && num_buckets==ht->num_buckets && !ht->old_buckets)  {
+#   else /* CH_USE_DYNAMIC_BUCKETS */
+    if (num_buckets==CH_NUM_BUCKETS)  {
+#   endif /* CH_USE_DYNAMIC_BUCKETS */
+        /* fast path: every bucket is restored as it is (without inserting its items one by one) */
+        size_t total=0;
+        for (i=0;i<num_buckets;i++) {
+            CH_VECTOR_TYPE* b = &ht->buckets[i];
+            size_t size=0,hash;
+            check = cvh_serializer_read_size_t(deserializer,&size) && size<=num_items-total;
+            if (check && size>0)    {
+                if (pod)    {
+                    CH_VECTOR_TYPE_FCT(_reserve)(b,size,ht);
+                    check = cvh_serializer_read_bytes(deserializer,b->v,size*sizeof(CH_HASHTABLE_ITEM_TYPE));
+                    if (check) CH_VECTOR_TYPE_FCT(_set_size)(b,size);
+                }
+                else {
+                    CH_VECTOR_TYPE_FCT(_resize)(b,size,ht);
+                    for (j=0;check && j<size;j++)   {
+                        CH_HASHTABLE_ITEM_TYPE* item = &b->v[j];
+                        check = key_deserialize ? key_deserialize(&item->k,deserializer) : cvh_serializer_read_bytes(deserializer,&item->k,sizeof(CH_KEY_TYPE));
+                        if (check) check = value_deserialize ? value_deserialize(&item->v,deserializer) : cvh_serializer_read_bytes(deserializer,&item->v,sizeof(CH_VALUE_TYPE));
+#                       ifdef CH_USE_CACHED_HASHES
+                        item->h = (unsigned) ht->key_hash(&item->k);
+#                       endif
+                    }
+                }
+                if (check)  {
+                    /* the (sorted) bucket is still valid only if 'key_hash' has not changed */
+                    hash = (size_t) ht->key_hash(&b->v[0].k);
+#                   ifdef CH_USE_DYNAMIC_BUCKETS
+                    check = ((hash&(num_buckets-1))==i);
+#                   elif defined(CH_USE_CACHED_HASHES)
+                    check = ((hash%CH_NUM_BUCKETS)==i);
+#                   else
+                    check = (hash==i);
+#                   endif
+#                   ifdef CH_USE_CACHED_HASHES
+                    if (check) check = (b->v[0].h==(unsigned)hash);
+#                   endif
+                    CH_ASSERT(check);   /* the snapshot was written with a different 'key_hash' */
+                }
+                total+=size;
+            }
+            if (!check) {CH_HASHTABLE_TYPE_FCT(_clear)(ht);return 0;}
+        }
+        check = (total==num_items);
+        CH_ASSERT(check);
+#       ifdef CH_USE_DYNAMIC_BUCKETS
+        *((size_t*)&ht->num_items) = total;
+#       endif
+        if (!check) CH_HASHTABLE_TYPE_FCT(_clear)(ht);
+        return check;
+    }
+#   endif /* CH_USE_OPEN_ADDRESSING */
+    /* slow path: every item is inserted again */
+#   ifdef CH_USE_OPEN_ADDRESSING
+    CH_HASHTABLE_TYPE_FCT(_rehash)(ht,num_items);
+#   elif defined(CH_USE_DYNAMIC_BUCKETS)
+    CH_HASHTABLE_TYPE_FCT(_rehash)(ht,num_items/CH_DYNAMIC_BUCKETS_MAX_LOAD_FACTOR);
+#   endif
+    for (i=0,j=0;j<(num_buckets>0 ? num_buckets : 1);j++)   {
+        size_t size = num_items;
+        if (num_buckets>0) check = cvh_serializer_read_size_t(deserializer,&size) && size<=num_items-i;
+        for (;check && size>0;size--,i++)  {
+            CH_HASHTABLE_ITEM_TYPE item;CH_VALUE_TYPE* value;
+            memset((void*)&item,0,sizeof(CH_HASHTABLE_ITEM_TYPE));
+            if (pod) check = cvh_serializer_read_bytes(deserializer,&item,sizeof(CH_HASHTABLE_ITEM_TYPE));
+            else    {
+                if (ht->key_ctr) ht->key_ctr(&item.k);
+                check = key_deserialize ? key_deserialize(&item.k,deserializer) : cvh_serializer_read_bytes(deserializer,&item.k,sizeof(CH_KEY_TYPE));
+            }
+            value = check ? CH_HASHTABLE_TYPE_FCT(_get_or_insert)(ht,&item.k,NULL) : NULL;
+            if (!pod && ht->key_dtr) ht->key_dtr(&item.k);
+            if (value)  {
+                if (pod) memcpy((void*)value,&item.v,sizeof(CH_VALUE_TYPE));
+                else check = value_deserialize ? value_deserialize(value,deserializer) : cvh_serializer_read_bytes(deserializer,value,sizeof(CH_VALUE_TYPE));
+            }
+        }
+        if (!check) {CH_HASHTABLE_TYPE_FCT(_clear)(ht);return 0;}
+    }
+    check = (i==num_items);
+    CH_ASSERT(check);
+    if (!check) CH_HASHTABLE_TYPE_FCT(_clear)(ht);
+    return check;
+}
+#endif /* CH_HAS_CVH_SERIALIZER */
+
 CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create_with)(
         CH_HASHTABLE_TYPE* ht,
-        ch_hash_uint (*key_hash)(const CH_KEY_TYPE*),
+        CH_KEY_HASH_UINT (*key_hash)(const CH_KEY_TYPE*),
         int (*key_cmp) (const CH_CMP_TYPE*,const CH_CMP_TYPE*),
         void (*key_ctr)(CH_KEY_TYPE*),void (*key_dtr)(CH_KEY_TYPE*),void (*key_cpy)(CH_KEY_TYPE*,const CH_KEY_TYPE*),
         void (*value_ctr)(CH_VALUE_TYPE*),void (*value_dtr)(CH_VALUE_TYPE*),void (*value_cpy)(CH_VALUE_TYPE*,const CH_VALUE_TYPE*),
         size_t initial_bucket_capacity)   {
-    typedef ch_hash_uint (*key_hash_type)(const CH_KEY_TYPE*);
+    typedef CH_KEY_HASH_UINT (*key_hash_type)(const CH_KEY_TYPE*);
     typedef int (*key_cmp_type)(const CH_CMP_TYPE*,const CH_CMP_TYPE*);
     typedef void (*key_ctr_dtr_type)(CH_KEY_TYPE*);
     typedef void (*key_cpy_type)(CH_KEY_TYPE*,const CH_KEY_TYPE*);
@@ -1049,6 +2867,22 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create_with)(
     typedef int (* dbg_check_mf)(const CH_HASHTABLE_TYPE*);
     typedef void (* swap_mf)(CH_HASHTABLE_TYPE* a,CH_HASHTABLE_TYPE* b);
     typedef void (* cpy_mf)(CH_HASHTABLE_TYPE* a,const CH_HASHTABLE_TYPE* b);
+    typedef size_t (* get_batch_mf)(CH_HASHTABLE_TYPE*,const CH_KEY_TYPE*,size_t,CH_VALUE_TYPE**);
+    typedef size_t (* get_or_insert_batch_mf)(CH_HASHTABLE_TYPE*,const CH_KEY_TYPE*,size_t,CH_VALUE_TYPE**,int*);
+    typedef void (* build_from_mf)(CH_HASHTABLE_TYPE*,const CH_HASHTABLE_ITEM_TYPE*,size_t);
+#   if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+    typedef void (* rehash_mf)(CH_HASHTABLE_TYPE* ht,size_t min_num_buckets_or_capacity);
+#   endif
+#   ifdef CH_USE_STRIPED_LOCKS
+    typedef int (* concurrent_get_mf)(CH_HASHTABLE_TYPE*,const CH_KEY_TYPE*,CH_VALUE_TYPE*);
+    typedef int (* concurrent_set_mf)(CH_HASHTABLE_TYPE*,const CH_KEY_TYPE*,const CH_VALUE_TYPE*);
+    typedef int (* concurrent_update_mf)(CH_HASHTABLE_TYPE*,const CH_KEY_TYPE*,void (*)(CH_VALUE_TYPE*,int,void*),void*);
+    typedef int (* concurrent_remove_mf)(CH_HASHTABLE_TYPE*,const CH_KEY_TYPE*);
+#   endif
+#   ifdef CH_USE_STATS
+    typedef void (* get_stats_mf)(const CH_HASHTABLE_TYPE*,ch_stats_t*);
+    typedef void (* reset_stats_mf)(CH_HASHTABLE_TYPE*);
+#   endif
 #   endif
     CH_ASSERT(ht);
     memset(ht,0,sizeof(CH_HASHTABLE_TYPE));
@@ -1063,6 +2897,9 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create_with)(
     *((size_t*)&ht->initial_bucket_capacity) = initial_bucket_capacity>1 ? initial_bucket_capacity : 1;
     CH_ASSERT(ht->key_hash);
     /*memset(ht->buckets,0,CH_NUM_BUCKETS*sizeof(CH_VECTOR_TYPE));*/
+#   ifdef CH_USE_DYNAMIC_BUCKETS
+    *((size_t*)&ht->num_buckets) = CH_NUM_BUCKETS;  /* 'buckets' is allocated at the first insertion */
+#   endif
 #   ifndef CH_DISABLE_FAKE_MEMBER_FUNCTIONS
     *((clear_free_shrink_to_fit_mf*)&ht->clear) = &CH_HASHTABLE_TYPE_FCT(_clear);
     *((clear_free_shrink_to_fit_mf*)&ht->free) = &CH_HASHTABLE_TYPE_FCT(_free);
@@ -1079,17 +2916,56 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create_with)(
     *((dbg_check_mf*)&ht->dbg_check) = &CH_HASHTABLE_TYPE_FCT(_dbg_check);
     *((swap_mf*)&ht->swap) = &CH_HASHTABLE_TYPE_FCT(_swap);
     *((cpy_mf*)&ht->cpy) = &CH_HASHTABLE_TYPE_FCT(_cpy);
+    *((get_batch_mf*)&ht->get_batch) = &CH_HASHTABLE_TYPE_FCT(_get_batch);
+    *((get_or_insert_batch_mf*)&ht->get_or_insert_batch) = &CH_HASHTABLE_TYPE_FCT(_get_or_insert_batch);
+    *((build_from_mf*)&ht->build_from) = &CH_HASHTABLE_TYPE_FCT(_build_from);
+#   if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+    *((rehash_mf*)&ht->rehash) = &CH_HASHTABLE_TYPE_FCT(_rehash);
+#   endif
+#   ifdef CH_USE_STRIPED_LOCKS
+    *((concurrent_get_mf*)&ht->concurrent_get) = &CH_HASHTABLE_TYPE_FCT(_concurrent_get);
+    *((concurrent_set_mf*)&ht->concurrent_set) = &CH_HASHTABLE_TYPE_FCT(_concurrent_set);
+    *((concurrent_update_mf*)&ht->concurrent_update) = &CH_HASHTABLE_TYPE_FCT(_concurrent_update);
+    *((concurrent_remove_mf*)&ht->concurrent_remove) = &CH_HASHTABLE_TYPE_FCT(_concurrent_remove);
+#   endif
+#   ifdef CH_USE_STATS
+    *((get_stats_mf*)&ht->get_stats) = &CH_HASHTABLE_TYPE_FCT(_get_stats);
+    *((reset_stats_mf*)&ht->reset_stats) = &CH_HASHTABLE_TYPE_FCT(_reset_stats);
+#   endif
 #   endif
 }
-CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uint (*key_hash)(const CH_KEY_TYPE*),int (*key_cmp) (const CH_CMP_TYPE*,const CH_CMP_TYPE*),size_t initial_bucket_capacity)    {
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,CH_KEY_HASH_UINT (*key_hash)(const CH_KEY_TYPE*),int (*key_cmp) (const CH_CMP_TYPE*,const CH_CMP_TYPE*),size_t initial_bucket_capacity)    {
     CH_HASHTABLE_TYPE_FCT(_create_with)(ht,key_hash,key_cmp,NULL,NULL,NULL,NULL,NULL,NULL,initial_bucket_capacity);
 }
+/* 'policy' (optional) must outlive the hashtable. It's used by the sorted buckets only (the open addressing slot array always doubles) */
+CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_set_growth_policy)(CH_HASHTABLE_TYPE* ht,const cvh_growth_policy_t* policy)    {
+    CH_ASSERT(ht);
+    *((const cvh_growth_policy_t**)&ht->growth_policy) = policy;
+}
 
 #ifdef __cplusplus
     CH_HASHTABLE_TYPE::CH_HASHTABLE_TYPE() :
         key_ctr(NULL),key_dtr(NULL),key_cpy(NULL),key_cmp(NULL),key_hash(NULL),
         value_ctr(NULL),value_dtr(NULL),value_cpy(NULL),
-        initial_bucket_capacity(0),
+        initial_bucket_capacity(0),growth_policy(NULL),
+#       ifdef CH_USE_DYNAMIC_BUCKETS
+        buckets(NULL),num_buckets(CH_NUM_BUCKETS),num_items(0),old_buckets(NULL),old_num_buckets(0),rehash_index(0),
+#       endif
+#       ifdef CH_USE_BUCKET_SLABS
+        slabs(),
+#       endif
+#       ifdef CH_USE_OPEN_ADDRESSING
+        slots(NULL),ctrl(NULL),capacity(0),num_items(0),growth_left(0),
+#       endif
+#       ifdef CH_USE_STRIPED_LOCKS
+        locks(),
+#       endif
+#       ifdef CH_USE_RCU_READS
+        rcu(),
+#       endif
+#       ifdef CH_USE_STATS
+        stats(),
+#       endif
         clear(&CH_HASHTABLE_TYPE_FCT(_clear)),free(&CH_HASHTABLE_TYPE_FCT(_free)),shrink_to_fit(&CH_HASHTABLE_TYPE_FCT(_shrink_to_fit)),
         get_or_insert(&CH_HASHTABLE_TYPE_FCT(_get_or_insert)),get_or_insert_by_val(&CH_HASHTABLE_TYPE_FCT(_get_or_insert_by_val)),
         get(&CH_HASHTABLE_TYPE_FCT(_get)),get_by_val(&CH_HASHTABLE_TYPE_FCT(_get_by_val)),
@@ -1097,11 +2973,41 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
         remove(&CH_HASHTABLE_TYPE_FCT(_remove)),remove_by_val(&CH_HASHTABLE_TYPE_FCT(_remove_by_val)),
         get_num_items(&CH_HASHTABLE_TYPE_FCT(_get_num_items)),
         dbg_check(&CH_HASHTABLE_TYPE_FCT(_dbg_check)),
-        swap(&CH_HASHTABLE_TYPE_FCT(_swap)),cpy(&CH_HASHTABLE_TYPE_FCT(_cpy))
+        swap(&CH_HASHTABLE_TYPE_FCT(_swap)),cpy(&CH_HASHTABLE_TYPE_FCT(_cpy)),
+        get_batch(&CH_HASHTABLE_TYPE_FCT(_get_batch)),get_or_insert_batch(&CH_HASHTABLE_TYPE_FCT(_get_or_insert_batch)),
+        build_from(&CH_HASHTABLE_TYPE_FCT(_build_from))
+#       if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+        ,rehash(&CH_HASHTABLE_TYPE_FCT(_rehash))
+#       endif
+#       ifdef CH_USE_STRIPED_LOCKS
+        ,concurrent_get(&CH_HASHTABLE_TYPE_FCT(_concurrent_get)),concurrent_set(&CH_HASHTABLE_TYPE_FCT(_concurrent_set))
+        ,concurrent_update(&CH_HASHTABLE_TYPE_FCT(_concurrent_update)),concurrent_remove(&CH_HASHTABLE_TYPE_FCT(_concurrent_remove))
+#       endif
+#       ifdef CH_USE_STATS
+        ,get_stats(&CH_HASHTABLE_TYPE_FCT(_get_stats)),reset_stats(&CH_HASHTABLE_TYPE_FCT(_reset_stats))
+#       endif
     {}
     CH_HASHTABLE_TYPE::CH_HASHTABLE_TYPE(const CH_HASHTABLE_TYPE& o) :
         key_ctr(o.key_ctr),key_dtr(o.key_dtr),key_cpy(o.key_cpy),key_cmp(o.key_cmp),key_hash(o.key_hash),
-        value_ctr(o.value_ctr),value_dtr(o.value_dtr),value_cpy(o.value_cpy),initial_bucket_capacity(o.initial_bucket_capacity),
+        value_ctr(o.value_ctr),value_dtr(o.value_dtr),value_cpy(o.value_cpy),initial_bucket_capacity(o.initial_bucket_capacity),growth_policy(o.growth_policy),
+#       ifdef CH_USE_DYNAMIC_BUCKETS
+        buckets(NULL),num_buckets(o.num_buckets),num_items(0),old_buckets(NULL),old_num_buckets(0),rehash_index(0),
+#       endif
+#       ifdef CH_USE_BUCKET_SLABS
+        slabs(),
+#       endif
+#       ifdef CH_USE_OPEN_ADDRESSING
+        slots(NULL),ctrl(NULL),capacity(0),num_items(0),growth_left(0),
+#       endif
+#       ifdef CH_USE_STRIPED_LOCKS
+        locks(),
+#       endif
+#       ifdef CH_USE_RCU_READS
+        rcu(),
+#       endif
+#       ifdef CH_USE_STATS
+        stats(),
+#       endif
         clear(&CH_HASHTABLE_TYPE_FCT(_clear)),free(&CH_HASHTABLE_TYPE_FCT(_free)),shrink_to_fit(&CH_HASHTABLE_TYPE_FCT(_shrink_to_fit)),
         get_or_insert(&CH_HASHTABLE_TYPE_FCT(_get_or_insert)),get_or_insert_by_val(&CH_HASHTABLE_TYPE_FCT(_get_or_insert_by_val)),
         get(&CH_HASHTABLE_TYPE_FCT(_get)),get_by_val(&CH_HASHTABLE_TYPE_FCT(_get_by_val)),
@@ -1109,7 +3015,19 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
         remove(&CH_HASHTABLE_TYPE_FCT(_remove)),remove_by_val(&CH_HASHTABLE_TYPE_FCT(_remove_by_val)),
         get_num_items(&CH_HASHTABLE_TYPE_FCT(_get_num_items)),
         dbg_check(&CH_HASHTABLE_TYPE_FCT(_dbg_check)),
-        swap(&CH_HASHTABLE_TYPE_FCT(_swap)),cpy(&CH_HASHTABLE_TYPE_FCT(_cpy))
+        swap(&CH_HASHTABLE_TYPE_FCT(_swap)),cpy(&CH_HASHTABLE_TYPE_FCT(_cpy)),
+        get_batch(&CH_HASHTABLE_TYPE_FCT(_get_batch)),get_or_insert_batch(&CH_HASHTABLE_TYPE_FCT(_get_or_insert_batch)),
+        build_from(&CH_HASHTABLE_TYPE_FCT(_build_from))
+#       if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+        ,rehash(&CH_HASHTABLE_TYPE_FCT(_rehash))
+#       endif
+#       ifdef CH_USE_STRIPED_LOCKS
+        ,concurrent_get(&CH_HASHTABLE_TYPE_FCT(_concurrent_get)),concurrent_set(&CH_HASHTABLE_TYPE_FCT(_concurrent_set))
+        ,concurrent_update(&CH_HASHTABLE_TYPE_FCT(_concurrent_update)),concurrent_remove(&CH_HASHTABLE_TYPE_FCT(_concurrent_remove))
+#       endif
+#       ifdef CH_USE_STATS
+        ,get_stats(&CH_HASHTABLE_TYPE_FCT(_get_stats)),reset_stats(&CH_HASHTABLE_TYPE_FCT(_reset_stats))
+#       endif
     {
         CH_HASHTABLE_TYPE_FCT(_cpy)(this,&o);
     }
@@ -1119,7 +3037,25 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
 #   ifdef CH_HAS_MOVE_SEMANTICS
     CH_HASHTABLE_TYPE::CH_HASHTABLE_TYPE(CH_HASHTABLE_TYPE&& o) :
         key_ctr(o.key_ctr),key_dtr(o.key_dtr),key_cpy(o.key_cpy),key_cmp(o.key_cmp),key_hash(o.key_hash),
-        value_ctr(o.value_ctr),value_dtr(o.value_dtr),value_cpy(o.value_cpy),initial_bucket_capacity(o.initial_bucket_capacity),
+        value_ctr(o.value_ctr),value_dtr(o.value_dtr),value_cpy(o.value_cpy),initial_bucket_capacity(o.initial_bucket_capacity),growth_policy(o.growth_policy),
+#       ifdef CH_USE_DYNAMIC_BUCKETS
+        buckets(NULL),num_buckets(o.num_buckets),num_items(0),old_buckets(NULL),old_num_buckets(0),rehash_index(0),
+#       endif
+#       ifdef CH_USE_BUCKET_SLABS
+        slabs(),
+#       endif
+#       ifdef CH_USE_OPEN_ADDRESSING
+        slots(NULL),ctrl(NULL),capacity(0),num_items(0),growth_left(0),
+#       endif
+#       ifdef CH_USE_STRIPED_LOCKS
+        locks(),
+#       endif
+#       ifdef CH_USE_RCU_READS
+        rcu(),
+#       endif
+#       ifdef CH_USE_STATS
+        stats(),
+#       endif
         clear(&CH_HASHTABLE_TYPE_FCT(_clear)),free(&CH_HASHTABLE_TYPE_FCT(_free)),shrink_to_fit(&CH_HASHTABLE_TYPE_FCT(_shrink_to_fit)),
         get_or_insert(&CH_HASHTABLE_TYPE_FCT(_get_or_insert)),get_or_insert_by_val(&CH_HASHTABLE_TYPE_FCT(_get_or_insert_by_val)),
         get(&CH_HASHTABLE_TYPE_FCT(_get)),get_by_val(&CH_HASHTABLE_TYPE_FCT(_get_by_val)),
@@ -1127,8 +3063,21 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
         remove(&CH_HASHTABLE_TYPE_FCT(_remove)),remove_by_val(&CH_HASHTABLE_TYPE_FCT(_remove_by_val)),
         get_num_items(&CH_HASHTABLE_TYPE_FCT(_get_num_items)),
         dbg_check(&CH_HASHTABLE_TYPE_FCT(_dbg_check)),
-        swap(&CH_HASHTABLE_TYPE_FCT(_swap)),cpy(&CH_HASHTABLE_TYPE_FCT(_cpy))
+        swap(&CH_HASHTABLE_TYPE_FCT(_swap)),cpy(&CH_HASHTABLE_TYPE_FCT(_cpy)),
+        get_batch(&CH_HASHTABLE_TYPE_FCT(_get_batch)),get_or_insert_batch(&CH_HASHTABLE_TYPE_FCT(_get_or_insert_batch)),
+        build_from(&CH_HASHTABLE_TYPE_FCT(_build_from))
+#       if (defined(CH_USE_DYNAMIC_BUCKETS) || defined(CH_USE_OPEN_ADDRESSING))
+        ,rehash(&CH_HASHTABLE_TYPE_FCT(_rehash))
+#       endif
+#       ifdef CH_USE_STRIPED_LOCKS
+        ,concurrent_get(&CH_HASHTABLE_TYPE_FCT(_concurrent_get)),concurrent_set(&CH_HASHTABLE_TYPE_FCT(_concurrent_set))
+        ,concurrent_update(&CH_HASHTABLE_TYPE_FCT(_concurrent_update)),concurrent_remove(&CH_HASHTABLE_TYPE_FCT(_concurrent_remove))
+#       endif
+#       ifdef CH_USE_STATS
+        ,get_stats(&CH_HASHTABLE_TYPE_FCT(_get_stats)),reset_stats(&CH_HASHTABLE_TYPE_FCT(_reset_stats))
+#       endif
     {
+#       if (!defined(CH_USE_DYNAMIC_BUCKETS) && !defined(CH_USE_OPEN_ADDRESSING))
         size_t i;
         for (i=0;i<CH_NUM_BUCKETS;i++) {
             CH_VECTOR_TYPE& d = buckets[i];
@@ -1138,10 +3087,17 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
             s.v=NULL;
             *((size_t*)&s.size)=0;*((size_t*)&s.capacity)=0;
         }
+#       ifdef CH_USE_BUCKET_SLABS
+        memcpy(&slabs,&o.slabs,sizeof(ch_slab_allocator));memset(&o.slabs,0,sizeof(ch_slab_allocator));
+#       endif
+#       else
+        CH_HASHTABLE_TYPE_FCT(_swap)(this,&o);  /* 'this' is empty */
+#       endif
     }
 
     CH_HASHTABLE_TYPE& CH_HASHTABLE_TYPE::operator=(CH_HASHTABLE_TYPE&& o)    {
         if (this != &o) {
+#           if (!defined(CH_USE_DYNAMIC_BUCKETS) && !defined(CH_USE_OPEN_ADDRESSING))
             size_t i;
             CH_HASHTABLE_TYPE_FCT(_free)(this);
             for (i=0;i<CH_NUM_BUCKETS;i++) {
@@ -1152,6 +3108,13 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
                 s.v=NULL;
                 *((size_t*)&s.size)=0;*((size_t*)&s.capacity)=0;
             }
+#           ifdef CH_USE_BUCKET_SLABS
+            memcpy(&slabs,&o.slabs,sizeof(ch_slab_allocator));memset(&o.slabs,0,sizeof(ch_slab_allocator));
+#           endif
+#           else
+            CH_HASHTABLE_TYPE_FCT(_free)(this);
+            CH_HASHTABLE_TYPE_FCT(_swap)(this,&o);  /* now 'o' is empty */
+#           endif
         }
         return *this;
     }
@@ -1174,6 +3137,16 @@ CH_API_DEF void CH_HASHTABLE_TYPE_FCT(_create)(CH_HASHTABLE_TYPE* ht,ch_hash_uin
 #undef CHV_KEY_SUPPORT_EQUALITY_CMP_IN_UNSORTED_SEARCH
 #undef CH_HASHTABLE_ITEM_TYPE_TMP
 #undef CH_HASHTABLE_ITEM_TYPE
+#undef CH_KEY_HASH_UINT
+#undef CH_HAS_CVH_SERIALIZER
+#undef CH_USE_DYNAMIC_BUCKETS
+#undef CH_USE_OPEN_ADDRESSING
+#undef CH_USE_CACHED_HASHES
+#undef CH_USE_BUCKET_SLABS
+#undef CH_USE_STRIPED_LOCKS
+#undef CH_USE_RCU_READS
+#undef CH_USE_STATS
+#undef CH_STATS_ADD
 #undef CH_LAST_INCLUDED_NUM_BUCKETS
 #define CH_LAST_INCLUDED_NUM_BUCKETS CH_NUM_BUCKETS
 #undef CH_NUM_BUCKETS
@@ -37,6 +37,7 @@ freely, subject to the following restrictions:
    CH_ENABLE_DECLARATION_AND_DEFINITION // when used, C_HASHTABLE_TYPE_UNSAFE_IMPLEMENTATION must be
                                         // defined before including this file in a single source (.c) file
    CH_NO_PLACEMENT_NEW                  // (c++ mode only) it does not define (unused) helper stuff like: CH_PLACEMENT_NEW, cpp_ctr_tu,cpp_dtr_tu,cpp_cpy_tu,cpp_cmp_tu
+   CH_NO_SIMD                           // disables the SSE2/AVX2 key search used when 'key_cmp' is NULL and 'key_size_in_bytes' is 4, 8 or 16 (a scalar fallback is used)
 
    CH_MALLOC
    CH_REALLOC
@@ -55,10 +56,27 @@ freely, subject to the following restrictions:
 #ifndef C_HASHTABLE_TYPE_UNSAFE_H
 #define C_HASHTABLE_TYPE_UNSAFE_H
 
-#define C_HASHTABLE_TYPE_UNSAFE_VERSION         "1.06 rev2"
-#define C_HASHTABLE_TYPE_UNSAFE_VERSION_NUM     0106
+#define C_HASHTABLE_TYPE_UNSAFE_VERSION         "1.08"
+#define C_HASHTABLE_TYPE_UNSAFE_VERSION_NUM     0108
 
 /* HISTORY:
+   C_HASHTABLE_TYPE_UNSAFE_VERSION_NUM 108
+   -> added 'chashtable_serialize(ht,serializer,key_serialize,value_serialize)' and 'chashtable_deserialize(ht,deserializer,key_deserialize,value_deserialize)'.
+      They use the 'cvh_serializer_t' of "c_vector.h" (or of "c_vector_type_unsafe.h"), so they are available only when
+      one of these two headers is included before <c_hashtable_type_unsafe.h>. The callbacks are optional: when both are NULL keys
+      and values are plain-old-data, and the keys and the values of every bucket are written (and read back) as two blocks.
+      When only one of them is NULL, its (plain-old-data) key or value is just copied.
+      The snapshot layout is: [size_t num_items][size_t CH_NUM_USED_BUCKETS][size_t item_size] then, for every bucket,
+      [size_t bucket_size][items]. 'item_size' is 'key_size_in_bytes+value_size_in_bytes' when both callbacks are NULL (0 otherwise).
+      When the reader has the same CH_NUM_USED_BUCKETS, buckets are restored as they are (after checking that the 'key_hash'
+      of their first key still maps to them). Otherwise every item is inserted again.
+      Like the vector (de)serialization, the snapshot is NOT endian-independent (and its plain-old-data items are NOT portable).
+
+   C_HASHTABLE_TYPE_UNSAFE_VERSION_NUM 107
+   -> when 'key_cmp' is NULL and 'key_size_in_bytes' is 4, 8 or 16, 'chvector_unsorted_search(...)' now compares
+      a whole block of keys per instruction with SSE2 (16 bytes) or AVX2 (32 bytes), when available.
+      Define CH_NO_SIMD globally to use the scalar (memcmp) fallback.
+
    C_HASHTABLE_TYPE_UNSAFE_VERSION_NUM 106 rev2
    -> added the CV_SIZE_T_FORMATTING definition (internal usage).
 
@@ -398,6 +416,64 @@ CH_API unsigned ch_hash32_FNV1a_str(const char* text)	{
 #	define CH_HASH_FROM_HASH32_USING_FIBFOLDING(hash32,num_buckets_pot_exponent)	((hash32*2654435769U) >> (32-(num_buckets_pot_exponent)))
 #endif /* CH_COMMON_FUNCTIONS_GUARD */
 
+#if (!defined(CH_NO_SIMD) && !defined(CHTU_SIMD_GUARD))
+#define CHTU_SIMD_GUARD
+/* SIMD key search helpers: keys of 4, 8 or 16 bytes are compared CHTU_SIMD_BLOCK_SIZE bytes at a time */
+#if (defined(__AVX2__))
+#   include <immintrin.h>
+#   define CHTU_USE_AVX2
+#   define CHTU_SIMD_BLOCK_SIZE 32
+#elif (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2))
+#   include <emmintrin.h>
+#   define CHTU_USE_SSE2
+#   define CHTU_SIMD_BLOCK_SIZE 16
+#endif
+#ifdef CHTU_SIMD_BLOCK_SIZE
+/* 'mask' has 4 bits set for every equal 32-bit word of the block: returns a bit mask with the first bit of every equal key */
+CH_API unsigned chtu_simd_key_mask(unsigned mask,size_t key_size)    {
+    if (key_size>=8)    mask&=mask>>4;
+    if (key_size>=16)   mask&=mask>>8;
+    return mask & (key_size==4 ? 0x11111111U : (key_size==8 ? 0x01010101U : 0x00010001U));
+}
+CH_API unsigned chtu_simd_ctz(unsigned mask)    {
+    /* 'mask' must not be zero */
+#   if (defined(__GNUC__) || defined(__clang__))
+    return (unsigned) __builtin_ctz(mask);
+#   else
+    unsigned n=0;
+    while (!(mask&1)) {mask>>=1;++n;}
+    return n;
+#   endif
+}
+/* returns the index of the first key in 'keys' (an array of 'num_keys' keys) that is bitwise equal to 'key', or 'num_keys' */
+CH_API size_t chtu_simd_find_key(const unsigned char* keys,size_t num_keys,const void* key,size_t key_size)   {
+    const size_t keys_per_block = CHTU_SIMD_BLOCK_SIZE/key_size;
+    size_t i=0;unsigned mask;
+    __m128i k;
+    CH_ASSERT(key_size==4 || key_size==8 || key_size==16);
+    if (key_size==4)    {int t;memcpy(&t,key,4);k=_mm_set1_epi32(t);}
+    else if (key_size==8)   {k=_mm_loadl_epi64((const __m128i*) key);k=_mm_unpacklo_epi64(k,k);}
+    else k=_mm_loadu_si128((const __m128i*) key);
+    {
+#   ifdef CHTU_USE_AVX2
+    const __m256i k2 = _mm256_inserti128_si256(_mm256_castsi128_si256(k),k,1);
+    for (;i+keys_per_block<=num_keys;i+=keys_per_block)    {
+        mask = chtu_simd_key_mask((unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(keys+i*key_size)),k2)),key_size);
+        if (mask) return i+chtu_simd_ctz(mask)/key_size;
+    }
+#   else
+    for (;i+keys_per_block<=num_keys;i+=keys_per_block)    {
+        mask = chtu_simd_key_mask((unsigned) _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(keys+i*key_size)),k)),key_size);
+        if (mask) return i+chtu_simd_ctz(mask)/key_size;
+    }
+#   endif
+    }
+    for (;i<num_keys;i++) {if (memcmp(key,keys+i*key_size,key_size)==0) return i;}
+    return num_keys;
+}
+#endif /* CHTU_SIMD_BLOCK_SIZE */
+#endif /* CHTU_SIMD_GUARD */
+
 #ifndef CH_NUM_USED_BUCKETS
 #   define CH_NUM_USED_BUCKETS 256
 #endif
@@ -490,6 +566,10 @@ typedef struct chvector chvector;
 #endif
 typedef chvector chvectors[CH_NUM_USED_BUCKETS];
 
+#if (defined(C_VECTOR_H_) || (defined(C_VECTOR_TYPE_UNSAFE_H) && !defined(CV_NO_CVH_SERIALIZER_T)))
+#   define CHTU_HAS_CVH_SERIALIZER  /* 'chashtable_serialize(...)' and 'chashtable_deserialize(...)' need 'cvh_serializer_t' (internal usage) */
+#endif
+
 
 #ifdef CH_ENABLE_DECLARATION_AND_DEFINITION
 /* function declarations */
@@ -504,6 +584,10 @@ CH_API_DEC int chashtable_dbg_check(const chashtable* ht);
 CH_API_DEC void chashtable_swap(chashtable* a,chashtable* b);
 CH_API_DEC void chashtable_cpy(chashtable* a,const chashtable* b);
 CH_API_DEC void chashtable_shrink_to_fit(chashtable* ht);
+#ifdef CHTU_HAS_CVH_SERIALIZER
+CH_API_DEC void chashtable_serialize(const chashtable* ht,cvh_serializer_t* serializer,void (*key_serialize)(const void*,cvh_serializer_t*),void (*value_serialize)(const void*,cvh_serializer_t*));
+CH_API_DEC int chashtable_deserialize(chashtable* ht,const cvh_serializer_t* deserializer,int (*key_deserialize)(void*,const cvh_serializer_t*),int (*value_deserialize)(void*,const cvh_serializer_t*));
+#endif
 CH_API_DEC void chashtable_create_with(
         chashtable* ht,
 		size_t key_size_in_bytes,size_t value_size_in_bytes,
@@ -593,6 +677,13 @@ CH_API size_t chvector_unsorted_search(const chvector* v,const void* key,int* ma
     CH_ASSERT(v && ht);
     if (match) *match=0;
     if (v->size==0) return 0;  /* otherwise match will be 1 */
+#   ifdef CHTU_SIMD_BLOCK_SIZE
+    if (!ht->key_cmp && (ht->key_size_in_bytes==4 || ht->key_size_in_bytes==8 || ht->key_size_in_bytes==16))   {
+        i = chtu_simd_find_key((const unsigned char*)v->k,v->size,key,ht->key_size_in_bytes);
+        if (i<v->size && match) *match=1;
+        return i;
+    }
+#   endif
     if (!ht->key_cmp)   {
         int cmp_ok=0;
         for (i = 0; i < v->size; i++) {
@@ -946,6 +1037,106 @@ CH_API_DEF void chashtable_shrink_to_fit(chashtable* ht)   {
     }
 }
 
+#ifdef CHTU_HAS_CVH_SERIALIZER
+/* It needs "c_vector.h" (or "c_vector_type_unsafe.h") to be included before <c_hashtable_type_unsafe.h>.
+   'key_serialize' and 'value_serialize' can be NULL for plain-old-data keys and values
+   (when both are NULL, the keys and the values of every bucket are written as two blocks). Please see history for version 1.08 */
+CH_API_DEF void chashtable_serialize(const chashtable* ht,cvh_serializer_t* serializer,void (*key_serialize)(const void*,cvh_serializer_t*),void (*value_serialize)(const void*,cvh_serializer_t*))  {
+    const int pod = (!key_serialize && !value_serialize);
+    size_t i,j;
+    CH_ASSERT(ht && serializer);
+    cvh_serializer_write_size_t(serializer,chashtable_get_num_items(ht));
+    cvh_serializer_write_size_t(serializer,CH_NUM_USED_BUCKETS);
+    cvh_serializer_write_size_t(serializer,pod ? (ht->key_size_in_bytes+ht->value_size_in_bytes) : 0);
+    for (i=0;i<CH_NUM_USED_BUCKETS;i++) {
+        const chvector* b = &ht->buckets[i];
+        cvh_serializer_write_size_t(serializer,b->size);
+        if (b->size==0) continue;
+        if (pod)    {
+            cvh_serializer_write_bytes(serializer,b->k,b->size*ht->key_size_in_bytes);
+            cvh_serializer_write_bytes(serializer,b->v,b->size*ht->value_size_in_bytes);
+            continue;
+        }
+        for (j=0;j<b->size;j++) {
+            const unsigned char* k = (const unsigned char*)b->k+j*ht->key_size_in_bytes;
+            const unsigned char* v = (const unsigned char*)b->v+j*ht->value_size_in_bytes;
+            if (key_serialize) key_serialize(k,serializer);
+            else cvh_serializer_write_bytes(serializer,k,ht->key_size_in_bytes);
+            if (value_serialize) value_serialize(v,serializer);
+            else cvh_serializer_write_bytes(serializer,v,ht->value_size_in_bytes);
+        }
+    }
+}
+/* It clears 'ht' (that must have been created with the same 'key_hash' and callbacks used when serializing)
+   and returns 1 on success. The deserialization callbacks must be NULL when the serialization callbacks were NULL */
+CH_API_DEF int chashtable_deserialize(chashtable* ht,const cvh_serializer_t* deserializer,int (*key_deserialize)(void*,const cvh_serializer_t*),int (*value_deserialize)(void*,const cvh_serializer_t*))  {
+    const int pod = (!key_deserialize && !value_deserialize);
+    size_t num_items=0,num_buckets=0,item_size=0,total=0,i,j;
+    void* tmp = NULL;   /* keys that are inserted again */
+    int check;
+    CH_ASSERT(ht && deserializer);
+    chashtable_clear(ht);
+    check = cvh_serializer_read_size_t(deserializer,&num_items) && cvh_serializer_read_size_t(deserializer,&num_buckets) && cvh_serializer_read_size_t(deserializer,&item_size);
+    if (!check) return 0;
+    check = (item_size==(pod ? (ht->key_size_in_bytes+ht->value_size_in_bytes) : 0));
+    CH_ASSERT(check);   /* the snapshot was written with different callbacks (or with different key or value sizes) */
+    if (!check) return 0;
+    for (i=0;check && i<num_buckets;i++)    {
+        size_t size=0;
+        check = cvh_serializer_read_size_t(deserializer,&size) && size<=num_items-total;
+        if (!check || size==0) continue;
+        total+=size;
+        if (num_buckets==CH_NUM_USED_BUCKETS)   {
+            /* fast path: the bucket is restored as it is (without inserting its items one by one) */
+            chvector* b = &ht->buckets[i];
+            if (pod)    {
+                chvector_reserve(b,size,ht);
+                check = cvh_serializer_read_bytes(deserializer,b->k,size*ht->key_size_in_bytes) && cvh_serializer_read_bytes(deserializer,b->v,size*ht->value_size_in_bytes);
+                if (check) *((size_t*) &b->size)=size;
+            }
+            else {
+                chvector_resize(b,size,ht);
+                for (j=0;check && j<size;j++)   {
+                    unsigned char* k = (unsigned char*)b->k+j*ht->key_size_in_bytes;
+                    unsigned char* v = (unsigned char*)b->v+j*ht->value_size_in_bytes;
+                    check = key_deserialize ? key_deserialize(k,deserializer) : cvh_serializer_read_bytes(deserializer,k,ht->key_size_in_bytes);
+                    if (check) check = value_deserialize ? value_deserialize(v,deserializer) : cvh_serializer_read_bytes(deserializer,v,ht->value_size_in_bytes);
+                }
+            }
+            /* the (sorted) bucket is still valid only if 'key_hash' has not changed */
+            if (check) {check = ((size_t)ht->key_hash(b->k)==i);CH_ASSERT(check);}
+        }
+        else if (pod)   {
+            /* slow path: every item is inserted again (here all the keys of the bucket come first) */
+            ch_safe_realloc(&tmp,size*ht->key_size_in_bytes);
+            check = cvh_serializer_read_bytes(deserializer,tmp,size*ht->key_size_in_bytes);
+            for (j=0;check && j<size;j++)   {
+                void* v = chashtable_get_or_insert(ht,(const unsigned char*)tmp+j*ht->key_size_in_bytes,NULL);
+                check = cvh_serializer_read_bytes(deserializer,v,ht->value_size_in_bytes);
+            }
+        }
+        else {
+            /* slow path: every item is inserted again */
+            if (!tmp) {tmp = ch_malloc(ht->key_size_in_bytes);memset(tmp,0,ht->key_size_in_bytes);if (ht->key_ctr) ht->key_ctr(tmp);}
+            for (j=0;check && j<size;j++)   {
+                void* v;
+                check = key_deserialize ? key_deserialize(tmp,deserializer) : cvh_serializer_read_bytes(deserializer,tmp,ht->key_size_in_bytes);
+                if (!check) break;
+                v = chashtable_get_or_insert(ht,tmp,NULL);
+                check = value_deserialize ? value_deserialize(v,deserializer) : cvh_serializer_read_bytes(deserializer,v,ht->value_size_in_bytes);
+            }
+        }
+    }
+    if (tmp)    {
+        if (!pod && ht->key_dtr) ht->key_dtr(tmp);
+        ch_free(tmp);
+    }
+    if (check) {check = (total==num_items);CH_ASSERT(check);}
+    if (!check) chashtable_clear(ht);
+    return check;
+}
+#endif /* CHTU_HAS_CVH_SERIALIZER */
+
 CH_API_DEF void chashtable_create_with(
         chashtable* ht,
 		size_t key_size_in_bytes,size_t value_size_in_bytes,
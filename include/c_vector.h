@@ -43,6 +43,17 @@ freely, subject to the following restrictions:
    CV_NO_ASSERT
    CV_NO_STDIO
    CV_NO_STDLIB
+   CV_NO_MMAP                           // it disables mmap(...) in cvh_mmap_open(...), that just loads the whole file in this case (mmap(...) is used by default on unix-like systems only).
+   CVH_SERIALIZER_STREAM_BUFFER_SIZE    // default buffer size (in bytes) of a streaming cvh_serializer_t (see cvh_serializer_init_sink(...) and cvh_serializer_init_source(...)). Defaults to 65536.
+   CV_SORT_INSERTION_THRESHOLD          // cv_xxx_sort(...) uses insertion sort on partitions smaller than this (defaults to 24, it must be at least 3).
+   CV_SORT_NINTHER_THRESHOLD            // cv_xxx_sort(...) uses a pseudo median-of-9 pivot (instead of a median-of-3) on partitions bigger than this (defaults to 128, it must be at least 8).
+   CV_PREFETCH(ADDR)                    // defaults to __builtin_prefetch(ADDR) (or to _mm_prefetch(ADDR,_MM_HINT_T0) with Visual C++). It can be defined as a no-op.
+   CV_ENABLE_PARALLEL                   // it adds cv_xxx_parallel_sort(...), cv_xxx_parallel_for_each(...) and cv_xxx_parallel_cpy(...) (pthreads, or Win32 threads on Windows: please link with -pthread on unix-like systems).
+   CV_PARALLEL_NUM_THREADS              // (CV_ENABLE_PARALLEL only) number of threads used when the 'num_threads' argument is <=0 (defaults to 0, that means: the number of online processors).
+   CV_PARALLEL_MIN_ITEMS_PER_THREAD     // (CV_ENABLE_PARALLEL only) fewer threads are used if they'd get less items than this, and the serial code if there's just one thread (defaults to 65536).
+   CV_PARALLEL_MAX_THREADS              // (CV_ENABLE_PARALLEL only) max number of threads (defaults to 64).
+   CVH_VM_HUGE_PAGE_SIZE                // huge page size (in bytes) used by 'cvh_vm_allocator_t' when 'use_huge_pages' is true (defaults to 2 MB).
+   CV_ENABLE_ALLOC_STATS                // it adds allocation counters (cv_xxx_get_alloc_stats(...), cvh_serializer_get_alloc_stats(...), cvh_string_get_alloc_stats(...)) and an allocation callback (cvh_set_alloc_callback(...)).
    CV_API_INL                           // this simply defines the 'inline' keyword syntax (defaults to __inline).
    CV_API                               // used always when CV_ENABLE_DECLARATION_AND_DEFINITION is not defined and in some global or private functions otherwise.
    CV_API_DEC                           // defaults to CV_API, or to 'CV_API_INL extern' if CV_ENABLE_DECLARATION_AND_DEFINITION is defined.
@@ -54,12 +65,115 @@ freely, subject to the following restrictions:
 
 
 #ifndef C_VECTOR_VERSION
-#define C_VECTOR_VERSION        "1.15 rev4"
-#define C_VECTOR_VERSION_NUM    0115
+#define C_VECTOR_VERSION        "1.28"
+#define C_VECTOR_VERSION_NUM    0128
 #endif
 
 
 /* HISTORY:
+   C_VECTOR_VERSION_NUM 128
+   -> added 'cvh_vm_allocator_t' (shared with "c_vector_type_unsafe.h"), a 'cvh_allocator_t' for very large vectors: every buffer is an anonymous
+      mmap(...) that grows with mremap(...) on Linux (the items are never copied: growing a multi-gigabyte vector costs O(new pages)).
+      cvh_vm_allocator_init(&a,use_huge_pages) can also round big buffers up to whole (aligned) huge pages and advise them with MADV_HUGEPAGE.
+      Usage: cv_xxx_init_with_allocator(&v,...,&a.allocator), and cvh_vm_allocator_close(&a) at the end. The lengths of the mappings are kept
+      in a table inside the allocator (so buffers start on a page boundary, and the allocator is not thread-safe).
+      In plain C mremap(...) needs _GNU_SOURCE (otherwise growing copies the items), and without mmap(...) (e.g. on Windows) CV_MALLOC/CV_REALLOC/CV_FREE are used.
+   -> added the optional 'cvh_allocator_t::shrink' callback: when present, cv_xxx_shrink_to_fit(...) trims the buffer in place through it
+      (instead of copying the items to a new buffer). 'cvh_vm_allocator_t' uses it to release the tail pages.
+
+   C_VECTOR_VERSION_NUM 127
+   -> added 'cvh_growth_policy_t' (shared with "c_vector_type_unsafe.h" and "c_hashtable.h"), an optional per-instance growth policy
+      that replaces the default (about 1.5x) growth of cv_xxx_reserve(...). It can be geometric (cvh_growth_policy_geometric(num,den), e.g. 2/1),
+      a fixed chunk (cvh_growth_policy_fixed_chunk(chunk_bytes), linear growth with bounded unused memory) or page-aligned
+      (cvh_growth_policy_page_aligned(num,den,page_bytes): geometric, with the buffer size rounded up to whole pages, e.g. 2 MB huge pages).
+      It's set after the init with cv_xxx_set_growth_policy(v,&policy) (NULL restores the default), and it must outlive the vector.
+      The same policy can be used by cvh_serializer_set_growth_policy(...) and cvh_string_set_growth_policy(...).
+      See the growth policy section of "benchmark_main.c" for its effect on the number of reallocations.
+
+   C_VECTOR_VERSION_NUM 126
+   -> added optional allocation telemetry (it must be enabled by the global definition CV_ENABLE_ALLOC_STATS): every vector type, and
+      'cvh_serializer_t' and 'cvh_string_t', keep a 'cvh_alloc_stats_t' with the number of allocations, growths and releases, the bytes of live items
+      moved by the growths, the current and peak capacity in bytes, and the unused capacity of the released buffers ("wasted" bytes).
+      They can be read and reset with cv_xxx_get_alloc_stats(...)/cv_xxx_reset_alloc_stats(), cvh_serializer_get_alloc_stats(...)/cvh_serializer_reset_alloc_stats()
+      and cvh_string_get_alloc_stats(...)/cvh_string_reset_alloc_stats(). cvh_set_alloc_callback(callback,user_data) also reports every single event
+      (a 'cvh_alloc_event_t' with the type name, the container, the item size, its size and its old and new capacity).
+      Counters and callback are static variables (per translation unit, and not thread-safe). Without CV_ENABLE_ALLOC_STATS, no code is added.
+
+   C_VECTOR_VERSION_NUM 125
+   -> added CV_DEFINE_POD(CV_TYPE) and CV_DECLARE_AND_DEFINE_POD(CV_TYPE), to be used (instead of CV_DEFINE(CV_TYPE)
+      and CV_DECLARE_AND_DEFINE(CV_TYPE)) with trivially copyable types: the item_ctr, item_dtr and item_cpy code paths
+      are removed at compile time (these callbacks must be NULL), so that cv_xxx_push_back(...), cv_xxx_resize(...),
+      cv_xxx_insert_at(...), etc. just copy items (CV_DEFINE(CV_TYPE) is now CV_DEFINITION_CHUNK(CV_TYPE,0)).
+
+   C_VECTOR_VERSION_NUM 124
+   -> added the optional CV_DECLARE_CMP_INLINE(CV_TYPE), CV_DEFINE_CMP_INLINE(CV_TYPE) and CV_DECLARE_AND_DEFINE_CMP_INLINE(CV_TYPE) macros,
+      that must be used (after CV_DECLARE/CV_DEFINE) where the scoped definition CV_CMP_INLINE(a,b) is set. They generate
+      cv_xxx_binary_search_inline(...), cv_xxx_insert_sorted_inline(...) and cv_xxx_sort_inline(...), where the comparison is expanded inline
+      (no calls through the 'item_cmp' pointer), and the binary search is a branchless lower bound (with equal items it returns the first one).
+   -> the private sort helpers are now generated by CV_SORT_FUNCTIONS_CHUNK(...), that is shared by cv_xxx_sort(...) and cv_xxx_sort_inline(...).
+
+   C_VECTOR_VERSION_NUM 123
+   -> added 'cv_xxx_search_index': a read-only search accelerator built from a sorted vector with cv_xxx_search_index_init(index,v)
+      (and released with cv_xxx_search_index_free(index)). It keeps a copy of the items in Eytzinger (BFS) order, so that the first levels
+      of every search share the same few cache lines, and cv_xxx_search_index_find(index,item_to_search,match) walks it with a branchless loop
+      that prefetches the items four levels ahead (CV_PREFETCH(ADDR)). It returns the lower bound (the position of the first item
+      not less than 'item_to_search', computed from the Eytzinger index with no extra memory) and sets 'match' like cv_xxx_binary_search(...).
+      Without duplicates the position is the same, but on equal items cv_xxx_binary_search(...) can return any of them, while this returns the first one. Items are copied bitwise and are never constructed nor destructed,
+      so the index must be rebuilt (or freed) when the vector changes.
+
+   C_VECTOR_VERSION_NUM 122
+   -> added an optional parallel layer (it must be enabled by the global definition CV_ENABLE_PARALLEL, and it uses pthreads or Win32 threads):
+      cv_xxx_parallel_sort(v,num_threads), cv_xxx_parallel_for_each(v,fn,user_data,num_threads) and cv_xxx_parallel_cpy(a,b,num_threads).
+      'num_threads'<=0 means CV_PARALLEL_NUM_THREADS (or the number of online processors), and every thread gets at least
+      CV_PARALLEL_MIN_ITEMS_PER_THREAD items, so that the serial code (cv_xxx_sort(...), cv_xxx_cpy(...)) is used for small vectors.
+      cv_xxx_parallel_sort(...) sorts a chunk per thread and then merges the chunks in log2(num_threads) rounds, where every thread
+      writes the same amount of items. User callbacks ('fn', 'item_ctr' and 'item_cpy') must be thread-safe, while the allocator is used by the calling thread only.
+      There's no parallel serialization, because a 'cvh_serializer_t' is a single sequential stream.
+      These functions have no fake member functions.
+
+   C_VECTOR_VERSION_NUM 121
+   -> added cv_xxx_radix_sort_by_key(v,key_extractor) (and its fake member function): a stable LSD radix sort (8 bits per pass)
+      of the items by the unsigned integer key returned by 'key_extractor' (that is called once per item). 'item_cmp' is not used,
+      passes where all the items share the same digit are skipped (so small keys are fast), and the scratch buffer comes from the vector allocator.
+      Signed and floating point keys can be mapped to order-preserving unsigned keys with the global helpers
+      cv_radix_key_from_int(...), cv_radix_key_from_long_long(...), cv_radix_key_from_float(...) and cv_radix_key_from_double(...).
+
+   C_VECTOR_VERSION_NUM 120
+   -> added cv_xxx_sort(v) (and its fake member function), that sorts the vector in place using 'item_cmp'.
+      Unlike qsort(...), it's generated for every CV_TYPE, so items are moved and swapped with fixed-size copies
+      (that the compiler can inline), and it does not need CV_USE_VOID_PTRS_IN_CMP_FCT.
+      It's a pattern-defeating quicksort (introsort-like: it never degrades to O(N^2), because it switches to heap sort
+      after too many bad partitions, and it's linear on already sorted or reversed input). The sort is NOT stable.
+      Two new definitions tune it: CV_SORT_INSERTION_THRESHOLD and CV_SORT_NINTHER_THRESHOLD.
+
+   C_VECTOR_VERSION_NUM 119
+   -> added cv_xxx_insert_sorted_range(v,items_to_insert,num_items_to_insert,insert_even_if_item_match) (and its fake member function).
+      It inserts a batch of (unsorted) items into a sorted vector: the batch is sorted first (a stable merge sort of item pointers),
+      and then it's merged into the vector in a single backward pass, so that every old item is moved only once (inserting M items
+      one by one with cv_xxx_insert_sorted(...) moves O(N*M) items). It returns the number of inserted items.
+      When 'insert_even_if_item_match' is 0, only the first of equal new items is inserted, and only if it's not present in the vector.
+
+   C_VECTOR_VERSION_NUM 118
+   -> added zero-copy loading of POD vectors: cvh_mmap_open(...) maps a whole file in memory (copy-on-write), cvh_serializer_init_mapped(...)
+      makes a read-only deserializer of it, and cv_xxx_deserialize_mapped(...) makes 'v->v' point directly into the mapped file
+      when 'item_deserialize' is NULL (and the items are aligned inside the file). Otherwise it just calls cv_xxx_deserialize(...).
+      mmap(...) is used on unix-like systems only (unless CV_NO_MMAP is defined): otherwise cvh_mmap_open(...) just loads the whole file.
+
+   C_VECTOR_VERSION_NUM 117
+   -> added a streaming mode to 'cvh_serializer_t': cvh_serializer_init_sink(...) and cvh_serializer_init_source(...) take a write/read callback
+      and a stream pointer, and use a fixed buffer (CVH_SERIALIZER_STREAM_BUFFER_SIZE bytes by default) that is flushed to (or refilled from) the stream.
+      This way peak memory does not grow with the amount of serialized data. cvh_serializer_init_file_sink(...) and cvh_serializer_init_file_source(...)
+      wrap a FILE* (file descriptors can be used by passing wrappers of the POSIX write(...)/read(...) functions).
+   -> added cvh_serializer_flush(...), cvh_serializer_fill(...), cvh_serializer_write_bytes(...) and cvh_serializer_read_bytes(...).
+      cv_xxx_serialize(...)/cv_xxx_deserialize(...) and cvh_string_serialize(...)/cvh_string_deserialize(...) now use them, so they work in both modes.
+
+   C_VECTOR_VERSION_NUM 116
+   -> added the 'cvh_allocator_t' struct (alloc, realloc, free and a user_data pointer) and cv_xxx_init_with_allocator(...),
+      that stores an optional per-instance allocator in the 'cv_xxx::allocator' field. When it's NULL, CV_MALLOC/CV_REALLOC/CV_FREE are used as before.
+      cvh_allocator_t::realloc and cvh_allocator_t::free can be NULL: this way a bump arena just needs 'alloc', and all the
+      vectors allocated with it can be released in O(1) by resetting the arena (cv_xxx_free(...) can be skipped when 'item_dtr' is NULL).
+   -> cv_xxx_swap(...) and the c++ move ctr/assignment now swap/move the allocator together with the memory it owns.
+
    C_VECTOR_VERSION_NUM 115 rev3
    -> added the CV_SIZE_T_FORMATTING definition (internal usage).
 
@@ -281,6 +395,52 @@ freely, subject to the following restrictions:
 
 #include <string.h> /*memcpy,memmove,memset*/
 
+#if (!defined(CV_NO_MMAP) && !defined(CV_HAS_MMAP) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))))
+#   define CV_HAS_MMAP  /* internal usage */
+#endif
+#ifdef CV_HAS_MMAP
+#   include <sys/types.h>
+#   include <sys/stat.h>    /* fstat */
+#   include <sys/mman.h>    /* mmap, munmap */
+#   include <fcntl.h>       /* open */
+#   include <unistd.h>      /* close */
+#endif
+
+#ifndef CV_ALIGNOF   /* internal usage (zero-copy mapped vectors) */
+#   if (defined(__cplusplus) && __cplusplus>=201103L)
+#       define CV_ALIGNOF(T)    alignof(T)
+#   elif (defined(__STDC_VERSION__) && __STDC_VERSION__>=201112L)
+#       define CV_ALIGNOF(T)    _Alignof(T)
+#   elif defined(__GNUC__)
+#       define CV_ALIGNOF(T)    __alignof__(T)
+#   elif defined(_MSC_VER)
+#       define CV_ALIGNOF(T)    __alignof(T)
+#   else
+#       define CV_ALIGNOF(T)    (sizeof(T)&(~sizeof(T)+1))   /* the largest power of two that divides sizeof(T): a multiple of its alignment */
+#   endif
+#endif
+
+#ifndef CV_PREFETCH
+#   if (defined(__GNUC__) || defined(__clang__))
+#       define CV_PREFETCH(ADDR)   __builtin_prefetch((const void*)(ADDR))
+#   elif (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86)))
+#       include <xmmintrin.h>
+#       define CV_PREFETCH(ADDR)   _mm_prefetch((const char*)(ADDR),_MM_HINT_T0)
+#   else
+#       define CV_PREFETCH(ADDR)   /* no-op */
+#   endif
+#endif /* CV_PREFETCH */
+
+#ifndef CVH_SERIALIZER_STREAM_BUFFER_SIZE
+#   define CVH_SERIALIZER_STREAM_BUFFER_SIZE    (65536)
+#endif
+#ifndef CV_SORT_INSERTION_THRESHOLD
+#   define CV_SORT_INSERTION_THRESHOLD  (24)
+#endif
+#ifndef CV_SORT_NINTHER_THRESHOLD
+#   define CV_SORT_NINTHER_THRESHOLD    (128)
+#endif
+
 
 #ifndef CV_API_INL  /* __inline, _inline or inline (C99) */
 #define CV_API_INL __inline
@@ -349,6 +509,7 @@ freely, subject to the following restrictions:
 #define CV_TYPE_FCT(CV_TYPE,name) CV_CAT(CV_TYPE,name)
 #define CV_VECTOR_(name) CV_CAT(cv_,name)
 #define CV_VECTOR_TYPE(CV_TYPE) CV_VECTOR_(CV_TYPE)
+#define CV_SEARCH_INDEX_TYPE(CV_TYPE) CV_CAT(CV_VECTOR_TYPE(CV_TYPE),_search_index)
 #ifdef CV_USE_VOID_PTRS_IN_CMP_FCT
 #   define CV_CMP_TYPE(CV_TYPE) void
 #else
@@ -356,17 +517,134 @@ freely, subject to the following restrictions:
 #endif
 
 
+#ifndef CVH_ALLOCATOR_GUARD_
+#define CVH_ALLOCATOR_GUARD_
+/* cvh_allocator_t is an optional per-instance allocator (see cv_xxx_init_with_allocator(...)). 'old_size' is passed to 'realloc' (and must be copied) so that bump arenas can implement it */
+typedef struct cvh_allocator_t {
+    void* (*alloc)(void* user_data,size_t size);
+    void* (*realloc)(void* user_data,void* ptr,size_t new_size,size_t old_size); /* optional (can be NULL): alloc + memcpy + free is used instead */
+    void (*free)(void* user_data,void* ptr);                                     /* optional (can be NULL): e.g. for bump arenas that are released all at once */
+    void* user_data;
+    void* (*shrink)(void* user_data,void* ptr,size_t new_size,size_t old_size);  /* optional (can be NULL): in-place trimming used by shrink_to_fit (instead of a copy) */
+} cvh_allocator_t;
+#endif /* CVH_ALLOCATOR_GUARD_ */
+
+#ifndef CVH_GROWTH_POLICY_GUARD_
+#define CVH_GROWTH_POLICY_GUARD_
+/* cvh_growth_policy_t is an optional per-instance growth policy (see cv_xxx_set_growth_policy(...)), shared by all the containers of
+   "c_vector.h", "c_vector_type_unsafe.h" and "c_hashtable.h". When it's NULL, every container keeps its default growth (about 1.5x).
+   A policy can be shared by many containers, and it must outlive them */
+#define CVH_GROWTH_GEOMETRIC      0   /* capacity*factor_num/factor_den (e.g. 2/1 doubles the capacity) */
+#define CVH_GROWTH_FIXED_CHUNK    1   /* capacity plus 'chunk_bytes' (at least one item): linear growth and bounded unused memory, for very big containers */
+#define CVH_GROWTH_PAGE_ALIGNED   2   /* like CVH_GROWTH_GEOMETRIC, but the buffer size is rounded up to a multiple of 'chunk_bytes' (e.g. 4 KB pages or 2 MB huge pages) */
+typedef struct cvh_growth_policy_t {
+    int type;                       /* one of the CVH_GROWTH_xxx definitions */
+    size_t factor_num,factor_den;   /* CVH_GROWTH_GEOMETRIC and CVH_GROWTH_PAGE_ALIGNED only (when not factor_num>factor_den>0, 3/2 is used) */
+    size_t chunk_bytes;             /* CVH_GROWTH_FIXED_CHUNK and CVH_GROWTH_PAGE_ALIGNED only */
+} cvh_growth_policy_t;
+CV_API cvh_growth_policy_t cvh_growth_policy_geometric(size_t factor_num,size_t factor_den)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_GEOMETRIC;p.factor_num=factor_num;p.factor_den=factor_den;p.chunk_bytes=0;return p;
+}
+CV_API cvh_growth_policy_t cvh_growth_policy_fixed_chunk(size_t chunk_bytes)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_FIXED_CHUNK;p.factor_num=p.factor_den=0;p.chunk_bytes=chunk_bytes;return p;
+}
+CV_API cvh_growth_policy_t cvh_growth_policy_page_aligned(size_t factor_num,size_t factor_den,size_t page_bytes)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_PAGE_ALIGNED;p.factor_num=factor_num;p.factor_den=factor_den;p.chunk_bytes=page_bytes;return p;
+}
+/* it returns the new capacity (in items of 'item_size' bytes) of a container of 'capacity' items that needs at least 'min_capacity' items */
+CV_API size_t cvh_growth_policy_next_capacity(const cvh_growth_policy_t* p,size_t capacity,size_t min_capacity,size_t item_size)  {
+    size_t c;
+    if (min_capacity<=capacity) return capacity;
+    if (item_size==0) item_size=1;
+    if (p->type==CVH_GROWTH_FIXED_CHUNK) c = capacity+(p->chunk_bytes>item_size ? p->chunk_bytes/item_size : 1);
+    else if (p->factor_den>0 && p->factor_num>p->factor_den) c = capacity/p->factor_den*p->factor_num+(capacity%p->factor_den)*p->factor_num/p->factor_den;
+    else c = capacity+capacity/2;
+    if (c<min_capacity) c=min_capacity;
+    if (p->type==CVH_GROWTH_PAGE_ALIGNED && p->chunk_bytes>0) c = (c*item_size+p->chunk_bytes-1)/p->chunk_bytes*p->chunk_bytes/item_size;
+    return c;
+}
+#endif /* CVH_GROWTH_POLICY_GUARD_ */
+
+#ifndef CVH_ALLOC_STATS_GUARD_
+#define CVH_ALLOC_STATS_GUARD_
+#ifdef CV_ENABLE_ALLOC_STATS
+/* allocation and growth telemetry (CV_ENABLE_ALLOC_STATS only). Every container type has its own counters (see cv_xxx_get_alloc_stats(...),
+   cvector_get_alloc_stats(...), cvh_serializer_get_alloc_stats(...) and cvh_string_get_alloc_stats(...)), and every (re)allocation or release
+   is also reported to the optional callback set by cvh_set_alloc_callback(...).
+   Counters and callback are plain static variables (per translation unit, and not thread-safe) */
+typedef struct cvh_alloc_stats_t {
+    size_t num_allocs;              /* first allocations (from zero capacity) */
+    size_t num_reallocs;            /* growths of an existing buffer */
+    size_t num_frees;
+    size_t num_bytes_copied;        /* bytes of live items moved by the growths (an upper bound: realloc(...) may grow in place) */
+    size_t capacity_bytes;          /* currently allocated bytes */
+    size_t peak_capacity_bytes;     /* max value of 'capacity_bytes' */
+    size_t wasted_bytes;            /* unused capacity of the released buffers (sum of (capacity-size)*item_size) */
+} cvh_alloc_stats_t;
+/* 'new_capacity' is 0 when the buffer is released. Capacities are in items of 'item_size' bytes */
+typedef struct cvh_alloc_event_t {
+    const char* type_name;          /* e.g. "cv_int", "cvector", "cvh_serializer_t", "cvh_string_t" */
+    const void* container;
+    size_t item_size,size,old_capacity,new_capacity;
+} cvh_alloc_event_t;
+typedef void (*cvh_alloc_callback_t)(const cvh_alloc_event_t* event,void* user_data);
+typedef struct cvh_alloc_stats_state_t {
+    cvh_alloc_callback_t callback;
+    void* user_data;
+    cvh_alloc_stats_t serializer,string;
+} cvh_alloc_stats_state_t;
+CV_API cvh_alloc_stats_state_t* cvh_alloc_stats_state(void) {static cvh_alloc_stats_state_t s;return &s;}
+/* 'callback' can be NULL (the counters work anyway) */
+CV_API void cvh_set_alloc_callback(cvh_alloc_callback_t callback,void* user_data)  {
+    cvh_alloc_stats_state_t* st = cvh_alloc_stats_state();
+    st->callback = callback;st->user_data = user_data;
+}
+CV_API void cvh_alloc_stats_record(cvh_alloc_stats_t* s,const char* type_name,const void* container,size_t item_size,size_t size,size_t old_capacity,size_t new_capacity)  {
+    const cvh_alloc_stats_state_t* st = cvh_alloc_stats_state();
+    const size_t old_bytes = old_capacity*item_size, new_bytes = new_capacity*item_size;
+    if (new_capacity==0)    {
+        ++s->num_frees;
+        if (old_capacity>size) s->wasted_bytes+=(old_capacity-size)*item_size;
+    }
+    else if (old_capacity==0) ++s->num_allocs;
+    else {++s->num_reallocs;s->num_bytes_copied+=size*item_size;}
+    s->capacity_bytes = s->capacity_bytes+new_bytes>old_bytes ? s->capacity_bytes+new_bytes-old_bytes : 0;
+    if (s->peak_capacity_bytes<s->capacity_bytes) s->peak_capacity_bytes=s->capacity_bytes;
+    if (st->callback)   {
+        cvh_alloc_event_t e;
+        e.type_name=type_name;e.container=container;e.item_size=item_size;
+        e.size=size;e.old_capacity=old_capacity;e.new_capacity=new_capacity;
+        st->callback(&e,st->user_data);
+    }
+}
+CV_API void cvh_serializer_get_alloc_stats(cvh_alloc_stats_t* stats)   {*stats = cvh_alloc_stats_state()->serializer;}
+CV_API void cvh_serializer_reset_alloc_stats(void)  {const cvh_alloc_stats_t zero = {0,0,0,0,0,0,0};cvh_alloc_stats_state()->serializer = zero;}
+CV_API void cvh_string_get_alloc_stats(cvh_alloc_stats_t* stats)   {*stats = cvh_alloc_stats_state()->string;}
+CV_API void cvh_string_reset_alloc_stats(void)  {const cvh_alloc_stats_t zero = {0,0,0,0,0,0,0};cvh_alloc_stats_state()->string = zero;}
+#   define CVH_ALLOC_STATS_RECORD(STATS,TYPE_NAME,CONTAINER,ITEM_SIZE,SIZE,OLD_CAPACITY,NEW_CAPACITY) cvh_alloc_stats_record(STATS,TYPE_NAME,CONTAINER,ITEM_SIZE,SIZE,OLD_CAPACITY,NEW_CAPACITY)
+#else /* CV_ENABLE_ALLOC_STATS */
+#   define CVH_ALLOC_STATS_RECORD(STATS,TYPE_NAME,CONTAINER,ITEM_SIZE,SIZE,OLD_CAPACITY,NEW_CAPACITY) /*no-op*/
+#endif /* CV_ENABLE_ALLOC_STATS */
+#endif /* CVH_ALLOC_STATS_GUARD_ */
+
 #ifndef CVH_SRIALIZER_GUARD_
 /* cvh_serializer_t provides serialization/deserialization support for all the vector macros that follow */
 typedef struct cvh_serializer_t {
     unsigned char* v;
     size_t size,capacity;
     /* mutable */ size_t offset;  /* used as read-pointer in deserialization. 'mutable' is not available in plain C (and it's better not to use 'ifdef __cplusplus' here) */
+    /* streaming mode (optional, see cvh_serializer_init_sink(...) and cvh_serializer_init_source(...)): 'v' is a fixed-size buffer that is flushed to (or refilled from) 'stream' */
+    size_t (*stream_write)(void* stream,const void* data,size_t num_bytes);  /* NULL if it's not a sink. It must return the number of bytes written */
+    size_t (*stream_read)(void* stream,void* data,size_t num_bytes);         /* NULL if it's not a source. It must return the number of bytes read (0 at the end of the stream) */
+    void* stream;       /* a 'cvh_mmap_t*' when both 'stream_write' and 'stream_read' are NULL (see cvh_serializer_init_mapped(...)): 'v' is not owned in this case */
+    int stream_error;   /* set when 'stream_write' or 'stream_read' fail (or when the stream ends too early) */
+    const cvh_growth_policy_t* growth_policy;   /* optional (can be NULL): see cvh_serializer_set_growth_policy(...) */
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
     void (*const reserve)(struct cvh_serializer_t* p,size_t new_capacity);
     void (*const free)(struct cvh_serializer_t* p);
     void (*const cpy)(struct cvh_serializer_t* dst,const struct cvh_serializer_t* src);
     void (*const clear)(struct cvh_serializer_t* p);
+    int (*const flush)(struct cvh_serializer_t* s);
     int (*const save)(const struct cvh_serializer_t* p,const char* path);
     int (*const load)(struct cvh_serializer_t* p,const char* path);
     void (*const offset_rewind)(const struct cvh_serializer_t* d);
@@ -404,6 +682,8 @@ typedef struct cvh_serializer_t {
     int (*const read_string)(const struct cvh_serializer_t* d,char** pstr,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/);
     void (*const write_blob)(struct cvh_serializer_t* s,const void* blob,size_t blob_size_in_bytes);
     int (*const read_blob)(const struct cvh_serializer_t* d,void** pblob,size_t* blob_size_out,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/);
+    void (*const write_bytes)(struct cvh_serializer_t* s,const void* data,size_t num_bytes);
+    int (*const read_bytes)(const struct cvh_serializer_t* d,void* data,size_t num_bytes);
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 #   ifdef __cplusplus
     CV_API_INL cvh_serializer_t();
@@ -416,6 +696,14 @@ typedef struct cvh_serializer_t {
 #       endif /* CV_HAS_MOVE_SEMANTICS */
 #   endif /*__cplusplus*/
 } cvh_serializer_t;
+/* cvh_mmap_t maps a whole file in memory (copy-on-write), so that POD vectors can point directly into it (see cvh_serializer_init_mapped(...)).
+   It must not be moved or copied after cvh_mmap_open(...), and it must outlive the vectors that use its 'allocator' */
+typedef struct cvh_mmap_t {
+    unsigned char* v;   /* the file content: it can be modified in memory, but changes are never written back to the file */
+    size_t size;
+    cvh_allocator_t allocator;  /* memory inside 'v' is never released by it (and it's copied to the heap when a vector must grow) */
+    int is_mapped;      /* 0 if mmap(...) is not available: in this case the file is just loaded in 'v' */
+} cvh_mmap_t;
 #endif /* CVH_SRIALIZER_GUARD_ */
 
 #ifdef __cplusplus
@@ -460,6 +748,9 @@ typedef struct cvh_serializer_t {
     size_t (* const insert_range_at)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* items_to_insert,size_t num_items_to_insert,size_t start_position);    \
     size_t (* const insert_sorted)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_insert,int* match,int insert_even_if_item_match);   \
     size_t (* const insert_sorted_by_val)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE item_to_insert,int* match,int insert_even_if_item_match); \
+    size_t (* const insert_sorted_range)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* items_to_insert,size_t num_items_to_insert,int insert_even_if_item_match);    \
+    void (* const sort)(CV_VECTOR_TYPE(CV_TYPE)* v); \
+    void (* const radix_sort_by_key)(CV_VECTOR_TYPE(CV_TYPE)* v,unsigned long long (*key_extractor)(const CV_TYPE*)); \
     int (* const remove_at)(CV_VECTOR_TYPE(CV_TYPE)* v,size_t position); \
     int (* const remove_range_at)(CV_VECTOR_TYPE(CV_TYPE)* v,size_t start_item_position,size_t num_items_to_remove); \
     void (* const cpy)(CV_VECTOR_TYPE(CV_TYPE)* a,const CV_VECTOR_TYPE(CV_TYPE)* b);  \
@@ -483,6 +774,8 @@ struct CV_VECTOR_TYPE(CV_TYPE) {         \
     int (*const item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*);		/* optional (can be NULL) (for sorted vectors only) */  \
     void (*const item_serialize)(const CV_TYPE*,cvh_serializer_t*);   \
     int (*const item_deserialize)(CV_TYPE*,const cvh_serializer_t*);   \
+    const cvh_allocator_t* const allocator;     /* optional (can be NULL) */    \
+    const cvh_growth_policy_t* const growth_policy;     /* optional (can be NULL) */    \
     CV_FAKE_MEMBER_FUNCTIONS_DECL_CHUNK(CV_TYPE)    \
     CV_CPP_DECLARATION_CHUNK0(CV_TYPE)  \
     CV_CPP_DECLARATION_CHUNK1(CV_TYPE)  \
@@ -507,6 +800,9 @@ CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_at_by_val)(CV_VECTOR_TYPE(C
 CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* items_to_insert,size_t num_items_to_insert,size_t start_position);  \
 CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_insert,int* match,int insert_even_if_item_match); \
 CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_by_val)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE item_to_insert,int* match,int insert_even_if_item_match);   \
+CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_range)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* items_to_insert,size_t num_items_to_insert,int insert_even_if_item_match);  \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_sort)(CV_VECTOR_TYPE(CV_TYPE)* v);   \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_radix_sort_by_key)(CV_VECTOR_TYPE(CV_TYPE)* v,unsigned long long (*key_extractor)(const CV_TYPE*));   \
 CV_API_DEC int CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_at)(CV_VECTOR_TYPE(CV_TYPE)* v,size_t position);   \
 CV_API_DEC int CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_range_at)(CV_VECTOR_TYPE(CV_TYPE)* v,size_t start_item_position,size_t num_items_to_remove);   \
 CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy)(CV_VECTOR_TYPE(CV_TYPE)* a,const CV_VECTOR_TYPE(CV_TYPE)* b);    \
@@ -514,10 +810,25 @@ CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_shrink_to_fit)(CV_VECTOR_TYPE(CV_TYP
 CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_dbg_check)(const CV_VECTOR_TYPE(CV_TYPE)* v);    \
 CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_serialize)(const CV_VECTOR_TYPE(CV_TYPE)* v,cvh_serializer_t* serializer);    \
 CV_API_DEC int CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize)(CV_VECTOR_TYPE(CV_TYPE)* v,const cvh_serializer_t* deserializer);    \
+CV_API_DEC int CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize_mapped)(CV_VECTOR_TYPE(CV_TYPE)* v,const cvh_serializer_t* deserializer);    \
 CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*),void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*)); \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with_allocator)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*),void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*),const cvh_allocator_t* allocator); \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_set_growth_policy)(CV_VECTOR_TYPE(CV_TYPE)* v,const cvh_growth_policy_t* policy); \
 CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_init)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*)); \
 CV_API_DEC CV_VECTOR_TYPE(CV_TYPE) CV_VECTOR_TYPE_FCT(CV_TYPE,_create_with)(int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*),void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*));   \
-CV_API_DEC CV_VECTOR_TYPE(CV_TYPE) CV_VECTOR_TYPE_FCT(CV_TYPE,_create)(int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*));
+CV_API_DEC CV_VECTOR_TYPE(CV_TYPE) CV_VECTOR_TYPE_FCT(CV_TYPE,_create)(int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*)); \
+/* read-only search accelerator of a sorted vector (its fields must not be modified) */  \
+typedef struct CV_SEARCH_INDEX_TYPE(CV_TYPE) {  \
+    CV_TYPE* items;         /* 'size+1' items in Eytzinger order ('items[0]' is not used) */  \
+    size_t size;    \
+    int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*);    \
+    const cvh_allocator_t* allocator;   \
+} CV_SEARCH_INDEX_TYPE(CV_TYPE);  \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_search_index_init)(CV_SEARCH_INDEX_TYPE(CV_TYPE)* index,const CV_VECTOR_TYPE(CV_TYPE)* v);   \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_search_index_free)(CV_SEARCH_INDEX_TYPE(CV_TYPE)* index);   \
+CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_search_index_find)(const CV_SEARCH_INDEX_TYPE(CV_TYPE)* index,const CV_TYPE* item_to_search,int* match);   \
+CV_PARALLEL_DECLARATION_CHUNK(CV_TYPE)  \
+CV_ALLOC_STATS_DECLARATION_CHUNK(CV_TYPE)
 
 
 /*  To use memcpy_s, memmove_s and memset_s, in your source file(s), please add this line before including this header:
@@ -572,6 +883,52 @@ CV_API void* cv_safe_realloc(void** const ptr, size_t new_size)  {
     }
     return ptr2;
 }
+/* per-instance allocator helpers (a NULL allocator falls back to the functions above) */
+CV_API void* cv_malloc_with(const cvh_allocator_t* a,size_t size) {
+    void* p;
+    if (!a) return cv_malloc(size);
+    CV_ASSERT(a->alloc);
+    p = a->alloc(a->user_data,size);
+    if (!p)	{
+        CV_ASSERT(0);	/* No more memory error */
+#       ifndef CV_NO_STDIO
+        fprintf(stderr,"CV_ERROR: cv_malloc_with(...) failed. Not enough memory.\n");
+#       endif
+#       ifndef CV_NO_STDLIB
+        exit(1);
+#       endif
+    }
+    return p;
+}
+CV_API void cv_free_with(const cvh_allocator_t* a,void* p) {
+    if (!a) cv_free(p);
+    else if (a->free && p) a->free(a->user_data,p);
+}
+CV_API void* cv_safe_realloc_with(const cvh_allocator_t* a,void** const ptr,size_t new_size,size_t old_size)  {
+    void *ptr2;
+    if (!a) return cv_safe_realloc(ptr,new_size);
+    CV_ASSERT(new_size!=0);    /* undefined behaviour */
+    if (a->realloc) ptr2 = a->realloc(a->user_data,*ptr,new_size,old_size);
+    else {
+        CV_ASSERT(a->alloc);
+        ptr2 = a->alloc(a->user_data,new_size);
+        if (ptr2 && *ptr) {CV_MEMCPY(ptr2,*ptr,old_size<new_size ? old_size : new_size);}
+        if (ptr2 && *ptr && a->free) a->free(a->user_data,*ptr);
+    }
+    if (ptr2) *ptr=ptr2;
+    else {
+        if (a->free && *ptr) a->free(a->user_data,*ptr);
+        *ptr=NULL;
+        CV_ASSERT(0);	/* No more memory error */
+#       ifndef CV_NO_STDIO
+        fprintf(stderr,"CV_ERROR: cv_safe_realloc_with(...) failed. Not enough memory.\n");
+#       endif
+#       ifndef CV_NO_STDLIB
+        exit(1);
+#       endif
+    }
+    return ptr2;
+}
 CV_API void cv_convert_bytes(size_t bytes_in,size_t pTGMKB[5])   {
     size_t i;pTGMKB[4] = bytes_in;
     for (i=0;i<4;i++)  {pTGMKB[3-i]=pTGMKB[4-i]/1024;pTGMKB[4-i]%=1024;}
@@ -593,14 +950,91 @@ CV_API void cv_display_bytes(size_t bytes_in)   {
 
 /* cvh_serializer_t functions */
 #ifndef CVH_SRIALIZER_GUARD_
+CV_API int cvh_serializer_flush(cvh_serializer_t* s)    {
+    /* sink mode: it writes all the buffered bytes to the stream (it's a no-op otherwise). It returns 0 if some write failed */
+    CV_ASSERT(s);
+    if (s->stream_write && s->size>0)   {
+        if (s->stream_write(s->stream,s->v,s->size)!=s->size) s->stream_error=1;
+        s->size=0;
+    }
+    return s->stream_error ? 0 : 1;
+}
+CV_API int cvh_serializer_fill(const cvh_serializer_t* d,size_t num_bytes)    {
+    /* it returns 1 if at least 'num_bytes' unread bytes are available at '&d->v[d->offset]'.
+       In source mode, it refills the buffer from the stream first (and it grows the buffer only when 'num_bytes' exceeds its capacity) */
+    cvh_serializer_t* s = (cvh_serializer_t*) d;  /* the buffer is 'mutable' in source mode, like 'offset' */
+    CV_ASSERT(d);
+    if (s->offset+num_bytes<=s->size) return 1;
+    if (!s->stream_read || s->stream_error) return 0;
+    if (s->offset>0)    {
+        s->size-=s->offset;
+        if (s->size>0) CV_MEMMOVE(s->v,&s->v[s->offset],s->size);
+        s->offset=0;
+    }
+    if (num_bytes>s->capacity)  {CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",s,1,s->size,s->capacity,num_bytes);cv_safe_realloc((void**)&s->v,num_bytes);CV_ASSERT(s->v);s->capacity=num_bytes;}
+    while (s->size<num_bytes)   {
+        const size_t n = s->stream_read(s->stream,&s->v[s->size],s->capacity-s->size);
+        if (n==0) {s->stream_error=1;return 0;}
+        s->size+=n;
+    }
+    return 1;
+}
 CV_API void cvh_serializer_reserve(cvh_serializer_t* p,size_t new_capacity)    {
     if (new_capacity>p->capacity) {
-        new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        if (p->stream_write)    {
+            /* sink mode: 'new_capacity' is 'p->size' plus the number of bytes we're going to write: we flush the buffer first */
+            new_capacity-=p->size;
+            cvh_serializer_flush(p);
+            if (new_capacity<=p->capacity) return;
+        }
+        CV_ASSERT(p->stream_write || p->stream_read || !p->stream);    /* a mapped serializer (see cvh_serializer_init_mapped(...)) is read-only */
+        if (p->growth_policy) new_capacity = cvh_growth_policy_next_capacity(p->growth_policy,p->capacity,new_capacity,1);
+        else new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,p->size,p->capacity,new_capacity);
         cv_safe_realloc((void**)&p->v,new_capacity);CV_ASSERT(p->v);
         p->capacity = new_capacity;
     }
 }
-CV_API void cvh_serializer_free(cvh_serializer_t* p)    {cv_free(p->v);p->v=NULL;p->size=p->capacity=p->offset=0;}
+CV_API void cvh_serializer_write_bytes(cvh_serializer_t* s,const void* data,size_t num_bytes)    {
+    /* it appends 'num_bytes' raw bytes. In sink mode, chunks bigger than the buffer are written directly to the stream */
+    CV_ASSERT(s && (data || num_bytes==0));
+    if (s->stream_write && s->size+num_bytes>s->capacity)   {
+        cvh_serializer_flush(s);
+        if (num_bytes>=s->capacity) {if (s->stream_write(s->stream,data,num_bytes)!=num_bytes) s->stream_error=1;return;}
+    }
+    cvh_serializer_reserve(s,s->size+num_bytes);
+    if (num_bytes>0) {CV_MEMCPY(&s->v[s->size],data,num_bytes);s->size+=num_bytes;}
+}
+CV_API int cvh_serializer_read_bytes(const cvh_serializer_t* d,void* data,size_t num_bytes)    {
+    /* it reads 'num_bytes' raw bytes. In source mode, chunks bigger than the buffer are read directly from the stream */
+    cvh_serializer_t* s = (cvh_serializer_t*) d;
+    int check;
+    CV_ASSERT(d && (data || num_bytes==0));
+    if (s->stream_read && !s->stream_error && s->offset+num_bytes>s->size && num_bytes>s->capacity)   {
+        size_t n = s->size-s->offset;
+        if (n>0) CV_MEMCPY(data,&s->v[s->offset],n);
+        s->offset=s->size=0;
+        while (n<num_bytes) {
+            const size_t m = s->stream_read(s->stream,(unsigned char*)data+n,num_bytes-n);
+            if (m==0) {s->stream_error=1;break;}
+            n+=m;
+        }
+        check = n==num_bytes;CV_ASSERT(check);return check;
+    }
+    check = cvh_serializer_fill(d,num_bytes);CV_ASSERT(check);if (!check) return 0;
+    if (num_bytes>0) {CV_MEMCPY(data,&s->v[s->offset],num_bytes);s->offset+=num_bytes;}
+    return 1;
+}
+CV_API void cvh_serializer_free(cvh_serializer_t* p)    {
+    /* in sink mode, it flushes the buffer first (but please call cvh_serializer_flush(...) to check for errors). The serializer returns to memory mode */
+    cvh_serializer_flush(p);
+    if (p->v && (!p->stream || p->stream_write || p->stream_read))  {   /* a mapped serializer does not own 'v' */
+        CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,p->size,p->capacity,0);
+        cv_free(p->v);
+    }
+    p->v=NULL;p->size=p->capacity=p->offset=0;
+    p->stream_write=NULL;p->stream_read=NULL;p->stream=NULL;p->stream_error=0;
+}
 CV_API void cvh_serializer_cpy(cvh_serializer_t* dst,const cvh_serializer_t* src)   {
     CV_ASSERT(src && dst);
     if (dst->capacity<src->size) cvh_serializer_reserve(dst,src->size);
@@ -638,7 +1072,7 @@ CV_API void cvh_serializer_offset_set(const cvh_serializer_t* d,size_t offset)
 CV_API void cvh_serializer_offset_advance(const cvh_serializer_t* d,size_t amount)  {CV_ASSERT(d->offset+amount<=d->size);*((size_t*)&d->offset)+=amount;}
 #   define CVH_SERIALIZER_WRITE(S,type,value)   {cvh_serializer_reserve(S,S->size + sizeof(type));*((type*) (&S->v[S->size])) = value;S->size+=sizeof(type);}
 #   define CVH_DESERIALIZER_READ(D,type,value_ptr)   { \
-       int check = (D->offset+sizeof(type)<=D->size);CV_ASSERT(check);if (!check) return 0; \
+       int check = (D->offset+sizeof(type)<=D->size || cvh_serializer_fill(D,sizeof(type)));CV_ASSERT(check);if (!check) return 0; \
        *value_ptr = *((type*) &D->v[D->offset]);*((size_t*) &D->offset)+=sizeof(type); return 1;}
 CV_API void cvh_serializer_write_size_t(cvh_serializer_t* s,size_t value) {CVH_SERIALIZER_WRITE(s,size_t,value)}
 CV_API int cvh_serializer_read_size_t(const cvh_serializer_t* d,size_t* value) {CVH_DESERIALIZER_READ(d,size_t,value)}
@@ -689,16 +1123,15 @@ CV_API void cvh_serializer_write_string(cvh_serializer_t* s,const char* str_beg,
         const size_t str_len = str_end ? (size_t)(str_end-str_beg) : strlen(str_beg);
         const size_t str_len_plus_trailing_zero = str_len+1;
         cvh_serializer_write_size_t_using_mipmaps(s,str_len_plus_trailing_zero);
-        cvh_serializer_reserve(s,s->size + str_len_plus_trailing_zero);
-        CV_MEMCPY(&s->v[s->size],str_beg,str_len);s->v[s->size+str_len]='\0';
-        s->size+=str_len_plus_trailing_zero;
+        cvh_serializer_write_bytes(s,str_beg,str_len);
+        cvh_serializer_write_unsigned_char(s,'\0');
     }
 }
 CV_API int cvh_serializer_read_string(const cvh_serializer_t* d,char** pstr,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/)    {
     int check=0;size_t str_len_plus_one = 0;
     CV_ASSERT(d && pstr);
     if (!cvh_serializer_read_size_t_using_mipmaps(d,&str_len_plus_one)) return 0;
-    check=d->offset+str_len_plus_one<=d->size;CV_ASSERT(check);if (!check) return 0;
+    check=cvh_serializer_fill(d,str_len_plus_one);CV_ASSERT(check);if (!check) return 0;
     if (str_len_plus_one==0)    {if (*pstr) {if (my_free) my_free(*pstr);else CV_FREE(*pstr);} return 1;}
     check = d->v[d->offset+str_len_plus_one-1]=='\0';CV_ASSERT(check); /* additional check (should we return 0?) */
     if (!(*pstr) || strlen(*pstr)<str_len_plus_one-1) {
@@ -713,20 +1146,19 @@ CV_API void cvh_serializer_write_blob(cvh_serializer_t* s,const void* blob,size_
     if (!blob || blob_size_in_bytes==0) cvh_serializer_write_size_t_using_mipmaps(s,0);   /* we want to preserve NULL blobs */
     else {
         cvh_serializer_write_size_t_using_mipmaps(s,blob_size_in_bytes);
-        cvh_serializer_reserve(s,s->size + blob_size_in_bytes);
-        CV_MEMCPY(&s->v[s->size],blob,blob_size_in_bytes);s->size+=blob_size_in_bytes;
+        cvh_serializer_write_bytes(s,blob,blob_size_in_bytes);
     }
 }
 CV_API int cvh_serializer_read_blob(const cvh_serializer_t* d,void** pblob,size_t* blob_size_out,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/)    {
     int check=0;size_t blob_size = 0;if (blob_size_out) *blob_size_out=0;
     CV_ASSERT(d && pblob);
     if (!cvh_serializer_read_size_t_using_mipmaps(d,&blob_size)) return 0;
-    check=d->offset+blob_size<=d->size;CV_ASSERT(check);if (!check) return 0;
+    check=d->stream_read || d->offset+blob_size<=d->size;CV_ASSERT(check);if (!check) return 0;
     if (blob_size==0)    {if (*pblob) {if (my_free) my_free(*pblob);else CV_FREE(*pblob);} return 1;}
     if (my_realloc) *pblob=(char*)my_realloc(*pblob,blob_size);
     else            *pblob=(char*)CV_REALLOC(*pblob,blob_size);
     CV_ASSERT(*pblob);
-    CV_MEMCPY(*pblob,&d->v[d->offset],blob_size);*((size_t*)&d->offset)+=blob_size;
+    if (!cvh_serializer_read_bytes(d,*pblob,blob_size)) return 0;
     if (blob_size_out) *blob_size_out=blob_size;
     return 1;
 }
@@ -737,6 +1169,7 @@ CV_API void cvh_serializer_init(cvh_serializer_t* p)    {
     {typedef void (*fnctype)(cvh_serializer_t*);            *((fnctype*)&p->free)=&cvh_serializer_free;}    \
     {typedef void (*fnctype)(cvh_serializer_t*,const cvh_serializer_t*);            *((fnctype*)&p->cpy)=&cvh_serializer_cpy;}    \
     {typedef void (*fnctype)(cvh_serializer_t*);            *((fnctype*)&p->clear)=&cvh_serializer_clear;}    \
+    {typedef int (*fnctype)(cvh_serializer_t*);             *((fnctype*)&p->flush)=&cvh_serializer_flush;}    \
     {typedef int (*fnctype)(const cvh_serializer_t*,const char*);  *((fnctype*)&p->save)=&cvh_serializer_save;} \
     {typedef int (*fnctype)(cvh_serializer_t*,const char*);  *((fnctype*)&p->load)=&cvh_serializer_load;}   \
     {typedef void (*fnctype)(const cvh_serializer_t*);  *((fnctype*)&p->offset_rewind)=&cvh_serializer_offset_rewind;}  \
@@ -773,14 +1206,109 @@ CV_API void cvh_serializer_init(cvh_serializer_t* p)    {
     {typedef void (*fnctype)(cvh_serializer_t*,const char*,const char*);  *((fnctype*)&p->write_string)=&cvh_serializer_write_string;}  \
     {typedef int (*fnctype)(const cvh_serializer_t*,char**,void* (*)(void*,size_t),void (*)(void*));  *((fnctype*)&p->read_string)=&cvh_serializer_read_string;}    \
     {typedef void (*fnctype)(cvh_serializer_t*,const void*,size_t);  *((fnctype*)&p->write_blob)=&cvh_serializer_write_blob;}   \
-    {typedef int (*fnctype)(const cvh_serializer_t*,void**,size_t*,void* (*)(void*,size_t),void (*)(void*));  *((fnctype*)&p->read_blob)=&cvh_serializer_read_blob;}
+    {typedef int (*fnctype)(const cvh_serializer_t*,void**,size_t*,void* (*)(void*,size_t),void (*)(void*));  *((fnctype*)&p->read_blob)=&cvh_serializer_read_blob;}  \
+    {typedef void (*fnctype)(cvh_serializer_t*,const void*,size_t);  *((fnctype*)&p->write_bytes)=&cvh_serializer_write_bytes;}   \
+    {typedef int (*fnctype)(const cvh_serializer_t*,void*,size_t);  *((fnctype*)&p->read_bytes)=&cvh_serializer_read_bytes;}
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 }
 CV_API cvh_serializer_t cvh_serializer_create(void) {cvh_serializer_t p;cvh_serializer_init(&p);return p;}
+/* 'policy' (optional: it can be NULL, and it must outlive 'p') replaces the default 3/2 growth factor. cvh_serializer_init(...) resets it */
+CV_API void cvh_serializer_set_growth_policy(cvh_serializer_t* p,const cvh_growth_policy_t* policy)  {p->growth_policy=policy;}
+/* Streaming mode: the serializer uses a fixed buffer of 'buffer_size' bytes (CVH_SERIALIZER_STREAM_BUFFER_SIZE when zero),
+   so that peak memory does not depend on the amount of serialized data:
+   -> a sink writes the buffer to 'stream' (using 'stream_write') every time it's full: call cvh_serializer_flush(...) at the end (it returns 0 on errors)
+   -> a source refills the buffer from 'stream' (using 'stream_read') while the data is deserialized
+   'offset' is relative to the buffer (so cvh_serializer_offset_xxx(...), cvh_serializer_cpy(...), cvh_serializer_save(...) and cvh_serializer_load(...) are for memory mode only).
+   With file descriptors, just pass wrappers of the POSIX write(...) and read(...) functions.
+   cvh_serializer_free(...) must be called as usual */
+CV_API void cvh_serializer_init_sink(cvh_serializer_t* p,size_t (*stream_write)(void* stream,const void* data,size_t num_bytes),void* stream,size_t buffer_size)    {
+    CV_ASSERT(p && stream_write);
+    cvh_serializer_init(p);
+    p->stream_write=stream_write;p->stream=stream;
+    p->capacity = buffer_size>0 ? buffer_size : CVH_SERIALIZER_STREAM_BUFFER_SIZE;
+    p->v = (unsigned char*) cv_malloc(p->capacity);
+    CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,0,0,p->capacity);
+}
+CV_API void cvh_serializer_init_source(cvh_serializer_t* p,size_t (*stream_read)(void* stream,void* data,size_t num_bytes),void* stream,size_t buffer_size)    {
+    CV_ASSERT(p && stream_read);
+    cvh_serializer_init(p);
+    p->stream_read=stream_read;p->stream=stream;
+    p->capacity = buffer_size>0 ? buffer_size : CVH_SERIALIZER_STREAM_BUFFER_SIZE;
+    p->v = (unsigned char*) cv_malloc(p->capacity);
+    CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,0,0,p->capacity);
+}
+#   ifndef CV_NO_STDIO
+CV_API size_t cvh_serializer_fwrite(void* f,const void* data,size_t num_bytes)   {return fwrite(data,1,num_bytes,(FILE*)f);}
+CV_API size_t cvh_serializer_fread(void* f,void* data,size_t num_bytes)   {return fread(data,1,num_bytes,(FILE*)f);}
+CV_API void cvh_serializer_init_file_sink(cvh_serializer_t* p,FILE* f,size_t buffer_size)   {cvh_serializer_init_sink(p,&cvh_serializer_fwrite,f,buffer_size);}
+CV_API void cvh_serializer_init_file_source(cvh_serializer_t* p,FILE* f,size_t buffer_size)   {cvh_serializer_init_source(p,&cvh_serializer_fread,f,buffer_size);}
+#   endif /* CV_NO_STDIO */
+CV_API void* cvh_mmap_allocator_alloc(void* user_data,size_t size)    {(void)user_data;return CV_MALLOC(size);}
+CV_API void cvh_mmap_allocator_free(void* user_data,void* ptr)    {
+    const cvh_mmap_t* m = (const cvh_mmap_t*) user_data;
+    if (m->v && (unsigned char*)ptr>=m->v && (unsigned char*)ptr<m->v+m->size) return; /* it points into the mapped file */
+    CV_FREE(ptr);
+}
+/* It maps the file at 'path' (copy-on-write). It returns 0 on failure. cvh_mmap_close(...) must be called at the end */
+CV_API int cvh_mmap_open(cvh_mmap_t* m,const char* path)    {
+    CV_ASSERT(m && path);
+    CV_MEMSET(m,0,sizeof(*m));
+    m->allocator.alloc=&cvh_mmap_allocator_alloc;m->allocator.free=&cvh_mmap_allocator_free;m->allocator.user_data=m;
+#   ifdef CV_HAS_MMAP
+    {
+        struct stat st;void* p;
+        const int fd = open(path,O_RDONLY);
+        if (fd<0) return 0;
+        if (fstat(fd,&st)!=0) {close(fd);return 0;}
+        if (st.st_size>0) {
+            p = mmap(NULL,(size_t)st.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);  /* pages are loaded lazily, and copied only when written */
+            if (p==MAP_FAILED) {close(fd);return 0;}
+            m->v=(unsigned char*)p;m->size=(size_t)st.st_size;m->is_mapped=1;
+        }
+        close(fd);  /* the mapping stays valid */
+        return 1;
+    }
+#   elif !defined(CV_NO_STDIO)
+    {
+        FILE* f=fopen(path,"rb");long file_size;
+        if (!f) return 0;
+        fseek(f,0,SEEK_END);file_size=ftell(f);fseek(f,0,SEEK_SET);
+        if (file_size>0) {
+            m->v=(unsigned char*)cv_malloc((size_t)file_size);
+            if (fread(m->v,(size_t)file_size,1,f)!=1) {cv_free(m->v);m->v=NULL;fclose(f);return 0;}
+            m->size=(size_t)file_size;
+        }
+        fclose(f);
+        return 1;
+    }
+#   else
+    CV_ASSERT(0 && "Cannot load files with the CV_NO_STDIO definition enabled");
+    return 0;
+#   endif
+}
+CV_API void cvh_mmap_close(cvh_mmap_t* m)    {
+    CV_ASSERT(m);
+    if (m->v)   {
+#       ifdef CV_HAS_MMAP
+        if (m->is_mapped) munmap(m->v,m->size);
+        else
+#       endif
+        cv_free(m->v);
+    }
+    m->v=NULL;m->size=0;m->is_mapped=0;
+}
+/* It makes 'd' a read-only deserializer of the mapped file: cv_xxx_deserialize_mapped(...) can then make POD vectors point directly into it (zero-copy).
+   All the other deserialization functions work as usual (but they copy data). cvh_serializer_free(...) does not unmap the file */
+CV_API void cvh_serializer_init_mapped(cvh_serializer_t* d,const cvh_mmap_t* m)    {
+    CV_ASSERT(d && m);
+    cvh_serializer_init(d);
+    d->v=m->v;d->size=d->capacity=m->size;
+    d->stream=(void*)m;
+}
 #   ifdef __cplusplus
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
 #       define CV_SERIALIZER_MF_CHUNK0  \
-                ,reserve(&cvh_serializer_reserve),free(&cvh_serializer_free),cpy(&cvh_serializer_cpy),clear(&cvh_serializer_clear),save(&cvh_serializer_save),load(&cvh_serializer_load)   \
+                ,reserve(&cvh_serializer_reserve),free(&cvh_serializer_free),cpy(&cvh_serializer_cpy),clear(&cvh_serializer_clear),flush(&cvh_serializer_flush),save(&cvh_serializer_save),load(&cvh_serializer_load)   \
                 ,offset_rewind(&cvh_serializer_offset_rewind),offset_set(&cvh_serializer_offset_set),offset_advance(&cvh_serializer_offset_advance),write_size_t(&cvh_serializer_write_size_t),read_size_t(&cvh_serializer_read_size_t) \
                 ,write_unsigned_char(&cvh_serializer_write_unsigned_char),read_unsigned_char(&cvh_serializer_read_unsigned_char),write_signed_char(&cvh_serializer_write_signed_char),read_signed_char(&cvh_serializer_read_signed_char) \
                 ,write_unsigned_short(&cvh_serializer_write_unsigned_short),read_unsigned_short(&cvh_serializer_read_unsigned_short),write_short(&cvh_serializer_write_short),read_short(&cvh_serializer_read_short) \
@@ -790,22 +1318,25 @@ CV_API cvh_serializer_t cvh_serializer_create(void) {cvh_serializer_t p;cvh_seri
                 ,write_long_long(&cvh_serializer_write_long_long),read_long_long(&cvh_serializer_read_long_long) \
                 ,write_float(&cvh_serializer_write_float),read_float(&cvh_serializer_read_float),write_double(&cvh_serializer_write_double),read_double(&cvh_serializer_read_double) \
                 ,write_size_t_using_mipmaps(&cvh_serializer_write_size_t_using_mipmaps),read_size_t_using_mipmaps(&cvh_serializer_read_size_t_using_mipmaps) \
-                ,write_string(&cvh_serializer_write_string),read_string(&cvh_serializer_read_string),write_blob(&cvh_serializer_write_blob),read_blob(&cvh_serializer_read_blob)
+                ,write_string(&cvh_serializer_write_string),read_string(&cvh_serializer_read_string),write_blob(&cvh_serializer_write_blob),read_blob(&cvh_serializer_read_blob) \
+                ,write_bytes(&cvh_serializer_write_bytes),read_bytes(&cvh_serializer_read_bytes)
 #   else    /*CV_DISABLE_FAKE_MEMBER_FUNCTIONS*/
 #       define CV_SERIALIZER_MF_CHUNK0  /* no-op */
 #   endif   /*CV_DISABLE_FAKE_MEMBER_FUNCTIONS*/
-    CV_API_INL cvh_serializer_t::cvh_serializer_t() : v(NULL),size(0),capacity(0),offset(0) CV_SERIALIZER_MF_CHUNK0 {}
-    CV_API_INL cvh_serializer_t::cvh_serializer_t(const cvh_serializer_t& o)  : v(NULL),size(0),capacity(0),offset(0) CV_SERIALIZER_MF_CHUNK0 {cvh_serializer_cpy(this,&o);}
+    CV_API_INL cvh_serializer_t::cvh_serializer_t() : v(NULL),size(0),capacity(0),offset(0),stream_write(NULL),stream_read(NULL),stream(NULL),stream_error(0),growth_policy(NULL) CV_SERIALIZER_MF_CHUNK0 {}
+    CV_API_INL cvh_serializer_t::cvh_serializer_t(const cvh_serializer_t& o)  : v(NULL),size(0),capacity(0),offset(0),stream_write(NULL),stream_read(NULL),stream(NULL),stream_error(0),growth_policy(o.growth_policy) CV_SERIALIZER_MF_CHUNK0 {cvh_serializer_cpy(this,&o);}
     CV_API_INL cvh_serializer_t& cvh_serializer_t::operator=(const cvh_serializer_t& o) {cvh_serializer_cpy(this,&o);return *this;}
     CV_API_INL cvh_serializer_t::~cvh_serializer_t()    {cvh_serializer_free(this);}
 #       ifdef CV_HAS_MOVE_SEMANTICS
-        CV_API_INL cvh_serializer_t::cvh_serializer_t(cvh_serializer_t&& o) : v(o.v),size(o.size),capacity(o.capacity),offset(o.offset) CV_SERIALIZER_MF_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;*((size_t*)&o.offset)=0;}
+        CV_API_INL cvh_serializer_t::cvh_serializer_t(cvh_serializer_t&& o) : v(o.v),size(o.size),capacity(o.capacity),offset(o.offset),stream_write(o.stream_write),stream_read(o.stream_read),stream(o.stream),stream_error(o.stream_error),growth_policy(o.growth_policy) CV_SERIALIZER_MF_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;*((size_t*)&o.offset)=0;o.stream_write=NULL;o.stream_read=NULL;o.stream=NULL;o.stream_error=0;}
         CV_API_INL cvh_serializer_t& cvh_serializer_t::operator=(cvh_serializer_t&& o)  {
             if (this != &o) {
                 cvh_serializer_free(this);
                 v=o.v;
                 *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;*((size_t*)&offset)=o.offset;
+                stream_write=o.stream_write;stream_read=o.stream_read;stream=o.stream;stream_error=o.stream_error;growth_policy=o.growth_policy;
                 o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;*((size_t*)&o.offset)=0;
+                o.stream_write=NULL;o.stream_read=NULL;o.stream=NULL;o.stream_error=0;
             }
             return *this;
         }
@@ -823,6 +1354,7 @@ CV_API cvh_serializer_t cvh_serializer_create(void) {cvh_serializer_t p;cvh_seri
 /* A constant, grow-only string pool. Basically you store the 'size_t' returned by 'cvh_string_push_back(...)' instead of a char* */
 typedef struct cvh_string_t {
     char* v;size_t size,capacity;
+    const cvh_growth_policy_t* growth_policy;   /* optional (can be NULL): see cvh_string_set_growth_policy(...) */
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
     void (*const reserve)(struct cvh_string_t* p,size_t new_capacity);
     size_t (*const push_back)(struct cvh_string_t* p,const char* str_beg,const char* str_end);
@@ -846,7 +1378,9 @@ typedef struct cvh_string_t {
 } cvh_string_t;
 CV_API void cvh_string_reserve(cvh_string_t* p,size_t new_capacity)    {
     if (new_capacity>p->capacity) {
-        new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        if (p->growth_policy) new_capacity = cvh_growth_policy_next_capacity(p->growth_policy,p->capacity,new_capacity,1);
+        else new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->string,"cvh_string_t",p,1,p->size,p->capacity,new_capacity);
         cv_safe_realloc((void**)&p->v,new_capacity);CV_ASSERT(p->v);
         p->capacity = new_capacity;
     }
@@ -861,7 +1395,7 @@ CV_API size_t cvh_string_push_back(cvh_string_t* p,const char* str_beg,const cha
     p->size+=len+1;
     return old_size;
 }
-CV_API void cvh_string_free(cvh_string_t* p)    {cv_free(p->v);p->v=NULL;p->size=p->capacity=0;}
+CV_API void cvh_string_free(cvh_string_t* p)    {if (p->v) {CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->string,"cvh_string_t",p,1,p->size,p->capacity,0);}cv_free(p->v);p->v=NULL;p->size=p->capacity=0;}
 CV_API void cvh_string_cpy(cvh_string_t* dst,const cvh_string_t* src)   {
     CV_ASSERT(src && dst);
     if (dst->capacity<src->size) cvh_string_reserve(dst,src->size);
@@ -873,18 +1407,19 @@ CV_API void cvh_string_serialize(const cvh_string_t* p,cvh_serializer_t* s)    {
     const size_t p_v_size_in_bytes = p->size;
     CV_ASSERT(p && s);
     /*if (p && p->v) {CV_ASSERT(p->size>0 && p->v[p->size-1]=='\0');}*/
-    cvh_serializer_reserve(s,s->size + size_t_size_in_bytes+p_v_size_in_bytes);
+    cvh_serializer_reserve(s,s->size + size_t_size_in_bytes);
     *((size_t*) &s->v[s->size]) = p->size;s->size+=size_t_size_in_bytes;
-    CV_MEMCPY(&s->v[s->size],p->v,p_v_size_in_bytes);s->size+=p_v_size_in_bytes;
+    cvh_serializer_write_bytes(s,p->v,p_v_size_in_bytes);
 }
 CV_API int cvh_string_deserialize(cvh_string_t* p,const cvh_serializer_t* d)    {
     const size_t size_t_size_in_bytes = sizeof(size_t);size_t psize=0;
-    int check = d->offset+size_t_size_in_bytes<=d->size;CV_ASSERT(check);if (!check) return 0;
+    int check = cvh_serializer_fill(d,size_t_size_in_bytes);CV_ASSERT(check);if (!check) return 0;
     CV_ASSERT(p && d);
     psize = *((const size_t*) &d->v[d->offset]);*((size_t*)&d->offset)+=size_t_size_in_bytes;
-    check = d->offset+psize<=d->size;CV_ASSERT(check && "No space to deserialize the content of a cvh_string_t");if (!check) return 0;
+    check = d->stream_read || d->offset+psize<=d->size;CV_ASSERT(check && "No space to deserialize the content of a cvh_string_t");if (!check) return 0;
     cvh_string_reserve(p,psize);CV_ASSERT(p->v);
-    CV_MEMCPY(p->v,&d->v[d->offset],psize);*((size_t*)&d->offset)+=psize;p->size=psize;
+    check = cvh_serializer_read_bytes(d,p->v,psize);if (!check) return 0;
+    p->size=psize;
     return 1;
 }
 CV_API void cvh_string_init(cvh_string_t* p)   {
@@ -908,6 +1443,8 @@ CV_API void cvh_string_init(cvh_string_t* p)   {
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 }
 CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v);return v;}
+/* 'policy' (optional: it can be NULL, and it must outlive 'p') replaces the default 3/2 growth factor. cvh_string_init(...) resets it */
+CV_API void cvh_string_set_growth_policy(cvh_string_t* p,const cvh_growth_policy_t* policy)  {p->growth_policy=policy;}
 #ifdef __cplusplus
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
 #       define CV_CPP_STRINGT_CHUNK0    ,reserve(&cvh_string_reserve),push_back(&cvh_string_push_back),free(&cvh_string_free),clear(&cvh_string_clear),  \
@@ -915,18 +1452,18 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
 #   else /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 #       define CV_CPP_STRINGT_CHUNK0    /* no-op */
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
-    CV_API_INL cvh_string_t::cvh_string_t() : v(NULL),size(0),capacity(0) CV_CPP_STRINGT_CHUNK0 {}
-    CV_API_INL cvh_string_t::cvh_string_t(const cvh_string_t& o) : v(NULL),size(0),capacity(0) CV_CPP_STRINGT_CHUNK0 {cvh_string_cpy(this,&o);}
+    CV_API_INL cvh_string_t::cvh_string_t() : v(NULL),size(0),capacity(0),growth_policy(NULL) CV_CPP_STRINGT_CHUNK0 {}
+    CV_API_INL cvh_string_t::cvh_string_t(const cvh_string_t& o) : v(NULL),size(0),capacity(0),growth_policy(o.growth_policy) CV_CPP_STRINGT_CHUNK0 {cvh_string_cpy(this,&o);}
     CV_API_INL cvh_string_t& cvh_string_t::operator=(const cvh_string_t& o) {cvh_string_cpy(this,&o);return *this;}
     CV_API_INL const char* cvh_string_t::operator[](size_t i) const {CV_ASSERT(i<size);return &v[i];}
     CV_API_INL cvh_string_t::~cvh_string_t() {cvh_string_free(this);}
 #   ifdef CV_HAS_MOVE_SEMANTICS
-        CV_API_INL cvh_string_t::cvh_string_t(cvh_string_t&& o) : v(o.v),size(o.size),capacity(o.capacity) CV_CPP_STRINGT_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;}
+        CV_API_INL cvh_string_t::cvh_string_t(cvh_string_t&& o) : v(o.v),size(o.size),capacity(o.capacity),growth_policy(o.growth_policy) CV_CPP_STRINGT_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;}
         CV_API_INL cvh_string_t& cvh_string_t::operator=(cvh_string_t&& o)    {
             if (this != &o) {
                 cvh_string_free(this);
                 v=o.v;
-                *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;
+                *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;growth_policy=o.growth_policy;
                 o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;
             }
             return *this;
@@ -939,6 +1476,290 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
 
 #endif /* CV_COMMON_FUNCTIONS_GUARD */
 
+#ifndef CVH_VM_ALLOCATOR_GUARD_
+#define CVH_VM_ALLOCATOR_GUARD_
+/* cvh_vm_allocator_t is a 'cvh_allocator_t' for very large vectors (pass '&a.allocator' to cv_xxx_init_with_allocator(...)). Every buffer is an anonymous
+   mmap(...) of whole pages that grows with mremap(...) on Linux: page table entries are moved, but the items are never copied, so that growing a 10 GB
+   vector costs O(new pages) instead of O(total bytes). With 'use_huge_pages', buffers of at least CVH_VM_HUGE_PAGE_SIZE bytes are made of whole huge pages
+   (their start is aligned to CVH_VM_HUGE_PAGE_SIZE when they're mapped) and advised with MADV_HUGEPAGE (transparent huge pages), and cv_xxx_shrink_to_fit(...)
+   just releases the tail pages (through 'allocator.shrink'). The lengths of the mappings are kept in a small table inside the allocator (not in the buffers,
+   that start exactly on a page boundary): so it's not thread-safe (vectors used by different threads need different allocators), and cvh_vm_allocator_close(...)
+   must be called at the end. In plain C, mremap(...) needs _GNU_SOURCE (defined before including any header): without it, growing maps new pages and copies the items.
+   Every buffer takes at least one page: don't use it for small vectors. Without mmap(...) (e.g. on Windows, or with CV_NO_MMAP) it just uses CV_MALLOC/CV_REALLOC/CV_FREE */
+#if (defined(CV_HAS_MMAP) && (defined(MAP_ANONYMOUS) || defined(MAP_ANON)))
+#   define CVH_VM_HAS_MMAP  /* internal usage */
+#   ifdef MAP_ANONYMOUS
+#       define CVH_VM_MAP_ANONYMOUS MAP_ANONYMOUS
+#   else
+#       define CVH_VM_MAP_ANONYMOUS MAP_ANON
+#   endif
+#   if (defined(__linux__) && defined(MREMAP_MAYMOVE))
+#       define CVH_VM_HAS_MREMAP    /* internal usage */
+#   endif
+#endif
+#ifndef CVH_VM_HUGE_PAGE_SIZE
+#   define CVH_VM_HUGE_PAGE_SIZE (2*1024*1024)
+#endif
+typedef struct cvh_vm_block_t {void* ptr;size_t len;} cvh_vm_block_t;   /* internal usage */
+typedef struct cvh_vm_allocator_t {
+    cvh_allocator_t allocator;  /* its 'user_data' points to this struct: it must not be moved or copied after cvh_vm_allocator_init(...) */
+    size_t page_size;
+    int use_huge_pages;
+    cvh_vm_block_t* blocks;     /* 'num_blocks' live mappings (please don't modify them) */
+    size_t num_blocks,blocks_capacity;
+} cvh_vm_allocator_t;
+/* length of the mapping of a buffer of 'size' bytes (a multiple of CVH_VM_HUGE_PAGE_SIZE for big buffers when 'use_huge_pages' is true) */
+CV_API size_t cvh_vm_allocator_length(const cvh_vm_allocator_t* a,size_t size)  {
+    const size_t page = (a->use_huge_pages && size>=CVH_VM_HUGE_PAGE_SIZE) ? CVH_VM_HUGE_PAGE_SIZE : a->page_size;
+    return (size+page-1)/page*page;
+}
+#ifdef CVH_VM_HAS_MMAP
+CV_API void cvh_vm_allocator_advise(const cvh_vm_allocator_t* a,void* ptr,size_t len)  {
+#   ifdef MADV_HUGEPAGE
+    if (a->use_huge_pages && len>=CVH_VM_HUGE_PAGE_SIZE) madvise(ptr,len,MADV_HUGEPAGE);  /* just a hint: failures are ignored */
+#   else
+    (void)a;(void)ptr;(void)len;
+#   endif
+}
+/* it returns the index of 'ptr' in 'a->blocks' ('a->num_blocks' if it's missing) */
+CV_API size_t cvh_vm_allocator_find(const cvh_vm_allocator_t* a,const void* ptr)  {
+    size_t i=a->num_blocks;
+    while (i>0) {--i;if (a->blocks[i].ptr==ptr) return i;}    /* the most recent blocks first */
+    return a->num_blocks;
+}
+/* it maps 'len' bytes. When 'len' is a multiple of CVH_VM_HUGE_PAGE_SIZE the start is aligned to it too (a bigger region is mapped and trimmed) */
+CV_API void* cvh_vm_allocator_map(const cvh_vm_allocator_t* a,size_t len)  {
+    const int align = (a->use_huge_pages && len>=CVH_VM_HUGE_PAGE_SIZE);
+    const size_t map_len = align ? len+CVH_VM_HUGE_PAGE_SIZE : len;
+    unsigned char *p,*start;
+    void* m = mmap(NULL,map_len,PROT_READ|PROT_WRITE,MAP_PRIVATE|CVH_VM_MAP_ANONYMOUS,-1,0);    /* pages are zero-filled lazily */
+    if (m==MAP_FAILED) return NULL;
+    p = start = (unsigned char*) m;
+    if (align)  {
+        const size_t head = (CVH_VM_HUGE_PAGE_SIZE-(size_t)p%CVH_VM_HUGE_PAGE_SIZE)%CVH_VM_HUGE_PAGE_SIZE;
+        start = p+head;
+        if (head>0) munmap(p,head);
+        munmap(start+len,map_len-head-len);
+    }
+    cvh_vm_allocator_advise(a,start,len);
+    return start;
+}
+#endif /* CVH_VM_HAS_MMAP */
+CV_API void* cvh_vm_allocator_alloc(void* user_data,size_t size)    {
+    cvh_vm_allocator_t* a = (cvh_vm_allocator_t*) user_data;
+#   ifdef CVH_VM_HAS_MMAP
+    const size_t len = cvh_vm_allocator_length(a,size>0 ? size : 1);
+    void* p;
+    if (a->num_blocks==a->blocks_capacity)  {
+        const size_t c = a->blocks_capacity>0 ? 2*a->blocks_capacity : 16;
+        cvh_vm_block_t* blocks = (cvh_vm_block_t*) CV_REALLOC(a->blocks,c*sizeof(cvh_vm_block_t));
+        if (!blocks) return NULL;
+        a->blocks=blocks;a->blocks_capacity=c;
+    }
+    p = cvh_vm_allocator_map(a,len);
+    if (!p) return NULL;
+    a->blocks[a->num_blocks].ptr=p;a->blocks[a->num_blocks].len=len;++a->num_blocks;
+    return p;
+#   else
+    (void)a;return CV_MALLOC(size);
+#   endif
+}
+CV_API void cvh_vm_allocator_free(void* user_data,void* ptr)    {
+    cvh_vm_allocator_t* a = (cvh_vm_allocator_t*) user_data;
+#   ifdef CVH_VM_HAS_MMAP
+    size_t i;
+    if (!ptr) return;
+    i = cvh_vm_allocator_find(a,ptr);
+    CV_ASSERT(i<a->num_blocks && "cvh_vm_allocator_free(...): 'ptr' was not allocated by this allocator");
+    if (i==a->num_blocks) return;
+    munmap(ptr,a->blocks[i].len);
+    a->blocks[i]=a->blocks[--a->num_blocks];
+#   else
+    (void)a;CV_FREE(ptr);
+#   endif
+}
+/* growing uses mremap(...) when available (no copy). Shrinking just unmaps the tail pages ('ptr' does not move): it's also used as 'allocator.shrink' */
+CV_API void* cvh_vm_allocator_realloc(void* user_data,void* ptr,size_t new_size,size_t old_size)    {
+    cvh_vm_allocator_t* a = (cvh_vm_allocator_t*) user_data;
+#   ifdef CVH_VM_HAS_MMAP
+    size_t i,old_len,new_len;
+    if (!ptr) return cvh_vm_allocator_alloc(user_data,new_size);
+    i = cvh_vm_allocator_find(a,ptr);
+    CV_ASSERT(i<a->num_blocks && "cvh_vm_allocator_realloc(...): 'ptr' was not allocated by this allocator");
+    if (i==a->num_blocks) return NULL;
+    old_len = a->blocks[i].len;new_len = cvh_vm_allocator_length(a,new_size>0 ? new_size : 1);
+    if (new_len<old_len) {munmap((unsigned char*)ptr+new_len,old_len-new_len);a->blocks[i].len=new_len;}
+    else if (new_len>old_len)   {
+#       ifdef CVH_VM_HAS_MREMAP
+        void* p = mremap(ptr,old_len,new_len,MREMAP_MAYMOVE);
+        if (p==MAP_FAILED) return NULL;
+        cvh_vm_allocator_advise(a,p,new_len);
+        a->blocks[i].ptr=p;a->blocks[i].len=new_len;
+        return p;
+#       else
+        void* p = cvh_vm_allocator_alloc(user_data,new_size);   /* it can move 'a->blocks' */
+        if (!p) return NULL;
+        CV_MEMCPY(p,ptr,old_size<new_size ? old_size : new_size);
+        cvh_vm_allocator_free(user_data,ptr);
+        return p;
+#       endif
+    }
+    (void)old_size;
+    return ptr;
+#   else
+    (void)a;(void)old_size;return CV_REALLOC(ptr,new_size);
+#   endif
+}
+/* 'use_huge_pages' (0 or 1) is just a hint: it's ignored where MADV_HUGEPAGE is not available */
+CV_API void cvh_vm_allocator_init(cvh_vm_allocator_t* a,int use_huge_pages)    {
+    CV_ASSERT(a);
+    CV_MEMSET(a,0,sizeof(*a));
+    a->allocator.alloc=&cvh_vm_allocator_alloc;a->allocator.realloc=&cvh_vm_allocator_realloc;
+    a->allocator.free=&cvh_vm_allocator_free;a->allocator.shrink=&cvh_vm_allocator_realloc;
+    a->allocator.user_data=a;
+    a->use_huge_pages=use_huge_pages;
+    a->page_size=4096;
+#   ifdef CVH_VM_HAS_MMAP
+    {const long page_size = sysconf(_SC_PAGESIZE);if (page_size>0) a->page_size=(size_t)page_size;}
+#   endif
+}
+/* It unmaps the buffers that are still alive (the vectors that use them must not be used any more) and it releases the table of the mappings */
+CV_API void cvh_vm_allocator_close(cvh_vm_allocator_t* a)    {
+    CV_ASSERT(a);
+#   ifdef CVH_VM_HAS_MMAP
+    while (a->num_blocks>0) {--a->num_blocks;munmap(a->blocks[a->num_blocks].ptr,a->blocks[a->num_blocks].len);}
+#   endif
+    if (a->blocks) CV_FREE(a->blocks);
+    a->blocks=NULL;a->num_blocks=a->blocks_capacity=0;
+}
+#endif /* CVH_VM_ALLOCATOR_GUARD_ */
+
+#ifndef CV_RADIX_KEY_FUNCTIONS_GUARD
+#define CV_RADIX_KEY_FUNCTIONS_GUARD
+/* helpers that map signed and floating point keys to unsigned keys with the same order (for cv_xxx_radix_sort_by_key(...)) */
+CV_API unsigned long long cv_radix_key_from_int(int value) {return (unsigned long long)(((unsigned)value)^(~((~0U)>>1)));}
+CV_API unsigned long long cv_radix_key_from_long_long(long long value) {return ((unsigned long long)value)^(~(((unsigned long long)-1)>>1));}
+CV_API unsigned long long cv_radix_key_from_float(float value) {
+    unsigned u;CV_ASSERT(sizeof(float)==sizeof(unsigned));
+    CV_MEMCPY(&u,&value,sizeof(unsigned));
+    return (unsigned long long)((u&(~((~0U)>>1))) ? ~u : (u|(~((~0U)>>1))));   /* negative values: all bits flipped, positive values: sign bit set */
+}
+CV_API unsigned long long cv_radix_key_from_double(double value) {
+    unsigned long long u;CV_ASSERT(sizeof(double)==sizeof(unsigned long long));
+    CV_MEMCPY(&u,&value,sizeof(unsigned long long));
+    return (u&(~(((unsigned long long)-1)>>1))) ? ~u : (u|(~(((unsigned long long)-1)>>1)));
+}
+#endif /* CV_RADIX_KEY_FUNCTIONS_GUARD */
+
+#ifndef CV_EYTZINGER_FUNCTIONS_GUARD
+#define CV_EYTZINGER_FUNCTIONS_GUARD
+CV_API size_t cv_log2_floor(size_t x)  {
+    /* x must be >0 */
+#   if (defined(__GNUC__) || defined(__clang__))
+    return (size_t)(sizeof(unsigned long long)*8-1-__builtin_clzll((unsigned long long)x));
+#   else
+    size_t r=0;while (x>>=1) ++r;return r;
+#   endif
+}
+/* It returns the position in the sorted array of the item at index 'k' (in [1,n]) of its Eytzinger layout (of 'n' items).
+   It's the in-order rank of node 'k' in a perfect tree (of the same height), minus the missing last-level nodes that precede it. */
+CV_API size_t cv_eytzinger_position(size_t k,size_t n)   {
+    const size_t height = cv_log2_floor(n), depth = cv_log2_floor(k);
+    const size_t last_level = ((size_t)1)<<height, first_missing = n-last_level+1;   /* last level: indices [last_level,n] */
+    const size_t perfect_rank = ((2*(k-(((size_t)1)<<depth))+1)<<(height-depth))-1;
+    const size_t num_preceding_slots = (perfect_rank+1)/2;  /* last-level slots (present or not) before 'k' */
+    return perfect_rank - (num_preceding_slots>first_missing ? num_preceding_slots-first_missing : 0);
+}
+#endif /* CV_EYTZINGER_FUNCTIONS_GUARD */
+
+#if (defined(CV_ENABLE_PARALLEL) && !defined(CV_PARALLEL_GUARD))
+#define CV_PARALLEL_GUARD
+#ifndef CV_PARALLEL_NUM_THREADS
+#   define CV_PARALLEL_NUM_THREADS  (0)     /* 0 means: the number of online processors */
+#endif
+#ifndef CV_PARALLEL_MIN_ITEMS_PER_THREAD
+#   define CV_PARALLEL_MIN_ITEMS_PER_THREAD (65536)
+#endif
+#ifndef CV_PARALLEL_MAX_THREADS
+#   define CV_PARALLEL_MAX_THREADS  (64)
+#endif
+#if (CV_PARALLEL_MIN_ITEMS_PER_THREAD<1 || CV_PARALLEL_MAX_THREADS<1)
+#   error CV_PARALLEL_MIN_ITEMS_PER_THREAD and CV_PARALLEL_MAX_THREADS must be at least 1
+#endif
+#ifdef _WIN32
+#   include <windows.h> /* CreateThread, WaitForSingleObject, CloseHandle, GetSystemInfo */
+#else
+#   include <pthread.h> /* pthread_create, pthread_join (please link with -pthread) */
+#   include <unistd.h>  /* sysconf */
+#endif
+typedef struct cv_parallel_task_t {
+    void (*fn)(void* ctx,size_t task_index);
+    void* ctx;
+    size_t task_index;
+} cv_parallel_task_t;
+#ifdef _WIN32
+CV_API DWORD WINAPI cv_parallel_thread_entry(LPVOID p) {cv_parallel_task_t* t = (cv_parallel_task_t*) p;t->fn(t->ctx,t->task_index);return 0;}
+#else
+CV_API void* cv_parallel_thread_entry(void* p) {cv_parallel_task_t* t = (cv_parallel_task_t*) p;t->fn(t->ctx,t->task_index);return NULL;}
+#endif
+/* It returns the number of threads to use for 'num_items' items (1 means: use the serial code).
+   'num_threads'<=0 means CV_PARALLEL_NUM_THREADS (or the number of online processors if it's 0 too).
+   Every thread gets at least CV_PARALLEL_MIN_ITEMS_PER_THREAD items. */
+CV_API size_t cv_parallel_num_threads(int num_threads,size_t num_items)  {
+    size_t n;
+    if (num_threads<=0) num_threads = CV_PARALLEL_NUM_THREADS;
+    if (num_threads<=0) {
+#       ifdef _WIN32
+        SYSTEM_INFO si;GetSystemInfo(&si);num_threads = (int) si.dwNumberOfProcessors;
+#       elif defined(_SC_NPROCESSORS_ONLN)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#       endif
+        if (num_threads<=0) num_threads = 1;
+    }
+    n = (size_t) num_threads;
+    if (n>CV_PARALLEL_MAX_THREADS) n = CV_PARALLEL_MAX_THREADS;
+    if (n>num_items/CV_PARALLEL_MIN_ITEMS_PER_THREAD) n = num_items/CV_PARALLEL_MIN_ITEMS_PER_THREAD;
+    return n>0 ? n : 1;
+}
+/* start of the 'task_index'-th of 'num_tasks' contiguous (and almost equal) chunks of [0,size) */
+CV_API size_t cv_parallel_chunk_begin(size_t size,size_t num_tasks,size_t task_index)   {
+    const size_t q = size/num_tasks, r = size%num_tasks;
+    return q*task_index + (task_index<r ? task_index : r);
+}
+/* It calls fn(ctx,i) for every i in [0,num_tasks) and waits for them: task 0 runs on the calling thread,
+   and every other task on its own thread (or on the calling thread too, if the thread can't be created) */
+CV_API void cv_parallel_run(void (*fn)(void*,size_t),void* ctx,size_t num_tasks)   {
+    cv_parallel_task_t tasks[CV_PARALLEL_MAX_THREADS];
+#   ifdef _WIN32
+    HANDLE threads[CV_PARALLEL_MAX_THREADS];
+#   else
+    pthread_t threads[CV_PARALLEL_MAX_THREADS];
+#   endif
+    int started[CV_PARALLEL_MAX_THREADS];
+    size_t i;
+    CV_ASSERT(fn && num_tasks<=CV_PARALLEL_MAX_THREADS);
+    if (num_tasks>CV_PARALLEL_MAX_THREADS) num_tasks = CV_PARALLEL_MAX_THREADS;
+    for (i=1;i<num_tasks;i++)   {
+        tasks[i].fn = fn;tasks[i].ctx = ctx;tasks[i].task_index = i;
+#       ifdef _WIN32
+        threads[i] = CreateThread(NULL,0,&cv_parallel_thread_entry,&tasks[i],0,NULL);
+        started[i] = (threads[i]!=NULL) ? 1 : 0;
+#       else
+        started[i] = (pthread_create(&threads[i],NULL,&cv_parallel_thread_entry,&tasks[i])==0) ? 1 : 0;
+#       endif
+    }
+    if (num_tasks>0) fn(ctx,0);
+    for (i=1;i<num_tasks;i++)   {
+        if (!started[i]) {fn(ctx,i);continue;}  /* serial fallback */
+#       ifdef _WIN32
+        WaitForSingleObject(threads[i],INFINITE);CloseHandle(threads[i]);
+#       else
+        pthread_join(threads[i],NULL);
+#       endif
+    }
+}
+#endif /* CV_PARALLEL_GUARD */
+
 
 #ifndef CV_NO_STDIO
 #   define CV_CHUNK_NO_STDIO_0(CV_TYPE) \
@@ -976,6 +1797,9 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
         typedef size_t (* insert_range_at_mf)(CV_VECTOR_TYPE(CV_TYPE)*,const CV_TYPE*,size_t,size_t);    \
         typedef size_t (* insert_sorted_mf)(CV_VECTOR_TYPE(CV_TYPE)*,const CV_TYPE*,int*,int);   \
         typedef size_t (* insert_sorted_by_val_mf)(CV_VECTOR_TYPE(CV_TYPE)*,const CV_TYPE,int*,int); \
+        typedef size_t (* insert_sorted_range_mf)(CV_VECTOR_TYPE(CV_TYPE)*,const CV_TYPE*,size_t,int);   \
+        typedef void (* sort_mf)(CV_VECTOR_TYPE(CV_TYPE)*); \
+        typedef void (* radix_sort_by_key_mf)(CV_VECTOR_TYPE(CV_TYPE)*,unsigned long long (*)(const CV_TYPE*)); \
         typedef int (* remove_at_mf)(CV_VECTOR_TYPE(CV_TYPE)*,size_t);   \
         typedef int (* remove_range_at_mf)(CV_VECTOR_TYPE(CV_TYPE)*,size_t,size_t);  \
         typedef void (* cpy_mf)(CV_VECTOR_TYPE(CV_TYPE)*,const CV_VECTOR_TYPE(CV_TYPE)*); \
@@ -1003,6 +1827,9 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
         *((insert_range_at_mf*)&v->insert_range_at)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at);  \
         *((insert_sorted_mf*)&v->insert_sorted)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted);    \
         *((insert_sorted_by_val_mf*)&v->insert_sorted_by_val)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_by_val);   \
+        *((insert_sorted_range_mf*)&v->insert_sorted_range)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_range);  \
+        *((sort_mf*)&v->sort)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_sort);   \
+        *((radix_sort_by_key_mf*)&v->radix_sort_by_key)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_radix_sort_by_key);   \
         *((remove_at_mf*)&v->remove_at)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_at);    \
         *((remove_range_at_mf*)&v->remove_range_at)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_range_at);  \
         *((cpy_mf*)&v->cpy)=&CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy);  \
@@ -1020,6 +1847,8 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
             insert_at(&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_at)),insert_at_by_val(&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_at_by_val)),    \
             insert_range_at(&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at)), \
             insert_sorted(&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted)),insert_sorted_by_val(&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_by_val)),    \
+            insert_sorted_range(&CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_range)),sort(&CV_VECTOR_TYPE_FCT(CV_TYPE,_sort)), \
+            radix_sort_by_key(&CV_VECTOR_TYPE_FCT(CV_TYPE,_radix_sort_by_key)), \
             remove_at(&CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_at)),remove_range_at(&CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_range_at)),  \
             cpy(&CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy)),dbg_check(&CV_VECTOR_TYPE_FCT(CV_TYPE,_dbg_check)),  \
             serialize(&CV_VECTOR_TYPE_FCT(CV_TYPE,_serialize)),deserialize(&CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize))
@@ -1037,13 +1866,13 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
 #   define CV_CPP_DEFINITION_CHUNK0(CV_TYPE)    \
         CV_VECTOR_TYPE(CV_TYPE)::CV_VECTOR_TYPE(CV_TYPE)() :  \
             v(NULL),size(0),capacity(0),    \
-            item_ctr(NULL),item_dtr(NULL),item_cpy(NULL),item_cmp(NULL),item_serialize(NULL),item_deserialize(NULL)    \
+            item_ctr(NULL),item_dtr(NULL),item_cpy(NULL),item_cmp(NULL),item_serialize(NULL),item_deserialize(NULL),allocator(NULL),growth_policy(NULL)    \
             CV_FAKE_MEMBER_FUNCTIONS_DEF_CPP_CHUNK(CV_TYPE)   \
         {}  \
             \
         CV_VECTOR_TYPE(CV_TYPE)::CV_VECTOR_TYPE(CV_TYPE)(const CV_VECTOR_TYPE(CV_TYPE)& o) :   \
             v(NULL),size(0),capacity(0),    \
-            item_ctr(o.item_ctr),item_dtr(o.item_dtr),item_cpy(o.item_cpy),item_cmp(o.item_cmp),item_serialize(o.item_serialize),item_deserialize(o.item_deserialize)    \
+            item_ctr(o.item_ctr),item_dtr(o.item_dtr),item_cpy(o.item_cpy),item_cmp(o.item_cmp),item_serialize(o.item_serialize),item_deserialize(o.item_deserialize),allocator(o.allocator),growth_policy(o.growth_policy)    \
             CV_FAKE_MEMBER_FUNCTIONS_DEF_CPP_CHUNK(CV_TYPE)   \
         {   \
             CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy)(this,&o);  \
@@ -1056,7 +1885,7 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
 #           define CV_CPP_DEFINITION_CHUNK1(CV_TYPE)    \
                 CV_VECTOR_TYPE(CV_TYPE)::CV_VECTOR_TYPE(CV_TYPE)(CV_VECTOR_TYPE(CV_TYPE)&& o) :    \
                     v(o.v),size(o.size),capacity(o.capacity),   \
-                    item_ctr(o.item_ctr),item_dtr(o.item_dtr),item_cpy(o.item_cpy),item_cmp(o.item_cmp),item_serialize(o.item_serialize),item_deserialize(o.item_deserialize)    \
+                    item_ctr(o.item_ctr),item_dtr(o.item_dtr),item_cpy(o.item_cpy),item_cmp(o.item_cmp),item_serialize(o.item_serialize),item_deserialize(o.item_deserialize),allocator(o.allocator),growth_policy(o.growth_policy)    \
                     CV_FAKE_MEMBER_FUNCTIONS_DEF_CPP_CHUNK(CV_TYPE)   \
                 {   \
                     o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;   \
@@ -1067,6 +1896,8 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
                         CV_VECTOR_TYPE_FCT(CV_TYPE,_free)(this);    \
                         v=o.v;  \
                         *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;  \
+                        *((const cvh_allocator_t**)&allocator)=o.allocator;  \
+                        *((const cvh_growth_policy_t**)&growth_policy)=o.growth_policy;  \
                         o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;   \
                     }   \
                     return *this;   \
@@ -1091,31 +1922,307 @@ CV_API cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v
         if (v->item_ctr || v->item_cpy) CV_MEMSET(v_val,0,num_items_to_insert*sizeof(CV_TYPE));
 #   define CV_CLEARING_ITEM_MEMORY_CHUNK4(CV_TYPE)  \
         if (v->item_ctr || v->item_cpy) CV_MEMSET(&v->v[start_position],0,num_items_to_insert*sizeof(CV_TYPE));
+#   define CV_CLEARING_ITEM_MEMORY_CHUNK5(CV_TYPE)  \
+        if (a->item_ctr || a->item_cpy) CV_MEMSET(&a->v[start],0,(end-start)*sizeof(CV_TYPE));
 #else /*CV_ENABLE_CLEARING_ITEM_MEMORY*/
 #   define CV_CLEARING_ITEM_MEMORY_CHUNK0(CV_TYPE)   /*no-op*/
 #   define CV_CLEARING_ITEM_MEMORY_CHUNK1(CV_TYPE)   /*no-op*/
 #   define CV_CLEARING_ITEM_MEMORY_CHUNK2(CV_TYPE)   /*no-op*/
 #   define CV_CLEARING_ITEM_MEMORY_CHUNK3(CV_TYPE)   /*no-op*/
 #   define CV_CLEARING_ITEM_MEMORY_CHUNK4(CV_TYPE)   /*no-op*/
+#   define CV_CLEARING_ITEM_MEMORY_CHUNK5(CV_TYPE)   /*no-op*/
 #endif /*CV_ENABLE_CLEARING_ITEM_MEMORY*/
 
+/* The sort helpers of cv_xxx_sort(...) (SUFFIX: _fct) and cv_xxx_sort_inline(...) (SUFFIX: _inline): 'CMP(a,b)' is either a call to
+   the 'item_cmp' argument (CMP_PARAM(CV_TYPE) and CMP_ARG() add it to the helpers) or the user-provided CV_CMP_INLINE(a,b) */
+#define CV_SORT_CMP_FCT(A,B)  item_cmp(A,B)
+#define CV_SORT_CMP_FCT_PARAM(CV_TYPE)  ,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*)
+#define CV_SORT_CMP_FCT_ARG()   ,item_cmp
+#define CV_SORT_CMP_INLINE_PARAM(CV_TYPE)   /* no-op */
+#define CV_SORT_CMP_INLINE_ARG()    /* no-op */
+#define CV_SORT_FUNCTIONS_CHUNK(CV_TYPE,SUFFIX,CMP,CMP_PARAM,CMP_ARG) \
+CV_API void CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort2,SUFFIX))(CV_TYPE* a,CV_TYPE* b CMP_PARAM(CV_TYPE)) {if (CMP(b,a)<0) CV_TYPE_FCT(CV_TYPE,_sort_swap)(a,b);}  \
+CV_API void CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort3,SUFFIX))(CV_TYPE* a,CV_TYPE* b,CV_TYPE* c CMP_PARAM(CV_TYPE)) {    \
+    CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort2,SUFFIX))(a,b CMP_ARG());CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort2,SUFFIX))(b,c CMP_ARG());CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort2,SUFFIX))(a,b CMP_ARG());  \
+}   \
+CV_API int CV_TYPE_FCT(CV_TYPE,CV_CAT(_insertion_sort,SUFFIX))(CV_TYPE* begin,CV_TYPE* end CMP_PARAM(CV_TYPE),int guarded,size_t max_moves) {    \
+    /* when 'guarded' is 0, *(begin-1) must be <= all the items in [begin,end). It returns 0 when more than 'max_moves' items are moved (and sorting is not complete) */   \
+    CV_TYPE *cur,*sift;CV_TYPE t;size_t num_moves=0;  \
+    if (begin==end) return 1;   \
+    for (cur=begin+1;cur!=end;++cur)    {   \
+        sift=cur;   \
+        if (CMP(sift,sift-1)<0)    {   \
+            CV_MEMCPY(&t,sift,sizeof(CV_TYPE)); \
+            do {CV_MEMCPY(sift,(sift-1),sizeof(CV_TYPE));--sift;} while ((!guarded || sift!=begin) && CMP(&t,sift-1)<0);   \
+            CV_MEMCPY(sift,&t,sizeof(CV_TYPE));    \
+            num_moves+=(size_t)(cur-sift);  \
+            if (num_moves>max_moves) return 0;  \
+        }   \
+    }   \
+    return 1;   \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,CV_CAT(_heap_sort,SUFFIX))(CV_TYPE* v,size_t size CMP_PARAM(CV_TYPE)) {  \
+    size_t i,j,c,n;  \
+    for (n=size,i=size/2;n>1;) {    \
+        /* first we build the heap (i>0), then we move its root to the end (i==0) */   \
+        if (i>0) --i;   \
+        else {--n;CV_TYPE_FCT(CV_TYPE,_sort_swap)(&v[0],&v[n]);}  \
+        for (j=i;(c=2*j+1)<n;j=c)    {   \
+            if (c+1<n && CMP(&v[c],&v[c+1])<0) ++c;   \
+            if (!(CMP(&v[j],&v[c])<0)) break;  \
+            CV_TYPE_FCT(CV_TYPE,_sort_swap)(&v[j],&v[c]);  \
+        }   \
+    }   \
+}   \
+CV_API CV_TYPE* CV_TYPE_FCT(CV_TYPE,CV_CAT(_partition_right,SUFFIX))(CV_TYPE* begin,CV_TYPE* end CMP_PARAM(CV_TYPE),int* already_partitioned) {   \
+    /* the pivot is *begin: items equal to it go to the right partition. The median-of-3 guarantees that the scans stop */  \
+    CV_TYPE *first=begin,*last=end,*pivot_pos;CV_TYPE pivot;  \
+    CV_MEMCPY(&pivot,begin,sizeof(CV_TYPE));    \
+    do {++first;} while (CMP(first,&pivot)<0);   \
+    if (first-1==begin) {while (first<last) {--last;if (CMP(last,&pivot)<0) break;}}    \
+    else {do {--last;} while (!(CMP(last,&pivot)<0));}  \
+    *already_partitioned = first>=last ? 1 : 0; \
+    while (first<last)  {   \
+        CV_TYPE_FCT(CV_TYPE,_sort_swap)(first,last);    \
+        do {++first;} while (CMP(first,&pivot)<0);   \
+        do {--last;} while (!(CMP(last,&pivot)<0)); \
+    }   \
+    pivot_pos = first-1;    \
+    CV_MEMCPY(begin,pivot_pos,sizeof(CV_TYPE));CV_MEMCPY(pivot_pos,&pivot,sizeof(CV_TYPE));   \
+    return pivot_pos;   \
+}   \
+CV_API CV_TYPE* CV_TYPE_FCT(CV_TYPE,CV_CAT(_partition_left,SUFFIX))(CV_TYPE* begin,CV_TYPE* end CMP_PARAM(CV_TYPE)) {   \
+    /* like '_partition_right(...)', but items equal to the pivot go to the left partition (used when there are many equal items) */   \
+    CV_TYPE *first=begin,*last=end,*pivot_pos;CV_TYPE pivot;  \
+    CV_MEMCPY(&pivot,begin,sizeof(CV_TYPE));    \
+    do {--last;} while (CMP(&pivot,last)<0);    \
+    if (last+1==end) {while (first<last) {++first;if (CMP(&pivot,first)<0) break;}}   \
+    else {do {++first;} while (!(CMP(&pivot,first)<0));} \
+    while (first<last)  {   \
+        CV_TYPE_FCT(CV_TYPE,_sort_swap)(first,last);    \
+        do {--last;} while (CMP(&pivot,last)<0);    \
+        do {++first;} while (!(CMP(&pivot,first)<0));    \
+    }   \
+    pivot_pos = last;   \
+    CV_MEMCPY(begin,pivot_pos,sizeof(CV_TYPE));CV_MEMCPY(pivot_pos,&pivot,sizeof(CV_TYPE));   \
+    return pivot_pos;   \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,CV_CAT(_pdq_sort,SUFFIX))(CV_TYPE* begin,CV_TYPE* end CMP_PARAM(CV_TYPE),int bad_allowed,int leftmost) {   \
+    /* pattern-defeating quicksort (Orson Peters): the left partition is sorted recursively, the right one in this loop */   \
+    for (;;)    {   \
+        const size_t size = (size_t)(end-begin);    \
+        size_t s2,l_size,r_size;CV_TYPE* pivot_pos;int already_partitioned;  \
+        if (size<CV_SORT_INSERTION_THRESHOLD) {CV_TYPE_FCT(CV_TYPE,CV_CAT(_insertion_sort,SUFFIX))(begin,end CMP_ARG(),leftmost,(size_t)-1);return;}  \
+        /* median-of-3 (or pseudo median-of-9 'ninther' for big partitions) pivot, moved to *begin */ \
+        s2 = size/2;    \
+        if (size>CV_SORT_NINTHER_THRESHOLD)   {   \
+            CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort3,SUFFIX))(begin,begin+s2,end-1 CMP_ARG()); \
+            CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort3,SUFFIX))(begin+1,begin+(s2-1),end-2 CMP_ARG());   \
+            CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort3,SUFFIX))(begin+2,begin+(s2+1),end-3 CMP_ARG());   \
+            CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort3,SUFFIX))(begin+(s2-1),begin+s2,begin+(s2+1) CMP_ARG());   \
+            CV_TYPE_FCT(CV_TYPE,_sort_swap)(begin,begin+s2);    \
+        }   \
+        else CV_TYPE_FCT(CV_TYPE,CV_CAT(_sort3,SUFFIX))(begin+s2,begin,end-1 CMP_ARG());    \
+        /* if the pivot is equal to the item before this partition (that is <= all its items), we put all the items equal to the pivot on the left, and skip them */  \
+        if (!leftmost && !(CMP(begin-1,begin)<0)) {begin = CV_TYPE_FCT(CV_TYPE,CV_CAT(_partition_left,SUFFIX))(begin,end CMP_ARG())+1;continue;}    \
+        pivot_pos = CV_TYPE_FCT(CV_TYPE,CV_CAT(_partition_right,SUFFIX))(begin,end CMP_ARG(),&already_partitioned); \
+        l_size = (size_t)(pivot_pos-begin);r_size = (size_t)(end-(pivot_pos+1));   \
+        if (l_size<size/8 || r_size<size/8)    {   \
+            /* bad partition: after too many of them we switch to heap sort, otherwise we break the patterns with a few swaps */  \
+            if (--bad_allowed==0) {CV_TYPE_FCT(CV_TYPE,CV_CAT(_heap_sort,SUFFIX))(begin,size CMP_ARG());return;}   \
+            if (l_size>=CV_SORT_INSERTION_THRESHOLD)    {   \
+                CV_TYPE_FCT(CV_TYPE,_sort_swap)(begin,begin+l_size/4);  \
+                CV_TYPE_FCT(CV_TYPE,_sort_swap)(pivot_pos-1,pivot_pos-l_size/4);    \
+                if (l_size>CV_SORT_NINTHER_THRESHOLD)   {   \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(begin+1,begin+(l_size/4+1));    \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(begin+2,begin+(l_size/4+2));    \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(pivot_pos-2,pivot_pos-(l_size/4+1));    \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(pivot_pos-3,pivot_pos-(l_size/4+2));    \
+                }   \
+            }   \
+            if (r_size>=CV_SORT_INSERTION_THRESHOLD)    {   \
+                CV_TYPE_FCT(CV_TYPE,_sort_swap)(pivot_pos+1,pivot_pos+(1+r_size/4));    \
+                CV_TYPE_FCT(CV_TYPE,_sort_swap)(end-1,end-r_size/4);    \
+                if (r_size>CV_SORT_NINTHER_THRESHOLD)   {   \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(pivot_pos+2,pivot_pos+(2+r_size/4));    \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(pivot_pos+3,pivot_pos+(3+r_size/4));    \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(end-2,end-(1+r_size/4));    \
+                    CV_TYPE_FCT(CV_TYPE,_sort_swap)(end-3,end-(2+r_size/4));    \
+                }   \
+            }   \
+        }   \
+        else if (already_partitioned && \
+                 CV_TYPE_FCT(CV_TYPE,CV_CAT(_insertion_sort,SUFFIX))(begin,pivot_pos CMP_ARG(),leftmost,8) &&    \
+                 CV_TYPE_FCT(CV_TYPE,CV_CAT(_insertion_sort,SUFFIX))(pivot_pos+1,end CMP_ARG(),0,8)) return;  /* (almost) sorted input */  \
+        CV_TYPE_FCT(CV_TYPE,CV_CAT(_pdq_sort,SUFFIX))(begin,pivot_pos CMP_ARG(),bad_allowed,leftmost);  \
+        begin = pivot_pos+1;leftmost = 0;   \
+    }   \
+}
 
-
-#define CV_DEFINE(CV_TYPE)	\
+#ifdef CV_ENABLE_PARALLEL
+#   define CV_PARALLEL_DECLARATION_CHUNK(CV_TYPE)  \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_parallel_sort)(CV_VECTOR_TYPE(CV_TYPE)* v,int num_threads);   \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_parallel_for_each)(CV_VECTOR_TYPE(CV_TYPE)* v,void (*fn)(CV_TYPE* item,size_t position,void* user_data),void* user_data,int num_threads);  \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_parallel_cpy)(CV_VECTOR_TYPE(CV_TYPE)* a,const CV_VECTOR_TYPE(CV_TYPE)* b,int num_threads);
+#   define CV_PARALLEL_DEFINITION_CHUNK(CV_TYPE)  \
+typedef struct CV_TYPE_FCT(CV_TYPE,_parallel_ctx) { \
+    CV_VECTOR_TYPE(CV_TYPE)* v; \
+    const CV_VECTOR_TYPE(CV_TYPE)* b;   /* _parallel_cpy(...) only */ \
+    CV_TYPE* src;CV_TYPE* dst;  \
+    size_t size,num_tasks,num_runs; \
+    size_t bounds[CV_PARALLEL_MAX_THREADS+1];   /* sorted runs (_parallel_sort(...) only) */  \
+    void (*fn)(CV_TYPE*,size_t,void*);void* user_data;    /* _parallel_for_each(...) only */  \
+} CV_TYPE_FCT(CV_TYPE,_parallel_ctx);   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_parallel_sort_task)(void* pctx,size_t t) {  \
+    const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)* c = (const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)*) pctx;   \
+    const size_t size = c->bounds[t+1]-c->bounds[t];size_t n;int log2_size=0;   \
+    if (size<2) return; \
+    for (n=size;n>1;n>>=1) ++log2_size;  \
+    CV_TYPE_FCT(CV_TYPE,_pdq_sort_fct)(c->src+c->bounds[t],c->src+c->bounds[t+1],c->v->item_cmp,log2_size,1);   \
+}   \
+CV_API size_t CV_TYPE_FCT(CV_TYPE,_merge_corank)(size_t k,const CV_TYPE* a,size_t m,const CV_TYPE* b,size_t n,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*)) {   \
+    /* it returns how many items of 'a' are among the first 'k' items of the (stable) merge of 'a' and 'b' */    \
+    size_t lo = k>n ? k-n : 0, hi = k<m ? k : m;    \
+    while (lo<hi)   {   \
+        const size_t mid = lo+(hi-lo)/2;    \
+        if (item_cmp(&a[mid],&b[k-mid-1])<=0) lo = mid+1;  /* a[mid] comes before b[k-mid-1] */    \
+        else hi = mid;  \
+    }   \
+    return lo;  \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_parallel_merge_task)(void* pctx,size_t t) { \
+    /* every task writes the same amount of merged items (even if it's the last round, with a single pair of runs to merge) */  \
+    const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)* c = (const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)*) pctx;   \
+    int (* const item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*) = c->v->item_cmp;    \
+    const size_t out_begin = cv_parallel_chunk_begin(c->size,c->num_tasks,t), out_end = cv_parallel_chunk_begin(c->size,c->num_tasks,t+1);    \
+    size_t p;   \
+    for (p=0;p<c->num_runs;p+=2)    {   \
+        const size_t a_begin = c->bounds[p], b_begin = c->bounds[p+1], b_end = c->bounds[p+2<=c->num_runs ? p+2 : c->num_runs];   \
+        const CV_TYPE* a = c->src+a_begin;const CV_TYPE* b = c->src+b_begin;CV_TYPE* out;  \
+        size_t lo,hi,i0,i1,j0,j1;   \
+        if (b_end<=out_begin) continue; \
+        if (a_begin>=out_end) break;    \
+        lo = (out_begin>a_begin ? out_begin : a_begin)-a_begin; \
+        hi = (out_end<b_end ? out_end : b_end)-a_begin; \
+        i0 = CV_TYPE_FCT(CV_TYPE,_merge_corank)(lo,a,b_begin-a_begin,b,b_end-b_begin,item_cmp);j0 = lo-i0;   \
+        i1 = CV_TYPE_FCT(CV_TYPE,_merge_corank)(hi,a,b_begin-a_begin,b,b_end-b_begin,item_cmp);j1 = hi-i1;   \
+        out = c->dst+a_begin+lo;    \
+        while (i0<i1 && j0<j1)  {   \
+            if (item_cmp(&b[j0],&a[i0])<0) {CV_MEMCPY(out,&b[j0],sizeof(CV_TYPE));++j0;}   \
+            else {CV_MEMCPY(out,&a[i0],sizeof(CV_TYPE));++i0;}  \
+            ++out;  \
+        }   \
+        if (i0<i1) {CV_MEMCPY(out,&a[i0],(i1-i0)*sizeof(CV_TYPE));out+=i1-i0;} \
+        if (j0<j1) CV_MEMCPY(out,&b[j0],(j1-j0)*sizeof(CV_TYPE));   \
+    }   \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_parallel_move_task)(void* pctx,size_t t) {  \
+    const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)* c = (const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)*) pctx;   \
+    const size_t begin = cv_parallel_chunk_begin(c->size,c->num_tasks,t), end = cv_parallel_chunk_begin(c->size,c->num_tasks,t+1);    \
+    CV_MEMCPY(&c->dst[begin],&c->src[begin],(end-begin)*sizeof(CV_TYPE));   \
+}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_parallel_sort)(CV_VECTOR_TYPE(CV_TYPE)* v,int num_threads)  {   \
+    /* every thread sorts a chunk of 'v' (like cv_xxx_sort(...)), and then the chunks are merged in log2(num_threads) parallel rounds (the sort is not stable) */   \
+    CV_TYPE_FCT(CV_TYPE,_parallel_ctx) c;CV_TYPE* tmp;size_t i;    \
+    CV_ASSERT(v && v->item_cmp);    \
+    CV_MEMSET(&c,0,sizeof(c));  \
+    c.v = v;c.size = v->size;c.num_tasks = cv_parallel_num_threads(num_threads,v->size);    \
+    if (c.num_tasks<2) {CV_VECTOR_TYPE_FCT(CV_TYPE,_sort)(v);return;}   /* serial fallback */   \
+    tmp = (CV_TYPE*) cv_malloc_with(v->allocator,c.size*sizeof(CV_TYPE));   \
+    c.num_runs = c.num_tasks;   \
+    for (i=0;i<=c.num_runs;i++) c.bounds[i] = cv_parallel_chunk_begin(c.size,c.num_runs,i);    \
+    c.src = v->v;c.dst = tmp;   \
+    cv_parallel_run(&CV_TYPE_FCT(CV_TYPE,_parallel_sort_task),&c,c.num_tasks);    \
+    while (c.num_runs>1)    {   \
+        CV_TYPE* t;  \
+        cv_parallel_run(&CV_TYPE_FCT(CV_TYPE,_parallel_merge_task),&c,c.num_tasks);    \
+        for (i=0;2*i<c.num_runs;i++) c.bounds[i] = c.bounds[2*i];   \
+        c.num_runs = (c.num_runs+1)/2;c.bounds[c.num_runs] = c.size;    \
+        t = c.src;c.src = c.dst;c.dst = t;   \
+    }   \
+    if (c.src!=v->v)    {c.dst = v->v;cv_parallel_run(&CV_TYPE_FCT(CV_TYPE,_parallel_move_task),&c,c.num_tasks);}   \
+    cv_free_with(v->allocator,tmp); \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_parallel_for_each_task)(void* pctx,size_t t) {  \
+    const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)* c = (const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)*) pctx;   \
+    const size_t end = cv_parallel_chunk_begin(c->size,c->num_tasks,t+1);size_t i;  \
+    for (i=cv_parallel_chunk_begin(c->size,c->num_tasks,t);i<end;i++) c->fn(&c->v->v[i],i,c->user_data);   \
+}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_parallel_for_each)(CV_VECTOR_TYPE(CV_TYPE)* v,void (*fn)(CV_TYPE* item,size_t position,void* user_data),void* user_data,int num_threads)  {   \
+    /* it calls fn(&v->v[i],i,user_data) for every item, splitting 'v' in contiguous chunks (one per thread): 'fn' must be thread-safe */   \
+    CV_TYPE_FCT(CV_TYPE,_parallel_ctx) c;   \
+    CV_ASSERT(v && fn); \
+    CV_MEMSET(&c,0,sizeof(c));  \
+    c.v = v;c.size = v->size;c.fn = fn;c.user_data = user_data;   \
+    c.num_tasks = cv_parallel_num_threads(num_threads,v->size); \
+    if (c.num_tasks<2) CV_TYPE_FCT(CV_TYPE,_parallel_for_each_task)(&c,0);   /* serial fallback */   \
+    else cv_parallel_run(&CV_TYPE_FCT(CV_TYPE,_parallel_for_each_task),&c,c.num_tasks);  \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_parallel_cpy_task)(void* pctx,size_t t) {  \
+    const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)* c = (const CV_TYPE_FCT(CV_TYPE,_parallel_ctx)*) pctx;   \
+    CV_VECTOR_TYPE(CV_TYPE)* a = c->v;const CV_VECTOR_TYPE(CV_TYPE)* b = c->b;  \
+    const size_t start = cv_parallel_chunk_begin(c->size,c->num_tasks,t), end = cv_parallel_chunk_begin(c->size,c->num_tasks,t+1);size_t i;    \
+    CV_CLEARING_ITEM_MEMORY_CHUNK5(CV_TYPE) \
+    if (a->item_ctr) {for (i=start;i<end;i++) a->item_ctr(&a->v[i]);}  \
+    if (!a->item_cpy)   {CV_MEMCPY(&a->v[start],&b->v[start],(end-start)*sizeof(CV_TYPE));}    \
+    else    {for (i=start;i<end;i++) a->item_cpy(&a->v[i],&b->v[i]);}   \
+}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_parallel_cpy)(CV_VECTOR_TYPE(CV_TYPE)* a,const CV_VECTOR_TYPE(CV_TYPE)* b,int num_threads) {   \
+    /* like cv_xxx_cpy(a,b), but items are constructed and copied by many threads: 'item_ctr' and 'item_cpy' (when used) must be thread-safe */  \
+    CV_TYPE_FCT(CV_TYPE,_parallel_ctx) c;   \
+    if (a==b || (a->size==0 && b->size==0)) return;   \
+    CV_ASSERT(a && b);  \
+    CV_MEMSET(&c,0,sizeof(c));  \
+    c.num_tasks = cv_parallel_num_threads(num_threads,b->size); \
+    if (c.num_tasks<2) {CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy)(a,b);return;}   /* serial fallback */   \
+    CV_ASSERT(a->item_ctr==b->item_ctr && a->item_dtr==b->item_dtr && a->item_cpy==b->item_cpy &&   \
+              a->item_serialize==b->item_serialize &&  a->item_deserialize==b->item_deserialize && \
+              "One of the two vectors has not been properly initialized");    \
+    CV_VECTOR_TYPE_FCT(CV_TYPE,_clear)(a);  \
+    if (b->size>a->capacity) CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(a,b->size);   \
+    c.v = a;c.b = b;c.size = b->size;   \
+    cv_parallel_run(&CV_TYPE_FCT(CV_TYPE,_parallel_cpy_task),&c,c.num_tasks);   \
+    *((size_t*) &a->size)=b->size;  \
+}
+#else /* CV_ENABLE_PARALLEL */
+#   define CV_PARALLEL_DECLARATION_CHUNK(CV_TYPE) /*no-op*/
+#   define CV_PARALLEL_DEFINITION_CHUNK(CV_TYPE)  /*no-op*/
+#endif /* CV_ENABLE_PARALLEL */
+
+#ifdef CV_ENABLE_ALLOC_STATS
+/* per-type counters: they're updated by cv_xxx_reserve(...), cv_xxx_free(...) and cv_xxx_deserialize_mapped(...) (see 'cvh_alloc_stats_t') */
+#   define CV_ALLOC_STATS_DECLARATION_CHUNK(CV_TYPE)  \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_get_alloc_stats)(cvh_alloc_stats_t* stats);   \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_reset_alloc_stats)(void);
+#   define CV_ALLOC_STATS_DEFINITION_CHUNK(CV_TYPE)  \
+CV_API cvh_alloc_stats_t* CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)(void) {static cvh_alloc_stats_t s;return &s;}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_get_alloc_stats)(cvh_alloc_stats_t* stats)   {*stats = *CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)();}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_reset_alloc_stats)(void)  {const cvh_alloc_stats_t zero = {0,0,0,0,0,0,0};*CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)() = zero;}
+#else /* CV_ENABLE_ALLOC_STATS */
+#   define CV_ALLOC_STATS_DECLARATION_CHUNK(CV_TYPE) /*no-op*/
+#   define CV_ALLOC_STATS_DEFINITION_CHUNK(CV_TYPE)  /*no-op*/
+#endif /* CV_ENABLE_ALLOC_STATS */
+
+
+
+/* CV_IS_POD is 0 (CV_DEFINE) or 1 (CV_DEFINE_POD): when it's 1 the item_ctr, item_dtr and item_cpy code paths are removed at compile time */
+#define CV_DEFINITION_CHUNK(CV_TYPE,CV_IS_POD)	\
 CV_API void CV_TYPE_FCT(CV_TYPE,_default_item_cpy)(CV_TYPE* a,const CV_TYPE* b) {   \
     /*CV_ASSERT(a);CV_ASSERT(b);*/  \
     CV_MEMCPY(a,b,sizeof(CV_TYPE));    \
 }  \
+CV_ALLOC_STATS_DEFINITION_CHUNK(CV_TYPE)    \
 /* 'cv_xxx_init(...)' and 'cv_xxx_free(...)' can be thought as the ctr and the dct of the 'cv_xxx' vector struct */   \
 /* Mandatory call at the end to free memory. The vector can be reused after this call. The function can be safely re-called multiple times  */  \
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_free)(CV_VECTOR_TYPE(CV_TYPE)* v)	{   \
 	if (v)	{   \
 		if (v->v) { \
-			if (v->item_dtr)	{			\
+			if (!CV_IS_POD && v->item_dtr)	{			\
 				size_t i;   \
 				for (i=0;i<v->size;i++)	v->item_dtr(&v->v[i]);  \
 			}   \
-			cv_free(v->v);v->v=NULL;    \
+			CVH_ALLOC_STATS_RECORD(CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)(),CV_XSTR(CV_VECTOR_TYPE(CV_TYPE)),v,sizeof(CV_TYPE),v->size,v->capacity,0);   \
+			cv_free_with(v->allocator,v->v);v->v=NULL;    \
 		}	\
 		*((size_t*) &v->size)=0;    \
 		*((size_t*) &v->capacity)=0;    \
@@ -1127,7 +2234,7 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_free)(CV_VECTOR_TYPE(CV_TYPE)* v)	{
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_clear)(CV_VECTOR_TYPE(CV_TYPE)* v)	{   \
 	if (v)	{   \
 		if (v->v) { \
-			if (v->item_dtr)	{			\
+			if (!CV_IS_POD && v->item_dtr)	{			\
 				size_t i;   \
 				for (i=0;i<v->size;i++)	v->item_dtr(&v->v[i]);  \
 			}   \
@@ -1144,10 +2251,11 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_swap)(CV_VECTOR_TYPE(CV_TYPE)* a,CV_
             /*CV_MEMCPY(t,a,sizeof(CV_VECTOR_TYPE(CV_TYPE)));*/ \
             /*CV_MEMCPY(a,b,sizeof(CV_VECTOR_TYPE(CV_TYPE)));*/ \
             /*CV_MEMCPY(b,t,sizeof(CV_VECTOR_TYPE(CV_TYPE)));*/ \
-            /* nope, we just swap 3 values */   \
+            /* nope, we just swap 3 values (plus the allocator that owns the memory) */   \
             {CV_TYPE* tmp=a->v;a->v=b->v;b->v=tmp;} \
             {size_t tmp=a->size;*((size_t*)&a->size)=b->size;*((size_t*)&b->size)=tmp;}   \
             {size_t tmp=a->capacity;*((size_t*)&a->capacity)=b->capacity;*((size_t*)&b->capacity)=tmp;}   \
+            {const cvh_allocator_t* tmp=a->allocator;*((const cvh_allocator_t**)&a->allocator)=b->allocator;*((const cvh_allocator_t**)&b->allocator)=tmp;}   \
         }   \
     }   \
 }   \
@@ -1156,10 +2264,12 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(CV_VECTOR_TYPE(CV_TYPE)* v,
 	CV_ASSERT(v);    \
 	/* grows-only! */   \
     if (size>v->capacity) {		    \
-        const size_t new_capacity = (v->capacity==0) ?    \
+        const size_t new_capacity = v->growth_policy ? cvh_growth_policy_next_capacity(v->growth_policy,v->capacity,size,sizeof(CV_TYPE)) :  \
+                    (v->capacity==0) ?    \
                     size :      /* possibly keep initial user-guided 'reserve(...)' */  \
                     (v->capacity+(size-v->capacity)+(v->capacity)/2);   /* our growing strategy */  \
-        cv_safe_realloc((void**) &v->v,new_capacity*sizeof(CV_TYPE)); \
+        CVH_ALLOC_STATS_RECORD(CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)(),CV_XSTR(CV_VECTOR_TYPE(CV_TYPE)),v,sizeof(CV_TYPE),v->size,v->capacity,new_capacity);   \
+        cv_safe_realloc_with(v->allocator,(void**) &v->v,new_capacity*sizeof(CV_TYPE),v->capacity*sizeof(CV_TYPE)); \
         *((size_t*) &v->capacity) = new_capacity;   \
 	}   \
 }   \
@@ -1167,8 +2277,8 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_resize)(CV_VECTOR_TYPE(CV_TYPE)* v,s
 	/*printf("%s\n",CV_XSTR(CV_VECTOR_TYPE_FCT(CV_TYPE,_resize)));*/    \
 	CV_ASSERT(v);  \
     if (size>v->capacity) CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(v,size); \
-    if (size<v->size)   {if (v->item_dtr) {size_t i;for (i=size;i<v->size;i++) v->item_dtr(&v->v[i]);}} \
-    else {  \
+    if (size<v->size)   {if (!CV_IS_POD && v->item_dtr) {size_t i;for (i=size;i<v->size;i++) v->item_dtr(&v->v[i]);}} \
+    else if (!CV_IS_POD) {  \
         CV_CLEARING_ITEM_MEMORY_CHUNK0(CV_TYPE) \
         if (v->item_ctr) {size_t i;for (i=v->size;i<size;i++) v->item_ctr(&v->v[i]);}   \
     }   \
@@ -1177,6 +2287,13 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_resize)(CV_VECTOR_TYPE(CV_TYPE)* v,s
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_resize_with)(CV_VECTOR_TYPE(CV_TYPE)* v,size_t size,const CV_TYPE* default_value)	{   \
 	CV_ASSERT(v);   \
 	if (!default_value) {CV_VECTOR_TYPE_FCT(CV_TYPE,_resize)(v,size);return;}   \
+    if (CV_IS_POD)  {   \
+        CV_TYPE value;size_t i;CV_MEMCPY(&value,default_value,sizeof(CV_TYPE)); /* 'default_value' can be an item of 'v' */  \
+        if (size>v->capacity) CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(v,size); \
+        for (i=v->size;i<size;i++) CV_MEMCPY(&v->v[i],&value,sizeof(CV_TYPE));   \
+        *((size_t*) &v->size)=size; \
+        return; \
+    }   \
     if (size>v->capacity) CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(v,size); \
     if (size<v->size)   {if (v->item_dtr) {size_t i;for (i=size;i<v->size;i++) v->item_dtr(&v->v[i]);}} \
     else {  \
@@ -1194,6 +2311,13 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_resize_with_by_val)(CV_VECTOR_TYPE(C
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_push_back)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* value)  {   \
 	void (*item_cpy)(CV_TYPE*,const CV_TYPE*);  \
     CV_ASSERT(v);   \
+    if (CV_IS_POD)  {   \
+        /* a plain store (when the vector grows we copy 'value' first: it can be an item of 'v') */   \
+        if (v->size == v->capacity) {CV_TYPE v_val;CV_MEMCPY(&v_val,value,sizeof(CV_TYPE));CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(v,v->size+1);CV_MEMCPY(&v->v[v->size],&v_val,sizeof(CV_TYPE));}  \
+        else CV_MEMCPY(&v->v[v->size],value,sizeof(CV_TYPE));  \
+        *((size_t*) &v->size)=v->size+1;    \
+        return; \
+    }   \
     item_cpy = v->item_cpy ? v->item_cpy : &(CV_TYPE_FCT(CV_TYPE,_default_item_cpy));   \
         if (v->v && value>=v->v && value<(v->v+v->size))  { \
             /* value ia a pointer to another vector item here */    \
@@ -1219,7 +2343,7 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_push_back)(CV_VECTOR_TYPE(CV_TYPE)*
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_push_back_by_val)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE value)  {CV_VECTOR_TYPE_FCT(CV_TYPE,_push_back)(v,&value);}   \
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_pop_back)(CV_VECTOR_TYPE(CV_TYPE)* v)	{   \
    CV_ASSERT(v && v->size>0);   \
-   if (v->size>0) {*((size_t*) &v->size)=v->size-1;if (v->item_dtr) v->item_dtr(&v->v[v->size]);}   \
+   if (v->size>0) {*((size_t*) &v->size)=v->size-1;if (!CV_IS_POD && v->item_dtr) v->item_dtr(&v->v[v->size]);}   \
 }   \
 CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_linear_search)(const CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_search,int* match)  {   \
     int cmp=0;size_t i; \
@@ -1260,10 +2384,59 @@ CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search)(const CV_VECTOR_TYP
     return cmp>0 ? (mid+1) : mid;   \
 }   \
 CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search_by_val)(const CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE item_to_search,int* match)    {return CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search)(v,&item_to_search,match);}   \
+CV_API size_t CV_TYPE_FCT(CV_TYPE,_eytzinger_fill)(CV_SEARCH_INDEX_TYPE(CV_TYPE)* index,const CV_TYPE* sorted_items,size_t i,size_t k) {  \
+    /* in-order visit of the implicit tree (children of 'k': 2k and 2k+1). It returns the next position in 'sorted_items' */  \
+    if (k<=index->size) {   \
+        i = CV_TYPE_FCT(CV_TYPE,_eytzinger_fill)(index,sorted_items,i,2*k); \
+        CV_MEMCPY(&index->items[k],&sorted_items[i],sizeof(CV_TYPE));++i;   \
+        i = CV_TYPE_FCT(CV_TYPE,_eytzinger_fill)(index,sorted_items,i,2*k+1);   \
+    }   \
+    return i;   \
+}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_search_index_init)(CV_SEARCH_INDEX_TYPE(CV_TYPE)* index,const CV_VECTOR_TYPE(CV_TYPE)* v)  {   \
+    /* 'v' must be sorted. 'index' must be released with cv_xxx_search_index_free(...) (that can be called before rebuilding it) */  \
+    CV_ASSERT(index && v && v->item_cmp);   \
+    CV_MEMSET(index,0,sizeof(CV_SEARCH_INDEX_TYPE(CV_TYPE)));   \
+    index->size = v->size;index->item_cmp = v->item_cmp;index->allocator = v->allocator;   \
+    if (v->size==0) return; \
+    index->items = (CV_TYPE*) cv_malloc_with(index->allocator,(v->size+1)*sizeof(CV_TYPE)); \
+    CV_MEMSET(&index->items[0],0,sizeof(CV_TYPE));  \
+    CV_TYPE_FCT(CV_TYPE,_eytzinger_fill)(index,v->v,0,1);   \
+}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_search_index_free)(CV_SEARCH_INDEX_TYPE(CV_TYPE)* index)  {   \
+    if (index)  {   \
+        if (index->items) cv_free_with(index->allocator,index->items);    \
+        index->items = NULL;index->size = 0;    \
+    }   \
+}   \
+CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_search_index_find)(const CV_SEARCH_INDEX_TYPE(CV_TYPE)* index,const CV_TYPE* item_to_search,int* match)  {   \
+    /* lower bound on the sorted vector (the first equal item on duplicates, where cv_xxx_binary_search(...) can return another one), branchless: it goes right when items[k]<item_to_search */ \
+    const CV_TYPE* items = index ? index->items : NULL;const size_t n = index ? index->size : 0;size_t k = 1; \
+    CV_ASSERT(index && index->item_cmp);    \
+    if (match) *match=0;    \
+    if (n==0) return 0; \
+    while (k<=n)    {   \
+        CV_PREFETCH(items + (16*k<=n ? 16*k : 0)); /* the first of its 16 descendants four levels below */  \
+        k = 2*k + (index->item_cmp(item_to_search,&items[k])>0 ? 1 : 0);  \
+    }   \
+    while (k&1) k>>=1;  /* it removes the final right turns, and the left turn before them: now 'k' is the first item >= item_to_search (or 0) */  \
+    k>>=1;  \
+    if (k==0) return n; \
+    if (match) *match = index->item_cmp(item_to_search,&items[k])==0 ? 1 : 0;    \
+    return cv_eytzinger_position(k,n); \
+}   \
 CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_at)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_insert,size_t position)  {    \
     /* position is in [0,v->size] */    \
     void (*item_cpy)(CV_TYPE*,const CV_TYPE*);  \
     CV_ASSERT(v && position<=v->size);  \
+    if (CV_IS_POD)  {   \
+        CV_TYPE v_val;CV_MEMCPY(&v_val,item_to_insert,sizeof(CV_TYPE));  /* it can be an item of 'v' */  \
+        if (v->size == v->capacity) {CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(v,v->size+1);}    \
+        if (position<v->size) CV_MEMMOVE(&v->v[position+1],&v->v[position],(v->size-position)*sizeof(CV_TYPE));    \
+        CV_MEMCPY(&v->v[position],&v_val,sizeof(CV_TYPE));   \
+        *((size_t*) &v->size)=v->size+1;    \
+        return position;    \
+    }   \
     item_cpy = v->item_cpy ? v->item_cpy : &(CV_TYPE_FCT(CV_TYPE,_default_item_cpy));   \
     if (v->v && item_to_insert>=v->v && item_to_insert<(v->v+v->size))  {   \
         CV_TYPE v_val;CV_MEMSET(&v_val,0,sizeof(CV_TYPE)); \
@@ -1298,9 +2471,9 @@ CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at)(CV_VECTOR_TYPE(CV
     CV_ASSERT(v && start_position<=v->size);    \
     if (num_items_to_insert==0) return start_position;  \
     if (v->v && (items_to_insert+num_items_to_insert)>=v->v && items_to_insert<(v->v+v->size))  {   \
-        v_val = (CV_TYPE*) cv_malloc(num_items_to_insert*sizeof(CV_TYPE));  \
+        v_val = (CV_TYPE*) cv_malloc_with(v->allocator,num_items_to_insert*sizeof(CV_TYPE));  \
         CV_CLEARING_ITEM_MEMORY_CHUNK3(CV_TYPE) \
-        if (v->item_cpy)	{   \
+        if (!CV_IS_POD && v->item_cpy)	{   \
             if (v->item_ctr)	{   \
                 for (i=0;i<num_items_to_insert;i++)   { \
                     v->item_ctr(&v_val[i]); \
@@ -1310,7 +2483,7 @@ CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at)(CV_VECTOR_TYPE(CV
             else	{for (i=0;i<num_items_to_insert;i++)   v->item_cpy(&v_val[i],&items_to_insert[i]);} \
         }   \
         else	{   \
-            if (v->item_ctr)	{for (i=0;i<num_items_to_insert;i++)   v->item_ctr(&v_val[i]);} \
+            if (!CV_IS_POD && v->item_ctr)	{for (i=0;i<num_items_to_insert;i++)   v->item_ctr(&v_val[i]);} \
             CV_MEMCPY(&v_val[0],&items_to_insert[0],num_items_to_insert*sizeof(CV_TYPE));  \
         }   \
         pitems = v_val; \
@@ -1321,7 +2494,7 @@ CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at)(CV_VECTOR_TYPE(CV
     CV_ASSERT(v->v);    \
     if (start_position<v->size) CV_MEMMOVE(&v->v[end_position],&v->v[start_position],(v->size-start_position)*sizeof(CV_TYPE));    \
     CV_CLEARING_ITEM_MEMORY_CHUNK4(CV_TYPE) \
-    if (v->item_cpy)	{   \
+    if (!CV_IS_POD && v->item_cpy)	{   \
         if (v->item_ctr)	{   \
             for (i=start_position;i<end_position;i++)   {   \
                 v->item_ctr(&v->v[i]);  \
@@ -1331,12 +2504,12 @@ CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_range_at)(CV_VECTOR_TYPE(CV
         else	{for (i=start_position;i<end_position;i++)   v->item_cpy(&v->v[i],&pitems[i-start_position]);}  \
     }   \
     else	{   \
-        if (v->item_ctr)	{for (i=start_position;i<end_position;i++)   v->item_ctr(&v->v[i]);}    \
+        if (!CV_IS_POD && v->item_ctr)	{for (i=start_position;i<end_position;i++)   v->item_ctr(&v->v[i]);}    \
         CV_MEMCPY(&v->v[start_position],&pitems[0],num_items_to_insert*sizeof(CV_TYPE));   \
     }   \
     if (v_val) {    \
-        if (v->item_dtr)	{for (i=0;i<num_items_to_insert;i++)   v->item_dtr(&v_val[i]);} \
-        cv_free(v_val);v_val=NULL;  \
+        if (!CV_IS_POD && v->item_dtr)	{for (i=0;i<num_items_to_insert;i++)   v->item_dtr(&v_val[i]);} \
+        cv_free_with(v->allocator,v_val);v_val=NULL;  \
     }   \
     *((size_t*) &v->size)=v->size+num_items_to_insert;  \
     return start_position;  \
@@ -1350,6 +2523,132 @@ CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted)(CV_VECTOR_TYPE(CV_T
     return position;    \
 }   \
 CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_by_val)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE item_to_insert,int* match,int insert_even_if_item_match)  {return CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted)(v,&item_to_insert,match,insert_even_if_item_match);}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_ptr_merge_sort)(const CV_TYPE** p,size_t num,const CV_TYPE** tmp,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*)) {   \
+    /* stable bottom-up merge sort of 'num' item pointers ('tmp' must store 'num' pointers) */ \
+    const CV_TYPE **src=p,**dst=tmp,**swp;const CV_TYPE* t;   \
+    size_t i,j,k,width; \
+    for (i=0;i<num;i+=8)    {   \
+        const size_t end = (num-i<8) ? num : (i+8);   \
+        for (j=i+1;j<end;j++)   {t=p[j];for (k=j;k>i && item_cmp(p[k-1],t)>0;k--) p[k]=p[k-1];p[k]=t;}  \
+    }   \
+    for (width=8;width<num;width*=2)    {   \
+        for (i=0;i<num;i+=2*width)  {   \
+            const size_t mid = (num-i<width) ? num : (i+width);   \
+            const size_t end = (num-i<2*width) ? num : (i+2*width);   \
+            size_t a=i,b=mid,o=i;   \
+            while (a<mid && b<end) dst[o++] = (item_cmp(src[b],src[a])<0) ? src[b++] : src[a++];    \
+            while (a<mid) dst[o++]=src[a++];    \
+            while (b<end) dst[o++]=src[b++];    \
+        }   \
+        swp=src;src=dst;dst=swp;    \
+    }   \
+    if (src!=p) CV_MEMCPY(p,src,num*sizeof(const CV_TYPE*));    \
+}   \
+CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_range)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* items_to_insert,size_t num_items_to_insert,int insert_even_if_item_match)  {   \
+    /* 'items_to_insert' can be unsorted. It returns the number of inserted items */  \
+    /* the new items are sorted (by pointer) and merged into 'v' in a single backward pass: every old item is moved once */ \
+    void (*item_cpy)(CV_TYPE*,const CV_TYPE*);  \
+    CV_TYPE* v_val=NULL;const CV_TYPE* pitems=items_to_insert;const CV_TYPE** p;  \
+    size_t i,num=0,last,position;int match;   \
+    CV_ASSERT(v && v->item_cmp && (items_to_insert || num_items_to_insert==0));    \
+    if (num_items_to_insert==0) return 0;   \
+    item_cpy = v->item_cpy ? v->item_cpy : &(CV_TYPE_FCT(CV_TYPE,_default_item_cpy));   \
+    if (v->v && (items_to_insert+num_items_to_insert)>=v->v && items_to_insert<(v->v+v->size))  {   \
+        /* the items are inside 'v': we copy them first */    \
+        v_val = (CV_TYPE*) cv_malloc_with(v->allocator,num_items_to_insert*sizeof(CV_TYPE));  \
+        CV_CLEARING_ITEM_MEMORY_CHUNK3(CV_TYPE) \
+        for (i=0;i<num_items_to_insert;i++) {if (v->item_ctr) v->item_ctr(&v_val[i]);item_cpy(&v_val[i],&items_to_insert[i]);}  \
+        pitems = v_val; \
+    }   \
+    p = (const CV_TYPE**) cv_malloc_with(v->allocator,2*num_items_to_insert*sizeof(const CV_TYPE*));  \
+    for (i=0;i<num_items_to_insert;i++) p[i]=&pitems[i];    \
+    CV_TYPE_FCT(CV_TYPE,_ptr_merge_sort)(p,num_items_to_insert,p+num_items_to_insert,v->item_cmp);    \
+    if (!insert_even_if_item_match) {   \
+        /* we keep only the first of equal new items, and only if it's not in 'v' already */  \
+        for (i=0;i<num_items_to_insert;i++) {   \
+            if (num>0 && v->item_cmp(p[i],p[num-1])==0) continue;   \
+            CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search)(v,p[i],&match);  \
+            if (!match) p[num++]=p[i];  \
+        }   \
+    }   \
+    else num=num_items_to_insert;   \
+    if (num>0)  {   \
+        if (v->size+num>v->capacity) CV_VECTOR_TYPE_FCT(CV_TYPE,_reserve)(v,v->size+num);  \
+        CV_ASSERT(v->v);    \
+        last = v->size;             /* old items in [0,last) are still in place */    \
+        position = v->size+num;     /* items in [position,v->size+num) are in their final place */    \
+        for (i=num;i-->0;)  {   \
+            /* we search the first old item in [0,last) greater than *p[i] (galloping backward from 'last', then with a binary search) */ \
+            size_t first=0,bound=last,step=1;   \
+            while (bound>0) {   \
+                const size_t j = (bound>step) ? (bound-step) : 0;   \
+                if (v->item_cmp(p[i],&v->v[j])<0) {bound=j;step*=2;}   \
+                else {first=j+1;break;} \
+            }   \
+            while (first<bound) {   \
+                const size_t mid = first+(bound-first)/2;   \
+                if (v->item_cmp(p[i],&v->v[mid])<0) bound=mid;  \
+                else first=mid+1;   \
+            }   \
+            if (first<last) {position-=last-first;CV_MEMMOVE(&v->v[position],&v->v[first],(last-first)*sizeof(CV_TYPE));last=first;}   \
+            --position; \
+            CV_CLEARING_ITEM_MEMORY_CHUNK2(CV_TYPE) \
+            if (v->item_ctr) v->item_ctr(&v->v[position]);  \
+            item_cpy(&v->v[position],p[i]); \
+        }   \
+        CV_ASSERT(position==last);  \
+        *((size_t*) &v->size)=v->size+num;  \
+    }   \
+    cv_free_with(v->allocator,p);   \
+    if (v_val) {    \
+        if (!CV_IS_POD && v->item_dtr)	{for (i=0;i<num_items_to_insert;i++)   v->item_dtr(&v_val[i]);} \
+        cv_free_with(v->allocator,v_val);v_val=NULL;  \
+    }   \
+    return num; \
+}   \
+CV_API void CV_TYPE_FCT(CV_TYPE,_sort_swap)(CV_TYPE* a,CV_TYPE* b) {CV_TYPE t;CV_MEMCPY(&t,a,sizeof(CV_TYPE));CV_MEMCPY(a,b,sizeof(CV_TYPE));CV_MEMCPY(b,&t,sizeof(CV_TYPE));}   \
+CV_SORT_FUNCTIONS_CHUNK(CV_TYPE,_fct,CV_SORT_CMP_FCT,CV_SORT_CMP_FCT_PARAM,CV_SORT_CMP_FCT_ARG)   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_sort)(CV_VECTOR_TYPE(CV_TYPE)* v)  {   \
+    /* it sorts 'v' in place using 'item_cmp' (the sort is not stable) */   \
+    size_t n;int log2_size=0;   \
+    CV_ASSERT(v && v->item_cmp);    \
+    if (v->size<2) return;  \
+    for (n=v->size;n>1;n>>=1) ++log2_size;  \
+    CV_TYPE_FCT(CV_TYPE,_pdq_sort_fct)(v->v,v->v+v->size,v->item_cmp,log2_size,1); \
+}   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_radix_sort_by_key)(CV_VECTOR_TYPE(CV_TYPE)* v,unsigned long long (*key_extractor)(const CV_TYPE*))  {   \
+    /* stable LSD radix sort (8 bits per pass) by the unsigned keys returned by 'key_extractor' ('item_cmp' is not used) */   \
+    /* keys are extracted once and sorted together with the items. Passes where all the items share the same digit are skipped */    \
+    const size_t n = v ? v->size : 0;   \
+    size_t counts[8][256];size_t i,sum;int d;   \
+    unsigned long long *keys,*keys2,*keys_mem,*ktmp;CV_TYPE *items,*items2,*items_mem,*itmp;  \
+    CV_ASSERT(v && key_extractor);  \
+    if (n<2) return;    \
+    keys = keys_mem = (unsigned long long*) cv_malloc_with(v->allocator,2*n*sizeof(unsigned long long)); \
+    keys2 = keys+n; \
+    items = v->v;items2 = items_mem = (CV_TYPE*) cv_malloc_with(v->allocator,n*sizeof(CV_TYPE)); \
+    CV_MEMSET(counts,0,sizeof(counts)); \
+    for (i=0;i<n;i++)   {   \
+        /* all the 8 histograms are built in a single pass */   \
+        const unsigned long long k = key_extractor(&items[i]);keys[i] = k;    \
+        for (d=0;d<8;d++) ++counts[d][(size_t)((k>>(8*d))&0xFF)];   \
+    }   \
+    for (d=0;d<8;d++)   {   \
+        size_t* c = counts[d];  \
+        if (c[(size_t)((keys[0]>>(8*d))&0xFF)]==n) continue;   /* all the items have the same digit */   \
+        for (i=0,sum=0;i<256;i++)    {const size_t t=c[i];c[i]=sum;sum+=t;}    \
+        for (i=0;i<n;i++)   {   \
+            const size_t j = c[(size_t)((keys[i]>>(8*d))&0xFF)]++;  \
+            keys2[j] = keys[i]; \
+            CV_MEMCPY(&items2[j],&items[i],sizeof(CV_TYPE));    \
+        }   \
+        ktmp=keys;keys=keys2;keys2=ktmp;    \
+        itmp=items;items=items2;items2=itmp;    \
+    }   \
+    if (items!=v->v) CV_MEMCPY(v->v,items,n*sizeof(CV_TYPE));  \
+    cv_free_with(v->allocator,items_mem);   \
+    cv_free_with(v->allocator,keys_mem);    \
+}   \
 CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_at)(CV_VECTOR_TYPE(CV_TYPE)* v,size_t position)  { \
     /* position is in [0,num_items) */  \
     int removal_ok; \
@@ -1357,7 +2656,7 @@ CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_at)(CV_VECTOR_TYPE(CV_TYPE)* v
 	removal_ok = (position<v->size) ? 1 : 0;    \
     CV_ASSERT(removal_ok);	/* error: position>=v->size */  \
 	if (removal_ok)	{   \
-        if (v->item_dtr) v->item_dtr(&v->v[position]);  \
+        if (!CV_IS_POD && v->item_dtr) v->item_dtr(&v->v[position]);  \
         CV_MEMMOVE(&v->v[position],&v->v[position+1],(v->size-position-1)*sizeof(CV_TYPE));    \
         *((size_t*) &v->size)=v->size-1;    \
     }   \
@@ -1371,7 +2670,7 @@ CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_remove_range_at)(CV_VECTOR_TYPE(CV_TY
     removal_ok = end_item_position<=v->size ? 1 : 0;    \
     CV_ASSERT(removal_ok);	/* error: start_item_position + num_items_to_remove > v.size */	    \
     if (removal_ok && num_items_to_remove>0)	{   \
-        if (v->item_dtr) {for (i=start_item_position;i<end_item_position;i++) v->item_dtr(&v->v[i]);}   \
+        if (!CV_IS_POD && v->item_dtr) {for (i=start_item_position;i<end_item_position;i++) v->item_dtr(&v->v[i]);}   \
         if (end_item_position<v->size) CV_MEMMOVE(&v->v[start_item_position],&v->v[end_item_position],(v->size-end_item_position)*sizeof(CV_TYPE));    \
         *((size_t*) &v->size)=v->size-num_items_to_remove;  \
     }   \
@@ -1404,12 +2703,22 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy)(CV_VECTOR_TYPE(CV_TYPE)* a,cons
               "One of the two vectors has not been properly initialized");    \
     CV_VECTOR_TYPE_FCT(CV_TYPE,_resize)(a,b->size); \
     CV_ASSERT(((a->v && b->v) || (!a->v && !b->v)) && a->size==b->size);  \
-    if (!a->item_cpy)   {CV_MEMCPY(&a->v[0],&b->v[0],a->size*sizeof(CV_TYPE));}    \
+    if (CV_IS_POD || !a->item_cpy)   {CV_MEMCPY(&a->v[0],&b->v[0],a->size*sizeof(CV_TYPE));}    \
     else    {for (i=0;i<a->size;i++) a->item_cpy(&a->v[i],&b->v[i]);}   \
 }   \
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_shrink_to_fit)(CV_VECTOR_TYPE(CV_TYPE)* v)	{   \
+    if (v && v->allocator && v->allocator->shrink && v->size>0 && v->size<v->capacity)   {   \
+        /* in-place trimming (e.g. 'cvh_vm_allocator_t' just releases the tail pages) */   \
+        void* p = v->allocator->shrink(v->allocator->user_data,v->v,v->size*sizeof(CV_TYPE),v->capacity*sizeof(CV_TYPE));  \
+        if (p)  {   \
+            CVH_ALLOC_STATS_RECORD(CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)(),CV_XSTR(CV_VECTOR_TYPE(CV_TYPE)),v,sizeof(CV_TYPE),v->size,v->capacity,v->size);   \
+            v->v=(CV_TYPE*)p;*((size_t*)&v->capacity)=v->size;  \
+            return; \
+        }   \
+    }   \
     if (v)	{   \
-        CV_VECTOR_TYPE(CV_TYPE) o = CV_VECTOR_TYPE_FCT(CV_TYPE,_create_with)(v->item_cmp,v->item_ctr,v->item_dtr,v->item_cpy,v->item_serialize,v->item_deserialize);  \
+        CV_VECTOR_TYPE(CV_TYPE) o;  \
+        CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with_allocator)(&o,v->item_cmp,v->item_ctr,v->item_dtr,v->item_cpy,v->item_serialize,v->item_deserialize,v->allocator);  \
         CV_VECTOR_TYPE_FCT(CV_TYPE,_cpy)(&o,v); /* now 'o' is 'v' trimmed */    \
         CV_VECTOR_TYPE_FCT(CV_TYPE,_free)(v);   \
         CV_VECTOR_TYPE_FCT(CV_TYPE,_swap)(&o,v);    \
@@ -1449,9 +2758,7 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_serialize)(const CV_VECTOR_TYPE(CV_T
     if (v->item_serialize)  {size_t i;for(i=0;i<v->size;i++) v->item_serialize(&v->v[i],serializer);} /* serializer->size is incremented by 'v->item_serialize' */ \
     else {  \
         const size_t v_size_in_bytes = v->size*sizeof(CV_TYPE);   \
-        cvh_serializer_reserve(serializer,serializer->size + v_size_in_bytes); /* space reserved for all the items (v_size_in_bytes) */  \
-        CV_ASSERT(serializer->v);   \
-        CV_MEMCPY(&serializer->v[serializer->size],v->v,v_size_in_bytes);serializer->size+=v_size_in_bytes; /* serializer->size must be incremented */ \
+        cvh_serializer_write_bytes(serializer,v->v,v_size_in_bytes); /* in streaming mode, big chunks are written directly to the stream */  \
     } \
 }   \
 CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize)(CV_VECTOR_TYPE(CV_TYPE)* v,const cvh_serializer_t* deserializer)  {    \
@@ -1459,7 +2766,7 @@ CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize)(CV_VECTOR_TYPE(CV_TYPE)*
     const size_t size_t_size_in_bytes = sizeof(size_t); \
     size_t vsize;int check;   \
     CV_ASSERT(v && deserializer);  \
-    check = (deserializer->offset+size_t_size_in_bytes<=deserializer->size);    \
+    check = cvh_serializer_fill(deserializer,size_t_size_in_bytes); /* in streaming mode, it refills the buffer from the stream if needed */ \
     CV_ASSERT(check && "missing space to deserialize 'size_t_size_in_bytes'");  /* otherwise deserialization will fail */ \
     if (!check) return 0; /* but when we compile with NDEBUG, or CV_NO_ASSERT, the caller must be notified of the failure */  \
     vsize = *((size_t*) &deserializer->v[deserializer->offset]);*((size_t*) &deserializer->offset)+=size_t_size_in_bytes; /* 'vsize' read, 'deserializer->offset' incremented */ \
@@ -1468,19 +2775,42 @@ CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize)(CV_VECTOR_TYPE(CV_TYPE)*
     if (v->item_deserialize)  {size_t i;for(i=0;i<vsize;i++) {if (!v->item_deserialize(&v->v[i],deserializer)) return 0;}} /* 'deserializer->offset' is incremented by 'v->item_deserialize' */ \
     else {  \
         size_t v_size_in_bytes = vsize*sizeof(CV_TYPE);   \
-        check = deserializer->offset+v_size_in_bytes<=deserializer->size;   \
-        CV_ASSERT(check && "missing space to deserialize all items using CV_MEMCPY");  /* otherwise deserialization will fail */   \
+        check = cvh_serializer_read_bytes(deserializer,v->v,v_size_in_bytes); /* 'deserializer->offset' is incremented by cvh_serializer_read_bytes(...) */ \
+        CV_ASSERT(check && "missing space to deserialize all items");  /* otherwise deserialization will fail */   \
         if (!check) return 0;\
-        CV_MEMCPY(v->v,&deserializer->v[deserializer->offset],v_size_in_bytes); \
-        *((size_t*) &deserializer->offset)+=v_size_in_bytes; /* 'deserializer->offset' must be incremented */ \
     } \
     return 1; /* we must return 1 on success */  \
+}   \
+/* Same as cv_xxx_deserialize(...), but when 'deserializer' is mapped (see cvh_serializer_init_mapped(...)) and 'v->item_deserialize' is NULL,  */    \
+/* 'v->v' points directly into the mapped file (zero-copy) and 'v->allocator' is replaced by the 'cvh_mmap_t::allocator'.  */    \
+/* The vector can be used and modified as usual (changes are never written back to the file, and the items are copied to the heap when it grows), */    \
+/* but the 'cvh_mmap_t' must outlive it. In all the other cases (or when the items are not aligned inside the file), it just calls cv_xxx_deserialize(...) */  \
+CV_API_DEF int CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize_mapped)(CV_VECTOR_TYPE(CV_TYPE)* v,const cvh_serializer_t* deserializer)  {    \
+    const cvh_mmap_t* m = (deserializer->stream && !deserializer->stream_read && !deserializer->stream_write) ? (const cvh_mmap_t*) deserializer->stream : NULL;   \
+    const size_t item_align = CV_ALIGNOF(CV_TYPE);   \
+    const size_t items_offset = deserializer->offset+sizeof(size_t);   \
+    size_t vsize;int check;   \
+    CV_ASSERT(v && deserializer);  \
+    if (!m || v->item_deserialize || items_offset>deserializer->size || ((size_t)(&deserializer->v[items_offset]))%item_align!=0)  \
+        return CV_VECTOR_TYPE_FCT(CV_TYPE,_deserialize)(v,deserializer);   \
+    vsize = *((const size_t*) &deserializer->v[deserializer->offset]);   \
+    check = (vsize<=(deserializer->size-items_offset)/sizeof(CV_TYPE));   \
+    CV_ASSERT(check && "missing space to deserialize all items");  /* otherwise deserialization will fail */   \
+    if (!check) return 0;\
+    CV_VECTOR_TYPE_FCT(CV_TYPE,_free)(v);   \
+    *((const cvh_allocator_t**)&v->allocator)=&m->allocator;   \
+    v->v = vsize>0 ? (CV_TYPE*) &deserializer->v[items_offset] : NULL;   \
+    *((size_t*) &v->size)=*((size_t*) &v->capacity)=vsize;   \
+    if (vsize>0) {CVH_ALLOC_STATS_RECORD(CV_VECTOR_TYPE_FCT(CV_TYPE,_alloc_stats)(),CV_XSTR(CV_VECTOR_TYPE(CV_TYPE)),v,sizeof(CV_TYPE),0,0,vsize);}   /* counted as an allocation (of mapped memory) */  \
+    *((size_t*) &deserializer->offset)=items_offset+vsize*sizeof(CV_TYPE);  \
+    return 1;   \
 }   \
     \
     \
 /* create methods */    \
-CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*)    \
-                                                        ,void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*))	{   \
+/* 'allocator' (optional) must outlive the vector: all the vector memory is allocated and released through it */  \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with_allocator)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*)    \
+                                                        ,void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*),const cvh_allocator_t* allocator)	{   \
     typedef void (*item_ctr_dtr_type)(CV_TYPE*);    \
     typedef void (*item_cpy_type)(CV_TYPE*,const CV_TYPE*); \
     typedef int (*item_cmp_type)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*);    \
@@ -1488,6 +2818,7 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with)(CV_VECTOR_TYPE(CV_TYPE)*
     typedef int (*item_deserialize_type)(CV_TYPE*,const cvh_serializer_t*); \
     CV_FAKE_MEMBER_FUNCTIONS_DEF_CHUNK0(CV_TYPE)    \
     CV_ASSERT(v);   \
+    CV_ASSERT((!CV_IS_POD || (!item_ctr && !item_dtr && !item_cpy)) && "CV_DEFINE_POD(...) vectors can't have item_ctr, item_dtr or item_cpy");  \
     CV_MEMSET(v,0,sizeof(CV_VECTOR_TYPE(CV_TYPE))); \
     *((item_ctr_dtr_type*)&v->item_ctr)=item_ctr;   \
     *((item_ctr_dtr_type*)&v->item_dtr)=item_dtr;   \
@@ -1495,8 +2826,18 @@ CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with)(CV_VECTOR_TYPE(CV_TYPE)*
     *((item_cmp_type*)&v->item_cmp)=item_cmp;   \
     *((item_serialize_type*)&v->item_serialize)=item_serialize;   \
     *((item_deserialize_type*)&v->item_deserialize)=item_deserialize;   \
+    *((const cvh_allocator_t**)&v->allocator)=allocator;   \
     CV_FAKE_MEMBER_FUNCTIONS_DEF_CHUNK1(CV_TYPE)   \
 }   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*)    \
+                                                        ,void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*))	{   \
+    CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with_allocator)(v,item_cmp,item_ctr,item_dtr,item_cpy,item_serialize,item_deserialize,NULL);   \
+}   \
+/* 'policy' (optional) must outlive the vector. It's not swapped by cv_xxx_swap(...) (it belongs to the instance, not to its memory) */  \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_set_growth_policy)(CV_VECTOR_TYPE(CV_TYPE)* v,const cvh_growth_policy_t* policy)	{   \
+    CV_ASSERT(v);   \
+    *((const cvh_growth_policy_t**)&v->growth_policy)=policy;   \
+}   \
 CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_init)(CV_VECTOR_TYPE(CV_TYPE)* v,int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*))  {CV_VECTOR_TYPE_FCT(CV_TYPE,_init_with)(v,item_cmp,NULL,NULL,NULL,NULL,NULL);}  \
 CV_API_DEF CV_VECTOR_TYPE(CV_TYPE) CV_VECTOR_TYPE_FCT(CV_TYPE,_create_with)(int (*item_cmp)(const CV_CMP_TYPE(CV_TYPE)*,const CV_CMP_TYPE(CV_TYPE)*),void (*item_ctr)(CV_TYPE*),void (*item_dtr)(CV_TYPE*),void (*item_cpy)(CV_TYPE*,const CV_TYPE*),void (*item_serialize)(const CV_TYPE*,cvh_serializer_t*),int (*item_deserialize)(CV_TYPE*,const cvh_serializer_t*))    {   \
     CV_VECTOR_TYPE(CV_TYPE) v; /* = CV_ZERO_INIT; */  \
@@ -1505,12 +2846,73 @@ CV_API_DEF CV_VECTOR_TYPE(CV_TYPE) CV_VECTOR_TYPE_FCT(CV_TYPE,_create)(int (*ite
     CV_VECTOR_TYPE(CV_TYPE) v; /* = CV_ZERO_INIT; */  \
     CV_VECTOR_TYPE_FCT(CV_TYPE,_init)(&v,item_cmp);return v;}   \
     CV_CPP_DEFINITION_CHUNK0(CV_TYPE)   \
-    CV_CPP_DEFINITION_CHUNK1(CV_TYPE)
+    CV_CPP_DEFINITION_CHUNK1(CV_TYPE)   \
+    CV_PARALLEL_DEFINITION_CHUNK(CV_TYPE)
+
 
+#define CV_DEFINE(CV_TYPE)  CV_DEFINITION_CHUNK(CV_TYPE,0)
+/* Like CV_DEFINE(CV_TYPE), for trivially copyable types only (item_ctr, item_dtr and item_cpy must be NULL): items are
+   copied with plain assignments or memcpy, and no callback is ever tested, so cv_xxx_push_back(...) on small structs is just a store */
+#define CV_DEFINE_POD(CV_TYPE)  CV_DEFINITION_CHUNK(CV_TYPE,1)
 
 #define CV_DECLARE_AND_DEFINE(CV_TYPE)               \
     CV_DECLARE(CV_TYPE)                                  \
     CV_DEFINE(CV_TYPE)
+#define CV_DECLARE_AND_DEFINE_POD(CV_TYPE)           \
+    CV_DECLARE(CV_TYPE)                                  \
+    CV_DEFINE_POD(CV_TYPE)
+
+
+/* Optional: cv_xxx_binary_search_inline(...), cv_xxx_insert_sorted_inline(...) and cv_xxx_sort_inline(...) use the scoped definition
+   CV_CMP_INLINE(a,b) (two 'const CV_TYPE*', with no side effects) instead of the 'item_cmp' function pointer (that is not used at all).
+   CV_CMP_INLINE(a,b) must be defined where CV_DEFINE_CMP_INLINE(CV_TYPE) is used, e.g.:
+   #define CV_CMP_INLINE(a,b) ((*(a)>*(b))-(*(a)<*(b)))
+   CV_DECLARE_AND_DEFINE_CMP_INLINE(int)  // after CV_DECLARE_AND_DEFINE(int)
+   #undef CV_CMP_INLINE
+*/
+#define CV_DECLARE_CMP_INLINE(CV_TYPE)  \
+CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search_inline)(const CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_search,int* match); \
+CV_API_DEC size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_inline)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_insert,int* match,int insert_even_if_item_match); \
+CV_API_DEC void CV_VECTOR_TYPE_FCT(CV_TYPE,_sort_inline)(CV_VECTOR_TYPE(CV_TYPE)* v);
+
+#define CV_DEFINE_CMP_INLINE(CV_TYPE)   \
+CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search_inline)(const CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_search,int* match)  {   \
+    /* branchless lower bound: it returns the position of the first item >= item_to_search (v->size if there's none) */  \
+    const CV_TYPE* base;size_t n,position;  \
+    CV_ASSERT(v);   \
+    if (match) *match=0;    \
+    if (v->size==0) return 0;   \
+    for (base=v->v,n=v->size;n>1;)  {   \
+        const size_t half = n/2;    \
+        CV_PREFETCH(base+half/2);CV_PREFETCH(base+(half+half/2));  /* the two possible next probes */  \
+        base = (CV_CMP_INLINE(&base[half],item_to_search)<0) ? base+half : base;  \
+        n -= half;  \
+    }   \
+    position = (size_t)(base-v->v) + (CV_CMP_INLINE(base,item_to_search)<0 ? 1 : 0);   \
+    if (match && position<v->size && CV_CMP_INLINE(&v->v[position],item_to_search)==0) *match=1;   \
+    return position;    \
+}   \
+CV_API_DEF size_t CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_sorted_inline)(CV_VECTOR_TYPE(CV_TYPE)* v,const CV_TYPE* item_to_insert,int* match,int insert_even_if_item_match)  {   \
+    int my_match = 0;size_t position;   \
+    position = CV_VECTOR_TYPE_FCT(CV_TYPE,_binary_search_inline)(v,item_to_insert,&my_match);  \
+    if (match) *match = my_match;   \
+    if (my_match && !insert_even_if_item_match) return position;    \
+    CV_VECTOR_TYPE_FCT(CV_TYPE,_insert_at)(v,item_to_insert,position);  \
+    return position;    \
+}   \
+CV_SORT_FUNCTIONS_CHUNK(CV_TYPE,_inline,CV_CMP_INLINE,CV_SORT_CMP_INLINE_PARAM,CV_SORT_CMP_INLINE_ARG)   \
+CV_API_DEF void CV_VECTOR_TYPE_FCT(CV_TYPE,_sort_inline)(CV_VECTOR_TYPE(CV_TYPE)* v)  {   \
+    /* like cv_xxx_sort(...), but using CV_CMP_INLINE(a,b) */  \
+    size_t n;int log2_size=0;   \
+    CV_ASSERT(v);   \
+    if (v->size<2) return;  \
+    for (n=v->size;n>1;n>>=1) ++log2_size;  \
+    CV_TYPE_FCT(CV_TYPE,_pdq_sort_inline)(v->v,v->v+v->size,log2_size,1); \
+}
+
+#define CV_DECLARE_AND_DEFINE_CMP_INLINE(CV_TYPE)   \
+    CV_DECLARE_CMP_INLINE(CV_TYPE)  \
+    CV_DEFINE_CMP_INLINE(CV_TYPE)
 
 
 /* ------------------------------------------------- */
@@ -45,6 +45,10 @@ freely, subject to the following restrictions:
    CV_NO_ASSERT
    CV_NO_STDIO
    CV_NO_STDLIB
+   CV_NO_MMAP                           // it disables mmap(...) in cvh_mmap_open(...), that just loads the whole file in this case (mmap(...) is used by default on unix-like systems only).
+   CVH_VM_HUGE_PAGE_SIZE                // huge page size (in bytes) used by 'cvh_vm_allocator_t' when 'use_huge_pages' is true (defaults to 2 MB).
+   CVH_SERIALIZER_STREAM_BUFFER_SIZE    // default buffer size (in bytes) of a streaming cvh_serializer_t (see cvh_serializer_init_sink(...) and cvh_serializer_init_source(...)). Defaults to 65536.
+   CV_ENABLE_ALLOC_STATS                // it adds allocation counters (cvector_get_alloc_stats(...), cvh_serializer_get_alloc_stats(...), cvh_string_get_alloc_stats(...)) and an allocation callback (cvh_set_alloc_callback(...)).
    CV_API_INL                           // this simply defines the 'inline' keyword syntax (defaults to __inline)
    CV_API                               // used always when CV_ENABLE_DECLARATION_AND_DEFINITION is not defined and in some global or private functions otherwise
    CV_API_DEC                           // defaults to CV_API, or to 'CV_API_INL extern' if CV_ENABLE_DECLARATION_AND_DEFINITION is defined
@@ -56,10 +60,49 @@ freely, subject to the following restrictions:
 #ifndef C_VECTOR_TYPE_UNSAFE_H
 #define C_VECTOR_TYPE_UNSAFE_H
 
-#define C_VECTOR_TYPE_UNSAFE_VERSION            "1.09 rev3"
-#define C_VECTOR_TYPE_UNSAFE_VERSION_NUM        0109
+#define C_VECTOR_TYPE_UNSAFE_VERSION            "1.16"
+#define C_VECTOR_TYPE_UNSAFE_VERSION_NUM        0116
 
 /* HISTORY
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 116
+   -> Added 'cvh_vm_allocator_t' (shared with "c_vector.h"): a 'cvh_allocator_t' for very large vectors, whose buffers are anonymous mmap(...) regions
+      that grow with mremap(...) on Linux (no copy), optionally rounded up to (aligned) huge pages and advised with MADV_HUGEPAGE. Usage:
+      cvh_vm_allocator_init(&a,use_huge_pages), cvector_init_with_allocator(&v,...,&a.allocator) and cvh_vm_allocator_close(&a) at the end.
+   -> Added the optional 'cvh_allocator_t::shrink' callback: when present, cvector_shrink_to_fit(...) trims the buffer in place through it (no copy).
+
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 115
+   -> Added 'cvh_growth_policy_t' (shared with "c_vector.h" and "c_hashtable.h"): an optional per-instance growth policy (geometric, fixed chunk or
+      page-aligned) used by cvector_reserve(...) instead of the default 1.5x growth. It's set with cvector_set_growth_policy(v,&policy),
+      cvh_serializer_set_growth_policy(...) and cvh_string_set_growth_policy(...), and it must outlive the container.
+
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 114
+   -> Added optional allocation telemetry (global definition CV_ENABLE_ALLOC_STATS), shared with "c_vector.h": 'cvector' (all instances together), 'cvh_serializer_t'
+      and 'cvh_string_t' keep a 'cvh_alloc_stats_t' (allocations, growths, releases, bytes moved by the growths, current and peak capacity, unused capacity of the
+      released buffers), read and reset with cvector_get_alloc_stats(...)/cvector_reset_alloc_stats() and similar functions, and cvh_set_alloc_callback(...)
+      reports every single event. Counters and callback are static variables (per translation unit, and not thread-safe).
+
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 113
+   -> Added cvector_radix_sort(v,key_offset,key_width): a stable LSD radix sort of the items by an unsigned integer key of 'key_width' bytes (1 to 8,
+      in native byte order) stored 'key_offset' bytes inside each item. 'item_cmp' is not used, and the scratch buffer comes from the vector allocator.
+
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 112
+   -> Added zero-copy loading of POD vectors: cvh_mmap_open(...) maps a whole file in memory (copy-on-write), cvh_serializer_init_mapped(...)
+      makes a read-only deserializer of it, and cvector_deserialize_mapped(...) makes 'v->v' point directly into the mapped file
+      when 'item_deserialize' is NULL (and the items are aligned inside the file). The CV_NO_MMAP definition disables mmap(...).
+
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 111
+   -> Added a streaming mode to 'cvh_serializer_t': cvh_serializer_init_sink(...) and cvh_serializer_init_source(...) take a write/read callback
+      and a stream pointer, and use a fixed buffer (CVH_SERIALIZER_STREAM_BUFFER_SIZE bytes by default) that is flushed to (or refilled from) the stream.
+      cvh_serializer_init_file_sink(...) and cvh_serializer_init_file_source(...) wrap a FILE*.
+   -> Added cvh_serializer_flush(...), cvh_serializer_fill(...), cvh_serializer_write_bytes(...) and cvh_serializer_read_bytes(...),
+      now used by cvector_serialize(...)/cvector_deserialize(...) and cvh_string_serialize(...)/cvh_string_deserialize(...).
+
+   C_VECTOR_TYPE_UNSAFE_VERSION_NUM 110
+   -> Added the 'cvh_allocator_t' struct (alloc, realloc, free and a user_data pointer) and cvector_init_with_allocator(...),
+      that stores an optional per-instance allocator in the 'cvector::allocator' field. When it's NULL, CV_MALLOC/CV_REALLOC/CV_FREE are used as before.
+      cvh_allocator_t::realloc and cvh_allocator_t::free can be NULL, so that a bump arena just needs 'alloc' (please see "c_vector_main.c").
+   -> cvector_swap(...) and the c++ move ctr/assignment now swap/move the allocator together with the memory it owns.
+
    C_VECTOR_TYPE_UNSAFE_VERSION_NUM 109 rev2
    -> -> added the CV_SIZE_T_FORMATTING definition (internal usage).
 
@@ -191,6 +234,21 @@ freely, subject to the following restrictions:
 
 #include <string.h> /*memcpy,memmove,memset*/
 
+#if (!defined(CV_NO_MMAP) && !defined(CV_HAS_MMAP) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))))
+#   define CV_HAS_MMAP  /* internal usage */
+#endif
+#ifdef CV_HAS_MMAP
+#   include <sys/types.h>
+#   include <sys/stat.h>    /* fstat */
+#   include <sys/mman.h>    /* mmap, munmap */
+#   include <fcntl.h>       /* open */
+#   include <unistd.h>      /* close */
+#endif
+
+#ifndef CVH_SERIALIZER_STREAM_BUFFER_SIZE
+#   define CVH_SERIALIZER_STREAM_BUFFER_SIZE    (65536)
+#endif
+
 
 #ifndef CV_API_INL  /* __inline, _inline or inline (C99) */
 #define CV_API_INL __inline
@@ -268,6 +326,116 @@ freely, subject to the following restrictions:
 #endif
 #endif /*CV_MEMCPY */
 
+#ifndef CVH_ALLOCATOR_GUARD_
+#define CVH_ALLOCATOR_GUARD_
+/* cvh_allocator_t is an optional per-instance allocator (see cvector_init_with_allocator(...)). 'old_size' is passed to 'realloc' (and must be copied) so that bump arenas can implement it */
+typedef struct cvh_allocator_t {
+    void* (*alloc)(void* user_data,size_t size);
+    void* (*realloc)(void* user_data,void* ptr,size_t new_size,size_t old_size); /* optional (can be NULL): alloc + memcpy + free is used instead */
+    void (*free)(void* user_data,void* ptr);                                     /* optional (can be NULL): e.g. for bump arenas that are released all at once */
+    void* user_data;
+    void* (*shrink)(void* user_data,void* ptr,size_t new_size,size_t old_size);  /* optional (can be NULL): in-place trimming used by shrink_to_fit (instead of a copy) */
+} cvh_allocator_t;
+#endif /* CVH_ALLOCATOR_GUARD_ */
+
+#ifndef CVH_GROWTH_POLICY_GUARD_
+#define CVH_GROWTH_POLICY_GUARD_
+/* cvh_growth_policy_t is an optional per-instance growth policy (see cv_xxx_set_growth_policy(...)), shared by all the containers of
+   "c_vector.h", "c_vector_type_unsafe.h" and "c_hashtable.h". When it's NULL, every container keeps its default growth (about 1.5x).
+   A policy can be shared by many containers, and it must outlive them */
+#define CVH_GROWTH_GEOMETRIC      0   /* capacity*factor_num/factor_den (e.g. 2/1 doubles the capacity) */
+#define CVH_GROWTH_FIXED_CHUNK    1   /* capacity plus 'chunk_bytes' (at least one item): linear growth and bounded unused memory, for very big containers */
+#define CVH_GROWTH_PAGE_ALIGNED   2   /* like CVH_GROWTH_GEOMETRIC, but the buffer size is rounded up to a multiple of 'chunk_bytes' (e.g. 4 KB pages or 2 MB huge pages) */
+typedef struct cvh_growth_policy_t {
+    int type;                       /* one of the CVH_GROWTH_xxx definitions */
+    size_t factor_num,factor_den;   /* CVH_GROWTH_GEOMETRIC and CVH_GROWTH_PAGE_ALIGNED only (when not factor_num>factor_den>0, 3/2 is used) */
+    size_t chunk_bytes;             /* CVH_GROWTH_FIXED_CHUNK and CVH_GROWTH_PAGE_ALIGNED only */
+} cvh_growth_policy_t;
+CV_API cvh_growth_policy_t cvh_growth_policy_geometric(size_t factor_num,size_t factor_den)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_GEOMETRIC;p.factor_num=factor_num;p.factor_den=factor_den;p.chunk_bytes=0;return p;
+}
+CV_API cvh_growth_policy_t cvh_growth_policy_fixed_chunk(size_t chunk_bytes)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_FIXED_CHUNK;p.factor_num=p.factor_den=0;p.chunk_bytes=chunk_bytes;return p;
+}
+CV_API cvh_growth_policy_t cvh_growth_policy_page_aligned(size_t factor_num,size_t factor_den,size_t page_bytes)    {
+    cvh_growth_policy_t p;p.type=CVH_GROWTH_PAGE_ALIGNED;p.factor_num=factor_num;p.factor_den=factor_den;p.chunk_bytes=page_bytes;return p;
+}
+/* it returns the new capacity (in items of 'item_size' bytes) of a container of 'capacity' items that needs at least 'min_capacity' items */
+CV_API size_t cvh_growth_policy_next_capacity(const cvh_growth_policy_t* p,size_t capacity,size_t min_capacity,size_t item_size)  {
+    size_t c;
+    if (min_capacity<=capacity) return capacity;
+    if (item_size==0) item_size=1;
+    if (p->type==CVH_GROWTH_FIXED_CHUNK) c = capacity+(p->chunk_bytes>item_size ? p->chunk_bytes/item_size : 1);
+    else if (p->factor_den>0 && p->factor_num>p->factor_den) c = capacity/p->factor_den*p->factor_num+(capacity%p->factor_den)*p->factor_num/p->factor_den;
+    else c = capacity+capacity/2;
+    if (c<min_capacity) c=min_capacity;
+    if (p->type==CVH_GROWTH_PAGE_ALIGNED && p->chunk_bytes>0) c = (c*item_size+p->chunk_bytes-1)/p->chunk_bytes*p->chunk_bytes/item_size;
+    return c;
+}
+#endif /* CVH_GROWTH_POLICY_GUARD_ */
+
+#ifndef CVH_ALLOC_STATS_GUARD_
+#define CVH_ALLOC_STATS_GUARD_
+#ifdef CV_ENABLE_ALLOC_STATS
+/* allocation and growth telemetry (CV_ENABLE_ALLOC_STATS only). Every container type has its own counters (see cv_xxx_get_alloc_stats(...),
+   cvector_get_alloc_stats(...), cvh_serializer_get_alloc_stats(...) and cvh_string_get_alloc_stats(...)), and every (re)allocation or release
+   is also reported to the optional callback set by cvh_set_alloc_callback(...).
+   Counters and callback are plain static variables (per translation unit, and not thread-safe) */
+typedef struct cvh_alloc_stats_t {
+    size_t num_allocs;              /* first allocations (from zero capacity) */
+    size_t num_reallocs;            /* growths of an existing buffer */
+    size_t num_frees;
+    size_t num_bytes_copied;        /* bytes of live items moved by the growths (an upper bound: realloc(...) may grow in place) */
+    size_t capacity_bytes;          /* currently allocated bytes */
+    size_t peak_capacity_bytes;     /* max value of 'capacity_bytes' */
+    size_t wasted_bytes;            /* unused capacity of the released buffers (sum of (capacity-size)*item_size) */
+} cvh_alloc_stats_t;
+/* 'new_capacity' is 0 when the buffer is released. Capacities are in items of 'item_size' bytes */
+typedef struct cvh_alloc_event_t {
+    const char* type_name;          /* e.g. "cv_int", "cvector", "cvh_serializer_t", "cvh_string_t" */
+    const void* container;
+    size_t item_size,size,old_capacity,new_capacity;
+} cvh_alloc_event_t;
+typedef void (*cvh_alloc_callback_t)(const cvh_alloc_event_t* event,void* user_data);
+typedef struct cvh_alloc_stats_state_t {
+    cvh_alloc_callback_t callback;
+    void* user_data;
+    cvh_alloc_stats_t serializer,string;
+} cvh_alloc_stats_state_t;
+CV_API cvh_alloc_stats_state_t* cvh_alloc_stats_state(void) {static cvh_alloc_stats_state_t s;return &s;}
+/* 'callback' can be NULL (the counters work anyway) */
+CV_API void cvh_set_alloc_callback(cvh_alloc_callback_t callback,void* user_data)  {
+    cvh_alloc_stats_state_t* st = cvh_alloc_stats_state();
+    st->callback = callback;st->user_data = user_data;
+}
+CV_API void cvh_alloc_stats_record(cvh_alloc_stats_t* s,const char* type_name,const void* container,size_t item_size,size_t size,size_t old_capacity,size_t new_capacity)  {
+    const cvh_alloc_stats_state_t* st = cvh_alloc_stats_state();
+    const size_t old_bytes = old_capacity*item_size, new_bytes = new_capacity*item_size;
+    if (new_capacity==0)    {
+        ++s->num_frees;
+        if (old_capacity>size) s->wasted_bytes+=(old_capacity-size)*item_size;
+    }
+    else if (old_capacity==0) ++s->num_allocs;
+    else {++s->num_reallocs;s->num_bytes_copied+=size*item_size;}
+    s->capacity_bytes = s->capacity_bytes+new_bytes>old_bytes ? s->capacity_bytes+new_bytes-old_bytes : 0;
+    if (s->peak_capacity_bytes<s->capacity_bytes) s->peak_capacity_bytes=s->capacity_bytes;
+    if (st->callback)   {
+        cvh_alloc_event_t e;
+        e.type_name=type_name;e.container=container;e.item_size=item_size;
+        e.size=size;e.old_capacity=old_capacity;e.new_capacity=new_capacity;
+        st->callback(&e,st->user_data);
+    }
+}
+CV_API void cvh_serializer_get_alloc_stats(cvh_alloc_stats_t* stats)   {*stats = cvh_alloc_stats_state()->serializer;}
+CV_API void cvh_serializer_reset_alloc_stats(void)  {const cvh_alloc_stats_t zero = {0,0,0,0,0,0,0};cvh_alloc_stats_state()->serializer = zero;}
+CV_API void cvh_string_get_alloc_stats(cvh_alloc_stats_t* stats)   {*stats = cvh_alloc_stats_state()->string;}
+CV_API void cvh_string_reset_alloc_stats(void)  {const cvh_alloc_stats_t zero = {0,0,0,0,0,0,0};cvh_alloc_stats_state()->string = zero;}
+#   define CVH_ALLOC_STATS_RECORD(STATS,TYPE_NAME,CONTAINER,ITEM_SIZE,SIZE,OLD_CAPACITY,NEW_CAPACITY) cvh_alloc_stats_record(STATS,TYPE_NAME,CONTAINER,ITEM_SIZE,SIZE,OLD_CAPACITY,NEW_CAPACITY)
+#else /* CV_ENABLE_ALLOC_STATS */
+#   define CVH_ALLOC_STATS_RECORD(STATS,TYPE_NAME,CONTAINER,ITEM_SIZE,SIZE,OLD_CAPACITY,NEW_CAPACITY) /*no-op*/
+#endif /* CV_ENABLE_ALLOC_STATS */
+#endif /* CVH_ALLOC_STATS_GUARD_ */
+
 #ifndef CV_COMMON_FUNCTIONS_GUARD
 #define CV_COMMON_FUNCTIONS_GUARD
 /* base memory helpers */
@@ -301,6 +469,52 @@ CV_API void* cv_safe_realloc(void** const ptr, size_t new_size)  {
     }
     return ptr2;
 }
+/* per-instance allocator helpers (a NULL allocator falls back to the functions above) */
+CV_API void* cv_malloc_with(const cvh_allocator_t* a,size_t size) {
+    void* p;
+    if (!a) return cv_malloc(size);
+    CV_ASSERT(a->alloc);
+    p = a->alloc(a->user_data,size);
+    if (!p)	{
+        CV_ASSERT(0);	/* No more memory error */
+#       ifndef CV_NO_STDIO
+        fprintf(stderr,"CV_ERROR: cv_malloc_with(...) failed. Not enough memory.\n");
+#       endif
+#       ifndef CV_NO_STDLIB
+        exit(1);
+#       endif
+    }
+    return p;
+}
+CV_API void cv_free_with(const cvh_allocator_t* a,void* p) {
+    if (!a) cv_free(p);
+    else if (a->free && p) a->free(a->user_data,p);
+}
+CV_API void* cv_safe_realloc_with(const cvh_allocator_t* a,void** const ptr,size_t new_size,size_t old_size)  {
+    void *ptr2;
+    if (!a) return cv_safe_realloc(ptr,new_size);
+    CV_ASSERT(new_size!=0);    /* undefined behaviour */
+    if (a->realloc) ptr2 = a->realloc(a->user_data,*ptr,new_size,old_size);
+    else {
+        CV_ASSERT(a->alloc);
+        ptr2 = a->alloc(a->user_data,new_size);
+        if (ptr2 && *ptr) {CV_MEMCPY(ptr2,*ptr,old_size<new_size ? old_size : new_size);}
+        if (ptr2 && *ptr && a->free) a->free(a->user_data,*ptr);
+    }
+    if (ptr2) *ptr=ptr2;
+    else {
+        if (a->free && *ptr) a->free(a->user_data,*ptr);
+        *ptr=NULL;
+        CV_ASSERT(0);	/* No more memory error */
+#       ifndef CV_NO_STDIO
+        fprintf(stderr,"CV_ERROR: cv_safe_realloc_with(...) failed. Not enough memory.\n");
+#       endif
+#       ifndef CV_NO_STDLIB
+        exit(1);
+#       endif
+    }
+    return ptr2;
+}
 CV_API void cv_convert_bytes(size_t bytes_in,size_t pTGMKB[5])   {
     size_t i;pTGMKB[4] = bytes_in;
     for (i=0;i<4;i++)  {pTGMKB[3-i]=pTGMKB[4-i]/1024;pTGMKB[4-i]%=1024;}
@@ -321,6 +535,164 @@ CV_API void cv_display_bytes(size_t bytes_in)   {
 #endif /* CV_NO_STDIO */
 #endif /* CV_COMMON_FUNCTIONS_GUARD */
 
+#ifndef CVH_VM_ALLOCATOR_GUARD_
+#define CVH_VM_ALLOCATOR_GUARD_
+/* cvh_vm_allocator_t is a 'cvh_allocator_t' for very large vectors (pass '&a.allocator' to cv_xxx_init_with_allocator(...)). Every buffer is an anonymous
+   mmap(...) of whole pages that grows with mremap(...) on Linux: page table entries are moved, but the items are never copied, so that growing a 10 GB
+   vector costs O(new pages) instead of O(total bytes). With 'use_huge_pages', buffers of at least CVH_VM_HUGE_PAGE_SIZE bytes are made of whole huge pages
+   (their start is aligned to CVH_VM_HUGE_PAGE_SIZE when they're mapped) and advised with MADV_HUGEPAGE (transparent huge pages), and cv_xxx_shrink_to_fit(...)
+   just releases the tail pages (through 'allocator.shrink'). The lengths of the mappings are kept in a small table inside the allocator (not in the buffers,
+   that start exactly on a page boundary): so it's not thread-safe (vectors used by different threads need different allocators), and cvh_vm_allocator_close(...)
+   must be called at the end. In plain C, mremap(...) needs _GNU_SOURCE (defined before including any header): without it, growing maps new pages and copies the items.
+   Every buffer takes at least one page: don't use it for small vectors. Without mmap(...) (e.g. on Windows, or with CV_NO_MMAP) it just uses CV_MALLOC/CV_REALLOC/CV_FREE */
+#if (defined(CV_HAS_MMAP) && (defined(MAP_ANONYMOUS) || defined(MAP_ANON)))
+#   define CVH_VM_HAS_MMAP  /* internal usage */
+#   ifdef MAP_ANONYMOUS
+#       define CVH_VM_MAP_ANONYMOUS MAP_ANONYMOUS
+#   else
+#       define CVH_VM_MAP_ANONYMOUS MAP_ANON
+#   endif
+#   if (defined(__linux__) && defined(MREMAP_MAYMOVE))
+#       define CVH_VM_HAS_MREMAP    /* internal usage */
+#   endif
+#endif
+#ifndef CVH_VM_HUGE_PAGE_SIZE
+#   define CVH_VM_HUGE_PAGE_SIZE (2*1024*1024)
+#endif
+typedef struct cvh_vm_block_t {void* ptr;size_t len;} cvh_vm_block_t;   /* internal usage */
+typedef struct cvh_vm_allocator_t {
+    cvh_allocator_t allocator;  /* its 'user_data' points to this struct: it must not be moved or copied after cvh_vm_allocator_init(...) */
+    size_t page_size;
+    int use_huge_pages;
+    cvh_vm_block_t* blocks;     /* 'num_blocks' live mappings (please don't modify them) */
+    size_t num_blocks,blocks_capacity;
+} cvh_vm_allocator_t;
+/* length of the mapping of a buffer of 'size' bytes (a multiple of CVH_VM_HUGE_PAGE_SIZE for big buffers when 'use_huge_pages' is true) */
+CV_API size_t cvh_vm_allocator_length(const cvh_vm_allocator_t* a,size_t size)  {
+    const size_t page = (a->use_huge_pages && size>=CVH_VM_HUGE_PAGE_SIZE) ? CVH_VM_HUGE_PAGE_SIZE : a->page_size;
+    return (size+page-1)/page*page;
+}
+#ifdef CVH_VM_HAS_MMAP
+CV_API void cvh_vm_allocator_advise(const cvh_vm_allocator_t* a,void* ptr,size_t len)  {
+#   ifdef MADV_HUGEPAGE
+    if (a->use_huge_pages && len>=CVH_VM_HUGE_PAGE_SIZE) madvise(ptr,len,MADV_HUGEPAGE);  /* just a hint: failures are ignored */
+#   else
+    (void)a;(void)ptr;(void)len;
+#   endif
+}
+/* it returns the index of 'ptr' in 'a->blocks' ('a->num_blocks' if it's missing) */
+CV_API size_t cvh_vm_allocator_find(const cvh_vm_allocator_t* a,const void* ptr)  {
+    size_t i=a->num_blocks;
+    while (i>0) {--i;if (a->blocks[i].ptr==ptr) return i;}    /* the most recent blocks first */
+    return a->num_blocks;
+}
+/* it maps 'len' bytes. When 'len' is a multiple of CVH_VM_HUGE_PAGE_SIZE the start is aligned to it too (a bigger region is mapped and trimmed) */
+CV_API void* cvh_vm_allocator_map(const cvh_vm_allocator_t* a,size_t len)  {
+    const int align = (a->use_huge_pages && len>=CVH_VM_HUGE_PAGE_SIZE);
+    const size_t map_len = align ? len+CVH_VM_HUGE_PAGE_SIZE : len;
+    unsigned char *p,*start;
+    void* m = mmap(NULL,map_len,PROT_READ|PROT_WRITE,MAP_PRIVATE|CVH_VM_MAP_ANONYMOUS,-1,0);    /* pages are zero-filled lazily */
+    if (m==MAP_FAILED) return NULL;
+    p = start = (unsigned char*) m;
+    if (align)  {
+        const size_t head = (CVH_VM_HUGE_PAGE_SIZE-(size_t)p%CVH_VM_HUGE_PAGE_SIZE)%CVH_VM_HUGE_PAGE_SIZE;
+        start = p+head;
+        if (head>0) munmap(p,head);
+        munmap(start+len,map_len-head-len);
+    }
+    cvh_vm_allocator_advise(a,start,len);
+    return start;
+}
+#endif /* CVH_VM_HAS_MMAP */
+CV_API void* cvh_vm_allocator_alloc(void* user_data,size_t size)    {
+    cvh_vm_allocator_t* a = (cvh_vm_allocator_t*) user_data;
+#   ifdef CVH_VM_HAS_MMAP
+    const size_t len = cvh_vm_allocator_length(a,size>0 ? size : 1);
+    void* p;
+    if (a->num_blocks==a->blocks_capacity)  {
+        const size_t c = a->blocks_capacity>0 ? 2*a->blocks_capacity : 16;
+        cvh_vm_block_t* blocks = (cvh_vm_block_t*) CV_REALLOC(a->blocks,c*sizeof(cvh_vm_block_t));
+        if (!blocks) return NULL;
+        a->blocks=blocks;a->blocks_capacity=c;
+    }
+    p = cvh_vm_allocator_map(a,len);
+    if (!p) return NULL;
+    a->blocks[a->num_blocks].ptr=p;a->blocks[a->num_blocks].len=len;++a->num_blocks;
+    return p;
+#   else
+    (void)a;return CV_MALLOC(size);
+#   endif
+}
+CV_API void cvh_vm_allocator_free(void* user_data,void* ptr)    {
+    cvh_vm_allocator_t* a = (cvh_vm_allocator_t*) user_data;
+#   ifdef CVH_VM_HAS_MMAP
+    size_t i;
+    if (!ptr) return;
+    i = cvh_vm_allocator_find(a,ptr);
+    CV_ASSERT(i<a->num_blocks && "cvh_vm_allocator_free(...): 'ptr' was not allocated by this allocator");
+    if (i==a->num_blocks) return;
+    munmap(ptr,a->blocks[i].len);
+    a->blocks[i]=a->blocks[--a->num_blocks];
+#   else
+    (void)a;CV_FREE(ptr);
+#   endif
+}
+/* growing uses mremap(...) when available (no copy). Shrinking just unmaps the tail pages ('ptr' does not move): it's also used as 'allocator.shrink' */
+CV_API void* cvh_vm_allocator_realloc(void* user_data,void* ptr,size_t new_size,size_t old_size)    {
+    cvh_vm_allocator_t* a = (cvh_vm_allocator_t*) user_data;
+#   ifdef CVH_VM_HAS_MMAP
+    size_t i,old_len,new_len;
+    if (!ptr) return cvh_vm_allocator_alloc(user_data,new_size);
+    i = cvh_vm_allocator_find(a,ptr);
+    CV_ASSERT(i<a->num_blocks && "cvh_vm_allocator_realloc(...): 'ptr' was not allocated by this allocator");
+    if (i==a->num_blocks) return NULL;
+    old_len = a->blocks[i].len;new_len = cvh_vm_allocator_length(a,new_size>0 ? new_size : 1);
+    if (new_len<old_len) {munmap((unsigned char*)ptr+new_len,old_len-new_len);a->blocks[i].len=new_len;}
+    else if (new_len>old_len)   {
+#       ifdef CVH_VM_HAS_MREMAP
+        void* p = mremap(ptr,old_len,new_len,MREMAP_MAYMOVE);
+        if (p==MAP_FAILED) return NULL;
+        cvh_vm_allocator_advise(a,p,new_len);
+        a->blocks[i].ptr=p;a->blocks[i].len=new_len;
+        return p;
+#       else
+        void* p = cvh_vm_allocator_alloc(user_data,new_size);   /* it can move 'a->blocks' */
+        if (!p) return NULL;
+        CV_MEMCPY(p,ptr,old_size<new_size ? old_size : new_size);
+        cvh_vm_allocator_free(user_data,ptr);
+        return p;
+#       endif
+    }
+    (void)old_size;
+    return ptr;
+#   else
+    (void)a;(void)old_size;return CV_REALLOC(ptr,new_size);
+#   endif
+}
+/* 'use_huge_pages' (0 or 1) is just a hint: it's ignored where MADV_HUGEPAGE is not available */
+CV_API void cvh_vm_allocator_init(cvh_vm_allocator_t* a,int use_huge_pages)    {
+    CV_ASSERT(a);
+    CV_MEMSET(a,0,sizeof(*a));
+    a->allocator.alloc=&cvh_vm_allocator_alloc;a->allocator.realloc=&cvh_vm_allocator_realloc;
+    a->allocator.free=&cvh_vm_allocator_free;a->allocator.shrink=&cvh_vm_allocator_realloc;
+    a->allocator.user_data=a;
+    a->use_huge_pages=use_huge_pages;
+    a->page_size=4096;
+#   ifdef CVH_VM_HAS_MMAP
+    {const long page_size = sysconf(_SC_PAGESIZE);if (page_size>0) a->page_size=(size_t)page_size;}
+#   endif
+}
+/* It unmaps the buffers that are still alive (the vectors that use them must not be used any more) and it releases the table of the mappings */
+CV_API void cvh_vm_allocator_close(cvh_vm_allocator_t* a)    {
+    CV_ASSERT(a);
+#   ifdef CVH_VM_HAS_MMAP
+    while (a->num_blocks>0) {--a->num_blocks;munmap(a->blocks[a->num_blocks].ptr,a->blocks[a->num_blocks].len);}
+#   endif
+    if (a->blocks) CV_FREE(a->blocks);
+    a->blocks=NULL;a->num_blocks=a->blocks_capacity=0;
+}
+#endif /* CVH_VM_ALLOCATOR_GUARD_ */
+
 #ifndef CV_NO_CVH_SERIALIZER_T
 #ifndef CVH_SRIALIZER_GUARD_
 /* cvh_serializer_t provides serialization/deserialization support to the cvector struct */
@@ -328,11 +700,18 @@ typedef struct cvh_serializer_t {
     unsigned char* v;
     size_t size,capacity;
     /* mutable */ size_t offset;  /* used as read-pointer in deserialization. 'mutable' is not available in plain C (and it's better not to use 'ifdef __cplusplus' here) */
+    /* streaming mode (optional, see cvh_serializer_init_sink(...) and cvh_serializer_init_source(...)): 'v' is a fixed-size buffer that is flushed to (or refilled from) 'stream' */
+    size_t (*stream_write)(void* stream,const void* data,size_t num_bytes);  /* NULL if it's not a sink. It must return the number of bytes written */
+    size_t (*stream_read)(void* stream,void* data,size_t num_bytes);         /* NULL if it's not a source. It must return the number of bytes read (0 at the end of the stream) */
+    void* stream;       /* a 'cvh_mmap_t*' when both 'stream_write' and 'stream_read' are NULL (see cvh_serializer_init_mapped(...)): 'v' is not owned in this case */
+    int stream_error;   /* set when 'stream_write' or 'stream_read' fail (or when the stream ends too early) */
+    const cvh_growth_policy_t* growth_policy;   /* optional (can be NULL): see cvh_serializer_set_growth_policy(...) */
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
     void (*const reserve)(struct cvh_serializer_t* p,size_t new_capacity);
     void (*const free)(struct cvh_serializer_t* p);
     void (*const cpy)(struct cvh_serializer_t* dst,const struct cvh_serializer_t* src);
     void (*const clear)(struct cvh_serializer_t* p);
+    int (*const flush)(struct cvh_serializer_t* s);
     int (*const save)(const struct cvh_serializer_t* p,const char* path);
     int (*const load)(struct cvh_serializer_t* p,const char* path);
     void (*const offset_rewind)(const struct cvh_serializer_t* d);
@@ -370,6 +749,8 @@ typedef struct cvh_serializer_t {
     int (*const read_string)(const struct cvh_serializer_t* d,char** pstr,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/);
     void (*const write_blob)(struct cvh_serializer_t* s,const void* blob,size_t blob_size_in_bytes);
     int (*const read_blob)(const struct cvh_serializer_t* d,void** pblob,size_t* blob_size_out,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/);
+    void (*const write_bytes)(struct cvh_serializer_t* s,const void* data,size_t num_bytes);
+    int (*const read_bytes)(const struct cvh_serializer_t* d,void* data,size_t num_bytes);
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 #   ifdef __cplusplus
     CV_API_CPP_DEC cvh_serializer_t();
@@ -382,6 +763,14 @@ typedef struct cvh_serializer_t {
 #       endif /* CV_HAS_MOVE_SEMANTICS */
 #   endif /*__cplusplus*/
 } cvh_serializer_t;
+/* cvh_mmap_t maps a whole file in memory (copy-on-write), so that POD vectors can point directly into it (see cvh_serializer_init_mapped(...)).
+   It must not be moved or copied after cvh_mmap_open(...), and it must outlive the vectors that use its 'allocator' */
+typedef struct cvh_mmap_t {
+    unsigned char* v;   /* the file content: it can be modified in memory, but changes are never written back to the file */
+    size_t size;
+    cvh_allocator_t allocator;  /* memory inside 'v' is never released by it (and it's copied to the heap when a vector must grow) */
+    int is_mapped;      /* 0 if mmap(...) is not available: in this case the file is just loaded in 'v' */
+} cvh_mmap_t;
 #endif /* CVH_SRIALIZER_GUARD_ */
 #endif /* CV_NO_CVH_SERIALIZER_T */
 
@@ -400,6 +789,8 @@ struct cvector {
         void (*const item_serialize)(const void*,cvh_serializer_t*);    /* optional (can be NULL) */
         int  (*const item_deserialize)(void*,const cvh_serializer_t*);  /* optional (can be NULL) */
 #       endif /* CV_NO_CVH_SERIALIZER_T */
+    const cvh_allocator_t* const allocator;                  /* optional (can be NULL) */
+    const cvh_growth_policy_t* const growth_policy;          /* optional (can be NULL) */
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS  /* must be defined glabally (in the Project Options)) */
     void (* const free)(cvector* v);
     void (* const clear)(cvector* v);
@@ -415,6 +806,7 @@ struct cvector {
     size_t (* const insert_at)(cvector* v,const void* item_to_insert,size_t position);
     size_t (* const insert_range_at)(cvector* v,const void* items_to_insert,size_t num_items_to_insert,size_t start_position);
     size_t (* const insert_sorted)(cvector* v,const void* item_to_insert,int* match,int insert_even_if_item_match);
+    void (* const radix_sort)(cvector* v,size_t key_offset,size_t key_width);
     int (* const remove_at)(cvector* v,size_t position);
     int (* const remove_range_at)(cvector* v,size_t start_item_position,size_t num_items_to_remove);
     void (* const cpy)(cvector* a,const cvector* b);
@@ -456,19 +848,27 @@ CV_API_DEC size_t cvector_binary_search(const cvector* v,const void* item_to_sea
 CV_API_DEC size_t cvector_insert_at(cvector* v,const void* item_to_insert,size_t position);
 CV_API_DEC size_t cvector_insert_range_at(cvector* v,const void* items_to_insert,size_t num_items_to_insert,size_t start_position);
 CV_API_DEC size_t cvector_insert_sorted(cvector* v,const void* item_to_insert,int* match,int insert_even_if_item_match);
+CV_API_DEC void cvector_radix_sort(cvector* v,size_t key_offset,size_t key_width);
 CV_API_DEC int cvector_remove_at(cvector* v,size_t position);
 CV_API_DEC int cvector_remove_range_at(cvector* v,size_t start_item_position,size_t num_items_to_remove);
 CV_API_DEC void cvector_cpy(cvector* a,const cvector* b);
 CV_API_DEC void cvector_shrink_to_fit(cvector* v);
 CV_API_DEC void cvector_dbg_check(const cvector* v);
+#ifdef CV_ENABLE_ALLOC_STATS
+CV_API_DEC void cvector_get_alloc_stats(cvh_alloc_stats_t* stats);
+CV_API_DEC void cvector_reset_alloc_stats(void);
+#endif /* CV_ENABLE_ALLOC_STATS */
 #ifndef CV_NO_CVH_SERIALIZER_T
 CV_API_DEC void cvector_serialize(const cvector* v,cvh_serializer_t* serializer);
 CV_API_DEC int  cvector_deserialize(cvector* v,const cvh_serializer_t* deserializer);
+CV_API_DEC int  cvector_deserialize_mapped(cvector* v,const cvh_serializer_t* deserializer);
 #   define CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0    ,void (*item_serialize)(const void*,cvh_serializer_t*),int (*item_deserialize)(void*,const cvh_serializer_t*)
 #else /* CV_NO_CVH_SERIALIZER_T */
 #   define CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0    /* no-op */
 #endif /* CV_NO_CVH_SERIALIZER_T */
 CV_API_DEC void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0);
+CV_API_DEC void cvector_init_with_allocator(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0,const cvh_allocator_t* allocator);
+CV_API_DEC void cvector_set_growth_policy(cvector* v,const cvh_growth_policy_t* policy);
 CV_API_DEC void cvector_init(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*));
 CV_API_DEC cvector cvector_create_with(size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0);
 CV_API_DEC cvector cvector_create(size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*));
@@ -481,6 +881,8 @@ CV_API_DEC void cvh_serializer_reserve(cvh_serializer_t* p,size_t new_capacity);
 CV_API_DEC void cvh_serializer_free(cvh_serializer_t* p);
 CV_API_DEC void cvh_serializer_cpy(cvh_serializer_t* dst,const cvh_serializer_t* src);
 CV_API_DEC void cvh_serializer_clear(cvh_serializer_t* p);
+CV_API_DEC int cvh_serializer_flush(cvh_serializer_t* s);
+CV_API_DEC int cvh_serializer_fill(const cvh_serializer_t* d,size_t num_bytes);
 CV_API_DEC int cvh_serializer_save(const cvh_serializer_t* p,const char* path);
 CV_API_DEC int cvh_serializer_load(cvh_serializer_t* p,const char* path);
 CV_API_DEC void cvh_serializer_offset_rewind(const cvh_serializer_t* d);
@@ -518,8 +920,22 @@ CV_API_DEC void cvh_serializer_write_string(cvh_serializer_t* s,const char* str_
 CV_API_DEC int cvh_serializer_read_string(const cvh_serializer_t* d,char** pstr,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/);
 CV_API_DEC void cvh_serializer_write_blob(cvh_serializer_t* s,const void* blob,size_t blob_size_in_bytes);
 CV_API_DEC int cvh_serializer_read_blob(const cvh_serializer_t* d,void** pblob,size_t* blob_size_out,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/);
+CV_API_DEC void cvh_serializer_write_bytes(cvh_serializer_t* s,const void* data,size_t num_bytes);
+CV_API_DEC int cvh_serializer_read_bytes(const cvh_serializer_t* d,void* data,size_t num_bytes);
 CV_API_DEC void cvh_serializer_init(cvh_serializer_t* p);
 CV_API_DEC cvh_serializer_t cvh_serializer_create(void);
+CV_API_DEC void cvh_serializer_set_growth_policy(cvh_serializer_t* p,const cvh_growth_policy_t* policy);
+CV_API_DEC void cvh_serializer_init_sink(cvh_serializer_t* p,size_t (*stream_write)(void* stream,const void* data,size_t num_bytes),void* stream,size_t buffer_size);
+CV_API_DEC void cvh_serializer_init_source(cvh_serializer_t* p,size_t (*stream_read)(void* stream,void* data,size_t num_bytes),void* stream,size_t buffer_size);
+#ifndef CV_NO_STDIO
+CV_API_DEC size_t cvh_serializer_fwrite(void* f,const void* data,size_t num_bytes);
+CV_API_DEC size_t cvh_serializer_fread(void* f,void* data,size_t num_bytes);
+CV_API_DEC void cvh_serializer_init_file_sink(cvh_serializer_t* p,FILE* f,size_t buffer_size);
+CV_API_DEC void cvh_serializer_init_file_source(cvh_serializer_t* p,FILE* f,size_t buffer_size);
+#endif /* CV_NO_STDIO */
+CV_API_DEC int cvh_mmap_open(cvh_mmap_t* m,const char* path);
+CV_API_DEC void cvh_mmap_close(cvh_mmap_t* m);
+CV_API_DEC void cvh_serializer_init_mapped(cvh_serializer_t* d,const cvh_mmap_t* m);
 #endif /* CVH_SRIALIZER_GUARD_ */
 #endif /* CV_NO_CVH_SERIALIZER_T */
 
@@ -529,6 +945,7 @@ CV_API_DEC cvh_serializer_t cvh_serializer_create(void);
 /* A constant, grow-only string pool. Basically you store the 'size_t' returned by 'cvh_string_push_back(...)' instead of a char* */
 typedef struct cvh_string_t {
     char* v;size_t size,capacity;
+    const cvh_growth_policy_t* growth_policy;   /* optional (can be NULL): see cvh_string_set_growth_policy(...) */
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
     void (*const reserve)(struct cvh_string_t* p,size_t new_capacity);
     size_t (*const push_back)(struct cvh_string_t* p,const char* str_beg,const char* str_end);
@@ -563,6 +980,7 @@ CV_API_DEC void cvh_string_clear(cvh_string_t* p);
 #   endif /* CV_NO_CVH_SERIALIZER_T */
 CV_API_DEC void cvh_string_init(cvh_string_t* p);
 CV_API_DEC cvh_string_t cvh_string_create(void);
+CV_API_DEC void cvh_string_set_growth_policy(cvh_string_t* p,const cvh_growth_policy_t* policy);
 #endif /* CVH_STRING_GUARD_ */
 #endif /* CV_NO_CVH_STRING_T */
 
@@ -591,14 +1009,91 @@ CV_API_DEC cvh_string_t cvh_string_create(void);
 #ifndef CV_NO_CVH_SERIALIZER_T
 #ifndef CVH_SRIALIZER_GUARD_
 
+CV_API_DEF int cvh_serializer_flush(cvh_serializer_t* s)    {
+    /* sink mode: it writes all the buffered bytes to the stream (it's a no-op otherwise). It returns 0 if some write failed */
+    CV_ASSERT(s);
+    if (s->stream_write && s->size>0)   {
+        if (s->stream_write(s->stream,s->v,s->size)!=s->size) s->stream_error=1;
+        s->size=0;
+    }
+    return s->stream_error ? 0 : 1;
+}
+CV_API_DEF int cvh_serializer_fill(const cvh_serializer_t* d,size_t num_bytes)    {
+    /* it returns 1 if at least 'num_bytes' unread bytes are available at '&d->v[d->offset]'.
+       In source mode, it refills the buffer from the stream first (and it grows the buffer only when 'num_bytes' exceeds its capacity) */
+    cvh_serializer_t* s = (cvh_serializer_t*) d;  /* the buffer is 'mutable' in source mode, like 'offset' */
+    CV_ASSERT(d);
+    if (s->offset+num_bytes<=s->size) return 1;
+    if (!s->stream_read || s->stream_error) return 0;
+    if (s->offset>0)    {
+        s->size-=s->offset;
+        if (s->size>0) CV_MEMMOVE(s->v,&s->v[s->offset],s->size);
+        s->offset=0;
+    }
+    if (num_bytes>s->capacity)  {CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",s,1,s->size,s->capacity,num_bytes);cv_safe_realloc((void**)&s->v,num_bytes);CV_ASSERT(s->v);s->capacity=num_bytes;}
+    while (s->size<num_bytes)   {
+        const size_t n = s->stream_read(s->stream,&s->v[s->size],s->capacity-s->size);
+        if (n==0) {s->stream_error=1;return 0;}
+        s->size+=n;
+    }
+    return 1;
+}
 CV_API_DEF void cvh_serializer_reserve(cvh_serializer_t* p,size_t new_capacity)    {
     if (new_capacity>p->capacity) {
-        new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        if (p->stream_write)    {
+            /* sink mode: 'new_capacity' is 'p->size' plus the number of bytes we're going to write: we flush the buffer first */
+            new_capacity-=p->size;
+            cvh_serializer_flush(p);
+            if (new_capacity<=p->capacity) return;
+        }
+        CV_ASSERT(p->stream_write || p->stream_read || !p->stream);    /* a mapped serializer (see cvh_serializer_init_mapped(...)) is read-only */
+        if (p->growth_policy) new_capacity = cvh_growth_policy_next_capacity(p->growth_policy,p->capacity,new_capacity,1);
+        else new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,p->size,p->capacity,new_capacity);
         cv_safe_realloc((void**)&p->v,new_capacity);CV_ASSERT(p->v);
         p->capacity = new_capacity;
     }
 }
-CV_API_DEF void cvh_serializer_free(cvh_serializer_t* p)    {cv_free(p->v);p->v=NULL;p->size=p->capacity=p->offset=0;}
+CV_API_DEF void cvh_serializer_write_bytes(cvh_serializer_t* s,const void* data,size_t num_bytes)    {
+    /* it appends 'num_bytes' raw bytes. In sink mode, chunks bigger than the buffer are written directly to the stream */
+    CV_ASSERT(s && (data || num_bytes==0));
+    if (s->stream_write && s->size+num_bytes>s->capacity)   {
+        cvh_serializer_flush(s);
+        if (num_bytes>=s->capacity) {if (s->stream_write(s->stream,data,num_bytes)!=num_bytes) s->stream_error=1;return;}
+    }
+    cvh_serializer_reserve(s,s->size+num_bytes);
+    if (num_bytes>0) {CV_MEMCPY(&s->v[s->size],data,num_bytes);s->size+=num_bytes;}
+}
+CV_API_DEF int cvh_serializer_read_bytes(const cvh_serializer_t* d,void* data,size_t num_bytes)    {
+    /* it reads 'num_bytes' raw bytes. In source mode, chunks bigger than the buffer are read directly from the stream */
+    cvh_serializer_t* s = (cvh_serializer_t*) d;
+    int check;
+    CV_ASSERT(d && (data || num_bytes==0));
+    if (s->stream_read && !s->stream_error && s->offset+num_bytes>s->size && num_bytes>s->capacity)   {
+        size_t n = s->size-s->offset;
+        if (n>0) CV_MEMCPY(data,&s->v[s->offset],n);
+        s->offset=s->size=0;
+        while (n<num_bytes) {
+            const size_t m = s->stream_read(s->stream,(unsigned char*)data+n,num_bytes-n);
+            if (m==0) {s->stream_error=1;break;}
+            n+=m;
+        }
+        check = n==num_bytes;CV_ASSERT(check);return check;
+    }
+    check = cvh_serializer_fill(d,num_bytes);CV_ASSERT(check);if (!check) return 0;
+    if (num_bytes>0) {CV_MEMCPY(data,&s->v[s->offset],num_bytes);s->offset+=num_bytes;}
+    return 1;
+}
+CV_API_DEF void cvh_serializer_free(cvh_serializer_t* p)    {
+    /* in sink mode, it flushes the buffer first (but please call cvh_serializer_flush(...) to check for errors). The serializer returns to memory mode */
+    cvh_serializer_flush(p);
+    if (p->v && (!p->stream || p->stream_write || p->stream_read))  {   /* a mapped serializer does not own 'v' */
+        CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,p->size,p->capacity,0);
+        cv_free(p->v);
+    }
+    p->v=NULL;p->size=p->capacity=p->offset=0;
+    p->stream_write=NULL;p->stream_read=NULL;p->stream=NULL;p->stream_error=0;
+}
 CV_API_DEF void cvh_serializer_cpy(cvh_serializer_t* dst,const cvh_serializer_t* src)   {
     CV_ASSERT(src && dst);
     if (dst->capacity<src->size) cvh_serializer_reserve(dst,src->size);
@@ -636,7 +1131,7 @@ CV_API_DEF void cvh_serializer_offset_set(const cvh_serializer_t* d,size_t offse
 CV_API_DEF void cvh_serializer_offset_advance(const cvh_serializer_t* d,size_t amount)  {CV_ASSERT(d->offset+amount<=d->size);*((size_t*)&d->offset)+=amount;}
 #   define CVH_SERIALIZER_WRITE(S,type,value)   {cvh_serializer_reserve(S,S->size + sizeof(type));*((type*) (&S->v[S->size])) = value;S->size+=sizeof(type);}
 #   define CVH_DESERIALIZER_READ(D,type,value_ptr)   { \
-       int check = (D->offset+sizeof(type)<=D->size);CV_ASSERT(check);if (!check) return 0; \
+       int check = (D->offset+sizeof(type)<=D->size || cvh_serializer_fill(D,sizeof(type)));CV_ASSERT(check);if (!check) return 0; \
        *value_ptr = *((type*) &D->v[D->offset]);*((size_t*) &D->offset)+=sizeof(type); return 1;}
 CV_API_DEF void cvh_serializer_write_size_t(cvh_serializer_t* s,size_t value) {CVH_SERIALIZER_WRITE(s,size_t,value)}
 CV_API_DEF int cvh_serializer_read_size_t(const cvh_serializer_t* d,size_t* value) {CVH_DESERIALIZER_READ(d,size_t,value)}
@@ -687,16 +1182,15 @@ CV_API_DEF void cvh_serializer_write_string(cvh_serializer_t* s,const char* str_
         const size_t str_len = str_end ? (size_t)(str_end-str_beg) : strlen(str_beg);
         const size_t str_len_plus_trailing_zero = str_len+1;
         cvh_serializer_write_size_t_using_mipmaps(s,str_len_plus_trailing_zero);
-        cvh_serializer_reserve(s,s->size + str_len_plus_trailing_zero);
-        CV_MEMCPY(&s->v[s->size],str_beg,str_len);s->v[s->size+str_len]='\0';
-        s->size+=str_len_plus_trailing_zero;
+        cvh_serializer_write_bytes(s,str_beg,str_len);
+        cvh_serializer_write_unsigned_char(s,'\0');
     }
 }
 CV_API_DEF int cvh_serializer_read_string(const cvh_serializer_t* d,char** pstr,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/)    {
     int check=0;size_t str_len_plus_one = 0;
     CV_ASSERT(d && pstr);
     if (!cvh_serializer_read_size_t_using_mipmaps(d,&str_len_plus_one)) return 0;
-    check=d->offset+str_len_plus_one<=d->size;CV_ASSERT(check);if (!check) return 0;
+    check=cvh_serializer_fill(d,str_len_plus_one);CV_ASSERT(check);if (!check) return 0;
     if (str_len_plus_one==0)    {if (*pstr) {if (my_free) my_free(*pstr);else CV_FREE(*pstr);} return 1;}
     check = d->v[d->offset+str_len_plus_one-1]=='\0';CV_ASSERT(check); /* additional check (should we return 0?) */
     if (!(*pstr) || strlen(*pstr)<str_len_plus_one-1) {
@@ -711,20 +1205,19 @@ CV_API_DEF void cvh_serializer_write_blob(cvh_serializer_t* s,const void* blob,s
     if (!blob || blob_size_in_bytes==0) cvh_serializer_write_size_t_using_mipmaps(s,0);   /* we want to preserve NULL blobs */
     else {
         cvh_serializer_write_size_t_using_mipmaps(s,blob_size_in_bytes);
-        cvh_serializer_reserve(s,s->size + blob_size_in_bytes);
-        CV_MEMCPY(&s->v[s->size],blob,blob_size_in_bytes);s->size+=blob_size_in_bytes;
+        cvh_serializer_write_bytes(s,blob,blob_size_in_bytes);
     }
 }
 CV_API_DEF int cvh_serializer_read_blob(const cvh_serializer_t* d,void** pblob,size_t* blob_size_out,void* (*my_realloc)(void*,size_t)/*=NULL*/,void (*my_free)(void*)/*=NULL*/)    {
     int check=0;size_t blob_size = 0;if (blob_size_out) *blob_size_out=0;
     CV_ASSERT(d && pblob);
     if (!cvh_serializer_read_size_t_using_mipmaps(d,&blob_size)) return 0;
-    check=d->offset+blob_size<=d->size;CV_ASSERT(check);if (!check) return 0;
+    check=d->stream_read || d->offset+blob_size<=d->size;CV_ASSERT(check);if (!check) return 0;
     if (blob_size==0)    {if (*pblob) {if (my_free) my_free(*pblob);else CV_FREE(*pblob);} return 1;}
     if (my_realloc) *pblob=(char*)my_realloc(*pblob,blob_size);
     else            *pblob=(char*)CV_REALLOC(*pblob,blob_size);
     CV_ASSERT(*pblob);
-    CV_MEMCPY(*pblob,&d->v[d->offset],blob_size);*((size_t*)&d->offset)+=blob_size;
+    if (!cvh_serializer_read_bytes(d,*pblob,blob_size)) return 0;
     if (blob_size_out) *blob_size_out=blob_size;
     return 1;
 }
@@ -735,6 +1228,7 @@ CV_API_DEF void cvh_serializer_init(cvh_serializer_t* p)    {
     {typedef void (*fnctype)(cvh_serializer_t*);            *((fnctype*)&p->free)=&cvh_serializer_free;}    \
     {typedef void (*fnctype)(cvh_serializer_t*,const cvh_serializer_t*);            *((fnctype*)&p->cpy)=&cvh_serializer_cpy;}    \
     {typedef void (*fnctype)(cvh_serializer_t*);            *((fnctype*)&p->clear)=&cvh_serializer_clear;}    \
+    {typedef int (*fnctype)(cvh_serializer_t*);             *((fnctype*)&p->flush)=&cvh_serializer_flush;}    \
     {typedef int (*fnctype)(const cvh_serializer_t*,const char*);  *((fnctype*)&p->save)=&cvh_serializer_save;} \
     {typedef int (*fnctype)(cvh_serializer_t*,const char*);  *((fnctype*)&p->load)=&cvh_serializer_load;}   \
     {typedef void (*fnctype)(const cvh_serializer_t*);  *((fnctype*)&p->offset_rewind)=&cvh_serializer_offset_rewind;}  \
@@ -771,14 +1265,109 @@ CV_API_DEF void cvh_serializer_init(cvh_serializer_t* p)    {
     {typedef void (*fnctype)(cvh_serializer_t*,const char*,const char*);  *((fnctype*)&p->write_string)=&cvh_serializer_write_string;}  \
     {typedef int (*fnctype)(const cvh_serializer_t*,char**,void* (*)(void*,size_t),void (*)(void*));  *((fnctype*)&p->read_string)=&cvh_serializer_read_string;}    \
     {typedef void (*fnctype)(cvh_serializer_t*,const void*,size_t);  *((fnctype*)&p->write_blob)=&cvh_serializer_write_blob;}   \
-    {typedef int (*fnctype)(const cvh_serializer_t*,void**,size_t*,void* (*)(void*,size_t),void (*)(void*));  *((fnctype*)&p->read_blob)=&cvh_serializer_read_blob;}
+    {typedef int (*fnctype)(const cvh_serializer_t*,void**,size_t*,void* (*)(void*,size_t),void (*)(void*));  *((fnctype*)&p->read_blob)=&cvh_serializer_read_blob;}  \
+    {typedef void (*fnctype)(cvh_serializer_t*,const void*,size_t);  *((fnctype*)&p->write_bytes)=&cvh_serializer_write_bytes;}   \
+    {typedef int (*fnctype)(const cvh_serializer_t*,void*,size_t);  *((fnctype*)&p->read_bytes)=&cvh_serializer_read_bytes;}
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 }
 CV_API_DEF cvh_serializer_t cvh_serializer_create(void) {cvh_serializer_t p;cvh_serializer_init(&p);return p;}
+/* 'policy' (optional: it can be NULL, and it must outlive 'p') replaces the default 3/2 growth factor. cvh_serializer_init(...) resets it */
+CV_API_DEF void cvh_serializer_set_growth_policy(cvh_serializer_t* p,const cvh_growth_policy_t* policy)  {p->growth_policy=policy;}
+/* Streaming mode: the serializer uses a fixed buffer of 'buffer_size' bytes (CVH_SERIALIZER_STREAM_BUFFER_SIZE when zero),
+   so that peak memory does not depend on the amount of serialized data:
+   -> a sink writes the buffer to 'stream' (using 'stream_write') every time it's full: call cvh_serializer_flush(...) at the end (it returns 0 on errors)
+   -> a source refills the buffer from 'stream' (using 'stream_read') while the data is deserialized
+   'offset' is relative to the buffer (so cvh_serializer_offset_xxx(...), cvh_serializer_cpy(...), cvh_serializer_save(...) and cvh_serializer_load(...) are for memory mode only).
+   With file descriptors, just pass wrappers of the POSIX write(...) and read(...) functions.
+   cvh_serializer_free(...) must be called as usual */
+CV_API_DEF void cvh_serializer_init_sink(cvh_serializer_t* p,size_t (*stream_write)(void* stream,const void* data,size_t num_bytes),void* stream,size_t buffer_size)    {
+    CV_ASSERT(p && stream_write);
+    cvh_serializer_init(p);
+    p->stream_write=stream_write;p->stream=stream;
+    p->capacity = buffer_size>0 ? buffer_size : CVH_SERIALIZER_STREAM_BUFFER_SIZE;
+    p->v = (unsigned char*) cv_malloc(p->capacity);
+    CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,0,0,p->capacity);
+}
+CV_API_DEF void cvh_serializer_init_source(cvh_serializer_t* p,size_t (*stream_read)(void* stream,void* data,size_t num_bytes),void* stream,size_t buffer_size)    {
+    CV_ASSERT(p && stream_read);
+    cvh_serializer_init(p);
+    p->stream_read=stream_read;p->stream=stream;
+    p->capacity = buffer_size>0 ? buffer_size : CVH_SERIALIZER_STREAM_BUFFER_SIZE;
+    p->v = (unsigned char*) cv_malloc(p->capacity);
+    CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->serializer,"cvh_serializer_t",p,1,0,0,p->capacity);
+}
+#   ifndef CV_NO_STDIO
+CV_API_DEF size_t cvh_serializer_fwrite(void* f,const void* data,size_t num_bytes)   {return fwrite(data,1,num_bytes,(FILE*)f);}
+CV_API_DEF size_t cvh_serializer_fread(void* f,void* data,size_t num_bytes)   {return fread(data,1,num_bytes,(FILE*)f);}
+CV_API_DEF void cvh_serializer_init_file_sink(cvh_serializer_t* p,FILE* f,size_t buffer_size)   {cvh_serializer_init_sink(p,&cvh_serializer_fwrite,f,buffer_size);}
+CV_API_DEF void cvh_serializer_init_file_source(cvh_serializer_t* p,FILE* f,size_t buffer_size)   {cvh_serializer_init_source(p,&cvh_serializer_fread,f,buffer_size);}
+#   endif /* CV_NO_STDIO */
+CV_API_DEF void* cvh_mmap_allocator_alloc(void* user_data,size_t size)    {(void)user_data;return CV_MALLOC(size);}
+CV_API_DEF void cvh_mmap_allocator_free(void* user_data,void* ptr)    {
+    const cvh_mmap_t* m = (const cvh_mmap_t*) user_data;
+    if (m->v && (unsigned char*)ptr>=m->v && (unsigned char*)ptr<m->v+m->size) return; /* it points into the mapped file */
+    CV_FREE(ptr);
+}
+/* It maps the file at 'path' (copy-on-write). It returns 0 on failure. cvh_mmap_close(...) must be called at the end */
+CV_API_DEF int cvh_mmap_open(cvh_mmap_t* m,const char* path)    {
+    CV_ASSERT(m && path);
+    CV_MEMSET(m,0,sizeof(*m));
+    m->allocator.alloc=&cvh_mmap_allocator_alloc;m->allocator.free=&cvh_mmap_allocator_free;m->allocator.user_data=m;
+#   ifdef CV_HAS_MMAP
+    {
+        struct stat st;void* p;
+        const int fd = open(path,O_RDONLY);
+        if (fd<0) return 0;
+        if (fstat(fd,&st)!=0) {close(fd);return 0;}
+        if (st.st_size>0) {
+            p = mmap(NULL,(size_t)st.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);  /* pages are loaded lazily, and copied only when written */
+            if (p==MAP_FAILED) {close(fd);return 0;}
+            m->v=(unsigned char*)p;m->size=(size_t)st.st_size;m->is_mapped=1;
+        }
+        close(fd);  /* the mapping stays valid */
+        return 1;
+    }
+#   elif !defined(CV_NO_STDIO)
+    {
+        FILE* f=fopen(path,"rb");long file_size;
+        if (!f) return 0;
+        fseek(f,0,SEEK_END);file_size=ftell(f);fseek(f,0,SEEK_SET);
+        if (file_size>0) {
+            m->v=(unsigned char*)cv_malloc((size_t)file_size);
+            if (fread(m->v,(size_t)file_size,1,f)!=1) {cv_free(m->v);m->v=NULL;fclose(f);return 0;}
+            m->size=(size_t)file_size;
+        }
+        fclose(f);
+        return 1;
+    }
+#   else
+    CV_ASSERT(0 && "Cannot load files with the CV_NO_STDIO definition enabled");
+    return 0;
+#   endif
+}
+CV_API_DEF void cvh_mmap_close(cvh_mmap_t* m)    {
+    CV_ASSERT(m);
+    if (m->v)   {
+#       ifdef CV_HAS_MMAP
+        if (m->is_mapped) munmap(m->v,m->size);
+        else
+#       endif
+        cv_free(m->v);
+    }
+    m->v=NULL;m->size=0;m->is_mapped=0;
+}
+/* It makes 'd' a read-only deserializer of the mapped file: cv_xxx_deserialize_mapped(...) can then make POD vectors point directly into it (zero-copy).
+   All the other deserialization functions work as usual (but they copy data). cvh_serializer_free(...) does not unmap the file */
+CV_API_DEF void cvh_serializer_init_mapped(cvh_serializer_t* d,const cvh_mmap_t* m)    {
+    CV_ASSERT(d && m);
+    cvh_serializer_init(d);
+    d->v=m->v;d->size=d->capacity=m->size;
+    d->stream=(void*)m;
+}
 #   ifdef __cplusplus
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
 #       define CV_SERIALIZER_MF_CHUNK0  \
-                ,reserve(&cvh_serializer_reserve),free(&cvh_serializer_free),cpy(&cvh_serializer_cpy),clear(&cvh_serializer_clear),save(&cvh_serializer_save),load(&cvh_serializer_load)   \
+                ,reserve(&cvh_serializer_reserve),free(&cvh_serializer_free),cpy(&cvh_serializer_cpy),clear(&cvh_serializer_clear),flush(&cvh_serializer_flush),save(&cvh_serializer_save),load(&cvh_serializer_load)   \
                 ,offset_rewind(&cvh_serializer_offset_rewind),offset_set(&cvh_serializer_offset_set),offset_advance(&cvh_serializer_offset_advance),write_size_t(&cvh_serializer_write_size_t),read_size_t(&cvh_serializer_read_size_t) \
                 ,write_unsigned_char(&cvh_serializer_write_unsigned_char),read_unsigned_char(&cvh_serializer_read_unsigned_char),write_signed_char(&cvh_serializer_write_signed_char),read_signed_char(&cvh_serializer_read_signed_char) \
                 ,write_unsigned_short(&cvh_serializer_write_unsigned_short),read_unsigned_short(&cvh_serializer_read_unsigned_short),write_short(&cvh_serializer_write_short),read_short(&cvh_serializer_read_short) \
@@ -788,22 +1377,25 @@ CV_API_DEF cvh_serializer_t cvh_serializer_create(void) {cvh_serializer_t p;cvh_
                 ,write_long_long(&cvh_serializer_write_long_long),read_long_long(&cvh_serializer_read_long_long) \
                 ,write_float(&cvh_serializer_write_float),read_float(&cvh_serializer_read_float),write_double(&cvh_serializer_write_double),read_double(&cvh_serializer_read_double) \
                 ,write_size_t_using_mipmaps(&cvh_serializer_write_size_t_using_mipmaps),read_size_t_using_mipmaps(&cvh_serializer_read_size_t_using_mipmaps) \
-                ,write_string(&cvh_serializer_write_string),read_string(&cvh_serializer_read_string),write_blob(&cvh_serializer_write_blob),read_blob(&cvh_serializer_read_blob)
+                ,write_string(&cvh_serializer_write_string),read_string(&cvh_serializer_read_string),write_blob(&cvh_serializer_write_blob),read_blob(&cvh_serializer_read_blob) \
+                ,write_bytes(&cvh_serializer_write_bytes),read_bytes(&cvh_serializer_read_bytes)
 #   else    /*CV_DISABLE_FAKE_MEMBER_FUNCTIONS*/
 #       define CV_SERIALIZER_MF_CHUNK0  /* no-op */
 #   endif   /*CV_DISABLE_FAKE_MEMBER_FUNCTIONS*/
-    CV_API_CPP_DEF cvh_serializer_t::cvh_serializer_t() : v(NULL),size(0),capacity(0),offset(0) CV_SERIALIZER_MF_CHUNK0 {}
-    CV_API_CPP_DEF cvh_serializer_t::cvh_serializer_t(const cvh_serializer_t& o)  : v(NULL),size(0),capacity(0),offset(0) CV_SERIALIZER_MF_CHUNK0 {cvh_serializer_cpy(this,&o);}
+    CV_API_CPP_DEF cvh_serializer_t::cvh_serializer_t() : v(NULL),size(0),capacity(0),offset(0),stream_write(NULL),stream_read(NULL),stream(NULL),stream_error(0),growth_policy(NULL) CV_SERIALIZER_MF_CHUNK0 {}
+    CV_API_CPP_DEF cvh_serializer_t::cvh_serializer_t(const cvh_serializer_t& o)  : v(NULL),size(0),capacity(0),offset(0),stream_write(NULL),stream_read(NULL),stream(NULL),stream_error(0),growth_policy(o.growth_policy) CV_SERIALIZER_MF_CHUNK0 {cvh_serializer_cpy(this,&o);}
     CV_API_CPP_DEF cvh_serializer_t& cvh_serializer_t::operator=(const cvh_serializer_t& o) {cvh_serializer_cpy(this,&o);return *this;}
     CV_API_CPP_DEF cvh_serializer_t::~cvh_serializer_t()    {cvh_serializer_free(this);}
 #       ifdef CV_HAS_MOVE_SEMANTICS
-        CV_API_CPP_DEF cvh_serializer_t::cvh_serializer_t(cvh_serializer_t&& o) : v(o.v),size(o.size),capacity(o.capacity),offset(o.offset) CV_SERIALIZER_MF_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;*((size_t*)&o.offset)=0;}
+        CV_API_CPP_DEF cvh_serializer_t::cvh_serializer_t(cvh_serializer_t&& o) : v(o.v),size(o.size),capacity(o.capacity),offset(o.offset),stream_write(o.stream_write),stream_read(o.stream_read),stream(o.stream),stream_error(o.stream_error),growth_policy(o.growth_policy) CV_SERIALIZER_MF_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;*((size_t*)&o.offset)=0;o.stream_write=NULL;o.stream_read=NULL;o.stream=NULL;o.stream_error=0;}
         CV_API_CPP_DEF cvh_serializer_t& cvh_serializer_t::operator=(cvh_serializer_t&& o)  {
             if (this != &o) {
                 cvh_serializer_free(this);
                 v=o.v;
                 *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;*((size_t*)&offset)=o.offset;
+                stream_write=o.stream_write;stream_read=o.stream_read;stream=o.stream;stream_error=o.stream_error;growth_policy=o.growth_policy;
                 o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;*((size_t*)&o.offset)=0;
+                o.stream_write=NULL;o.stream_read=NULL;o.stream=NULL;o.stream_error=0;
             }
             return *this;
         }
@@ -821,7 +1413,9 @@ CV_API_DEF cvh_serializer_t cvh_serializer_create(void) {cvh_serializer_t p;cvh_
 #define CVH_STRING_GUARD_
 CV_API_DEF void cvh_string_reserve(cvh_string_t* p,size_t new_capacity)    {
     if (new_capacity>p->capacity) {
-        new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        if (p->growth_policy) new_capacity = cvh_growth_policy_next_capacity(p->growth_policy,p->capacity,new_capacity,1);
+        else new_capacity = new_capacity<p->capacity*3/2 ? p->capacity*3/2 : new_capacity; /* grow factor */
+        CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->string,"cvh_string_t",p,1,p->size,p->capacity,new_capacity);
         cv_safe_realloc((void**)&p->v,new_capacity);CV_ASSERT(p->v);
         p->capacity = new_capacity;
     }
@@ -836,7 +1430,7 @@ CV_API_DEF size_t cvh_string_push_back(cvh_string_t* p,const char* str_beg,const
     p->size+=len+1;
     return old_size;
 }
-CV_API_DEF void cvh_string_free(cvh_string_t* p)    {cv_free(p->v);p->v=NULL;p->size=p->capacity=0;}
+CV_API_DEF void cvh_string_free(cvh_string_t* p)    {if (p->v) {CVH_ALLOC_STATS_RECORD(&cvh_alloc_stats_state()->string,"cvh_string_t",p,1,p->size,p->capacity,0);}cv_free(p->v);p->v=NULL;p->size=p->capacity=0;}
 CV_API_DEF void cvh_string_cpy(cvh_string_t* dst,const cvh_string_t* src)   {
     CV_ASSERT(src && dst);
     if (dst->capacity<src->size) cvh_string_reserve(dst,src->size);
@@ -849,18 +1443,19 @@ CV_API_DEF void cvh_string_serialize(const cvh_string_t* p,cvh_serializer_t* s)
     const size_t p_v_size_in_bytes = p->size;
     CV_ASSERT(p && s);
     /*if (p && p->v) {CV_ASSERT(p->size>0 && p->v[p->size-1]=='\0');}*/
-    cvh_serializer_reserve(s,s->size + size_t_size_in_bytes+p_v_size_in_bytes);
+    cvh_serializer_reserve(s,s->size + size_t_size_in_bytes);
     *((size_t*) &s->v[s->size]) = p->size;s->size+=size_t_size_in_bytes;
-    CV_MEMCPY(&s->v[s->size],p->v,p_v_size_in_bytes);s->size+=p_v_size_in_bytes;
+    cvh_serializer_write_bytes(s,p->v,p_v_size_in_bytes);
 }
 CV_API_DEF int cvh_string_deserialize(cvh_string_t* p,const cvh_serializer_t* d)    {
     const size_t size_t_size_in_bytes = sizeof(size_t);size_t psize=0;
-    int check = d->offset+size_t_size_in_bytes<=d->size;CV_ASSERT(check);if (!check) return 0;
+    int check = cvh_serializer_fill(d,size_t_size_in_bytes);CV_ASSERT(check);if (!check) return 0;
     CV_ASSERT(p && d);
     psize = *((const size_t*) &d->v[d->offset]);*((size_t*)&d->offset)+=size_t_size_in_bytes;
-    check = d->offset+psize<=d->size;CV_ASSERT(check && "No space to deserialize the content of a cvh_string_t");if (!check) return 0;
+    check = d->stream_read || d->offset+psize<=d->size;CV_ASSERT(check && "No space to deserialize the content of a cvh_string_t");if (!check) return 0;
     cvh_string_reserve(p,psize);CV_ASSERT(p->v);
-    CV_MEMCPY(p->v,&d->v[d->offset],psize);*((size_t*)&d->offset)+=psize;p->size=psize;
+    check = cvh_serializer_read_bytes(d,p->v,psize);if (!check) return 0;
+    p->size=psize;
     return 1;
 }
 #endif /* CV_NO_CVH_SERIALIZER_T */
@@ -889,6 +1484,8 @@ CV_API_DEF void cvh_string_init(cvh_string_t* p)   {
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 }
 CV_API_DEF cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_init(&v);return v;}
+/* 'policy' (optional: it can be NULL, and it must outlive 'p') replaces the default 3/2 growth factor. cvh_string_init(...) resets it */
+CV_API_DEF void cvh_string_set_growth_policy(cvh_string_t* p,const cvh_growth_policy_t* policy)  {p->growth_policy=policy;}
 #ifdef __cplusplus
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS
 #       ifndef CV_NO_CVH_SERIALIZER_T
@@ -901,18 +1498,18 @@ CV_API_DEF cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_ini
 #   else /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
 #       define CV_CPP_STRINGT_CHUNK0    /* no-op */
 #   endif /* CV_DISABLE_FAKE_MEMBER_FUNCTIONS */
-    CV_API_CPP_DEF cvh_string_t::cvh_string_t() : v(NULL),size(0),capacity(0) CV_CPP_STRINGT_CHUNK0 {}
-    CV_API_CPP_DEF cvh_string_t::cvh_string_t(const cvh_string_t& o) : v(NULL),size(0),capacity(0) CV_CPP_STRINGT_CHUNK0 {cvh_string_cpy(this,&o);}
+    CV_API_CPP_DEF cvh_string_t::cvh_string_t() : v(NULL),size(0),capacity(0),growth_policy(NULL) CV_CPP_STRINGT_CHUNK0 {}
+    CV_API_CPP_DEF cvh_string_t::cvh_string_t(const cvh_string_t& o) : v(NULL),size(0),capacity(0),growth_policy(o.growth_policy) CV_CPP_STRINGT_CHUNK0 {cvh_string_cpy(this,&o);}
     CV_API_CPP_DEF cvh_string_t& cvh_string_t::operator=(const cvh_string_t& o) {cvh_string_cpy(this,&o);return *this;}
     CV_API_CPP_DEF const char* cvh_string_t::operator[](size_t i) const {CV_ASSERT(i<size);return &v[i];}
     CV_API_CPP_DEF cvh_string_t::~cvh_string_t() {cvh_string_free(this);}
 #   ifdef CV_HAS_MOVE_SEMANTICS
-        CV_API_CPP_DEF cvh_string_t::cvh_string_t(cvh_string_t&& o) : v(o.v),size(o.size),capacity(o.capacity) CV_CPP_STRINGT_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;}
+        CV_API_CPP_DEF cvh_string_t::cvh_string_t(cvh_string_t&& o) : v(o.v),size(o.size),capacity(o.capacity),growth_policy(o.growth_policy) CV_CPP_STRINGT_CHUNK0 {o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;}
         CV_API_CPP_DEF cvh_string_t& cvh_string_t::operator=(cvh_string_t&& o)    {
             if (this != &o) {
                 cvh_string_free(this);
                 v=o.v;
-                *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;
+                *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;growth_policy=o.growth_policy;
                 o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;
             }
             return *this;
@@ -926,6 +1523,13 @@ CV_API_DEF cvh_string_t cvh_string_create(void)   {cvh_string_t v;cvh_string_ini
 
 /* cv implementation */
 
+#ifdef CV_ENABLE_ALLOC_STATS
+/* counters shared by all the 'cvector' instances: they're updated by cvector_reserve(...), cvector_free(...) and cvector_deserialize_mapped(...) (see 'cvh_alloc_stats_t') */
+CV_API cvh_alloc_stats_t* cvector_alloc_stats(void) {static cvh_alloc_stats_t s;return &s;}
+CV_API_DEF void cvector_get_alloc_stats(cvh_alloc_stats_t* stats)   {*stats = *cvector_alloc_stats();}
+CV_API_DEF void cvector_reset_alloc_stats(void)  {const cvh_alloc_stats_t zero = {0,0,0,0,0,0,0};*cvector_alloc_stats() = zero;}
+#endif /* CV_ENABLE_ALLOC_STATS */
+
 /* Mandatory call at the end to free memory. The vector can be reused after this call. The function can be safely re-called multiple times  */
 CV_API_DEF void cvector_free(cvector* v)	{
 	if (v)	{
@@ -934,7 +1538,8 @@ CV_API_DEF void cvector_free(cvector* v)	{
 				size_t i;
                 for (i=0;i<v->size;i++)	v->item_dtr((unsigned char*)v->v+i*v->item_size_in_bytes);
 			}
-			cv_free(v->v);v->v=NULL;
+			CVH_ALLOC_STATS_RECORD(cvector_alloc_stats(),"cvector",v,v->item_size_in_bytes,v->size,v->capacity,0);
+			cv_free_with(v->allocator,v->v);v->v=NULL;
 		}	
 		*((size_t*) &v->size)=0;
 		*((size_t*) &v->capacity)=0;
@@ -960,20 +1565,23 @@ CV_API_DEF void cvector_swap(cvector* a,cvector* b)  {
         /*CV_MEMCPY(t,a,sizeof(cvector));
         CV_MEMCPY(a,b,sizeof(cvector));
         CV_MEMCPY(b,t,sizeof(cvector));*/
-        /* nope, we just swap 3 values */
+        /* nope, we just swap 3 values (plus the allocator that owns the memory) */
         {void* tmp=a->v;a->v=b->v;b->v=tmp;}
         {size_t tmp=a->size;*((size_t*)&a->size)=b->size;*((size_t*)&b->size)=tmp;}
         {size_t tmp=a->capacity;*((size_t*)&a->capacity)=b->capacity;*((size_t*)&b->capacity)=tmp;}
+        {const cvh_allocator_t* tmp=a->allocator;*((const cvh_allocator_t**)&a->allocator)=b->allocator;*((const cvh_allocator_t**)&b->allocator)=tmp;}
     }
 }
 CV_API_DEF void cvector_reserve(cvector* v,size_t size)	{
 	CV_ASSERT(v);    
 	/* grows-only! */
     if (size>v->capacity) {		
-        const size_t new_capacity = (v->capacity==0 && size>1) ?
+        const size_t new_capacity = v->growth_policy ? cvh_growth_policy_next_capacity(v->growth_policy,v->capacity,size,v->item_size_in_bytes) :
+                    (v->capacity==0 && size>1) ?
                     size :      /* possibly keep initial user-guided 'reserve(...)' */
                     (v->capacity+(size-v->capacity)+(v->capacity)/2);   /* our growing strategy */
-        cv_safe_realloc((void** const) &v->v,new_capacity*v->item_size_in_bytes);
+        CVH_ALLOC_STATS_RECORD(cvector_alloc_stats(),"cvector",v,v->item_size_in_bytes,v->size,v->capacity,new_capacity);
+        cv_safe_realloc_with(v->allocator,(void** const) &v->v,new_capacity*v->item_size_in_bytes,v->capacity*v->item_size_in_bytes);
         *((size_t*) &v->capacity) = new_capacity;
 	}
 }
@@ -1019,7 +1627,7 @@ CV_API_DEF void cvector_push_back(cvector* v,const void* value)  {
     unsigned char* p = (unsigned char*) v->v;
     CV_ASSERT(v);
     if (p && pvalue>=p && pvalue<(p+v->size))  {
-        v_val = (unsigned char*) cv_malloc(v->item_size_in_bytes);
+        v_val = (unsigned char*) cv_malloc_with(v->allocator,v->item_size_in_bytes);
 #       ifdef CV_ENABLE_CLEARING_ITEM_MEMORY
         if (v->item_ctr || v->item_cpy) CV_MEMSET(v_val,0,v->item_size_in_bytes);
 #		endif
@@ -1039,7 +1647,7 @@ CV_API_DEF void cvector_push_back(cvector* v,const void* value)  {
 
     if (v_val) {
         if (v->item_dtr) v->item_dtr(v_val);
-        cv_free(v_val);v_val=NULL;
+        cv_free_with(v->allocator,v_val);v_val=NULL;
     }
     *((size_t*) &v->size)=v->size+1;
 }
@@ -1098,7 +1706,7 @@ CV_API_DEF size_t cvector_insert_range_at(cvector* v,const void* items_to_insert
 
     if (num_items_to_insert==0) return start_position;
     if (p && (pitems+num_items_to_insert)>=p && pitems<(p+v->size))  {
-        v_val = (unsigned char*) cv_malloc(num_items_to_insert*v->item_size_in_bytes);
+        v_val = (unsigned char*) cv_malloc_with(v->allocator,num_items_to_insert*v->item_size_in_bytes);
 #		ifdef CV_ENABLE_CLEARING_ITEM_MEMORY
         if (v->item_ctr || v->item_cpy) CV_MEMSET(v_val,0,num_items_to_insert*v->item_size_in_bytes);
 #		endif
@@ -1140,7 +1748,7 @@ CV_API_DEF size_t cvector_insert_range_at(cvector* v,const void* items_to_insert
     }
     if (v_val) {
         if (v->item_dtr)	{for (i=0;i<num_items_to_insert;i++)   v->item_dtr(p+i*v->item_size_in_bytes);}
-        cv_free(v_val);v_val=NULL;
+        cv_free_with(v->allocator,v_val);v_val=NULL;
     }
     *((size_t*) &v->size)=v->size+num_items_to_insert;
     return start_position;
@@ -1154,6 +1762,40 @@ CV_API_DEF size_t cvector_insert_sorted(cvector* v,const void* item_to_insert,in
     cvector_insert_at(v,item_to_insert,position);
     return position;
 }
+CV_API_DEF void cvector_radix_sort(cvector* v,size_t key_offset,size_t key_width)  {
+    /* stable LSD radix sort (8 bits per pass) by the unsigned integer key of 'key_width' bytes (in [1,8], native byte order) stored 'key_offset' bytes inside each item */
+    /* 'v->item_cmp' is not used. Passes where all the items share the same digit are skipped. Items are moved bytewise (like in cvector_remove_at(...)) */
+    const size_t n = v ? v->size : 0;
+    const size_t item_size = v ? v->item_size_in_bytes : 0;
+    const unsigned short endianness_probe = 1;
+    const int little_endian = *((const unsigned char*)&endianness_probe);
+    size_t counts[8][256];size_t i,b,digit_offset,sum;
+    unsigned char *items,*items2,*items_mem,*tmp;
+    CV_ASSERT(v && key_width>0 && key_width<=8 && key_offset+key_width<=item_size);
+    if (n<2 || key_width==0 || key_width>8 || key_offset+key_width>item_size) return;
+    items = (unsigned char*) v->v;
+    items_mem = items2 = (unsigned char*) cv_malloc_with(v->allocator,n*item_size);
+    CV_MEMSET(counts,0,sizeof(counts));
+    for (b=0;b<key_width;b++)   {
+        /* all the histograms are built upfront: digit 'b' is the b-th least significant byte of the key */
+        size_t* c = counts[b];const unsigned char* p;
+        digit_offset = key_offset + (little_endian ? b : key_width-1-b);
+        for (i=0,p=items+digit_offset;i<n;i++,p+=item_size) ++c[*p];
+    }
+    for (b=0;b<key_width;b++)   {
+        size_t* c = counts[b];const unsigned char* p;
+        digit_offset = key_offset + (little_endian ? b : key_width-1-b);
+        if (c[items[digit_offset]]==n) continue;   /* all the items have the same digit */
+        for (i=0,sum=0;i<256;i++)    {const size_t t=c[i];c[i]=sum;sum+=t;}
+        for (i=0,p=items;i<n;i++,p+=item_size)   {
+            const size_t j = c[p[digit_offset]]++;
+            CV_MEMCPY((items2+j*item_size),p,item_size);
+        }
+        tmp=items;items=items2;items2=tmp;
+    }
+    if (items!=(unsigned char*)v->v) CV_MEMCPY(v->v,items,n*item_size);
+    cv_free_with(v->allocator,items_mem);
+}
 CV_API_DEF int cvector_remove_at(cvector* v,size_t position)  {
     /* position is in [0,num_items) */
     int removal_ok;
@@ -1218,12 +1860,22 @@ CV_API_DEF void cvector_cpy(cvector* a,const cvector* b) {
     else    {for (i=0;i<a->size;i++) a->item_cpy((unsigned char*)a->v+i*a->item_size_in_bytes,(const unsigned char*)b->v+i*b->item_size_in_bytes);}
 }
 CV_API_DEF void cvector_shrink_to_fit(cvector* v)	{
+    if (v && v->allocator && v->allocator->shrink && v->size>0 && v->size<v->capacity)   {
+        /* in-place trimming (e.g. 'cvh_vm_allocator_t' just releases the tail pages) */
+        void* p = v->allocator->shrink(v->allocator->user_data,v->v,v->size*v->item_size_in_bytes,v->capacity*v->item_size_in_bytes);
+        if (p)  {
+            CVH_ALLOC_STATS_RECORD(cvector_alloc_stats(),"cvector",v,v->item_size_in_bytes,v->size,v->capacity,v->size);
+            v->v=p;*((size_t*)&v->capacity)=v->size;
+            return;
+        }
+    }
     if (v)	{
-        cvector o = cvector_create_with(v->item_size_in_bytes,v->item_cmp,v->item_ctr,v->item_dtr,v->item_cpy
+        cvector o;
+        cvector_init_with_allocator(&o,v->item_size_in_bytes,v->item_cmp,v->item_ctr,v->item_dtr,v->item_cpy
 #       ifndef CV_NO_CVH_SERIALIZER_T
                                         ,v->item_serialize,v->item_deserialize
 #       endif
-                                        );
+                                        ,v->allocator);
         cvector_cpy(&o,v); /* now 'o' is 'v' trimmed */
         cvector_free(v);
         cvector_swap(&o,v);
@@ -1281,9 +1933,7 @@ CV_API_DEF void cvector_serialize(const cvector* v,cvh_serializer_t* serializer)
     }
     else {
         const size_t v_size_in_bytes = v->size*v->item_size_in_bytes;
-        cvh_serializer_reserve(serializer,serializer->size + v_size_in_bytes); /* space reserved for all the items (v_size_in_bytes) */
-        CV_ASSERT(serializer->v);
-        CV_MEMCPY(&serializer->v[serializer->size],v->v,v_size_in_bytes);serializer->size+=v_size_in_bytes; /* serializer->size must be incremented */
+        cvh_serializer_write_bytes(serializer,v->v,v_size_in_bytes); /* in streaming mode, big chunks are written directly to the stream */
     }
 }
 CV_API_DEF int  cvector_deserialize(cvector* v,const cvh_serializer_t* deserializer)    {
@@ -1291,7 +1941,7 @@ CV_API_DEF int  cvector_deserialize(cvector* v,const cvh_serializer_t* deseriali
     const size_t size_t_size_in_bytes = sizeof(size_t);
     size_t vsize;int check;
     CV_ASSERT(v && deserializer);
-    check = (deserializer->offset+size_t_size_in_bytes<=deserializer->size);
+    check = cvh_serializer_fill(deserializer,size_t_size_in_bytes); /* in streaming mode, it refills the buffer from the stream if needed */
     CV_ASSERT(check && "missing space to deserialize 'size_t_size_in_bytes'");  /* otherwise deserialization will fail */
     if (!check) return 0; /* but when we compile with NDEBUG, or CV_NO_ASSERT, the caller must be notified of the failure */
     vsize = *((size_t*) &deserializer->v[deserializer->offset]);*((size_t*) &deserializer->offset)+=size_t_size_in_bytes; /* 'vsize' read, 'deserializer->offset' incremented */
@@ -1305,14 +1955,36 @@ CV_API_DEF int  cvector_deserialize(cvector* v,const cvh_serializer_t* deseriali
     }
     else {
         size_t v_size_in_bytes = vsize*v->item_size_in_bytes;
-        check = deserializer->offset+v_size_in_bytes<=deserializer->size;
-        CV_ASSERT(check && "missing space to deserialize all items using CV_MEMCPY");  /* otherwise deserialization will fail */
+        check = cvh_serializer_read_bytes(deserializer,v->v,v_size_in_bytes); /* 'deserializer->offset' is incremented by cvh_serializer_read_bytes(...) */
+        CV_ASSERT(check && "missing space to deserialize all items");  /* otherwise deserialization will fail */
         if (!check) return 0;
-        CV_MEMCPY(v->v,&deserializer->v[deserializer->offset],v_size_in_bytes);
-        *((size_t*) &deserializer->offset)+=v_size_in_bytes; /* 'deserializer->offset' must be incremented */
     }
     return 1; /* we must return 1 on success */
 }
+/* Same as cvector_deserialize(...), but when 'deserializer' is mapped (see cvh_serializer_init_mapped(...)) and 'v->item_deserialize' is NULL,
+   'v->v' points directly into the mapped file (zero-copy) and 'v->allocator' is replaced by the 'cvh_mmap_t::allocator'.
+   The vector can be used and modified as usual (changes are never written back to the file, and the items are copied to the heap when it grows),
+   but the 'cvh_mmap_t' must outlive it. In all the other cases (or when the items are not aligned inside the file), it just calls cvector_deserialize(...) */
+CV_API_DEF int  cvector_deserialize_mapped(cvector* v,const cvh_serializer_t* deserializer)    {
+    const cvh_mmap_t* m = (deserializer->stream && !deserializer->stream_read && !deserializer->stream_write) ? (const cvh_mmap_t*) deserializer->stream : NULL;
+    const size_t item_align = v->item_size_in_bytes&(~v->item_size_in_bytes+1);   /* the largest power of two that divides the item size: a multiple of its alignment */
+    const size_t items_offset = deserializer->offset+sizeof(size_t);
+    size_t vsize;int check;
+    CV_ASSERT(v && deserializer);
+    if (!m || v->item_deserialize || items_offset>deserializer->size || ((size_t)(&deserializer->v[items_offset]))%(item_align<16 ? item_align : 16)!=0)
+        return cvector_deserialize(v,deserializer);
+    vsize = *((const size_t*) &deserializer->v[deserializer->offset]);
+    check = (vsize<=(deserializer->size-items_offset)/v->item_size_in_bytes);
+    CV_ASSERT(check && "missing space to deserialize all items");  /* otherwise deserialization will fail */
+    if (!check) return 0;
+    cvector_free(v);
+    *((const cvh_allocator_t**)&v->allocator)=&m->allocator;
+    v->v = vsize>0 ? (void*) &deserializer->v[items_offset] : NULL;
+    *((size_t*) &v->size)=*((size_t*) &v->capacity)=vsize;
+    if (vsize>0) {CVH_ALLOC_STATS_RECORD(cvector_alloc_stats(),"cvector",v,v->item_size_in_bytes,0,0,vsize);}   /* counted as an allocation (of mapped memory) */
+    *((size_t*) &deserializer->offset)=items_offset+vsize*v->item_size_in_bytes;
+    return 1;
+}
 #   define CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0    ,void (*item_serialize)(const void*,cvh_serializer_t*),int (*item_deserialize)(void*,const cvh_serializer_t*)
 #   define CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK1    ,NULL,NULL
 #   define CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK2    ,item_serialize,item_deserialize
@@ -1323,7 +1995,8 @@ CV_API_DEF int  cvector_deserialize(cvector* v,const cvh_serializer_t* deseriali
 #endif /* CV_NO_CVH_SERIALIZER_T */
 
 /* create methods */
-CV_API_DEF void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0)	{
+/* 'allocator' (optional) must outlive the vector: all the vector memory is allocated and released through it */
+CV_API_DEF void cvector_init_with_allocator(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0,const cvh_allocator_t* allocator)	{
     typedef int (*item_cmp_type)(const void*,const void*);
 	typedef void (*item_ctr_dtr_type)(void*);
 	typedef void (*item_cpy_type)(void*,const void*);
@@ -1342,6 +2015,7 @@ CV_API_DEF void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*ite
     typedef size_t (* insert_at_mf)(cvector*,const void*,size_t);
     typedef size_t (* insert_range_at_mf)(cvector*,const void*,size_t,size_t);
     typedef size_t (* insert_sorted_mf)(cvector*,const void*,int*,int);
+    typedef void (* radix_sort_mf)(cvector*,size_t,size_t);
     typedef int (* remove_at_mf)(cvector*,size_t);
     typedef int (* remove_range_at_mf)(cvector*,size_t,size_t);
     typedef void (* cpy_mf)(cvector*,const cvector*);
@@ -1363,6 +2037,7 @@ CV_API_DEF void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*ite
         *((item_serialize_type*)&v->item_serialize)=item_serialize;
         *((item_deserialize_type*)&v->item_deserialize)=item_deserialize;
 #       endif /* CV_NO_CVH_SERIALIZER_T */
+    *((const cvh_allocator_t**)&v->allocator)=allocator;
 #   ifndef CV_DISABLE_FAKE_MEMBER_FUNCTIONS  /* must be defined glabally (in the Project Options)) */
     *((free_clear_shrink_to_fit_pop_back_mf*)&v->free)=&cvector_free;
     *((free_clear_shrink_to_fit_pop_back_mf*)&v->clear)=&cvector_clear;
@@ -1378,6 +2053,7 @@ CV_API_DEF void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*ite
     *((insert_at_mf*)&v->insert_at)=&cvector_insert_at;
     *((insert_range_at_mf*)&v->insert_range_at)=&cvector_insert_range_at;
     *((insert_sorted_mf*)&v->insert_sorted)=&cvector_insert_sorted;
+    *((radix_sort_mf*)&v->radix_sort)=&cvector_radix_sort;
     *((remove_at_mf*)&v->remove_at)=&cvector_remove_at;
     *((remove_range_at_mf*)&v->remove_range_at)=&cvector_remove_range_at;
     *((cpy_mf*)&v->cpy)=&cvector_cpy;
@@ -1388,6 +2064,12 @@ CV_API_DEF void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*ite
 #       endif /* CV_NO_CVH_SERIALIZER_T */
 #   endif
 }
+/* 'policy' (optional) must outlive the vector. It's not swapped by cvector_swap(...) (it belongs to the instance, not to its memory) */
+CV_API_DEF void cvector_set_growth_policy(cvector* v,const cvh_growth_policy_t* policy)	{
+    CV_ASSERT(v);
+    *((const cvh_growth_policy_t**)&v->growth_policy)=policy;
+}
+CV_API_DEF void cvector_init_with(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0)	{cvector_init_with_allocator(v,item_size_in_bytes,item_cmp,item_ctr,item_dtr,item_cpy CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK2,NULL);}
 CV_API_DEF void cvector_init(cvector* v,size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*))	{cvector_init_with(v,item_size_in_bytes,item_cmp,NULL,NULL,NULL CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK1);}
 CV_API_DEF cvector cvector_create_with(size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*),void (*item_ctr)(void*),void (*item_dtr)(void*),void (*item_cpy)(void*,const void*) CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK0)	{cvector v;cvector_init_with(&v,item_size_in_bytes,item_cmp,item_ctr,item_dtr,item_cpy CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK2);return v;}
 CV_API_DEF cvector cvector_create(size_t item_size_in_bytes,int (*item_cmp)(const void*,const void*))	{return cvector_create_with(item_size_in_bytes,item_cmp,NULL,NULL,NULL CV_CVECTOR_CREATE_ARGS_SERIALIZER_CHUNK1);}
@@ -1409,24 +2091,26 @@ CV_API_DEF cvector cvector_create(size_t item_size_in_bytes,int (*item_cmp)(cons
     CV_API_CPP_DEF cvector::cvector() :
     v(NULL),size(0),capacity(0),item_size_in_bytes(0),
     item_cmp(NULL),item_ctr(NULL),item_dtr(NULL),item_cpy(NULL),CV_SERIALIZER_DEFINITION_CHUNK1
+    allocator(NULL),growth_policy(NULL),
     free(&cvector_free),clear(&cvector_clear),shrink_to_fit(&cvector_shrink_to_fit),swap(&cvector_swap),
     reserve(&cvector_reserve),resize(&cvector_resize),resize_with(&cvector_resize_with),
     push_back(&cvector_push_back),pop_back(&cvector_pop_back),
     linear_search(&cvector_linear_search),binary_search(&cvector_binary_search),
     insert_at(&cvector_insert_at),insert_range_at(&cvector_insert_range_at),insert_sorted(&cvector_insert_sorted),
-    remove_at(&cvector_remove_at),remove_range_at(&cvector_remove_range_at),
+    radix_sort(&cvector_radix_sort),remove_at(&cvector_remove_at),remove_range_at(&cvector_remove_range_at),
     cpy(&cvector_cpy),dbg_check(&cvector_dbg_check) CV_SERIALIZER_DEFINITION_CHUNK0
     {}
 
     CV_API_CPP_DEF cvector::cvector(const cvector& o) :
     v(NULL),size(0),capacity(0),item_size_in_bytes(o.item_size_in_bytes),
     item_cmp(o.item_cmp),item_ctr(o.item_ctr),item_dtr(o.item_dtr),item_cpy(o.item_cpy),CV_SERIALIZER_DEFINITION_CHUNK1
+    allocator(o.allocator),growth_policy(o.growth_policy),
     free(&cvector_free),clear(&cvector_clear),shrink_to_fit(&cvector_shrink_to_fit),swap(&cvector_swap),
     reserve(&cvector_reserve),resize(&cvector_resize),resize_with(&cvector_resize_with),
     push_back(&cvector_push_back),pop_back(&cvector_pop_back),
     linear_search(&cvector_linear_search),binary_search(&cvector_binary_search),
     insert_at(&cvector_insert_at),insert_range_at(&cvector_insert_range_at),insert_sorted(&cvector_insert_sorted),
-    remove_at(&cvector_remove_at),remove_range_at(&cvector_remove_range_at),
+    radix_sort(&cvector_radix_sort),remove_at(&cvector_remove_at),remove_range_at(&cvector_remove_range_at),
     cpy(&cvector_cpy),dbg_check(&cvector_dbg_check) CV_SERIALIZER_DEFINITION_CHUNK0
     {
         cvector_cpy(this,&o);
@@ -1438,12 +2122,13 @@ CV_API_DEF cvector cvector_create(size_t item_size_in_bytes,int (*item_cmp)(cons
     CV_API_CPP_DEF cvector::cvector(cvector&& o) :
     v(o.v),size(o.size),capacity(o.capacity),item_size_in_bytes(o.item_size_in_bytes),
     item_cmp(o.item_cmp),item_ctr(o.item_ctr),item_dtr(o.item_dtr),item_cpy(o.item_cpy),CV_SERIALIZER_DEFINITION_CHUNK2
+    allocator(o.allocator),growth_policy(o.growth_policy),
     free(&cvector_free),clear(&cvector_clear),shrink_to_fit(&cvector_shrink_to_fit),swap(&cvector_swap),
     reserve(&cvector_reserve),resize(&cvector_resize),resize_with(&cvector_resize_with),
     push_back(&cvector_push_back),pop_back(&cvector_pop_back),
     linear_search(&cvector_linear_search),binary_search(&cvector_binary_search),
     insert_at(&cvector_insert_at),insert_range_at(&cvector_insert_range_at),insert_sorted(&cvector_insert_sorted),
-    remove_at(&cvector_remove_at),remove_range_at(&cvector_remove_range_at),
+    radix_sort(&cvector_radix_sort),remove_at(&cvector_remove_at),remove_range_at(&cvector_remove_range_at),
     cpy(&cvector_cpy),dbg_check(&cvector_dbg_check) CV_SERIALIZER_DEFINITION_CHUNK0
     {
         o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;
@@ -1454,6 +2139,8 @@ CV_API_DEF cvector cvector_create(size_t item_size_in_bytes,int (*item_cmp)(cons
             cvector_free(this);
             v=o.v;
             *((size_t*)&size)=o.size;*((size_t*)&capacity)=o.capacity;
+            *((const cvh_allocator_t**)&allocator)=o.allocator;
+            *((const cvh_growth_policy_t**)&growth_policy)=o.growth_policy;
             o.v=NULL;*((size_t*)&o.size)=0;*((size_t*)&o.capacity)=0;
         }
         return *this;